@@ -0,0 +1,1058 @@
+/**
+ * @file   tiledb_bench.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Benchmarks of the read/write hot paths of TileDB, namely dense and sparse
+ * writes in every layout, subarray reads of varying selectivity, key-value
+ * puts and gets, consolidation, and writes/reads with every compressor.
+ * The results, i.e., throughput and latency percentiles, are printed as
+ * JSON so that they can be compared across commits. All the data are
+ * generated from a fixed seed.
+ *
+ * Usage:
+ *
+ * $ ./tiledb_bench [--reps N] [--filter SUBSTRING] [--out FILE]
+ *                  [--dir DIR] [--seed SEED]
+ *
+ * `--reps` sets the repetitions of every benchmark (default 5), `--filter`
+ * runs only the benchmarks whose name contains the input substring,
+ * `--out` writes the JSON to a file instead of stdout and `--dir` sets the
+ * workspace directory (default `tiledb_bench_workspace`), which is removed
+ * upon exit. The tile cache is disabled, so that reads always hit storage.
+ */
+
+#include <tiledb.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/* ********************************* */
+/*             CONSTANTS             */
+/* ********************************* */
+
+/** The number of rows/columns of the 2D arrays. */
+static const uint64_t DIM_SIZE = 1000;
+
+/** The tile extent of both dimensions of the 2D arrays. */
+static const uint64_t TILE_EXTENT = 100;
+
+/** The number of cells of the 1D arrays used by the compressor benchmarks. */
+static const uint64_t COMPRESSOR_CELL_NUM = 1000000;
+
+/** The tile extent of the 1D arrays used by the compressor benchmarks. */
+static const uint64_t COMPRESSOR_TILE_EXTENT = 10000;
+
+/** The number of items written to the key-value store. */
+static const int KV_ITEM_NUM = 10000;
+
+/** The number of random gets per key-value benchmark repetition. */
+static const int KV_GET_NUM = 1000;
+
+/** The number of fragments merged by each consolidation. */
+static const uint64_t CONSOLIDATION_FRAGMENT_NUM = 10;
+
+/* ********************************* */
+/*          TYPE DEFINITIONS         */
+/* ********************************* */
+
+/** The measurements of a single benchmark. */
+struct Result {
+  /** The benchmark name. */
+  std::string name_;
+  /** The error message, if the benchmark failed. */
+  std::string error_;
+  /** The latency of every operation, in nanoseconds. */
+  std::vector<uint64_t> latencies_;
+  /** The number of bytes processed by each operation. */
+  uint64_t op_bytes_ = 0;
+  /** The number of cells processed by each operation. */
+  uint64_t op_cells_ = 0;
+  /** Additional benchmark-specific values. */
+  std::vector<std::pair<std::string, uint64_t>> extras_;
+};
+
+/** The benchmark options. */
+struct Options {
+  /** The workspace directory. */
+  std::string dir_ = "tiledb_bench_workspace";
+  /** Only benchmarks whose name contains this substring are run. */
+  std::string filter_;
+  /** The output file; if empty, the results are printed to stdout. */
+  std::string out_;
+  /** The repetitions of every benchmark. */
+  int reps_ = 5;
+  /** The seed of the data generation. */
+  unsigned seed_ = 0;
+};
+
+/** A compressor under benchmark. */
+struct CompressorInfo {
+  /** The compressor. */
+  tiledb_compressor_t compressor_;
+  /** The name used in the benchmark names. */
+  const char* name_;
+};
+
+/* ********************************* */
+/*          GLOBAL VARIABLES         */
+/* ********************************* */
+
+/** The TileDB context shared by all benchmarks. */
+static tiledb_ctx_t* ctx = nullptr;
+
+/** The benchmark options. */
+static Options options;
+
+/** The results of all benchmarks run so far. */
+static std::vector<Result> results;
+
+/** The compressors under benchmark, i.e., one per codec family. */
+static const CompressorInfo COMPRESSORS[] = {
+    {TILEDB_NO_COMPRESSION, "none"},
+    {TILEDB_GZIP, "gzip"},
+    {TILEDB_ZSTD, "zstd"},
+    {TILEDB_LZ4, "lz4"},
+    {TILEDB_BLOSC_LZ4, "blosc_lz4"},
+    {TILEDB_RLE, "rle"},
+    {TILEDB_BZIP2, "bzip2"},
+    {TILEDB_DOUBLE_DELTA, "double_delta"},
+    {TILEDB_BITPACK, "bitpack"},
+    {TILEDB_AUTO, "auto"},
+};
+
+/**
+ * The compressors under benchmark on real values, i.e., those accepting
+ * `float64` attributes.
+ */
+static const CompressorInfo REAL_COMPRESSORS[] = {
+    {TILEDB_NO_COMPRESSION, "none"},
+    {TILEDB_GZIP, "gzip"},
+    {TILEDB_ZSTD, "zstd"},
+    {TILEDB_LZ4, "lz4"},
+    {TILEDB_BLOSC_LZ4, "blosc_lz4"},
+    {TILEDB_RLE, "rle"},
+    {TILEDB_BZIP2, "bzip2"},
+    {TILEDB_GORILLA, "gorilla"},
+    {TILEDB_AUTO, "auto"},
+};
+
+/* ********************************* */
+/*              HELPERS              */
+/* ********************************* */
+
+/** Thrown by the benchmarks upon a TileDB error. */
+struct BenchError {
+  /** The error message. */
+  std::string msg_;
+};
+
+/**
+ * Checks the return code of a C API call, throwing the last error of the
+ * context on failure.
+ */
+static void check(int rc) {
+  if (rc == TILEDB_OK)
+    return;
+
+  BenchError e;
+  e.msg_ = "Unknown error";
+  tiledb_error_t* err = nullptr;
+  if (tiledb_ctx_get_last_error(ctx, &err) == TILEDB_OK && err != nullptr) {
+    const char* msg = nullptr;
+    if (tiledb_error_message(err, &msg) == TILEDB_OK && msg != nullptr)
+      e.msg_ = msg;
+    tiledb_error_free(err);
+  }
+  throw e;
+}
+
+/** Returns the current time in nanoseconds. */
+static uint64_t now_ns() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/** Returns `true` if the benchmark with the input name must run. */
+static bool selected(const std::string& name) {
+  return options.filter_.empty() ||
+         name.find(options.filter_) != std::string::npos;
+}
+
+/** Returns the URI of an array with the input name in the workspace. */
+static std::string uri(const std::string& name) {
+  return options.dir_ + "/" + name;
+}
+
+/** Removes the input TileDB object if it exists. */
+static void remove_object(const std::string& path) {
+  tiledb_object_t type;
+  check(tiledb_object_type(ctx, path.c_str(), &type));
+  if (type != TILEDB_INVALID)
+    check(tiledb_object_remove(ctx, path.c_str()));
+}
+
+/** Returns the value of the input key in the stats JSON of a query. */
+static uint64_t query_stat(tiledb_query_t* query, const char* key) {
+  const char* json = nullptr;
+  check(tiledb_query_get_stats(ctx, query, &json));
+  std::string pattern = std::string("\"") + key + "\": ";
+  const char* pos = strstr(json, pattern.c_str());
+  return (pos == nullptr) ? 0 :
+                            strtoull(pos + pattern.size(), nullptr, 10);
+}
+
+/**
+ * Creates a 2D array with `uint64` dimensions `[1, DIM_SIZE]`, tile
+ * extents `TILE_EXTENT`, row-major tile and cell orders and a single
+ * `int32` attribute `a1`.
+ */
+static void create_array_2d(
+    const std::string& array_uri,
+    tiledb_array_type_t array_type,
+    tiledb_compressor_t compressor) {
+  uint64_t dim_domain[] = {1, DIM_SIZE, 1, DIM_SIZE};
+  uint64_t tile_extents[] = {TILE_EXTENT, TILE_EXTENT};
+  tiledb_dimension_t* d1;
+  check(tiledb_dimension_create(
+      ctx, &d1, "d1", TILEDB_UINT64, &dim_domain[0], &tile_extents[0]));
+  tiledb_dimension_t* d2;
+  check(tiledb_dimension_create(
+      ctx, &d2, "d2", TILEDB_UINT64, &dim_domain[2], &tile_extents[1]));
+  tiledb_domain_t* domain;
+  check(tiledb_domain_create(ctx, &domain));
+  check(tiledb_domain_add_dimension(ctx, domain, d1));
+  check(tiledb_domain_add_dimension(ctx, domain, d2));
+  tiledb_attribute_t* a1;
+  check(tiledb_attribute_create(ctx, &a1, "a1", TILEDB_INT32));
+  check(tiledb_attribute_set_compressor(ctx, a1, compressor, -1));
+
+  tiledb_array_schema_t* array_schema;
+  check(tiledb_array_schema_create(ctx, &array_schema, array_type));
+  check(tiledb_array_schema_set_cell_order(
+      ctx, array_schema, TILEDB_ROW_MAJOR));
+  check(tiledb_array_schema_set_tile_order(
+      ctx, array_schema, TILEDB_ROW_MAJOR));
+  check(tiledb_array_schema_set_capacity(
+      ctx, array_schema, TILE_EXTENT * TILE_EXTENT));
+  check(tiledb_array_schema_set_domain(ctx, array_schema, domain));
+  check(tiledb_array_schema_add_attribute(ctx, array_schema, a1));
+  check(tiledb_array_schema_check(ctx, array_schema));
+  remove_object(array_uri);
+  check(tiledb_array_create(ctx, array_uri.c_str(), array_schema));
+
+  tiledb_attribute_free(ctx, a1);
+  tiledb_dimension_free(ctx, d1);
+  tiledb_dimension_free(ctx, d2);
+  tiledb_domain_free(ctx, domain);
+  tiledb_array_schema_free(ctx, array_schema);
+}
+
+/**
+ * Creates a 1D dense array with an attribute `a1` of the input type,
+ * compressed with the input compressor.
+ */
+static void create_array_1d(
+    const std::string& array_uri,
+    tiledb_datatype_t type,
+    tiledb_compressor_t compressor) {
+  uint64_t dim_domain[] = {1, COMPRESSOR_CELL_NUM};
+  uint64_t tile_extent = COMPRESSOR_TILE_EXTENT;
+  tiledb_dimension_t* d1;
+  check(tiledb_dimension_create(
+      ctx, &d1, "d1", TILEDB_UINT64, dim_domain, &tile_extent));
+  tiledb_domain_t* domain;
+  check(tiledb_domain_create(ctx, &domain));
+  check(tiledb_domain_add_dimension(ctx, domain, d1));
+  tiledb_attribute_t* a1;
+  check(tiledb_attribute_create(ctx, &a1, "a1", type));
+  check(tiledb_attribute_set_compressor(ctx, a1, compressor, -1));
+
+  tiledb_array_schema_t* array_schema;
+  check(tiledb_array_schema_create(ctx, &array_schema, TILEDB_DENSE));
+  check(tiledb_array_schema_set_domain(ctx, array_schema, domain));
+  check(tiledb_array_schema_add_attribute(ctx, array_schema, a1));
+  check(tiledb_array_schema_check(ctx, array_schema));
+  remove_object(array_uri);
+  check(tiledb_array_create(ctx, array_uri.c_str(), array_schema));
+
+  tiledb_attribute_free(ctx, a1);
+  tiledb_dimension_free(ctx, d1);
+  tiledb_domain_free(ctx, domain);
+  tiledb_array_schema_free(ctx, array_schema);
+}
+
+/**
+ * Submits a write query and returns its latency in nanoseconds, which
+ * includes the query creation and finalization.
+ *
+ * @param array_uri The array to write into.
+ * @param layout The layout of the written cells.
+ * @param subarray The subarray to write into, or `nullptr`.
+ * @param a1 The `a1` values.
+ * @param a1_size The size of `a1` in bytes.
+ * @param coords The coordinates, or `nullptr` if not needed.
+ * @param coords_size The size of `coords` in bytes.
+ */
+static uint64_t write(
+    const std::string& array_uri,
+    tiledb_layout_t layout,
+    const uint64_t* subarray,
+    const void* a1,
+    uint64_t a1_size,
+    const uint64_t* coords,
+    uint64_t coords_size) {
+  const char* attributes[] = {"a1", TILEDB_COORDS};
+  void* buffers[] = {(void*)a1, (void*)coords};
+  uint64_t buffer_sizes[] = {a1_size, coords_size};
+  unsigned attribute_num = (coords == nullptr) ? 1 : 2;
+
+  uint64_t start = now_ns();
+  tiledb_query_t* query;
+  check(tiledb_query_create(ctx, &query, array_uri.c_str(), TILEDB_WRITE));
+  int rc = tiledb_query_set_layout(ctx, query, layout);
+  if (rc == TILEDB_OK && subarray != nullptr)
+    rc = tiledb_query_set_subarray(ctx, query, subarray);
+  if (rc == TILEDB_OK)
+    rc = tiledb_query_set_buffers(
+        ctx, query, attributes, attribute_num, buffers, buffer_sizes);
+  if (rc == TILEDB_OK)
+    rc = tiledb_query_submit(ctx, query);
+  int free_rc = tiledb_query_free(ctx, query);
+  check(rc);
+  check(free_rc);
+
+  return now_ns() - start;
+}
+
+/** Returns the `a1` values of the cells of the 2D arrays, in row-major. */
+static std::vector<int> a1_values_2d() {
+  std::vector<int> values(DIM_SIZE * DIM_SIZE);
+  std::mt19937 rng(options.seed_);
+  for (auto& v : values)
+    v = (int)(rng() % 1000);
+  return values;
+}
+
+/**
+ * Returns the coordinates of all the cells of the 2D arrays in the global
+ * order, i.e., tiles and cells within the tiles both in row-major.
+ *
+ * @param stride Only the cells whose coordinates sum up to a multiple of
+ *     `stride` are returned.
+ */
+static std::vector<uint64_t> coords_global_2d(uint64_t stride) {
+  std::vector<uint64_t> coords;
+  for (uint64_t tr = 0; tr < DIM_SIZE; tr += TILE_EXTENT) {
+    for (uint64_t tc = 0; tc < DIM_SIZE; tc += TILE_EXTENT) {
+      for (uint64_t r = tr + 1; r <= tr + TILE_EXTENT; ++r) {
+        for (uint64_t c = tc + 1; c <= tc + TILE_EXTENT; ++c) {
+          if ((r + c) % stride != 0)
+            continue;
+          coords.push_back(r);
+          coords.push_back(c);
+        }
+      }
+    }
+  }
+  return coords;
+}
+
+/** Shuffles the input 2D coordinates with the benchmark seed. */
+static void shuffle_coords(std::vector<uint64_t>* coords) {
+  std::mt19937 rng(options.seed_);
+  uint64_t cell_num = coords->size() / 2;
+  for (uint64_t i = cell_num - 1; i > 0; --i) {
+    uint64_t j = rng() % (i + 1);
+    std::swap((*coords)[2 * i], (*coords)[2 * j]);
+    std::swap((*coords)[2 * i + 1], (*coords)[2 * j + 1]);
+  }
+}
+
+/**
+ * Returns `COMPRESSOR_CELL_NUM` values resembling real data, i.e., runs of
+ * repeated values with small steps in between.
+ */
+static std::vector<int64_t> compressor_values() {
+  std::vector<int64_t> values(COMPRESSOR_CELL_NUM);
+  std::mt19937 rng(options.seed_);
+  int64_t v = 0;
+  uint64_t i = 0;
+  while (i < COMPRESSOR_CELL_NUM) {
+    uint64_t run = 1 + rng() % 8;
+    for (uint64_t j = 0; j < run && i < COMPRESSOR_CELL_NUM; ++j)
+      values[i++] = v;
+    v += (int64_t)(rng() % 64) - 31;
+  }
+  return values;
+}
+
+/**
+ * Returns `COMPRESSOR_CELL_NUM` real values resembling sensor readings,
+ * i.e., a slowly drifting series with repeated readings in between.
+ */
+static std::vector<double> compressor_real_values() {
+  std::vector<double> values(COMPRESSOR_CELL_NUM);
+  std::mt19937 rng(options.seed_);
+  double v = 20.0;
+  uint64_t i = 0;
+  while (i < COMPRESSOR_CELL_NUM) {
+    uint64_t run = 1 + rng() % 8;
+    for (uint64_t j = 0; j < run && i < COMPRESSOR_CELL_NUM; ++j)
+      values[i++] = v;
+    v += ((int)(rng() % 64) - 31) * 0.01;
+  }
+  return values;
+}
+
+/* ********************************* */
+/*             BENCHMARKS            */
+/* ********************************* */
+
+/**
+ * Runs a benchmark if selected, recording its failure (if any) in the
+ * result instead of aborting the whole run.
+ */
+template <class F>
+static void run(const std::string& name, F f) {
+  if (!selected(name))
+    return;
+
+  std::cerr << "Running " << name << "\n";
+  Result result;
+  result.name_ = name;
+  try {
+    f(&result);
+  } catch (const BenchError& e) {
+    result.error_ = e.msg_;
+    result.latencies_.clear();
+  }
+  results.push_back(result);
+}
+
+/** Benchmarks the dense writes in every layout. */
+static void bench_dense_writes() {
+  auto values = a1_values_2d();
+  uint64_t size = values.size() * sizeof(int);
+
+  run("dense_write_ordered", [&](Result* result) {
+    create_array_2d(
+        uri("dense_write_ordered"), TILEDB_DENSE, TILEDB_NO_COMPRESSION);
+    uint64_t subarray[] = {1, DIM_SIZE, 1, DIM_SIZE};
+    for (int i = 0; i < options.reps_; ++i)
+      result->latencies_.push_back(write(
+          uri("dense_write_ordered"),
+          TILEDB_ROW_MAJOR,
+          subarray,
+          &values[0],
+          size,
+          nullptr,
+          0));
+    result->op_bytes_ = size;
+    result->op_cells_ = values.size();
+  });
+
+  run("dense_write_global", [&](Result* result) {
+    // Rearrange the values in the global order
+    auto coords = coords_global_2d(1);
+    std::vector<int> global(values.size());
+    for (uint64_t i = 0; i < global.size(); ++i)
+      global[i] =
+          values[(coords[2 * i] - 1) * DIM_SIZE + coords[2 * i + 1] - 1];
+
+    create_array_2d(
+        uri("dense_write_global"), TILEDB_DENSE, TILEDB_NO_COMPRESSION);
+    for (int i = 0; i < options.reps_; ++i)
+      result->latencies_.push_back(write(
+          uri("dense_write_global"),
+          TILEDB_GLOBAL_ORDER,
+          nullptr,
+          &global[0],
+          size,
+          nullptr,
+          0));
+    result->op_bytes_ = size;
+    result->op_cells_ = global.size();
+  });
+
+  run("dense_write_unordered", [&](Result* result) {
+    auto coords = coords_global_2d(1);
+    shuffle_coords(&coords);
+    create_array_2d(
+        uri("dense_write_unordered"), TILEDB_DENSE, TILEDB_NO_COMPRESSION);
+    uint64_t coords_size = coords.size() * sizeof(uint64_t);
+    for (int i = 0; i < options.reps_; ++i)
+      result->latencies_.push_back(write(
+          uri("dense_write_unordered"),
+          TILEDB_UNORDERED,
+          nullptr,
+          &values[0],
+          size,
+          &coords[0],
+          coords_size));
+    result->op_bytes_ = size + coords_size;
+    result->op_cells_ = values.size();
+  });
+}
+
+/**
+ * Benchmarks the sparse writes in every layout. Ordered layouts are not
+ * applicable to sparse writes.
+ */
+static void bench_sparse_writes() {
+  auto values = a1_values_2d();
+
+  run("sparse_write_global", [&](Result* result) {
+    auto coords = coords_global_2d(4);
+    uint64_t cell_num = coords.size() / 2;
+    uint64_t size = cell_num * sizeof(int);
+    uint64_t coords_size = coords.size() * sizeof(uint64_t);
+    create_array_2d(
+        uri("sparse_write_global"), TILEDB_SPARSE, TILEDB_NO_COMPRESSION);
+    for (int i = 0; i < options.reps_; ++i)
+      result->latencies_.push_back(write(
+          uri("sparse_write_global"),
+          TILEDB_GLOBAL_ORDER,
+          nullptr,
+          &values[0],
+          size,
+          &coords[0],
+          coords_size));
+    result->op_bytes_ = size + coords_size;
+    result->op_cells_ = cell_num;
+  });
+
+  run("sparse_write_unordered", [&](Result* result) {
+    auto coords = coords_global_2d(4);
+    shuffle_coords(&coords);
+    uint64_t cell_num = coords.size() / 2;
+    uint64_t size = cell_num * sizeof(int);
+    uint64_t coords_size = coords.size() * sizeof(uint64_t);
+    create_array_2d(
+        uri("sparse_write_unordered"), TILEDB_SPARSE, TILEDB_NO_COMPRESSION);
+    for (int i = 0; i < options.reps_; ++i)
+      result->latencies_.push_back(write(
+          uri("sparse_write_unordered"),
+          TILEDB_UNORDERED,
+          nullptr,
+          &values[0],
+          size,
+          &coords[0],
+          coords_size));
+    result->op_bytes_ = size + coords_size;
+    result->op_cells_ = cell_num;
+  });
+}
+
+/**
+ * Benchmarks row-major subarray reads covering 0.1%, 1%, 10% and 100% of
+ * the domain of a dense and a sparse array, each with a single fragment.
+ * The subarrays are squares at random positions.
+ */
+static void bench_reads() {
+  static const char* SELECTIVITY_NAMES[] = {"0.1", "1", "10", "100"};
+  static const double SELECTIVITIES[] = {0.001, 0.01, 0.1, 1.0};
+
+  for (int dense = 1; dense >= 0; --dense) {
+    std::string prefix = dense ? "dense_read_" : "sparse_read_";
+
+    // Check if any read is selected before populating the array
+    bool any_selected = false;
+    for (auto name : SELECTIVITY_NAMES)
+      any_selected |= selected(prefix + name + "pct");
+    if (!any_selected)
+      continue;
+
+    std::string array_uri = uri(prefix + "array");
+    std::string populate_error;
+    try {
+      auto values = a1_values_2d();
+      if (dense) {
+        uint64_t subarray[] = {1, DIM_SIZE, 1, DIM_SIZE};
+        create_array_2d(array_uri, TILEDB_DENSE, TILEDB_NO_COMPRESSION);
+        write(
+            array_uri,
+            TILEDB_ROW_MAJOR,
+            subarray,
+            &values[0],
+            values.size() * sizeof(int),
+            nullptr,
+            0);
+      } else {
+        auto coords = coords_global_2d(4);
+        create_array_2d(array_uri, TILEDB_SPARSE, TILEDB_NO_COMPRESSION);
+        write(
+            array_uri,
+            TILEDB_GLOBAL_ORDER,
+            nullptr,
+            &values[0],
+            coords.size() / 2 * sizeof(int),
+            &coords[0],
+            coords.size() * sizeof(uint64_t));
+      }
+    } catch (const BenchError& e) {
+      populate_error = e.msg_;
+    }
+
+    for (int s = 0; s < 4; ++s) {
+      run(prefix + SELECTIVITY_NAMES[s] + "pct", [&](Result* result) {
+        if (!populate_error.empty())
+          throw BenchError{populate_error};
+
+        uint64_t side =
+            (uint64_t)std::llround(DIM_SIZE * std::sqrt(SELECTIVITIES[s]));
+        side = std::max<uint64_t>(1, std::min(side, DIM_SIZE));
+        std::vector<int> a1(side * side);
+        std::vector<uint64_t> coords(2 * side * side);
+        const char* attributes[] = {"a1", TILEDB_COORDS};
+        std::mt19937 rng(options.seed_ + s);
+        uint64_t bytes = 0, cells = 0;
+
+        // Reads are cheap, hence they are repeated more
+        for (int i = 0; i < 10 * options.reps_; ++i) {
+          uint64_t r = 1 + rng() % (DIM_SIZE - side + 1);
+          uint64_t c = 1 + rng() % (DIM_SIZE - side + 1);
+          uint64_t subarray[] = {r, r + side - 1, c, c + side - 1};
+          void* buffers[] = {&a1[0], &coords[0]};
+          uint64_t buffer_sizes[] = {a1.size() * sizeof(int),
+                                     coords.size() * sizeof(uint64_t)};
+
+          uint64_t start = now_ns();
+          tiledb_query_t* query;
+          check(tiledb_query_create(
+              ctx, &query, array_uri.c_str(), TILEDB_READ));
+          int rc = tiledb_query_set_layout(ctx, query, TILEDB_ROW_MAJOR);
+          if (rc == TILEDB_OK)
+            rc = tiledb_query_set_subarray(ctx, query, subarray);
+          if (rc == TILEDB_OK)
+            rc = tiledb_query_set_buffers(
+                ctx,
+                query,
+                attributes,
+                dense ? 1 : 2,
+                buffers,
+                buffer_sizes);
+          if (rc == TILEDB_OK)
+            rc = tiledb_query_submit(ctx, query);
+          int free_rc = tiledb_query_free(ctx, query);
+          check(rc);
+          check(free_rc);
+          result->latencies_.push_back(now_ns() - start);
+
+          bytes += buffer_sizes[0] + (dense ? 0 : buffer_sizes[1]);
+          cells += buffer_sizes[0] / sizeof(int);
+        }
+        result->op_bytes_ = bytes / result->latencies_.size();
+        result->op_cells_ = cells / result->latencies_.size();
+      });
+    }
+  }
+}
+
+/**
+ * Benchmarks key-value puts (batches of `KV_ITEM_NUM` items flushed in a
+ * single fragment) and random gets of single items.
+ */
+static void bench_kv() {
+  std::string kv_uri = uri("kv");
+
+  auto create_kv = [&]() {
+    tiledb_attribute_t* a1;
+    check(tiledb_attribute_create(ctx, &a1, "a1", TILEDB_INT32));
+    tiledb_kv_schema_t* kv_schema;
+    check(tiledb_kv_schema_create(ctx, &kv_schema));
+    check(tiledb_kv_schema_add_attribute(ctx, kv_schema, a1));
+    check(tiledb_kv_schema_check(ctx, kv_schema));
+    remove_object(kv_uri);
+    check(tiledb_kv_create(ctx, kv_uri.c_str(), kv_schema));
+    tiledb_attribute_free(ctx, a1);
+    tiledb_kv_schema_free(ctx, kv_schema);
+  };
+
+  auto put_items = [&]() {
+    tiledb_kv_t* kv;
+    check(tiledb_kv_open(ctx, &kv, kv_uri.c_str(), nullptr, 0));
+    check(tiledb_kv_set_max_items(ctx, kv, KV_ITEM_NUM));
+    tiledb_kv_item_t* item;
+    check(tiledb_kv_item_create(ctx, &item));
+    int rc = TILEDB_OK;
+    for (int key = 0; key < KV_ITEM_NUM && rc == TILEDB_OK; ++key) {
+      int value = key;
+      rc = tiledb_kv_item_set_key(ctx, item, &key, TILEDB_INT32, sizeof(key));
+      if (rc == TILEDB_OK)
+        rc = tiledb_kv_item_set_value(
+            ctx, item, "a1", &value, TILEDB_INT32, sizeof(value));
+      if (rc == TILEDB_OK)
+        rc = tiledb_kv_add_item(ctx, kv, item);
+    }
+    tiledb_kv_item_free(ctx, item);
+    int close_rc = tiledb_kv_close(ctx, kv);
+    check(rc);
+    check(close_rc);
+  };
+
+  run("kv_put", [&](Result* result) {
+    for (int i = 0; i < options.reps_; ++i) {
+      create_kv();
+      uint64_t start = now_ns();
+      put_items();
+      result->latencies_.push_back(now_ns() - start);
+    }
+    result->op_bytes_ = KV_ITEM_NUM * 2 * sizeof(int);
+    result->op_cells_ = KV_ITEM_NUM;
+  });
+
+  run("kv_get", [&](Result* result) {
+    create_kv();
+    put_items();
+
+    tiledb_kv_t* kv;
+    check(tiledb_kv_open(ctx, &kv, kv_uri.c_str(), nullptr, 0));
+    std::mt19937 rng(options.seed_);
+    int rc = TILEDB_OK;
+    for (int i = 0; i < options.reps_ * KV_GET_NUM && rc == TILEDB_OK; ++i) {
+      int key = (int)(rng() % KV_ITEM_NUM);
+      uint64_t start = now_ns();
+      tiledb_kv_item_t* item = nullptr;
+      rc = tiledb_kv_get_item(ctx, kv, &item, &key, TILEDB_INT32, sizeof(key));
+      result->latencies_.push_back(now_ns() - start);
+      if (rc == TILEDB_OK && item == nullptr) {
+        tiledb_kv_close(ctx, kv);
+        throw BenchError{"Key-value item not found"};
+      }
+      if (item != nullptr)
+        tiledb_kv_item_free(ctx, item);
+    }
+    int close_rc = tiledb_kv_close(ctx, kv);
+    check(rc);
+    check(close_rc);
+    result->op_bytes_ = 2 * sizeof(int);
+    result->op_cells_ = 1;
+  });
+}
+
+/**
+ * Benchmarks the consolidation of `CONSOLIDATION_FRAGMENT_NUM` dense
+ * fragments, each covering a band of rows of the array.
+ */
+static void bench_consolidation() {
+  run("consolidate_dense", [&](Result* result) {
+    auto values = a1_values_2d();
+    uint64_t rows = DIM_SIZE / CONSOLIDATION_FRAGMENT_NUM;
+    uint64_t band_size = rows * DIM_SIZE * sizeof(int);
+    std::string array_uri = uri("consolidate_dense");
+
+    for (int i = 0; i < options.reps_; ++i) {
+      create_array_2d(array_uri, TILEDB_DENSE, TILEDB_NO_COMPRESSION);
+      for (uint64_t f = 0; f < CONSOLIDATION_FRAGMENT_NUM; ++f) {
+        uint64_t subarray[] = {f * rows + 1, (f + 1) * rows, 1, DIM_SIZE};
+        write(
+            array_uri,
+            TILEDB_ROW_MAJOR,
+            subarray,
+            &values[f * rows * DIM_SIZE],
+            band_size,
+            nullptr,
+            0);
+      }
+
+      uint64_t start = now_ns();
+      check(tiledb_array_consolidate(ctx, array_uri.c_str()));
+      result->latencies_.push_back(now_ns() - start);
+    }
+    result->op_bytes_ = values.size() * sizeof(int);
+    result->op_cells_ = values.size();
+  });
+}
+
+/**
+ * Benchmarks full writes and reads of a 1D dense array with every input
+ * compressor. The read results also report the bytes fetched from storage,
+ * which approximate the compressed size of the data.
+ *
+ * @param prefix The prefix of the compressor names in the benchmark names.
+ * @param type The type of the attribute.
+ * @param compressors The compressors under benchmark.
+ * @param values The written values.
+ */
+template <class T, size_t N>
+static void bench_compressors(
+    const std::string& prefix,
+    tiledb_datatype_t type,
+    const CompressorInfo (&compressors)[N],
+    const std::vector<T>& values) {
+  uint64_t size = values.size() * sizeof(T);
+  uint64_t subarray[] = {1, COMPRESSOR_CELL_NUM};
+
+  for (const auto& info : compressors) {
+    std::string name = prefix + info.name_;
+
+    run(std::string("compressor_write_") + name, [&](Result* result) {
+      std::string array_uri = uri("compressor_write_" + name);
+      create_array_1d(array_uri, type, info.compressor_);
+      for (int i = 0; i < options.reps_; ++i)
+        result->latencies_.push_back(write(
+            array_uri,
+            TILEDB_GLOBAL_ORDER,
+            nullptr,
+            &values[0],
+            size,
+            nullptr,
+            0));
+      result->op_bytes_ = size;
+      result->op_cells_ = values.size();
+    });
+
+    run(std::string("compressor_read_") + name, [&](Result* result) {
+      std::string array_uri = uri("compressor_read_" + name);
+      create_array_1d(array_uri, type, info.compressor_);
+      write(
+          array_uri,
+          TILEDB_GLOBAL_ORDER,
+          nullptr,
+          &values[0],
+          size,
+          nullptr,
+          0);
+
+      std::vector<T> a1(values.size());
+      const char* attributes[] = {"a1"};
+      uint64_t vfs_read_bytes = 0;
+      for (int i = 0; i < options.reps_; ++i) {
+        void* buffers[] = {&a1[0]};
+        uint64_t buffer_sizes[] = {size};
+        uint64_t start = now_ns();
+        tiledb_query_t* query;
+        check(
+            tiledb_query_create(ctx, &query, array_uri.c_str(), TILEDB_READ));
+        int rc = tiledb_query_set_layout(ctx, query, TILEDB_GLOBAL_ORDER);
+        if (rc == TILEDB_OK)
+          rc = tiledb_query_set_subarray(ctx, query, subarray);
+        if (rc == TILEDB_OK)
+          rc = tiledb_query_set_buffers(
+              ctx, query, attributes, 1, buffers, buffer_sizes);
+        if (rc == TILEDB_OK)
+          rc = tiledb_query_submit(ctx, query);
+        uint64_t end = now_ns();
+        if (rc == TILEDB_OK)
+          vfs_read_bytes = query_stat(query, "vfs_read_bytes");
+        int free_rc = tiledb_query_free(ctx, query);
+        check(rc);
+        check(free_rc);
+        result->latencies_.push_back(end - start);
+      }
+
+      if (a1 != values)
+        throw BenchError{"Read values differ from the written ones"};
+      result->op_bytes_ = size;
+      result->op_cells_ = values.size();
+      result->extras_.emplace_back("vfs_read_bytes", vfs_read_bytes);
+    });
+  }
+}
+
+/**
+ * Benchmarks every compressor on `int64` values, and the compressors
+ * accepting real values on `float64` values.
+ */
+static void bench_compressors() {
+  bench_compressors("", TILEDB_INT64, COMPRESSORS, compressor_values());
+  bench_compressors(
+      "float64_", TILEDB_FLOAT64, REAL_COMPRESSORS, compressor_real_values());
+}
+
+/* ********************************* */
+/*               OUTPUT              */
+/* ********************************* */
+
+/** Returns the input percentile of the sorted latencies (nearest rank). */
+static uint64_t percentile(const std::vector<uint64_t>& sorted, double p) {
+  auto rank = (uint64_t)std::ceil(p / 100.0 * sorted.size());
+  return sorted[(rank == 0) ? 0 : rank - 1];
+}
+
+/** Returns all the results as JSON. */
+static std::string to_json() {
+  int major, minor, rev;
+  tiledb_version(&major, &minor, &rev);
+
+  std::stringstream ss;
+  ss << "{\n";
+  ss << "  \"tiledb_version\": \"" << major << "." << minor << "." << rev
+     << "\",\n";
+  ss << "  \"seed\": " << options.seed_ << ",\n";
+  ss << "  \"reps\": " << options.reps_ << ",\n";
+  ss << "  \"benchmarks\": [";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const auto& r = results[i];
+    ss << (i == 0 ? "\n" : ",\n");
+    ss << "    {\n";
+    ss << "      \"name\": \"" << r.name_ << "\",\n";
+    if (!r.error_.empty() || r.latencies_.empty()) {
+      std::string error = r.error_;
+      std::replace(error.begin(), error.end(), '"', '\'');
+      ss << "      \"error\": \"" << error << "\"\n";
+      ss << "    }";
+      continue;
+    }
+
+    auto sorted = r.latencies_;
+    std::sort(sorted.begin(), sorted.end());
+    uint64_t total_ns = 0;
+    for (auto l : sorted)
+      total_ns += l;
+    double total_sec = std::max<uint64_t>(total_ns, 1) / 1e9;
+    uint64_t op_num = sorted.size();
+
+    ss << "      \"ops\": " << op_num << ",\n";
+    ss << "      \"op_bytes\": " << r.op_bytes_ << ",\n";
+    ss << "      \"op_cells\": " << r.op_cells_ << ",\n";
+    ss << "      \"throughput_mb_per_sec\": "
+       << (r.op_bytes_ * op_num) / total_sec / 1e6 << ",\n";
+    ss << "      \"throughput_cells_per_sec\": "
+       << (r.op_cells_ * op_num) / total_sec << ",\n";
+    ss << "      \"latency_ms\": {";
+    ss << "\"min\": " << sorted.front() / 1e6;
+    ss << ", \"mean\": " << total_ns / 1e6 / op_num;
+    ss << ", \"p50\": " << percentile(sorted, 50) / 1e6;
+    ss << ", \"p90\": " << percentile(sorted, 90) / 1e6;
+    ss << ", \"p99\": " << percentile(sorted, 99) / 1e6;
+    ss << ", \"max\": " << sorted.back() / 1e6 << "}";
+    for (const auto& extra : r.extras_)
+      ss << ",\n      \"" << extra.first << "\": " << extra.second;
+    ss << "\n    }";
+  }
+  ss << "\n  ]\n}\n";
+
+  return ss.str();
+}
+
+/* ********************************* */
+/*                MAIN               */
+/* ********************************* */
+
+/** Parses the command line options, returning `false` upon error. */
+static bool parse_options(int argc, char** argv) {
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (i + 1 == argc) {
+      std::cerr << "Missing value for option " << arg << "\n";
+      return false;
+    }
+    std::string value = argv[++i];
+    if (arg == "--reps") {
+      options.reps_ = atoi(value.c_str());
+      if (options.reps_ <= 0) {
+        std::cerr << "The repetitions must be positive\n";
+        return false;
+      }
+    } else if (arg == "--filter") {
+      options.filter_ = value;
+    } else if (arg == "--out") {
+      options.out_ = value;
+    } else if (arg == "--dir") {
+      options.dir_ = value;
+    } else if (arg == "--seed") {
+      options.seed_ = (unsigned)strtoul(value.c_str(), nullptr, 10);
+    } else {
+      std::cerr << "Unknown option " << arg << "\n";
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  if (!parse_options(argc, argv)) {
+    std::cerr << "Usage: tiledb_bench [--reps N] [--filter SUBSTRING] "
+                 "[--out FILE] [--dir DIR] [--seed SEED]\n";
+    return 1;
+  }
+
+  // Create TileDB context, with the tile cache disabled
+  tiledb_config_t* config;
+  tiledb_error_t* error = nullptr;
+  tiledb_config_create(&config, &error);
+  tiledb_config_set(config, "sm.tile_cache_size", "0", &error);
+  if (tiledb_ctx_create(&ctx, config) != TILEDB_OK) {
+    std::cerr << "Cannot create TileDB context\n";
+    tiledb_config_free(config);
+    return 1;
+  }
+  tiledb_config_free(config);
+
+  // Create the workspace
+  try {
+    remove_object(options.dir_);
+    check(tiledb_group_create(ctx, options.dir_.c_str()));
+  } catch (const BenchError& e) {
+    std::cerr << "Cannot create workspace: " << e.msg_ << "\n";
+    tiledb_ctx_free(ctx);
+    return 1;
+  }
+
+  bench_dense_writes();
+  bench_sparse_writes();
+  bench_reads();
+  bench_kv();
+  bench_consolidation();
+  bench_compressors();
+
+  // Clean up
+  tiledb_object_remove(ctx, options.dir_.c_str());
+  tiledb_ctx_free(ctx);
+
+  // Output the results
+  std::string json = to_json();
+  if (options.out_.empty()) {
+    std::cout << json;
+  } else {
+    std::ofstream ofs(options.out_);
+    ofs << json;
+    if (!ofs.good()) {
+      std::cerr << "Cannot write results to " << options.out_ << "\n";
+      return 1;
+    }
+  }
+
+  bool failed = false;
+  for (const auto& r : results)
+    failed |= !r.error_.empty();
+
+  return failed ? 2 : 0;
+}
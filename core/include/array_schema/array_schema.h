@@ -357,12 +357,30 @@ class ArraySchema {
    */
   bool check_attribute_dimension_names() const;
 
+  /**
+   * Returns false if bit-packing compression is used with real attributes
+   * or coordinates and true otherwise.
+   */
+  bool check_bitpack_compressor() const;
+
+  /**
+   * Returns false if dictionary encoding is enabled on an attribute that is
+   * not variable-sized char, and true otherwise.
+   */
+  bool check_dictionary_encoding() const;
+
   /**
    * Returns false if double delta compression is used with real attributes
    * or coordinates and true otherwise.
    */
   bool check_double_delta_compressor() const;
 
+  /**
+   * Returns false if Gorilla compression is used with non-real attributes
+   * or coordinates and true otherwise.
+   */
+  bool check_gorilla_compressor() const;
+
   /** Clears all members. Use with caution! */
   void clear();
 
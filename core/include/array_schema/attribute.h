@@ -38,6 +38,7 @@
 #include "buffer.h"
 #include "compressor.h"
 #include "datatype.h"
+#include "filter_pipeline.h"
 #include "status.h"
 
 namespace tiledb {
@@ -89,17 +90,37 @@ class Attribute {
   /** Returns the compression level. */
   int compression_level() const;
 
+  /**
+   * Appends a filter to the pipeline that runs on the attribute values
+   * prior to compression.
+   */
+  void add_filter(FilterType type);
+
+  /** Removes all the filters of the attribute. */
+  void clear_filters();
+
   /**
    * Populates the object members from the data in the input binary buffer.
    *
    * @param buff The buffer to deserialize from.
+   * @param version The format version of the array schema the attribute
+   *     belongs to, in format { major, minor, revision }.
    * @return Status
    */
-  Status deserialize(ConstBuffer* buff);
+  Status deserialize(ConstBuffer* buff, const int* version);
+
+  /**
+   * Returns *true* if the values of the attribute are dictionary-encoded
+   * in every tile.
+   */
+  bool dictionary_encoding() const;
 
   /** Dumps the attribute contents in ASCII form in the selected output. */
   void dump(FILE* out) const;
 
+  /** Returns the filter pipeline of the attribute. */
+  const FilterPipeline* filters() const;
+
   /** Returns the attribute name. */
   const std::string& name() const;
 
@@ -123,6 +144,9 @@ class Attribute {
   /** Sets the attribute compression level. */
   void set_compression_level(int compression_level);
 
+  /** Sets whether the attribute values are dictionary-encoded. */
+  void set_dictionary_encoding(bool dictionary_encoding);
+
   /** Sets the attribute name. */
   void set_name(const std::string& name);
 
@@ -149,6 +173,12 @@ class Attribute {
   /** The attribute compression level. */
   int compression_level_;
 
+  /** Whether the attribute values are dictionary-encoded. */
+  bool dictionary_encoding_;
+
+  /** The filters applied to the attribute values prior to compression. */
+  FilterPipeline filters_;
+
   /** The attribute name. */
   std::string name_;
 
@@ -62,6 +62,16 @@ class Buffer {
    */
   Buffer(void* data, uint64_t size, bool owns_data);
 
+  /**
+   * Constructor. Initializes an empty buffer that writes into the input
+   * memory without owning it. Writes and reallocations succeed only within
+   * the input capacity.
+   *
+   * @param data The memory the buffer writes into.
+   * @param alloced_size The capacity of the memory.
+   */
+  Buffer(void* data, uint64_t alloced_size);
+
   /** Destructor. */
   ~Buffer();
 
@@ -174,6 +174,22 @@ typedef enum {
 #undef TILEDB_COMPRESSOR_ENUM
 } tiledb_compressor_t;
 
+/** Filter type. */
+typedef enum {
+/** Helper macro for defining filter type enums. */
+#define TILEDB_FILTER_TYPE_ENUM(id) TILEDB_##id
+#include "tiledb_enum.h"
+#undef TILEDB_FILTER_TYPE_ENUM
+} tiledb_filter_type_t;
+
+/** Query condition comparison operator. */
+typedef enum {
+/** Helper macro for defining query condition operator enums. */
+#define TILEDB_QUERY_CONDITION_OP_ENUM(id) TILEDB_##id
+#include "tiledb_enum.h"
+#undef TILEDB_QUERY_CONDITION_OP_ENUM
+} tiledb_query_condition_op_t;
+
 /** Walk traversal order. */
 typedef enum {
 /** Helper macro for defining walk order enums. */
@@ -234,6 +250,9 @@ typedef struct tiledb_domain_t tiledb_domain_t;
 /** A TileDB query. */
 typedef struct tiledb_query_t tiledb_query_t;
 
+/** A TileDB query iterator. */
+typedef struct tiledb_query_iter_t tiledb_query_iter_t;
+
 /** A key-value store schema. */
 typedef struct tiledb_kv_schema_t tiledb_kv_schema_t;
 
@@ -494,6 +513,26 @@ TILEDB_EXPORT int tiledb_ctx_get_last_error(
 TILEDB_EXPORT int tiledb_ctx_is_supported_fs(
     tiledb_ctx_t* ctx, tiledb_filesystem_t fs, int* is_supported);
 
+/**
+ * Dumps the statistics aggregated over all the queries of a context as a
+ * JSON object. The object holds counters (e.g., `tile_read_num`,
+ * `tile_cache_hit_num`, `vfs_read_bytes`) and timers in nanoseconds (e.g.,
+ * `vfs_read_ns`, `decompress_ns`). Timers are inclusive and may overlap.
+ *
+ * @param ctx The TileDB context.
+ * @param out The output handle.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_ctx_stats_dump(tiledb_ctx_t* ctx, FILE* out);
+
+/**
+ * Resets the statistics of a context to zero.
+ *
+ * @param ctx The TileDB context.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_ctx_stats_reset(tiledb_ctx_t* ctx);
+
 /* ********************************* */
 /*                GROUP              */
 /* ********************************* */
@@ -599,6 +638,94 @@ TILEDB_EXPORT int tiledb_attribute_get_compressor(
     tiledb_compressor_t* compressor,
     int* compression_level);
 
+/**
+ * Appends a filter to the pipeline of an attribute. The filters run in the
+ * order they are added on the attribute values of every tile chunk prior
+ * to compression, and are reverted after decompression upon reads. For
+ * instance, byte shuffling followed by a ZSTD compressor often compresses
+ * floating point data much better than ZSTD alone. The filters apply to
+ * the values (not the offsets) of variable-sized attributes.
+ *
+ * @param ctx The TileDB context.
+ * @param attr The target attribute.
+ * @param filter The filter to be appended, which must be one of:
+ *    - TILEDB_FILTER_BYTESHUFFLE
+ *    - TILEDB_FILTER_BITSHUFFLE
+ *    - TILEDB_FILTER_DELTA
+ *    - TILEDB_FILTER_DOUBLE_DELTA
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_attribute_add_filter(
+    tiledb_ctx_t* ctx, tiledb_attribute_t* attr, tiledb_filter_type_t filter);
+
+/**
+ * Removes all the filters of an attribute.
+ *
+ * @param ctx The TileDB context.
+ * @param attr The target attribute.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_attribute_clear_filters(
+    tiledb_ctx_t* ctx, tiledb_attribute_t* attr);
+
+/**
+ * Retrieves the number of filters of an attribute.
+ *
+ * @param ctx The TileDB context.
+ * @param attr The attribute.
+ * @param filter_num The number of filters to be retrieved.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_attribute_get_filter_num(
+    tiledb_ctx_t* ctx, const tiledb_attribute_t* attr, unsigned int* filter_num);
+
+/**
+ * Retrieves a filter of an attribute given its index in the pipeline.
+ *
+ * @param ctx The TileDB context.
+ * @param attr The attribute.
+ * @param index The index of the filter.
+ * @param filter The filter to be retrieved.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_attribute_get_filter_from_index(
+    tiledb_ctx_t* ctx,
+    const tiledb_attribute_t* attr,
+    unsigned int index,
+    tiledb_filter_type_t* filter);
+
+/**
+ * Sets whether the values of an attribute are dictionary-encoded. Every
+ * distinct cell value of a tile is then stored once, and every cell is
+ * stored as a small fixed-width code into this per-tile dictionary, prior
+ * to filtering and compression. This pays off for low-cardinality strings
+ * (e.g., categories or country names). A tile whose dictionary would not
+ * make it smaller is stored as is. Only variable-sized `TILEDB_CHAR`
+ * attributes can be dictionary-encoded.
+ *
+ * @param ctx The TileDB context.
+ * @param attr The target attribute.
+ * @param dictionary_encoding `1` to enable dictionary encoding, `0` to
+ *     disable it.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_attribute_set_dictionary_encoding(
+    tiledb_ctx_t* ctx, tiledb_attribute_t* attr, int dictionary_encoding);
+
+/**
+ * Retrieves whether the values of an attribute are dictionary-encoded.
+ *
+ * @param ctx The TileDB context.
+ * @param attr The attribute.
+ * @param dictionary_encoding Set to `1` if dictionary encoding is enabled,
+ *     and `0` otherwise.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_attribute_get_dictionary_encoding(
+    tiledb_ctx_t* ctx,
+    const tiledb_attribute_t* attr,
+    int* dictionary_encoding);
+
 /**
  * Retrieves the number of values per cell for the attribute.
  *
@@ -1131,6 +1258,30 @@ TILEDB_EXPORT int tiledb_query_create(
     const char* array_uri,
     tiledb_query_type_t type);
 
+/**
+ * Creates a TileDB read query that sees only the array fragments written
+ * within a timestamp range, i.e., it reads the array as it was at
+ * *timestamp_end*, ignoring the fragments written before *timestamp_start*.
+ * Only the metadata of the fragments within the range are loaded. The
+ * timestamps are in milliseconds since the epoch. Note that a consolidated
+ * fragment takes the timestamp of the latest fragment it merged.
+ *
+ * @param ctx The TileDB context.
+ * @param query The query object to be created.
+ * @param array_uri The name of the array the query will focus on.
+ * @param type The query type, which must be TILEDB_READ.
+ * @param timestamp_start The smallest fragment timestamp (inclusive).
+ * @param timestamp_end The largest fragment timestamp (inclusive).
+ * @return TILEDB_OK for success and TILEDB_OOM or TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_query_create_with_timestamp_range(
+    tiledb_ctx_t* ctx,
+    tiledb_query_t** query,
+    const char* array_uri,
+    tiledb_query_type_t type,
+    uint64_t timestamp_start,
+    uint64_t timestamp_end);
+
 /**
  * Indicates that the query will write or read a subarray, and provides
  * the appropriate information.
@@ -1206,6 +1357,32 @@ TILEDB_EXPORT int tiledb_query_set_buffers(
 TILEDB_EXPORT int tiledb_query_set_layout(
     tiledb_ctx_t* ctx, tiledb_query_t* query, tiledb_layout_t layout);
 
+/**
+ * Adds a condition that the cells returned by a read query must satisfy.
+ * The conditions are evaluated on the decompressed tiles, so that only the
+ * satisfying cells are copied into the user buffers, and the tiles whose
+ * value statistics rule out any match are not read at all. Multiple
+ * conditions are combined with a logical AND. NaNs never satisfy a
+ * condition.
+ *
+ * Conditions apply only to sparse arrays, and to fixed-sized attributes with
+ * a single value per cell. The attribute need not be among those read.
+ *
+ * @param ctx The TileDB context.
+ * @param query The TileDB query.
+ * @param attribute The name of the attribute to compare.
+ * @param op The comparison operator. The condition is satisfied by the cells
+ *     whose attribute value `v` satisfies `v op value`.
+ * @param value The value to compare against, of the attribute type.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_query_add_condition(
+    tiledb_ctx_t* ctx,
+    tiledb_query_t* query,
+    const char* attribute,
+    tiledb_query_condition_op_t op,
+    const void* value);
+
 /**
  * Frees a TileDB query object.
  *
@@ -1292,6 +1469,126 @@ TILEDB_EXPORT int tiledb_query_get_attribute_status(
     const char* attribute_name,
     tiledb_query_status_t* status);
 
+/**
+ * Retrieves the statistics collected so far by a query as a JSON object,
+ * in the format of `tiledb_ctx_stats_dump`. The statistics of a query
+ * are also aggregated into those of its context.
+ *
+ * @param ctx The TileDB context.
+ * @param query The query.
+ * @param stats_json The JSON string to be retrieved. It is owned by the
+ *     query and remains valid until the next call to this function or
+ *     until the query is freed.
+ * @return TILEDB_OK upon success, and TILEDB_ERR upon error.
+ */
+TILEDB_EXPORT int tiledb_query_get_stats(
+    tiledb_ctx_t* ctx, tiledb_query_t* query, const char** stats_json);
+
+/* ********************************* */
+/*             QUERY ITER            */
+/* ********************************* */
+
+/**
+ * Creates a query iterator, which streams the results of a read query in
+ * batches of cells. The results are stored in internal buffers, which are
+ * allocated once within the memory budget set by the config parameter
+ * `sm.query_iter_memory_budget` and reused across batches. The first batch
+ * is retrieved upon creation.
+ *
+ * @param ctx The TileDB context.
+ * @param query_iter The query iterator to be created.
+ * @param array_uri The URI of the array to read from.
+ * @param subarray The subarray to read, as a sequence of [low, high] pairs
+ *     (one pair per dimension). `NULL` indicates the entire domain.
+ * @param attributes The attributes to read. `NULL` indicates **all**
+ *     attributes, plus the coordinates (`TILEDB_COORDS`) for sparse arrays.
+ * @param attribute_num The number of `attributes`.
+ * @param layout The layout of the retrieved cells.
+ * @return TILEDB_OK for success and TILEDB_OOM or TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_query_iter_create(
+    tiledb_ctx_t* ctx,
+    tiledb_query_iter_t** query_iter,
+    const char* array_uri,
+    const void* subarray,
+    const char** attributes,
+    unsigned int attribute_num,
+    tiledb_layout_t layout);
+
+/**
+ * Frees a query iterator.
+ *
+ * @param ctx The TileDB context.
+ * @param query_iter The query iterator to be freed.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_query_iter_free(
+    tiledb_ctx_t* ctx, tiledb_query_iter_t* query_iter);
+
+/**
+ * Retrieves the next batch of results. This invalidates the buffers
+ * retrieved for the previous batch.
+ *
+ * @param ctx The TileDB context.
+ * @param query_iter The query iterator.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_query_iter_next(
+    tiledb_ctx_t* ctx, tiledb_query_iter_t* query_iter);
+
+/**
+ * Checks if the iterator is done, i.e., if there are no more batches.
+ *
+ * @param ctx The TileDB context.
+ * @param query_iter The query iterator.
+ * @param done Sets this to `1` if the iterator is done, and `0` otherwise.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_query_iter_done(
+    tiledb_ctx_t* ctx, tiledb_query_iter_t* query_iter, int* done);
+
+/**
+ * Retrieves the results of the current batch for a fixed-sized attribute.
+ * Note that a batch may hold a different number of cells per attribute.
+ *
+ * @param ctx The TileDB context.
+ * @param query_iter The query iterator.
+ * @param attribute The attribute name.
+ * @param buffer Set to the internal buffer holding the attribute values.
+ * @param buffer_size Set to the size of the results in `buffer`.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_query_iter_get_buffer(
+    tiledb_ctx_t* ctx,
+    tiledb_query_iter_t* query_iter,
+    const char* attribute,
+    void** buffer,
+    uint64_t* buffer_size);
+
+/**
+ * Retrieves the results of the current batch for a variable-sized
+ * attribute. Note that a batch may hold a different number of cells per
+ * attribute.
+ *
+ * @param ctx The TileDB context.
+ * @param query_iter The query iterator.
+ * @param attribute The attribute name.
+ * @param buffer_off Set to the internal buffer holding the starting offsets
+ *     of the cell values in `buffer_val`.
+ * @param buffer_off_size Set to the size of the results in `buffer_off`.
+ * @param buffer_val Set to the internal buffer holding the attribute values.
+ * @param buffer_val_size Set to the size of the results in `buffer_val`.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_query_iter_get_buffer_var(
+    tiledb_ctx_t* ctx,
+    tiledb_query_iter_t* query_iter,
+    const char* attribute,
+    uint64_t** buffer_off,
+    uint64_t* buffer_off_size,
+    void** buffer_val,
+    uint64_t* buffer_val_size);
+
 /* ********************************* */
 /*               ARRAY               */
 /* ********************************* */
@@ -1319,6 +1616,79 @@ TILEDB_EXPORT int tiledb_array_create(
 TILEDB_EXPORT int tiledb_array_consolidate(
     tiledb_ctx_t* ctx, const char* array_uri);
 
+/**
+ * Consolidates the fragments of an array into a single fragment, reporting
+ * the progress of the consolidation. The cells are copied in batches, whose
+ * total memory is bounded by the `sm.consolidation_memory_budget`
+ * configuration parameter.
+ *
+ * @param ctx The TileDB context.
+ * @param array_uri The name of the TileDB array to be consolidated.
+ * @param callback The function called after every batch of cells written
+ *     to the consolidated fragment. Its arguments are the number of cells
+ *     and the number of bytes consolidated so far, and *callback_data*.
+ * @param callback_data The data to be passed to the callback function.
+ * @return TILEDB_OK on success, and TILEDB_ERR on error.
+ */
+TILEDB_EXPORT int tiledb_array_consolidate_with_progress(
+    tiledb_ctx_t* ctx,
+    const char* array_uri,
+    void (*callback)(uint64_t, uint64_t, void*),
+    void* callback_data);
+
+/**
+ * Consolidates the metadata of the fragments of an array into a single
+ * object, which allows opening the array with a single metadata read. The
+ * fragments themselves are not consolidated. Fragments written after this
+ * call have their metadata loaded separately, until the next call.
+ *
+ * @param ctx The TileDB context.
+ * @param array_uri The name of the TileDB array.
+ * @return TILEDB_OK on success, and TILEDB_ERR on error.
+ */
+TILEDB_EXPORT int tiledb_array_consolidate_metadata(
+    tiledb_ctx_t* ctx, const char* array_uri);
+
+/**
+ * Retrieves the statistics of the values of a fixed-sized attribute of an
+ * array. They are computed from the per-tile statistics stored in the
+ * fragment metadata upon writing, without reading any tile. The values
+ * equal to the empty value of the attribute type (its maximum value, which
+ * dense arrays store in the cells that were never written) are counted as
+ * nulls and excluded from the other statistics. The cells of every fragment
+ * are included, even if overwritten by a later fragment, so the minimum and
+ * maximum bound the current values, whereas the counts and the sum are
+ * exact only if the fragments do not overlap (e.g., after consolidation).
+ *
+ * @param ctx The TileDB context.
+ * @param array_uri The array URI.
+ * @param attribute_name The name of the fixed-sized attribute.
+ * @param min Holds one value of the attribute type, set to the minimum
+ *     non-null value if `count` is positive. It is ignored if `NULL`.
+ * @param max Holds one value of the attribute type, set to the maximum
+ *     non-null value if `count` is positive. It is ignored if `NULL`.
+ * @param sum Set to the sum of the non-null values, which is an `int64_t`
+ *     for signed integer types, a `uint64_t` for unsigned integer types and
+ *     a `double` for real types. It is ignored if `NULL` or if the attribute
+ *     type is `TILEDB_CHAR`.
+ * @param count Set to the number of non-null values.
+ * @param null_count Set to the number of null values.
+ * @param has_stats Set to `0` if some fragment stores no statistics for the
+ *     attribute (e.g., it was written by an older version), in which case
+ *     no other output is set, and to `1` otherwise.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_array_get_attribute_stats(
+    tiledb_ctx_t* ctx,
+    const char* array_uri,
+    const char* attribute_name,
+    void* min,
+    void* max,
+    void* sum,
+    uint64_t* count,
+    uint64_t* null_count,
+    int* has_stats);
+
 /**
  * Retrieves the non-empty domain from an array. This is the union of the
  * non-empty domains of the array fragments.
@@ -1358,6 +1728,37 @@ TILEDB_EXPORT int tiledb_array_compute_max_read_buffer_sizes(
     unsigned attribute_num,
     uint64_t* buffer_sizes);
 
+/**
+ * Computes an estimate of the buffer sizes required for a read query, for a
+ * given subarray and set of attributes, along with the upper bound computed
+ * by `tiledb_array_compute_max_read_buffer_sizes`. The estimate assumes that
+ * the cells of every tile are uniformly distributed within its domain (dense)
+ * or minimum bounding rectangle (sparse), and uses the size of the
+ * variable-sized values of every tile. It is computed from the fragment
+ * metadata only, without reading any tile.
+ *
+ * @param ctx The TileDB context.
+ * @param array_uri The array URI.
+ * @param subarray The subarray to focus on. Note that it must have the same
+ *     underlying type as the array domain.
+ * @param attributes The attributes to focus on.
+ * @param attribute_num The number of attributes.
+ * @param est_buffer_sizes The estimated buffer sizes to be retrieved, with
+ *     one buffer size per fixed-sized attribute and two per variable-sized
+ *     attribute, as in `tiledb_array_compute_max_read_buffer_sizes`.
+ * @param max_buffer_sizes The upper bounds on the buffer sizes to be
+ *     retrieved. It is ignored if it is `NULL`.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_array_compute_est_read_buffer_sizes(
+    tiledb_ctx_t* ctx,
+    const char* array_uri,
+    const void* subarray,
+    const char** attributes,
+    unsigned attribute_num,
+    uint64_t* est_buffer_sizes,
+    uint64_t* max_buffer_sizes);
+
 /* ********************************* */
 /*          OBJECT MANAGEMENT        */
 /* ********************************* */
@@ -1681,6 +2082,17 @@ TILEDB_EXPORT int tiledb_kv_create(
  */
 TILEDB_EXPORT int tiledb_kv_consolidate(tiledb_ctx_t* ctx, const char* kv_uri);
 
+/**
+ * Consolidates the metadata of the fragments of a key-value store into a
+ * single object. See `tiledb_array_consolidate_metadata`.
+ *
+ * @param ctx The TileDB context.
+ * @param kv_uri The name of the TileDB key-value store.
+ * @return TILEDB_OK on success, and TILEDB_ERR on error.
+ */
+TILEDB_EXPORT int tiledb_kv_consolidate_metadata(
+    tiledb_ctx_t* ctx, const char* kv_uri);
+
 /**
  * Sets the parameter that dictates the maximum number of written items
  * buffered in memory before a flush is initiated.
@@ -1764,6 +2176,34 @@ TILEDB_EXPORT int tiledb_kv_get_item(
     tiledb_datatype_t key_type,
     uint64_t key_size);
 
+/**
+ * Retrieves a batch of key-value items based on the input keys. This is
+ * much faster than invoking `tiledb_kv_get_item` for every key, since the
+ * keys are sorted on their hash and the items residing in the same data
+ * tile are retrieved with a single read. The items are returned in the
+ * order of the input keys. If the item with some key does not exist, the
+ * corresponding entry of `kv_items` is set to `NULL`. Every retrieved item
+ * must be freed with `tiledb_kv_item_free`.
+ *
+ * @param ctx The TileDB context.
+ * @param kv The key-value store.
+ * @param kv_items The key-value items to be retrieved. This must be an
+ *     array of `key_num` pointers, allocated by the user.
+ * @param keys The keys.
+ * @param key_types The key types.
+ * @param key_sizes The key sizes.
+ * @param key_num The number of keys.
+ * @return TILEDB_OK for success and TILEDB_ERR for error.
+ */
+TILEDB_EXPORT int tiledb_kv_get_items(
+    tiledb_ctx_t* ctx,
+    tiledb_kv_t* kv,
+    tiledb_kv_item_t** kv_items,
+    const void** keys,
+    const tiledb_datatype_t* key_types,
+    const uint64_t* key_sizes,
+    unsigned key_num);
+
 /* ****************************** */
 /*          KEY-VALUE ITER        */
 /* ****************************** */
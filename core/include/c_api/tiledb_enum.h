@@ -126,6 +126,12 @@
     TILEDB_COMPRESSOR_ENUM(BZIP2),
     /** Double-delta compressor */
     TILEDB_COMPRESSOR_ENUM(DOUBLE_DELTA),
+    /** Frame-of-reference bit-packing compressor */
+    TILEDB_COMPRESSOR_ENUM(BITPACK),
+    /** XOR (Gorilla) compressor for real values */
+    TILEDB_COMPRESSOR_ENUM(GORILLA),
+    /** Per-tile choice among the configured candidate compressors */
+    TILEDB_COMPRESSOR_ENUM(AUTO),
 #endif
 
 #ifdef TILEDB_QUERY_STATUS_ENUM
@@ -139,6 +145,21 @@
     TILEDB_QUERY_STATUS_ENUM(INCOMPLETE) = 2,
 #endif
 
+#ifdef TILEDB_QUERY_CONDITION_OP_ENUM
+    /** Less than */
+    TILEDB_QUERY_CONDITION_OP_ENUM(LT),
+    /** Less than or equal to */
+    TILEDB_QUERY_CONDITION_OP_ENUM(LE),
+    /** Greater than */
+    TILEDB_QUERY_CONDITION_OP_ENUM(GT),
+    /** Greater than or equal to */
+    TILEDB_QUERY_CONDITION_OP_ENUM(GE),
+    /** Equal to */
+    TILEDB_QUERY_CONDITION_OP_ENUM(EQ),
+    /** Not equal to */
+    TILEDB_QUERY_CONDITION_OP_ENUM(NE),
+#endif
+
 #ifdef TILEDB_WALK_ORDER_ENUM
     /** Pre-order traversal */
     TILEDB_WALK_ORDER_ENUM(PREORDER),
@@ -147,6 +168,17 @@
 #endif
 
 /** TileDB VFS mode */
+#ifdef TILEDB_FILTER_TYPE_ENUM
+    /** Byte shuffling: groups together the i-th bytes of all values */
+    TILEDB_FILTER_TYPE_ENUM(FILTER_BYTESHUFFLE),
+    /** Bit shuffling: groups together the i-th bits of all values */
+    TILEDB_FILTER_TYPE_ENUM(FILTER_BITSHUFFLE),
+    /** Delta encoding: stores the differences of consecutive values */
+    TILEDB_FILTER_TYPE_ENUM(FILTER_DELTA),
+    /** Double-delta encoding: applies delta encoding twice */
+    TILEDB_FILTER_TYPE_ENUM(FILTER_DOUBLE_DELTA),
+#endif
+
 #ifdef TILEDB_VFS_MODE_ENUM
     /** Read mode */
     TILEDB_VFS_MODE_ENUM(VFS_READ),
@@ -34,6 +34,7 @@
 #define TILEDB_LRU_CACHE_H
 
 #include "buffer.h"
+#include "stats.h"
 #include "status.h"
 
 #include <list>
@@ -75,11 +76,13 @@ class LRUCache {
    *     object. It takes as input the cache object to be evicted, and
    *     `evict_callback_data`.
    * @param evict_callback_data The data input to `evict_callback`.
+   * @param stats If not `nullptr`, the evictions are counted in these stats.
    */
   LRUCache(
       uint64_t max_size,
       void* (*evict_callback)(LRUCacheItem*, void*) = nullptr,
-      void* evict_callback_data = nullptr);
+      void* evict_callback_data = nullptr,
+      Stats* stats = nullptr);
 
   /** Destructor. */
   ~LRUCache();
@@ -187,6 +190,9 @@ class LRUCache {
   /** The current cache size. */
   uint64_t size_;
 
+  /** The stats the evictions are counted in, or `nullptr`. */
+  Stats* stats_;
+
   /* ********************************* */
   /*          PRIVATE METHODS          */
   /* ********************************* */
@@ -0,0 +1,150 @@
+/**
+ * @file   bitpack_compressor.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines the frame-of-reference bit-packing compressor.
+ */
+
+#ifndef TILEDB_BITPACK_H
+#define TILEDB_BITPACK_H
+
+#include "buffer.h"
+#include "const_buffer.h"
+#include "datatype.h"
+#include "status.h"
+
+namespace tiledb {
+
+/**
+ * Implements a frame-of-reference bit-packing compressor for integer
+ * values. The minimum value of the input is subtracted from every value
+ * and the resulting offsets are packed with the minimum number of bits
+ * that can represent the largest offset.
+ */
+class BitPack {
+ public:
+  /**
+   * Constant overhead (equal to 1 byte for the bit width, 8 bytes for
+   * the number of values and 8 bytes for the minimum value).
+   */
+  static const uint64_t OVERHEAD;
+
+  /* ****************************** */
+  /*               API              */
+  /* ****************************** */
+
+  /**
+   * Compression function. The output buffer will contain the following
+   * after compression:
+   *
+   * bitwidth | n | min | block_0 | block_1 | ... | block_k | tail
+   *
+   * where:
+   *  - *bitwidth* (uint8_t) is the number of bits of every packed offset.
+   *  - *n* (uint64_t) is the number of values in the input buffer.
+   *  - *min* (uint64_t) holds the bits of the minimum input value.
+   *  - *block_i* packs the offsets of 4 * W consecutive values, where W is
+   *    the number of bits in a 32-bit (for values of up to 4 bytes) or
+   *    64-bit (for 8-byte values) word. The offsets are distributed to
+   *    4 lanes in a round-robin fashion, and every lane packs its W
+   *    offsets into *bitwidth* words. The words of the 4 lanes are
+   *    interleaved, so that a block can be packed and unpacked with
+   *    SIMD instructions operating on 4 lanes at a time.
+   *  - *tail* contains the values that do not fill a whole block,
+   *    stored unpacked.
+   *
+   * @param type The type of the input values.
+   * @param input_buffer Input buffer to read from.
+   * @param output_buffer Output buffer to write to the compressed data.
+   * @return Status
+   */
+  static Status compress(
+      Datatype type, ConstBuffer* input_buffer, Buffer* output_buffer);
+
+  /**
+   * Decompression function.
+   *
+   * @param type The type of the original decompressed values.
+   * @param input_buffer Input buffer to read from.
+   * @param output_buffer Output buffer to write the decompressed data to.
+   * @return Status
+   */
+  static Status decompress(
+      Datatype type, ConstBuffer* input_buffer, Buffer* output_buffer);
+
+  /** Returns the compression overhead for the given input. */
+  static uint64_t overhead(uint64_t nbytes);
+
+ private:
+  /* ****************************** */
+  /*         PRIVATE METHODS        */
+  /* ****************************** */
+
+  /**
+   * Templated version of *compress* on the type of the values and on
+   * the type of the words the offsets are packed into.
+   */
+  template <class T, class W>
+  static Status compress(ConstBuffer* input_buffer, Buffer* output_buffer);
+
+  /**
+   * Templated version of *decompress* on the type of the values and on
+   * the type of the words the offsets are packed into.
+   */
+  template <class T, class W>
+  static Status decompress(ConstBuffer* input_buffer, Buffer* output_buffer);
+
+  /**
+   * Packs a block of 4 * W offsets.
+   *
+   * @tparam W The word type.
+   * @param in The offsets, of which every value uses at most *bitwidth*
+   *     bits.
+   * @param bitwidth The number of bits of every packed offset, in
+   *     [1, W].
+   * @param out The output block of 4 * *bitwidth* words.
+   */
+  template <class W>
+  static void pack_block(const W* in, unsigned int bitwidth, char* out);
+
+  /**
+   * Unpacks a block of 4 * W offsets.
+   *
+   * @tparam W The word type.
+   * @param in The input block of 4 * *bitwidth* words.
+   * @param bitwidth The number of bits of every packed offset, in
+   *     [1, W].
+   * @param out The unpacked offsets.
+   */
+  template <class W>
+  static void unpack_block(const char* in, unsigned int bitwidth, W* out);
+};
+
+}  // namespace tiledb
+
+#endif  // TILEDB_BITPACK_H
@@ -0,0 +1,89 @@
+/**
+ * @file   dict_encoder.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines the dictionary encoder of variable-sized cells.
+ */
+
+#ifndef TILEDB_DICT_ENCODER_H
+#define TILEDB_DICT_ENCODER_H
+
+#include "buffer.h"
+#include "const_buffer.h"
+#include "status.h"
+
+namespace tiledb {
+
+/**
+ * Handles the dictionary encoding/decoding of the values of a tile with
+ * variable-sized cells. Every distinct cell value is stored once, and
+ * every cell is replaced by a fixed-width code into this dictionary.
+ */
+class DictEncoder {
+ public:
+  /**
+   * Encoding function. The output buffer will contain either
+   *
+   * 0 | values
+   *
+   * if dictionary encoding does not make the input smaller, or
+   *
+   * 1 | cell_num | dict_num | code_size | dict_values_size |
+   * dict_offset_0 | ... | dict_offset_{dict_num-1} | dict_values |
+   * code_0 | ... | code_{cell_num-1}
+   *
+   * where the first byte is the encoding flag, *cell_num*, *dict_num*,
+   * *dict_values_size* and the dictionary offsets are uint64_t values,
+   * *code_size* is a byte equal to 1, 2 or 4, and the codes are
+   * *code_size*-byte unsigned integers.
+   *
+   * @param offsets_buffer The starting offsets of the cells (uint64_t),
+   *     relative to the offset of the first cell.
+   * @param values_buffer The cell values.
+   * @param output_buffer Output buffer to write the encoded data to.
+   * @return Status
+   */
+  static Status encode(
+      ConstBuffer* offsets_buffer,
+      ConstBuffer* values_buffer,
+      Buffer* output_buffer);
+
+  /**
+   * Decoding function. The decoded cell values are appended to the
+   * output buffer.
+   *
+   * @param input_buffer Input buffer to read the encoded data from.
+   * @param output_buffer Output buffer to write the decoded values to.
+   * @return Status
+   */
+  static Status decode(ConstBuffer* input_buffer, Buffer* output_buffer);
+};
+
+}  // namespace tiledb
+
+#endif  // TILEDB_DICT_ENCODER_H
@@ -0,0 +1,117 @@
+/**
+ * @file   gorilla_compressor.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines the XOR (Gorilla) compressor for real values.
+ */
+
+#ifndef TILEDB_GORILLA_H
+#define TILEDB_GORILLA_H
+
+#include "buffer.h"
+#include "const_buffer.h"
+#include "datatype.h"
+#include "status.h"
+
+namespace tiledb {
+
+/**
+ * Implements the XOR compressor for real values of the Gorilla time
+ * series database, which targets slowly changing values such as sensor
+ * readings.
+ */
+class Gorilla {
+ public:
+  /** Constant overhead (8 bytes for the number of values). */
+  static const uint64_t OVERHEAD;
+
+  /* ****************************** */
+  /*               API              */
+  /* ****************************** */
+
+  /**
+   * Compression function. Every value is XORed with the previous one,
+   * and the result is written to a stream of bits as follows:
+   *
+   *  - `0` if the XOR is zero, i.e., the value is repeated.
+   *  - `10` followed by the meaningful bits of the XOR, if these fall
+   *    within the window of meaningful bits of the last XOR that was
+   *    written with `11`.
+   *  - `11` followed by the number of leading zeros of the XOR, the
+   *    number of its meaningful bits minus one (both taking 5 bits for
+   *    float32 and 6 bits for float64), and its meaningful bits.
+   *
+   * The output buffer contains the number of values (uint64_t) followed
+   * by the bit stream, which starts with the first value unmodified and
+   * is written in whole 64-bit words.
+   *
+   * @param type The type of the input values.
+   * @param input_buffer Input buffer to read from.
+   * @param output_buffer Output buffer to write to the compressed data.
+   * @return Status
+   */
+  static Status compress(
+      Datatype type, ConstBuffer* input_buffer, Buffer* output_buffer);
+
+  /**
+   * Decompression function.
+   *
+   * @param type The type of the original decompressed values.
+   * @param input_buffer Input buffer to read from.
+   * @param output_buffer Output buffer to write the decompressed data to.
+   * @return Status
+   */
+  static Status decompress(
+      Datatype type, ConstBuffer* input_buffer, Buffer* output_buffer);
+
+  /** Returns the compression overhead for the given input. */
+  static uint64_t overhead(uint64_t nbytes);
+
+ private:
+  /* ****************************** */
+  /*         PRIVATE METHODS        */
+  /* ****************************** */
+
+  /**
+   * Templated version of *compress* on the unsigned integer type with
+   * the size of the real values.
+   */
+  template <class U>
+  static Status compress(ConstBuffer* input_buffer, Buffer* output_buffer);
+
+  /**
+   * Templated version of *decompress* on the unsigned integer type with
+   * the size of the real values.
+   */
+  template <class U>
+  static Status decompress(ConstBuffer* input_buffer, Buffer* output_buffer);
+};
+
+}  // namespace tiledb
+
+#endif  // TILEDB_GORILLA_H
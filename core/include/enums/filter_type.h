@@ -0,0 +1,66 @@
+/**
+ * @file filter_type.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This defines the tiledb FilterType enum that maps to the
+ * `tiledb_filter_type_t` C-api enum.
+ */
+
+#ifndef TILEDB_FILTER_TYPE_H
+#define TILEDB_FILTER_TYPE_H
+
+#include "constants.h"
+
+namespace tiledb {
+
+/** Defines the filter type. */
+enum class FilterType : char {
+#define TILEDB_FILTER_TYPE_ENUM(id) id
+#include "tiledb_enum.h"
+#undef TILEDB_FILTER_TYPE_ENUM
+};
+
+/** Returns the string representation of the input filter type. */
+inline const char* filter_type_str(FilterType type) {
+  switch (type) {
+    case FilterType::FILTER_BYTESHUFFLE:
+      return constants::filter_byteshuffle_str;
+    case FilterType::FILTER_BITSHUFFLE:
+      return constants::filter_bitshuffle_str;
+    case FilterType::FILTER_DELTA:
+      return constants::filter_delta_str;
+    case FilterType::FILTER_DOUBLE_DELTA:
+      return constants::filter_double_delta_str;
+    default:
+      return "";
+  }
+}
+
+}  // namespace tiledb
+
+#endif  // TILEDB_FILTER_TYPE_H
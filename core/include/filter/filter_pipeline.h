@@ -0,0 +1,237 @@
+/**
+ * @file   filter_pipeline.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class FilterPipeline.
+ */
+
+#ifndef TILEDB_FILTER_PIPELINE_H
+#define TILEDB_FILTER_PIPELINE_H
+
+#include "buffer.h"
+#include "compressor.h"
+#include "const_buffer.h"
+#include "datatype.h"
+#include "filter_type.h"
+#include "status.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace tiledb {
+
+/**
+ * An ordered list of filters that transform the data of an attribute tile
+ * prior to compression, so that the compressor performs better (e.g.,
+ * byte shuffling groups together the similar high-order bytes of
+ * floating point values). The pipeline runs on each tile chunk separately.
+ * All filters are lossless and size-preserving, and work on the values of
+ * the tile datatype; any trailing bytes that do not form a whole value
+ * (or a whole group of 8 values for bit shuffling) are left intact.
+ */
+class FilterPipeline {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** Constructor. */
+  FilterPipeline() = default;
+
+  /** Destructor. */
+  ~FilterPipeline() = default;
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /** Appends a filter to the pipeline. */
+  void add_filter(FilterType type);
+
+  /** Removes all the filters. */
+  void clear();
+
+  /**
+   * Populates the object members from the data in the input binary buffer.
+   *
+   * @param buff The buffer to deserialize from.
+   * @return Status
+   */
+  Status deserialize(ConstBuffer* buff);
+
+  /** Dumps the pipeline in ASCII form in the selected output. */
+  void dump(FILE* out) const;
+
+  /** Returns `true` if the pipeline has no filters. */
+  bool empty() const;
+
+  /** Returns the filter at the input index. */
+  FilterType filter(unsigned int index) const;
+
+  /** Returns the number of filters. */
+  unsigned int filter_num() const;
+
+  /**
+   * Applies the filters in order on the input data, in place.
+   *
+   * @param type The type of the values in `data`.
+   * @param data The data to be filtered.
+   * @param nbytes The size of `data`.
+   * @param scratch A buffer used as temporary space, reallocated if needed.
+   * @return Status
+   */
+  Status run_forward(
+      Datatype type, void* data, uint64_t nbytes, Buffer* scratch) const;
+
+  /**
+   * Reverts the filters in reverse order on the input data, in place,
+   * restoring the data given to `run_forward`.
+   *
+   * @param type The type of the values in `data`.
+   * @param data The data to be unfiltered.
+   * @param nbytes The size of `data`.
+   * @param scratch A buffer used as temporary space, reallocated if needed.
+   * @return Status
+   */
+  Status run_reverse(
+      Datatype type, void* data, uint64_t nbytes, Buffer* scratch) const;
+
+  /**
+   * Serializes the object members into a binary buffer.
+   *
+   * @param buff The buffer to serialize the data into.
+   * @return Status
+   */
+  Status serialize(Buffer* buff) const;
+
+  /**
+   * Returns the filters that run on the offsets tiles of the variable-sized
+   * attributes prior to the input compressor, or `nullptr` if there are
+   * none. The offsets are monotonic, so they are delta-encoded into the
+   * (small) cell sizes. For byte-oriented compressors, the deltas are also
+   * byte-shuffled, so that their zero high-order bytes form long runs,
+   * which amounts to bit-packing them ahead of the compressor. Nothing runs
+   * without compression, as the filters do not shrink the data on their
+   * own, nor before double delta, which already encodes the differences.
+   *
+   * @param compressor The compressor of the offsets tiles.
+   * @return The filters, which are never destroyed.
+   */
+  static const FilterPipeline* var_offsets_filters(Compressor compressor);
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The filters, in the order they are applied upon writes. */
+  std::vector<FilterType> filters_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /**
+   * Transposes the bits of every group of 8 values, such that the i-th
+   * bits of the values of the data are stored contiguously.
+   *
+   * @param data The data, holding `value_num` values.
+   * @param value_num The number of values, which must be a multiple of 8.
+   * @param value_size The size of each value.
+   * @param out The output, of the same size as `data`.
+   */
+  static void bitshuffle(
+      const char* data, uint64_t value_num, uint64_t value_size, char* out);
+
+  /** Reverts `bitshuffle`. */
+  static void bitunshuffle(
+      const char* data, uint64_t value_num, uint64_t value_size, char* out);
+
+  /**
+   * Transposes the bytes of the values, such that the i-th bytes of the
+   * values of the data are stored contiguously.
+   *
+   * @param data The data, holding `value_num` values.
+   * @param value_num The number of values.
+   * @param value_size The size of each value.
+   * @param out The output, of the same size as `data`.
+   */
+  static void byteshuffle(
+      const char* data, uint64_t value_num, uint64_t value_size, char* out);
+
+  /** Reverts `byteshuffle`. */
+  static void byteunshuffle(
+      const char* data, uint64_t value_num, uint64_t value_size, char* out);
+
+  /**
+   * Replaces every value with its difference from the previous one, in
+   * place. The values are treated as unsigned integers of `T`, so that
+   * the differences wrap around and any type (including floating point)
+   * is encoded losslessly.
+   *
+   * @tparam T An unsigned integer type of the value size.
+   * @param data The data.
+   * @param value_num The number of values in `data`.
+   */
+  template <class T>
+  static void delta_encode(char* data, uint64_t value_num);
+
+  /** Reverts `delta_encode`. */
+  template <class T>
+  static void delta_decode(char* data, uint64_t value_num);
+
+  /**
+   * Applies a single filter in place.
+   *
+   * @param filter The filter.
+   * @param reverse If `true`, the filter is reverted instead of applied.
+   * @param value_size The size of each value.
+   * @param data The data.
+   * @param nbytes The size of `data`.
+   * @param scratch A buffer used as temporary space.
+   * @return Status
+   */
+  static Status run_filter(
+      FilterType filter,
+      bool reverse,
+      uint64_t value_size,
+      char* data,
+      uint64_t nbytes,
+      Buffer* scratch);
+
+  /**
+   * Delta encodes or decodes the values in place, dispatching on the value
+   * size.
+   */
+  static Status run_delta(
+      bool reverse, uint64_t value_size, char* data, uint64_t value_num);
+};
+
+}  // namespace tiledb
+
+#endif  // TILEDB_FILTER_PIPELINE_H
@@ -72,6 +72,15 @@ class Fragment {
   /** Returns a variable-sized attribute with the input id. */
   URI attr_var_uri(unsigned int attribute_id) const;
 
+  /**
+   * Appends the tiles of the input sparse fragment verbatim to the write
+   * state (see WriteState::copy_tiles).
+   *
+   * @param metadata The metadata of the fragment to copy.
+   * @return Status
+   */
+  Status copy_tiles(const FragmentMetadata* metadata);
+
   /** Returns the URI of the coordinates file in this fragment. */
   URI coords_uri() const;
 
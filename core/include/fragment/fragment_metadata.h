@@ -35,11 +35,14 @@
 #define TILEDB_FRAGMENT_METADATA_H
 
 #include "array_schema.h"
+#include "bloom_filter.h"
 #include "buffer.h"
 #include "query_type.h"
 #include "status.h"
+#include "tile_stats.h"
 
 #include <zlib.h>
+#include <utility>
 #include <vector>
 
 namespace tiledb {
@@ -107,6 +110,26 @@ class FragmentMetadata {
    */
   void append_tile_offset(unsigned int attribute_id, uint64_t step);
 
+  /**
+   * Appends the value statistics of the next tile of the input fixed-sized
+   * attribute. The statistics of an attribute are stored only if they are
+   * appended for every one of its tiles.
+   *
+   * @param attribute_id The attribute id.
+   * @param stats The statistics to be appended.
+   * @return void
+   */
+  void append_tile_stats(unsigned int attribute_id, const TileStats& stats);
+
+  /**
+   * Appends the number of cells of the next tile (applicable only to sparse
+   * fragments).
+   *
+   * @param cell_num The number of cells to be appended.
+   * @return void
+   */
+  void append_tile_cell_num(uint64_t cell_num);
+
   /**
    * Appends a variable tile offset for the input attribute.
    *
@@ -127,6 +150,13 @@ class FragmentMetadata {
    */
   void append_tile_var_size(unsigned int attribute_id, uint64_t size);
 
+  /**
+   * Returns the bloom filter over the fragment coordinates, or `nullptr`
+   * if the fragment has none. Only key-value store fragments may have a
+   * bloom filter.
+   */
+  const BloomFilter* bloom_filter() const;
+
   /** Returns the bounding coordinates. */
   const std::vector<void*>& bounding_coords() const;
 
@@ -207,6 +237,33 @@ class FragmentMetadata {
       unsigned buffer_num,
       uint64_t* buffer_sizes) const;
 
+  /**
+   * Computes an estimate of the buffer sizes needed when reading a subarray
+   * from the fragment, for a given set of attributes. Each overlapping tile
+   * contributes in proportion to the fraction of its domain (for dense
+   * fragments) or its MBR (for sparse fragments) covered by the subarray,
+   * assuming that the cells and the variable-sized values are uniformly
+   * distributed within the tile. No tile data are read.
+   *
+   * @tparam T The coordinates type.
+   * @param subarray The targeted subarray.
+   * @param attributes The targeted attributes.
+   * @param attribute_num The attribute number.
+   * @param buffer_num The number of buffer sizes.
+   * @param buffer_sizes The buffer sizes to be computed. Note that there is
+   *     a single buffer size per fixed-sized attribute, and two for every
+   *     variable-sized attribute (the first is for the offsets, whereas the
+   *     second is for the actual variable-sized attribute values).
+   * @return Status
+   */
+  template <class T>
+  Status compute_est_read_buffer_sizes(
+      const T* subarray,
+      const char** attributes,
+      unsigned attribute_num,
+      unsigned buffer_num,
+      uint64_t* buffer_sizes) const;
+
   /**
    * Returns ture if the corresponding fragment is dense, and false if it
    * is sparse.
@@ -230,6 +287,9 @@ class FragmentMetadata {
   /** Returns the size of the variable attribute with the input id. */
   uint64_t file_var_sizes(unsigned int attribute_id) const;
 
+  /** Returns the total size of the fragment attribute files. */
+  uint64_t fragment_size() const;
+
   /** Returns the fragment URI. */
   const URI& fragment_uri() const;
 
@@ -259,6 +319,15 @@ class FragmentMetadata {
    */
   Status serialize(Buffer* buff);
 
+  /**
+   * Sets the bloom filter over the fragment coordinates. The fragment
+   * metadata take ownership of the filter.
+   *
+   * @param bloom_filter The bloom filter.
+   * @return void
+   */
+  void set_bloom_filter(BloomFilter* bloom_filter);
+
   /**
    * Simply sets the number of cells for the last tile.
    *
@@ -273,12 +342,27 @@ class FragmentMetadata {
   /** Returns the tile offsets. */
   const std::vector<std::vector<uint64_t>>& tile_offsets() const;
 
+  /**
+   * Returns the value statistics of the tile at the input position for the
+   * input attribute, or `nullptr` if the fragment does not store the
+   * statistics of the attribute (e.g., because it is variable-sized).
+   */
+  const TileStats* tile_stats(
+      unsigned int attribute_id, uint64_t tile_pos) const;
+
   /** Returns the variable tile offsets. */
   const std::vector<std::vector<uint64_t>>& tile_var_offsets() const;
 
   /** Returns the variable tile sizes. */
   const std::vector<std::vector<uint64_t>>& tile_var_sizes() const;
 
+  /**
+   * Returns `true` if the offsets tiles of the variable-sized attributes
+   * were filtered prior to compression, which depends on the version that
+   * created the fragment.
+   */
+  bool var_offsets_filtered() const;
+
  private:
   /* ********************************* */
   /*         PRIVATE ATTRIBUTES        */
@@ -287,6 +371,9 @@ class FragmentMetadata {
   /** The array schema */
   const ArraySchema* array_schema_;
 
+  /** The bloom filter over the fragment coordinates (may be `nullptr`). */
+  BloomFilter* bloom_filter_;
+
   /** A vector storing the first and last coordinates of each tile. */
   std::vector<void*> bounding_coords_;
 
@@ -337,6 +424,19 @@ class FragmentMetadata {
    */
   std::vector<std::vector<uint64_t>> tile_offsets_;
 
+  /**
+   * The number of cells of each tile (meaningful only in the sparse case).
+   * It is empty if all the tiles but the last one are full, which is always
+   * the case unless tiles were copied from other fragments.
+   */
+  std::vector<uint64_t> tile_cell_nums_;
+
+  /**
+   * The value statistics of each tile of each fixed-sized attribute. The
+   * vector of an attribute is empty if its statistics are not stored.
+   */
+  std::vector<std::vector<TileStats>> tile_stats_;
+
   /**
    * The variable tile offsets in their corresponding attribute files.
    * Meaningful only for variable-sized tiles.
@@ -360,6 +460,14 @@ class FragmentMetadata {
   template <class T>
   std::vector<uint64_t> compute_overlapping_tile_ids(const T* subarray) const;
 
+  /**
+   * Returns the ids (positions) of the tiles overlapping `subarray`, along
+   * with the fraction of each tile that is covered by `subarray`.
+   */
+  template <class T>
+  std::vector<std::pair<uint64_t, double>> compute_overlapping_tile_ids_cov(
+      const T* subarray) const;
+
   /**
    * Retrieves the tile domain for the input `subarray` based on the expanded
    * `domain_`.
@@ -382,6 +490,16 @@ class FragmentMetadata {
   template <class T>
   Status expand_non_empty_domain(const T* mbr);
 
+  /**
+   * Loads the bloom filter from the fragment metadata buffer, if there is
+   * one. Metadata written before the introduction of bloom filters end
+   * right before the filter, in which case no filter is loaded.
+   *
+   * @param buff Metadata buffer.
+   * @return Status
+   */
+  Status load_bloom_filter(ConstBuffer* buff);
+
   /**
    * Loads the bounding coordinates from the fragment metadata buffer.
    *
@@ -420,6 +538,14 @@ class FragmentMetadata {
    */
   Status load_non_empty_domain(ConstBuffer* buff);
 
+  /**
+   * Loads the tile cell numbers from the fragment metadata buffer.
+   *
+   * @param buff Metadata buffer.
+   * @return Status
+   */
+  Status load_tile_cell_nums(ConstBuffer* buff);
+
   /**
    * Loads the tile offsets from the fragment metadata buffer.
    *
@@ -428,6 +554,14 @@ class FragmentMetadata {
    */
   Status load_tile_offsets(ConstBuffer* buff);
 
+  /**
+   * Loads the tile value statistics from the fragment metadata buffer.
+   *
+   * @param buff Metadata buffer.
+   * @return Status
+   */
+  Status load_tile_stats(ConstBuffer* buff);
+
   /**
    * Loads the variable tile offsets from the fragment metadata buffer.
    *
@@ -447,6 +581,14 @@ class FragmentMetadata {
   /** Loads the library version from the buffer. */
   Status load_version(ConstBuffer* buff);
 
+  /**
+   * Writes the bloom filter to the fragment metadata buffer.
+   *
+   * @param buff Metadata buffer.
+   * @return Status
+   */
+  Status write_bloom_filter(Buffer* buff);
+
   /**
    * Writes the bounding coordinates to the fragment metadata buffer.
    *
@@ -485,6 +627,15 @@ class FragmentMetadata {
    */
   Status write_non_empty_domain(Buffer* buff);
 
+  /**
+   * Writes the tile cell numbers to the fragment metadata buffer, if not
+   * all the tiles but the last one are full.
+   *
+   * @param buff Metadata buffer.
+   * @return Status
+   */
+  Status write_tile_cell_nums(Buffer* buff);
+
   /**
    * Writes the tile offsets to the fragment metadata buffer.
    *
@@ -493,6 +644,14 @@ class FragmentMetadata {
    */
   Status write_tile_offsets(Buffer* buff);
 
+  /**
+   * Writes the tile value statistics to the fragment metadata buffer.
+   *
+   * @param buff Metadata buffer.
+   * @return Status
+   */
+  Status write_tile_stats(Buffer* buff);
+
   /**
    * Writes the variable tile offsets to the fragment metadata buffer.
    *
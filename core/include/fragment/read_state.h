@@ -38,6 +38,7 @@
 
 #include "fragment.h"
 #include "fragment_metadata.h"
+#include "query_condition.h"
 #include "tile.h"
 #include "tile_io.h"
 
@@ -92,6 +93,24 @@ class ReadState {
   /*                API                */
   /* ********************************* */
 
+  /**
+   * Finds the runs of cells of a range that satisfy the input condition.
+   * The statistics of the tile are consulted first, so that the tile is
+   * read only if they cannot decide the condition for all of its cells.
+   *
+   * @param condition The condition to evaluate.
+   * @param tile_i The tile the range belongs to.
+   * @param cell_pos_range The cell position range to evaluate.
+   * @param result The runs of satisfying cells are appended here, in
+   *     increasing order of cell position.
+   * @return Status
+   */
+  Status apply_condition(
+      const QueryCondition& condition,
+      uint64_t tile_i,
+      const CellPosRange& cell_pos_range,
+      std::vector<CellPosRange>* result);
+
   /**
    * Copies the cells of the input attribute into the input buffers, as
    * determined by the input cell position range.
@@ -320,9 +339,25 @@ class ReadState {
   /** The number of array attributes. */
   unsigned int attribute_num_;
 
+  /** The tile of each attribute held in `condition_tiles_`. */
+  std::vector<uint64_t> condition_fetched_tile_;
+
+  /**
+   * Tile buffers for evaluating query conditions, one per attribute and
+   * created on first use. They are kept apart from `tiles_`, whose
+   * offsets track the progress of copying cells into the user buffers.
+   */
+  std::vector<Tile*> condition_tiles_;
+
   /** The size of the array coordinates. */
   uint64_t coords_size_;
 
+  /**
+   * The tile of each attribute last read straight into the user buffer,
+   * which is thus fully written.
+   */
+  std::vector<uint64_t> direct_read_tile_;
+
   /** Indicates if the read operation on this fragment finished. */
   bool done_;
 
@@ -623,6 +658,29 @@ class ReadState {
    */
   Status read_tile(unsigned int attribute_id, uint64_t tile_i);
 
+  /**
+   * Reads an entire tile into the input tile object.
+   *
+   * @param attribute_id The attribute id.
+   * @param tile_i The tile index.
+   * @param tile The tile to read into.
+   * @return Status
+   */
+  Status read_tile(unsigned int attribute_id, uint64_t tile_i, Tile* tile);
+
+  /**
+   * Reads an entire tile of a fixed-sized attribute straight into the input
+   * memory (decompressing it there, if needed), bypassing the attribute
+   * tile.
+   *
+   * @param attribute_id The attribute id.
+   * @param tile_i The tile index.
+   * @param buffer The memory to read into, which must fit the tile.
+   * @return Status
+   */
+  Status read_tile_into(
+      unsigned int attribute_id, uint64_t tile_i, void* buffer);
+
   /**
    * Prepares a variable-sized tile from the disk for reading for an attribute.
    *
@@ -80,6 +80,18 @@ class WriteState {
    */
   Status close_files();
 
+  /**
+   * Appends the tiles of the input sparse fragment to the fragment, copying
+   * the attribute files verbatim (i.e., without decompressing and
+   * recompressing the tiles). The cells of the input fragment must succeed
+   * all the cells written so far in the global cell order. The tile
+   * currently being populated is written first, even if it is not full.
+   *
+   * @param metadata The metadata of the fragment to copy.
+   * @return Status
+   */
+  Status copy_tiles(const FragmentMetadata* metadata);
+
   /**
    * Performs a write operation in the fragment.
    *
@@ -124,6 +136,13 @@ class WriteState {
   /** The number of cells written in the current tile for each attribute. */
   std::vector<uint64_t> tile_cell_num_;
 
+  /**
+   * Scratch tiles holding the dictionary-encoded values of the current
+   * variable-sized tiles, one per attribute (`nullptr` if the attribute is
+   * not dictionary-encoded).
+   */
+  std::vector<Tile*> tiles_dict_;
+
   /** The current tiles, one per attribute. */
   std::vector<Tile*> tiles_;
 
@@ -145,6 +164,40 @@ class WriteState {
   /*           PRIVATE METHODS         */
   /* ********************************* */
 
+  /**
+   * Computes the value statistics of the input tile of a fixed-sized
+   * attribute and passes them to the fragment metadata. Nothing happens for
+   * the coordinates.
+   *
+   * @param attribute_id The attribute id.
+   * @param tile The tile, before it is written.
+   * @return Status
+   */
+  Status append_tile_stats(unsigned int attribute_id, const Tile* tile);
+
+  /** Returns the configured number of bloom filter bits per key. */
+  uint64_t bloom_filter_bits_per_key() const;
+
+  /**
+   * Builds a bloom filter over the coordinates of a key-value store
+   * fragment and passes it to the fragment metadata.
+   *
+   * @param coords The coordinates (keys) written in the fragment.
+   * @param coords_size The size of *coords* in bytes.
+   * @return void
+   */
+  void build_bloom_filter(const void* coords, uint64_t coords_size);
+
+  /**
+   * Appends the first *size* bytes of a file to another file.
+   *
+   * @param src_uri The URI of the file to copy from.
+   * @param dst_uri The URI of the file to append to.
+   * @param size The number of bytes to copy.
+   * @return Status
+   */
+  Status copy_file(const URI& src_uri, const URI& dst_uri, uint64_t size) const;
+
   /**
    * Expands the current MBR with the input coordinates.
    *
@@ -261,6 +314,14 @@ class WriteState {
    */
   Status write_attr_var_last(unsigned int attribute_id);
 
+  /**
+   * Writes the tile currently being populated for every attribute, even if
+   * it is not full, and starts new tiles.
+   *
+   * @return Status
+   */
+  Status write_current_tile();
+
   /**
    * Takes the appropriate actions for writing the very last tile of this write
    * operation. This is done for every attribute.
@@ -314,6 +375,17 @@ class WriteState {
       void* buffer_var,
       uint64_t buffer_var_size,
       const std::vector<uint64_t>& cell_pos);
+
+  /**
+   * Writes the current variable-sized tile of an attribute to the disk,
+   * dictionary-encoding its values first if the attribute requires so.
+   * It must be invoked before the corresponding offsets tile is written.
+   *
+   * @param attribute_id The id of the attribute this operation focuses on.
+   * @param bytes_written The number of bytes written to the disk.
+   * @return Status
+   */
+  Status write_tile_var(unsigned int attribute_id, uint64_t* bytes_written);
 };
 
 }  // namespace tiledb
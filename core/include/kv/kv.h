@@ -102,6 +102,28 @@ class KV {
    */
   Status get_item(const KVItem::Hash& hash, KVItem** kv_item);
 
+  /**
+   * Gets a batch of key-value items from the key-value store. This function
+   * first searches in the buffered items. The rest of the keys are sorted
+   * on their hash, grouped by the fragment tiles that may contain them, and
+   * each group is resolved with a single read query. Keys that fall outside
+   * every tile are resolved without any read.
+   *
+   * @param keys The keys to query on.
+   * @param key_types The key types.
+   * @param key_sizes The key sizes.
+   * @param key_num The number of keys.
+   * @param kv_items The key-value item results, in the order of the input
+   *     keys. An item is set to `nullptr` if its key does not exist.
+   * @return Status
+   */
+  Status get_items(
+      const void** keys,
+      const Datatype* key_types,
+      const uint64_t* key_sizes,
+      unsigned key_num,
+      KVItem** kv_items);
+
   /**
    * Initializes the key-value store for reading/writing.
    *
@@ -159,7 +181,10 @@ class KV {
    */
   std::vector<Datatype> read_attribute_types_;
 
-  /** These are the attributes to be passed to a TileDB read query. */
+  /**
+   * These are the attributes to be passed to a TileDB read query. The
+   * coordinates are always the last read attribute.
+   */
   char** read_attributes_;
 
   /** The number of read query attributes. */
@@ -298,6 +323,33 @@ class KV {
   /** Prepares the buffers for writing. */
   Status prepare_write_buffers();
 
+  /**
+   * Groups the input sorted hashes by the fragment tiles that may contain
+   * them. Two consecutive hashes belong to the same group if they fall in
+   * the same tile of every fragment. Hashes that fall outside every tile
+   * are not included in any group.
+   *
+   * @param hashes The hashes to be grouped, sorted in the global cell order,
+   *     each paired with the position of its key in the input batch.
+   * @param groups The groups to be retrieved, each represented as a range
+   *     `[start, end)` of positions in `hashes`.
+   * @return Status
+   */
+  Status group_hashes(
+      const std::vector<std::pair<KVItem::Hash, unsigned>>& hashes,
+      std::vector<std::pair<size_t, size_t>>* groups);
+
+  /**
+   * Populates a key-value item with the values of a cell stored in the
+   * local read buffers.
+   *
+   * @param pos The position of the cell in the read buffers.
+   * @param hash The hash of the key of the item.
+   * @param kv_item The key-value item to be populated.
+   * @return Status
+   */
+  Status populate_item(uint64_t pos, const KVItem::Hash& hash, KVItem* kv_item);
+
   /** Populates the write buffers with the buffered key-value items. */
   Status populate_write_buffers();
 
@@ -311,11 +363,33 @@ class KV {
    */
   Status read_item(const KVItem::Hash& hash, bool* found);
 
+  /**
+   * Reads a group of key-value items from persistent storage with a single
+   * read query, whose subarray is the bounding box of the group hashes.
+   *
+   * @param hashes The sorted hashes, each paired with the position of its
+   *     key in the input batch.
+   * @param start The first position of the group in `hashes`.
+   * @param end The position after the last one of the group in `hashes`.
+   * @param kv_items The key-value items, in the order of the input batch.
+   *     Only the items of the keys found in the group are set.
+   * @return Status
+   */
+  Status read_items(
+      const std::vector<std::pair<KVItem::Hash, unsigned>>& hashes,
+      size_t start,
+      size_t end,
+      KVItem** kv_items);
+
   /**
    * Reallocate memory for read buffers that results in an incomplete
    * read query.
+   *
+   * @param all If `true`, all read buffers are reallocated. Otherwise, only
+   *     the buffers whose size was set to zero by the query.
+   * @return Status
    */
-  Status realloc_read_buffers();
+  Status realloc_read_buffers(bool all = false);
 
   /** Submits a read query, retrieving the query status. */
   Status submit_read_query(const uint64_t* subarray, QueryStatus* status);
@@ -0,0 +1,136 @@
+/**
+ * @file   bloom_filter.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class BloomFilter.
+ */
+
+
+#ifndef TILEDB_BLOOM_FILTER_H
+#define TILEDB_BLOOM_FILTER_H
+
+#include "buffer.h"
+#include "const_buffer.h"
+#include "status.h"
+
+#include <cinttypes>
+#include <vector>
+
+namespace tiledb {
+
+/**
+ * A bloom filter over items that are already uniformly hashed into a pair
+ * of 64-bit values, such as the coordinates of a key-value store. The probe
+ * positions are derived from the two values via double hashing, so no
+ * extra hashing takes place upon insertions and lookups.
+ */
+class BloomFilter {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** Constructor. */
+  BloomFilter();
+
+  /** Destructor. */
+  ~BloomFilter() = default;
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Adds an item to the filter.
+   *
+   * @param h1 The first hash value of the item.
+   * @param h2 The second hash value of the item.
+   * @return void
+   */
+  void add(uint64_t h1, uint64_t h2);
+
+  /** Returns the number of bits of the filter. */
+  uint64_t bit_num() const;
+
+  /**
+   * Deserializes the filter from the input buffer.
+   *
+   * @param buff The buffer to deserialize from.
+   * @return Status
+   */
+  Status deserialize(ConstBuffer* buff);
+
+  /** Returns the number of probes per item. */
+  uint32_t hash_num() const;
+
+  /**
+   * Initializes an empty filter sized for the input number of items.
+   *
+   * @param item_num The expected number of items.
+   * @param bits_per_item The number of bits allotted per item, which
+   *     determines the false positive rate (about 1% for 10 bits).
+   * @return void
+   */
+  void init(uint64_t item_num, uint64_t bits_per_item);
+
+  /**
+   * Checks whether an item may have been added to the filter.
+   *
+   * @param h1 The first hash value of the item.
+   * @param h2 The second hash value of the item.
+   * @return `false` if the item was definitely not added, and `true` if it
+   *     may have been added.
+   */
+  bool may_contain(uint64_t h1, uint64_t h2) const;
+
+  /**
+   * Serializes the filter into the input buffer.
+   *
+   * @param buff The buffer to serialize into.
+   * @return Status
+   */
+  Status serialize(Buffer* buff) const;
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The number of bits of the filter. */
+  uint64_t bit_num_;
+
+  /** The filter bits, packed into 64-bit words. */
+  std::vector<uint64_t> bits_;
+
+  /** The number of probes per item. */
+  uint32_t hash_num_;
+};
+
+}  // namespace tiledb
+
+#endif  // TILEDB_BLOOM_FILTER_H
@@ -117,9 +117,30 @@ extern const uint64_t empty_uint64;
 /** The file suffix used in TileDB. */
 extern const char* file_suffix;
 
+/** The suffix of temporary files, which are moved in place when complete. */
+extern const char* tmp_file_suffix;
+
+/** The consolidated fragment metadata file name. */
+extern const char* consolidated_fragment_metadata_filename;
+
 /** The fragment file name. */
 extern const char* fragment_filename;
 
+/**
+ * The fragment manifest directory name, used on object stores that do not
+ * support appends, where every append is an object of its own.
+ */
+extern const char* fragment_manifest_dirname;
+
+/** The fragment manifest file name. */
+extern const char* fragment_manifest_filename;
+
+/**
+ * The number of attempts to load a fragment manifest stored in parts, whose
+ * parts may be deleted by a concurrent compaction while being loaded.
+ */
+extern const unsigned fragment_manifest_load_attempts;
+
 /** The fragment metadata file name. */
 extern const char* fragment_metadata_filename;
 
@@ -174,6 +195,81 @@ extern const uint64_t fragment_metadata_cache_size;
 /** The tile cache size. */
 extern const uint64_t tile_cache_size;
 
+/** The number of threads in the storage manager thread pool. */
+extern const uint64_t thread_pool_size;
+
+/**
+ * The file the execution trace is dumped into when the context is freed.
+ * Empty means that tracing is disabled.
+ */
+extern const char* trace_file;
+
+/** The number of trace spans buffered per thread. */
+extern const uint64_t trace_buffer_event_num;
+
+/**
+ * The number of local buffer sets used in ordered writes, i.e., the number of
+ * tile slabs that can be in flight at any time.
+ */
+extern const uint64_t ordered_write_buffer_num;
+
+/** The memory budget (in bytes) for the buffers of a query iterator. */
+extern const uint64_t query_iter_memory_budget;
+
+/**
+ * The compressors among which `Compressor::AUTO` picks one for every tile,
+ * as a comma-separated list of compressor names.
+ */
+extern const char* compression_auto_candidates;
+
+/**
+ * The storage read bandwidth (in bytes per second) against which
+ * `Compressor::AUTO` weighs the compressed size of a tile and its
+ * decompression time. Zero picks the compressor with the smallest output.
+ */
+extern const uint64_t compression_auto_bandwidth;
+
+/** The number of bytes of a tile that `Compressor::AUTO` samples. */
+extern const uint64_t compression_auto_sample_size;
+
+/**
+ * The number of bloom filter bits per key built for every key-value store
+ * fragment. Zero disables the bloom filters.
+ */
+extern const uint64_t kv_bloom_filter_bits_per_key;
+
+/**
+ * Whether read queries skip the shared lock of the array and rely only on
+ * the read snapshots registered in the process. Snapshots do not protect
+ * readers in other processes against a concurrent consolidation, so this
+ * is safe only if a single process reads and consolidates the array.
+ */
+extern const bool lock_free_reads;
+
+/**
+ * The maximum ratio between the sizes of the largest and the smallest
+ * fragment merged together by a consolidation. Zero disables the size
+ * check, i.e., fragments of any size are merged together.
+ */
+extern const float consolidation_size_ratio;
+
+/** The minimum number of fragments merged together by a consolidation. */
+extern const uint64_t consolidation_min_fragments;
+
+/**
+ * The maximum number of fragments merged together by a consolidation. Zero
+ * means that there is no limit.
+ */
+extern const uint64_t consolidation_max_fragments;
+
+/**
+ * The total memory budget (in bytes) of the buffers used by a consolidation.
+ * The budget is split evenly across the two batches of buffers that are
+ * used for overlapping reading with writing. Zero means that every buffer
+ * gets `consolidation_buffer_size` bytes.
+ */
+extern const uint64_t consolidation_memory_budget;
+
 /** String describing GZIP. */
 extern const char* gzip_str;
 
@@ -210,6 +306,27 @@ extern const char* bzip2_str;
 /** String describing DOUBLE_DELTA. */
 extern const char* double_delta_str;
 
+/** String describing BITPACK. */
+extern const char* bitpack_str;
+
+/** String describing GORILLA. */
+extern const char* gorilla_str;
+
+/** String describing AUTO. */
+extern const char* auto_str;
+
+/** String describing FILTER_BYTESHUFFLE. */
+extern const char* filter_byteshuffle_str;
+
+/** String describing FILTER_BITSHUFFLE. */
+extern const char* filter_bitshuffle_str;
+
+/** String describing FILTER_DELTA. */
+extern const char* filter_delta_str;
+
+/** String describing FILTER_DOUBLE_DELTA. */
+extern const char* filter_double_delta_str;
+
 /** The string representation for type int32. */
 extern const char* int32_str;
 
@@ -267,6 +384,21 @@ extern const char* null_str;
 /** The version in format { major, minor, revision }. */
 extern const int version[3];
 
+/**
+ * The first version whose fragments filter the offsets tiles of the
+ * variable-sized attributes prior to compression.
+ */
+extern const int var_offsets_filters_version[3];
+
+/** The first version whose array schemas store the attribute filters. */
+extern const int filters_version[3];
+
+/**
+ * The first version whose array schemas store the dictionary encoding flag
+ * of the attributes.
+ */
+extern const int dictionary_encoding_version[3];
+
 /** The size of a tile chunk. */
 extern const uint64_t tile_chunk_size;
 
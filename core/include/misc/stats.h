@@ -0,0 +1,211 @@
+/**
+ * @file   stats.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines classes Stats and ScopedTimer.
+ */
+
+#ifndef TILEDB_STATS_H
+#define TILEDB_STATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace tiledb {
+
+/**
+ * Thread-safe counters and timers collected while processing queries. A
+ * Stats object may have a parent, into which every recorded value is also
+ * propagated (e.g., the stats of a query propagate into those of the
+ * storage manager, which aggregate all the queries of a context).
+ */
+class Stats {
+ public:
+  /* ********************************* */
+  /*          TYPE DEFINITIONS         */
+  /* ********************************* */
+
+  /** The counters. */
+  enum class Counter : unsigned int {
+    /** Number of tiles fetched, either from the cache or from storage. */
+    TILE_READ_NUM,
+    /** Number of tiles found in the tile cache. */
+    TILE_CACHE_HIT_NUM,
+    /** Number of tiles not found in the tile cache. */
+    TILE_CACHE_MISS_NUM,
+    /** Number of bytes served by the tile cache. */
+    TILE_CACHE_HIT_BYTES,
+    /** Number of tiles evicted from the tile cache. */
+    TILE_CACHE_EVICT_NUM,
+    /** Number of reads issued to the storage backend. */
+    VFS_READ_NUM,
+    /** Number of bytes read from the storage backend. */
+    VFS_READ_BYTES,
+    /** Number of bytes produced by tile decompression. */
+    DECOMPRESSED_BYTES,
+    /** Number of bytes copied from tiles into the user buffers. */
+    CELL_COPY_BYTES,
+    /** Number of bytes of tiles read straight into the user buffers. */
+    DIRECT_READ_BYTES,
+    /** Number of tiles that query conditions skipped without reading. */
+    CONDITION_TILE_SKIP_NUM,
+    /** Sentinel holding the number of counters. */
+    COUNTER_NUM
+  };
+
+  /**
+   * The timers, in nanoseconds. Timers are inclusive, e.g., the
+   * fragment merge time includes the coordinate tile reads it triggers.
+   */
+  enum class Timer : unsigned int {
+    /** Time spent in synchronously submitted query reads. */
+    QUERY_READ,
+    /** Time spent reading from the storage backend. */
+    VFS_READ,
+    /** Time spent decompressing tiles. */
+    DECOMPRESS,
+    /** Time spent computing the cell ranges to read across fragments. */
+    FRAGMENT_MERGE,
+    /** Time spent copying cells from tiles into the user buffers. */
+    CELL_COPY,
+    /** Sentinel holding the number of timers. */
+    TIMER_NUM
+  };
+
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** Constructor. */
+  Stats();
+
+  /** Destructor. */
+  ~Stats() = default;
+
+  Stats(const Stats&) = delete;
+  Stats& operator=(const Stats&) = delete;
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Adds a value to a counter.
+   *
+   * @param counter The counter to update.
+   * @param value The value to add.
+   */
+  void add(Counter counter, uint64_t value);
+
+  /**
+   * Adds a duration to a timer.
+   *
+   * @param timer The timer to update.
+   * @param nanos The duration to add, in nanoseconds.
+   */
+  void add_time(Timer timer, uint64_t nanos);
+
+  /** Returns the value of the input counter. */
+  uint64_t counter(Counter counter) const;
+
+  /** Resets all counters and timers to zero. */
+  void reset();
+
+  /** Sets the parent into which all recorded values are propagated. */
+  void set_parent(Stats* parent);
+
+  /** Returns the input timer, in nanoseconds. */
+  uint64_t timer(Timer timer) const;
+
+  /**
+   * Returns the counters and timers as a flat JSON object, with the
+   * timers expressed in nanoseconds.
+   */
+  std::string to_json() const;
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The counter values. */
+  std::atomic<uint64_t> counters_[(unsigned int)Counter::COUNTER_NUM];
+
+  /** The parent stats, or `nullptr` if there is none. */
+  Stats* parent_;
+
+  /** The timer values, in nanoseconds. */
+  std::atomic<uint64_t> timers_[(unsigned int)Timer::TIMER_NUM];
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /** Returns the JSON key of the input counter. */
+  static const char* counter_str(Counter counter);
+
+  /** Returns the JSON key of the input timer. */
+  static const char* timer_str(Timer timer);
+};
+
+/**
+ * Measures the time elapsed from its construction to its destruction and
+ * adds it to a timer of the input stats.
+ */
+class ScopedTimer {
+ public:
+  /**
+   * Constructor.
+   *
+   * @param stats The stats to update. If `nullptr`, nothing is recorded.
+   * @param timer The timer to update.
+   */
+  ScopedTimer(Stats* stats, Stats::Timer timer);
+
+  /** Destructor. Records the elapsed time. */
+  ~ScopedTimer();
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+ private:
+  /** The time of construction. */
+  std::chrono::steady_clock::time_point start_;
+
+  /** The stats to update. */
+  Stats* stats_;
+
+  /** The timer to update. */
+  Stats::Timer timer_;
+};
+
+}  // namespace tiledb
+
+#endif  // TILEDB_STATS_H
@@ -103,10 +103,14 @@ enum class StatusCode : char {
   KV,
   KVItem,
   KVIter,
+  QueryIter,
   Config,
   Utils,
   FS_S3,
-  FS_HDFS
+  FS_HDFS,
+  ThreadPool,
+  Tracer,
+  FilterPipeline
 };
 
 class Status {
@@ -278,6 +282,11 @@ class Status {
     return Status(StatusCode::KVIter, msg, -1);
   }
 
+  /** Return a QueryIterError error class Status with a given message **/
+  static Status QueryIterError(const std::string& msg) {
+    return Status(StatusCode::QueryIter, msg, -1);
+  }
+
   /** Return a ConfigError error class Status with a given message **/
   static Status ConfigError(const std::string& msg) {
     return Status(StatusCode::Config, msg, -1);
@@ -298,6 +307,21 @@ class Status {
     return Status(StatusCode::FS_HDFS, msg, -1);
   }
 
+  /** Return a ThreadPoolError error class Status with a given message **/
+  static Status ThreadPoolError(const std::string& msg) {
+    return Status(StatusCode::ThreadPool, msg, -1);
+  }
+
+  /** Return a TracerError error class Status with a given message **/
+  static Status TracerError(const std::string& msg) {
+    return Status(StatusCode::Tracer, msg, -1);
+  }
+
+  /** Return a FilterPipelineError error class Status with a given message **/
+  static Status FilterPipelineError(const std::string& msg) {
+    return Status(StatusCode::FilterPipeline, msg, -1);
+  }
+
   /** Returns true iff the status indicates success **/
   bool ok() const {
     return (state_ == nullptr);
@@ -0,0 +1,131 @@
+/**
+ * @file   thread_pool.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class ThreadPool.
+ */
+
+#ifndef TILEDB_THREAD_POOL_H
+#define TILEDB_THREAD_POOL_H
+
+#include "status.h"
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace tiledb {
+
+/**
+ * A fixed-size pool of worker threads executing tasks in FIFO order. Each
+ * task returns a Status, which is delivered to the caller through the future
+ * returned upon enqueueing the task.
+ */
+class ThreadPool {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** Constructor. */
+  ThreadPool();
+
+  /** Destructor. Waits for all the enqueued tasks to complete. */
+  ~ThreadPool();
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Enqueues a task for execution by the next available worker thread.
+   *
+   * @param function The task to execute.
+   * @return A future holding the Status of the task. The future is invalid
+   *     if the task could not be enqueued (e.g., the pool is not initialized).
+   */
+  std::future<Status> enqueue(const std::function<Status()>& function);
+
+  /**
+   * Spawns the worker threads.
+   *
+   * @param num_threads The number of worker threads. Must be at least 1.
+   * @return Status
+   */
+  Status init(uint64_t num_threads);
+
+  /** Returns the number of worker threads. */
+  uint64_t num_threads() const;
+
+  /**
+   * Waits for all the input tasks to complete.
+   *
+   * @param tasks The futures of the tasks to wait on.
+   * @return The first non-ok Status among the tasks, or Ok if all of
+   *     them succeeded.
+   */
+  Status wait_all(std::vector<std::future<Status>>& tasks);
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** Signals the worker threads upon a new task or termination. */
+  std::condition_variable queue_cv_;
+
+  /** Protects the task queue and the termination flag. */
+  std::mutex queue_mtx_;
+
+  /** If true, the worker threads exit after draining the task queue. */
+  bool should_terminate_;
+
+  /** The pending tasks. */
+  std::queue<std::packaged_task<Status()>> task_queue_;
+
+  /** The worker threads. */
+  std::vector<std::thread> threads_;
+
+  /* ********************************* */
+  /*           PRIVATE METHODS         */
+  /* ********************************* */
+
+  /** Signals the worker threads to terminate and joins them. */
+  void terminate();
+
+  /** The loop executed by each worker thread. */
+  static void worker(ThreadPool* pool);
+};
+
+}  // namespace tiledb
+
+#endif  // TILEDB_THREAD_POOL_H
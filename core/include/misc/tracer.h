@@ -0,0 +1,198 @@
+/**
+ * @file   tracer.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines classes Tracer and TraceSpan.
+ */
+
+#ifndef TILEDB_TRACER_H
+#define TILEDB_TRACER_H
+
+#include "status.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tiledb {
+
+/**
+ * Records timed spans of execution and dumps them as a Chrome trace (the
+ * JSON format read by `chrome://tracing` and Perfetto). Every thread
+ * records into its own fixed-size ring buffer without locking, so the
+ * oldest spans of a thread are overwritten once its buffer is full. The
+ * mutex is taken only the first time a thread records a span.
+ */
+class Tracer {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** Constructor. The tracer is disabled until initialized. */
+  Tracer();
+
+  /** Destructor. */
+  ~Tracer();
+
+  Tracer(const Tracer&) = delete;
+  Tracer& operator=(const Tracer&) = delete;
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Writes the recorded spans to the trace file. It must not be invoked
+   * concurrently with threads recording spans.
+   *
+   * @return Status
+   */
+  Status dump() const;
+
+  /** Returns `true` if spans are being recorded. */
+  bool enabled() const;
+
+  /**
+   * Initializes the tracer.
+   *
+   * @param trace_file The file the spans will be dumped into. If empty,
+   *     the tracer stays disabled.
+   * @param buffer_event_num The number of spans each thread buffers.
+   * @return Status
+   */
+  Status init(const std::string& trace_file, uint64_t buffer_event_num);
+
+  /** Returns the time elapsed since the creation of the tracer (in ns). */
+  uint64_t now() const;
+
+  /**
+   * Records a span for the calling thread.
+   *
+   * @param name The span name. It must be a string literal, as only the
+   *     pointer is stored.
+   * @param start The start of the span, as returned by `now()`.
+   * @param end The end of the span, as returned by `now()`.
+   */
+  void record(const char* name, uint64_t start, uint64_t end);
+
+ private:
+  /* ********************************* */
+  /*          TYPE DEFINITIONS         */
+  /* ********************************* */
+
+  /** A recorded span. */
+  struct Event {
+    /** The span name. */
+    const char* name_;
+    /** The start of the span (in ns). */
+    uint64_t start_;
+    /** The end of the span (in ns). */
+    uint64_t end_;
+  };
+
+  /** The ring buffer of spans of a single thread. */
+  struct ThreadBuffer {
+    /** The spans, of `buffer_event_num_` capacity. */
+    Event* events_;
+    /** The number of spans ever recorded by the thread. */
+    std::atomic<uint64_t> event_num_;
+    /** The recording thread. */
+    std::thread::id thread_id_;
+  };
+
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The number of spans each thread buffer holds. */
+  uint64_t buffer_event_num_;
+
+  /** The thread buffers, in the order the threads started recording. */
+  std::vector<ThreadBuffer*> buffers_;
+
+  /** Protects `buffers_`. */
+  mutable std::mutex buffers_mtx_;
+
+  /** `true` if spans are being recorded. */
+  bool enabled_;
+
+  /** Distinguishes this tracer in the thread-local buffer lookups. */
+  uint64_t id_;
+
+  /** The time of creation of the tracer. */
+  std::chrono::steady_clock::time_point start_;
+
+  /** The file the spans are dumped into. */
+  std::string trace_file_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /** Returns the buffer of the calling thread, creating it if needed. */
+  ThreadBuffer* thread_buffer();
+};
+
+/**
+ * Records a span of a tracer, which starts upon construction and ends upon
+ * destruction.
+ */
+class TraceSpan {
+ public:
+  /**
+   * Constructor.
+   *
+   * @param tracer The tracer. If `nullptr` or disabled, nothing is recorded.
+   * @param name The span name. It must be a string literal.
+   */
+  TraceSpan(Tracer* tracer, const char* name);
+
+  /** Destructor. Records the span. */
+  ~TraceSpan();
+
+  TraceSpan(const TraceSpan&) = delete;
+  TraceSpan& operator=(const TraceSpan&) = delete;
+
+ private:
+  /** The span name. */
+  const char* name_;
+
+  /** The start of the span. */
+  uint64_t start_;
+
+  /** The tracer, or `nullptr` if nothing is to be recorded. */
+  Tracer* tracer_;
+};
+
+}  // namespace tiledb
+
+#endif  // TILEDB_TRACER_H
@@ -60,6 +60,15 @@ Status convert(const std::string& str, long* value);
 /** Converts the input string into a `uint64_t` value. */
 Status convert(const std::string& str, uint64_t* value);
 
+/** Converts the input string into a `float` value. */
+Status convert(const std::string& str, float* value);
+
+/**
+ * Converts the input comma-separated list of compressor names (e.g.,
+ * `"LZ4,ZSTD"`) into a vector of compressors.
+ */
+Status convert(const std::string& str, std::vector<Compressor>* value);
+
 /** Returns `true` if the input string is a (potentially signed) integer. */
 bool is_int(const std::string& str);
 
@@ -256,6 +265,14 @@ bool is_unary_subarray(const T* subarray, unsigned int dim_num);
 template <class T>
 bool overlap(const T* a, const T* b, unsigned dim_num);
 
+/**
+ * Returns the fraction of the volume of hyper-rectangle `a` that overlaps
+ * with `b`, in [0, 1]. For integer types the bounds are inclusive. For real
+ * types, a dimension where `a` has zero width counts as fully overlapping.
+ */
+template <class T>
+double overlap_ratio(const T* a, const T* b, unsigned dim_num);
+
 /**
  * Checks if a string starts with a certain prefix.
  *
@@ -67,14 +67,17 @@ class ArrayOrderedWriteState {
     ArrayOrderedWriteState* asws_;
   };
 
-  /** Stores local state about the current write/copy request. */
+  /**
+   * Stores local state about the current write/copy request. There is one
+   * set of local buffers per tile slab that can be in flight.
+   */
   struct CopyState {
     /** Local buffer offsets. */
-    uint64_t* buffer_offsets_[2];
+    std::vector<uint64_t*> buffer_offsets_;
     /** Local buffer sizes. */
-    uint64_t* buffer_sizes_[2];
+    std::vector<uint64_t*> buffer_sizes_;
     /** Local buffers. */
-    void** buffers_[2];
+    std::vector<void**> buffers_;
   };
 
   /** Info about a tile slab. */
@@ -169,19 +172,19 @@ class ArrayOrderedWriteState {
   void* (*advance_cell_slab_)(void*);
 
   /** Condition variables used for the internal async queries. */
-  std::condition_variable async_cv_[2];
+  std::vector<std::condition_variable> async_cv_;
 
   /** Data for the internal async queries. */
-  ASWS_Data async_data_[2];
+  std::vector<ASWS_Data> async_data_;
 
   /** Mutexes used in async queries. */
-  std::mutex async_mtx_[2];
+  std::vector<std::mutex> async_mtx_;
 
   /** The async queries. */
-  Query* async_query_[2];
+  std::vector<Query*> async_query_;
 
-  /** Wait for async flags, one for each local buffer. */
-  bool async_wait_[2];
+  /** Wait for async flags, one for each local buffer set. */
+  bool* async_wait_;
 
   /** The ids of the attributes the array was initialized with. */
   const std::vector<unsigned int> attribute_ids_;
@@ -237,17 +240,24 @@ class ArrayOrderedWriteState {
   /** Auxiliary variable used in calculate_tile_slab_info(). */
   void* tile_domain_;
 
-  /** The tile slab to be read for the first and second buffers. */
-  void* tile_slab_[2];
+  /** The tile slab to be written for each local buffer set. */
+  std::vector<void*> tile_slab_;
 
   /** Indicates if the tile slab has been initialized. */
-  bool tile_slab_init_[2];
+  bool* tile_slab_init_;
 
   /** Normalized tile slab. */
-  void* tile_slab_norm_[2];
+  std::vector<void*> tile_slab_norm_;
+
+  /** The info for each of the tile slabs under investigation. */
+  std::vector<TileSlabInfo> tile_slab_info_;
 
-  /** The info for each of the two tile slabs under investigation. */
-  TileSlabInfo tile_slab_info_[2];
+  /**
+   * The number of tile slabs that can be in flight, i.e., the number of local
+   * buffer sets. While the internal async query writes one tile slab, the
+   * cells of the following ones are re-arranged into the remaining sets.
+   */
+  unsigned int tile_slab_num_;
 
   /** The state for the current tile slab being copied. */
   TileSlabState tile_slab_state_;
@@ -329,6 +339,9 @@ class ArrayOrderedWriteState {
   /** Waits on an async condition on the input tile slab id. */
   void async_wait(unsigned int id);
 
+  /** Waits on the async conditions of all tile slabs. */
+  void async_wait_all();
+
   /**
    * Calculates the number of buffers to be allocated, based on the number
    * of attributes initialized for the array.
@@ -503,26 +516,54 @@ class ArrayOrderedWriteState {
   void calculate_tile_slab_info_row(unsigned int id);
 
   /**
-   * Copies a tile slab from the user buffers into the local buffers,
-   * properly re-organizing the cell order to follow the array global
-   * cell order.
+   * Copies the cell slabs of a single tile of the current tile slab from the
+   * user buffer into the local buffer, focusing on a particular fixed-length
+   * attribute. It invokes the proper templated function based on the
+   * coordinates type.
    *
+   * @param aid The index on attribute_ids_ to focus on.
+   * @param bid The index on the copy state buffers to focus on.
+   * @param tid The tile id within the tile slab.
    * @return void.
    */
-  void copy_tile_slab();
+  void copy_cell_slabs(unsigned int aid, unsigned int bid, uint64_t tid);
 
   /**
-   * Copies a tile slab from the local buffers into the user buffers,
-   * properly re-organizing the cell order to fit the targeted order,
-   * focusing on a particular fixed-length attribute.
+   * Copies the cell slabs of a single tile of the current tile slab from the
+   * user buffer into the local buffer, focusing on a particular fixed-length
+   * attribute. The user buffer offset of each cell slab is derived from its
+   * coordinates, so that the tiles can be copied independently.
    *
-   * @tparam T The attribute type.
+   * @tparam T The domain type.
    * @param aid The index on attribute_ids_ to focus on.
    * @param bid The index on the copy state buffers to focus on.
+   * @param tid The tile id within the tile slab.
    * @return void.
    */
   template <class T>
-  void copy_tile_slab(unsigned int aid, unsigned int bid);
+  void copy_cell_slabs(unsigned int aid, unsigned int bid, uint64_t tid);
+
+  /**
+   * Copies a tile slab from the user buffers into the local buffers,
+   * properly re-organizing the cell order to follow the array global
+   * cell order. The work is split into tasks per attribute and, for the
+   * fixed-sized attributes, per range of tiles, which are executed by the
+   * storage manager thread pool.
+   *
+   * @return Status
+   */
+  Status copy_tile_slab();
+
+  /**
+   * Copies a tile slab from the user buffers into the local buffers,
+   * focusing on a particular variable-length attribute. It invokes the
+   * proper templated function based on the attribute type.
+   *
+   * @param aid The index on attribute_ids_ to focus on.
+   * @param bid The index on the copy state buffers to focus on.
+   * @return Status
+   */
+  Status copy_tile_slab_var(unsigned int aid, unsigned int bid);
 
   /**
    * Copies a tile slab from the local buffers into the user buffers,
@@ -537,6 +578,44 @@ class ArrayOrderedWriteState {
   template <class T>
   void copy_tile_slab_var(unsigned int aid, unsigned int bid);
 
+  /**
+   * Copies the tiles in range `[tile_start, tile_end)` of the current tile
+   * slab from the user buffer into the local buffer, focusing on a particular
+   * fixed-length attribute. It invokes the proper templated function based on
+   * the attribute type.
+   *
+   * @param aid The index on attribute_ids_ to focus on.
+   * @param bid The index on the copy state buffers to focus on.
+   * @param tile_start The first tile id of the range.
+   * @param tile_end The tile id following the last one of the range.
+   * @return Status
+   */
+  Status copy_tiles(
+      unsigned int aid,
+      unsigned int bid,
+      uint64_t tile_start,
+      uint64_t tile_end);
+
+  /**
+   * Copies the tiles in range `[tile_start, tile_end)` of the current tile
+   * slab from the user buffer into the local buffer, focusing on a particular
+   * fixed-length attribute. The local tiles are first filled with empty
+   * values.
+   *
+   * @tparam T The attribute type.
+   * @param aid The index on attribute_ids_ to focus on.
+   * @param bid The index on the copy state buffers to focus on.
+   * @param tile_start The first tile id of the range.
+   * @param tile_end The tile id following the last one of the range.
+   * @return void.
+   */
+  template <class T>
+  void copy_tiles(
+      unsigned int aid,
+      unsigned int bid,
+      uint64_t tile_start,
+      uint64_t tile_end);
+
   /**
    * Creates the copy state buffers.
    *
@@ -554,16 +633,18 @@ class ArrayOrderedWriteState {
   void create_user_buffers(void** buffers, uint64_t* buffer_sizes);
 
   /**
-   * Fills the **entire** buffer of the current copy tile slab with the input id
-   * with empty values, based on the template type. Applicable only to
-   * fixed-sized attributes.
+   * Fills the range `[offset, offset + size)` of the buffer of the current copy
+   * tile slab with the input id with empty values, based on the template type.
+   * Applicable only to fixed-sized attributes.
    *
    * @tparam T The attribute type.
    * @param bid The buffer id corresponding to the targeted attribute.
+   * @param offset The offset in the buffer where the filling starts.
+   * @param size The number of bytes to fill.
    * @return void
    */
   template <class T>
-  void fill_with_empty(unsigned int bid);
+  void fill_with_empty(unsigned int bid, uint64_t offset, uint64_t size);
 
   /**
    * Fills the **a single** cell in a variable-sized buffer of the current copy
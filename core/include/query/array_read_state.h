@@ -201,6 +201,17 @@ class ArrayReadState {
   /*           PRIVATE METHODS         */
   /* ********************************* */
 
+  /**
+   * Refines the fragment cell position ranges of a read round to the runs of
+   * cells that satisfy all the query conditions. Since every attribute then
+   * copies the same refined ranges, the results stay aligned across the
+   * attribute buffers.
+   *
+   * @param fragment_cell_pos_ranges The ranges to refine in place.
+   * @return Status
+   */
+  Status apply_conditions(FragmentCellPosRanges* fragment_cell_pos_ranges);
+
   /** Cleans fragment cell positions that are processed by all attributes. */
   void clean_up_processed_fragment_cell_pos_ranges();
 
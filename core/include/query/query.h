@@ -37,6 +37,7 @@
 #include "array_ordered_write_state.h"
 #include "array_read_state.h"
 #include "fragment.h"
+#include "query_condition.h"
 #include "query_status.h"
 #include "query_type.h"
 #include "status.h"
@@ -78,6 +79,20 @@ class Query {
   /*                 API               */
   /* ********************************* */
 
+  /**
+   * Adds a condition that the cells returned by a read query must satisfy,
+   * in conjunction with any conditions already added. Applicable only to
+   * sparse arrays, and to fixed-sized attributes with a single value per
+   * cell.
+   *
+   * @param attribute The name of the attribute to compare.
+   * @param op The comparison operator.
+   * @param value The value to compare against, of the attribute type.
+   * @return Status
+   */
+  Status add_condition(
+      const char* attribute, QueryConditionOp op, const void* value);
+
   /** Returns the array schema.*/
   const ArraySchema* array_schema() const;
 
@@ -90,6 +105,19 @@ class Query {
   /** Finalizes and deletes the created fragments. */
   Status clear_fragments();
 
+  /** Returns the conditions the cells returned by a read must satisfy. */
+  const std::vector<QueryCondition>& conditions() const;
+
+  /**
+   * Appends the tiles of the input sparse fragment verbatim to the fragment
+   * being written. Applicable only to write queries in the global order,
+   * whose cells written so far precede those of the input fragment.
+   *
+   * @param metadata The metadata of the fragment to copy.
+   * @return Status
+   */
+  Status copy_tiles(const FragmentMetadata* metadata);
+
   /**
    * Retrieves the index of the coordinates buffer in the specified query
    * buffers.
@@ -272,6 +300,9 @@ class Query {
    */
   void set_callback(std::function<void(void*)> callback, void* callback_data);
 
+  /** Sets the conditions the cells returned by a read must satisfy. */
+  void set_conditions(const std::vector<QueryCondition>& conditions);
+
   /** Sets and initializes the fragment metadata. */
   Status set_fragment_metadata(
       const std::vector<FragmentMetadata*>& fragment_metadata);
@@ -301,6 +332,12 @@ class Query {
   /** Sets the query type. */
   void set_type(QueryType type);
 
+  /**
+   * Returns the stats of the query, which also propagate into the stats of
+   * the storage manager.
+   */
+  Stats* stats();
+
   /** Returns the query status. */
   QueryStatus status() const;
 
@@ -375,12 +412,18 @@ class Query {
    */
   Query* common_query_;
 
+  /** The conditions the cells returned by a read must satisfy. */
+  std::vector<QueryCondition> conditions_;
+
   /**
    * If non-empty, then this holds the name of the consolidation fragment to be
    * created by this query. This also implies that the query type is WRITE.
    */
   URI consolidation_fragment_uri_;
 
+  /** The stats collected while processing the query. */
+  Stats stats_;
+
   /** The query status. */
   QueryStatus status_;
 
@@ -471,6 +514,15 @@ class Query {
   /** Sets the query attributes. */
   Status set_attributes(const char** attributes, unsigned int attribute_num);
 
+  /**
+   * Checks whether a fragment can be skipped in a point lookup on a
+   * key-value store, because its bloom filter rules out the key.
+   *
+   * @param metadata The fragment metadata.
+   * @return `true` if the fragment definitely does not contain the key.
+   */
+  bool skip_fragment(const FragmentMetadata* metadata) const;
+
   /**
    * Sets the input buffer sizes to zero. The function assumes that the buffer
    * sizes correspond to the attribute buffers specified upon query creation.
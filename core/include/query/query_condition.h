@@ -0,0 +1,183 @@
+/**
+ * @file   query_condition.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class QueryCondition.
+ */
+
+#ifndef TILEDB_QUERY_CONDITION_H
+#define TILEDB_QUERY_CONDITION_H
+
+#include "datatype.h"
+#include "query_condition_op.h"
+#include "status.h"
+#include "tile_stats.h"
+
+#include <cinttypes>
+#include <vector>
+
+namespace tiledb {
+
+/**
+ * A condition comparing the values of a fixed-sized, single-valued attribute
+ * against a constant, which a read query evaluates on the decompressed tiles
+ * so that only the satisfying cells reach the user buffers. Every value is
+ * evaluated, including the maximum of the attribute type, which sparse
+ * fragments store as regular data. NaNs never satisfy a condition.
+ */
+class QueryCondition {
+ public:
+  /* ********************************* */
+  /*           TYPE DEFINITIONS        */
+  /* ********************************* */
+
+  /** A cell position pair [first, second]. */
+  typedef std::pair<uint64_t, uint64_t> CellPosRange;
+
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /**
+   * Constructor.
+   *
+   * @param attribute_id The id of the attribute the condition applies to.
+   * @param type The type of the attribute.
+   * @param op The comparison operator.
+   * @param value The value to compare against, of the attribute type.
+   */
+  QueryCondition(
+      unsigned int attribute_id,
+      Datatype type,
+      QueryConditionOp op,
+      const void* value);
+
+  /** Destructor. */
+  ~QueryCondition() = default;
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Finds the runs of consecutive cells of a range that satisfy the
+   * condition.
+   *
+   * @param values The attribute values of a tile.
+   * @param cell_pos_range The range of cell positions to evaluate.
+   * @param result The runs of satisfying cells are appended here, in
+   *     increasing order of cell position.
+   * @return Status
+   */
+  Status apply(
+      const void* values,
+      const CellPosRange& cell_pos_range,
+      std::vector<CellPosRange>* result) const;
+
+  /** Returns the id of the attribute the condition applies to. */
+  unsigned int attribute_id() const;
+
+  /**
+   * Returns `true` if the input statistics guarantee that all the values
+   * of the tile satisfy the condition.
+   */
+  bool matches_all(const TileStats& stats) const;
+
+  /**
+   * Returns `false` if the input statistics guarantee that no value of
+   * the tile satisfies the condition.
+   */
+  bool may_match(const TileStats& stats) const;
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The id of the attribute the condition applies to. */
+  unsigned int attribute_id_;
+
+  /** The comparison operator. */
+  QueryConditionOp op_;
+
+  /** The type of the attribute. */
+  Datatype type_;
+
+  /** The value to compare against, in the attribute type. */
+  char value_[sizeof(uint64_t)];
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /**
+   * Finds the runs of satisfying cells of a range.
+   *
+   * @tparam T The attribute type.
+   * @param values The attribute values of a tile.
+   * @param cell_pos_range The range of cell positions to evaluate.
+   * @param result The runs of satisfying cells are appended here.
+   * @return void
+   */
+  template <class T>
+  void apply_op(
+      const T* values,
+      const CellPosRange& cell_pos_range,
+      std::vector<CellPosRange>* result) const;
+
+  /**
+   * Finds the runs of cells of a range whose values compare to the
+   * condition value according to the input comparator.
+   *
+   * @tparam T The attribute type.
+   * @tparam Cmp The comparator type.
+   * @param values The attribute values of a tile.
+   * @param cell_pos_range The range of cell positions to evaluate.
+   * @param cmp The comparator.
+   * @param result The runs of satisfying cells are appended here.
+   * @return void
+   */
+  template <class T, class Cmp>
+  void apply_cmp(
+      const T* values,
+      const CellPosRange& cell_pos_range,
+      Cmp cmp,
+      std::vector<CellPosRange>* result) const;
+
+  /** Implements `matches_all` for attribute type `T`. */
+  template <class T>
+  bool matches_all(const TileStats& stats) const;
+
+  /** Implements `may_match` for attribute type `T`. */
+  template <class T>
+  bool may_match(const TileStats& stats) const;
+};
+
+}  // namespace tiledb
+
+#endif  // TILEDB_QUERY_CONDITION_H
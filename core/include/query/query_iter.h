@@ -0,0 +1,212 @@
+/**
+ * @file   query_iter.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class QueryIter.
+ */
+
+#ifndef TILEDB_QUERY_ITER_H
+#define TILEDB_QUERY_ITER_H
+
+#include "query.h"
+#include "status.h"
+#include "storage_manager.h"
+
+#include <string>
+#include <vector>
+
+namespace tiledb {
+
+/**
+ * A read query iterator. It streams the results of a read query in batches
+ * of cells, using a set of internal buffers that are allocated once within
+ * a memory budget (see the `sm.query_iter_memory_budget` config parameter)
+ * and reused across batches. The buffers grow beyond the budget only if a
+ * single cell of a variable-sized attribute does not fit.
+ *
+ * Each attribute is read independently, hence a batch may hold a different
+ * number of cells for each attribute, in case some buffer overflowed.
+ */
+class QueryIter {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** Constructor. */
+  explicit QueryIter(StorageManager* storage_manager);
+
+  /** Destructor. */
+  ~QueryIter();
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Retrieves the results of the current batch for a fixed-sized attribute.
+   * The buffer is valid until the next call to `next`.
+   *
+   * @param attribute The attribute name.
+   * @param buffer The buffer holding the attribute values.
+   * @param buffer_size The size of the useful data in `buffer`.
+   * @return Status
+   */
+  Status buffer(
+      const std::string& attribute, void** buffer, uint64_t* buffer_size) const;
+
+  /**
+   * Retrieves the results of the current batch for a variable-sized
+   * attribute. The buffers are valid until the next call to `next`.
+   *
+   * @param attribute The attribute name.
+   * @param buffer_off The buffer holding the starting offsets of the cell
+   *     values in `buffer_val`.
+   * @param buffer_off_size The size of the useful data in `buffer_off`.
+   * @param buffer_val The buffer holding the attribute values.
+   * @param buffer_val_size The size of the useful data in `buffer_val`.
+   * @return Status
+   */
+  Status buffer_var(
+      const std::string& attribute,
+      uint64_t** buffer_off,
+      uint64_t* buffer_off_size,
+      void** buffer_val,
+      uint64_t* buffer_val_size) const;
+
+  /** Returns `true` if there are no more batches to be retrieved. */
+  bool done() const;
+
+  /** Finalizes the iterator and frees all memory. */
+  Status finalize();
+
+  /**
+   * Initializes the iterator and retrieves the first batch of results.
+   *
+   * @param array_uri The URI of the array to read from.
+   * @param subarray The subarray to read. `nullptr` means the entire domain.
+   * @param attributes The attributes to read. `nullptr` indicates **all**
+   *     attributes (plus the coordinates for sparse arrays).
+   * @param attribute_num The number of attributes.
+   * @param layout The layout of the retrieved cells.
+   * @return Status
+   */
+  Status init(
+      const std::string& array_uri,
+      const void* subarray,
+      const char** attributes,
+      unsigned int attribute_num,
+      Layout layout);
+
+  /** Retrieves the next batch of results. */
+  Status next();
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The allocated sizes of the buffers. */
+  std::vector<uint64_t> alloced_sizes_;
+
+  /** The ids of the attributes being read. */
+  std::vector<unsigned int> attribute_ids_;
+
+  /** The names of the attributes being read. */
+  std::vector<std::string> attributes_;
+
+  /** `true` if the current batch holds some results. */
+  bool batch_;
+
+  /**
+   * The index in `buffers_` of the (first) buffer of each attribute, with a
+   * one-to-one correspondence with `attribute_ids_`.
+   */
+  std::vector<unsigned int> buffer_idx_;
+
+  /** The number of buffers. */
+  unsigned int buffer_num_;
+
+  /** The internal buffers passed to the read query. */
+  void** buffers_;
+
+  /** The sizes of the useful data in `buffers_`. */
+  uint64_t* buffer_sizes_;
+
+  /** The read query. */
+  Query* query_;
+
+  /** The read query status. */
+  QueryStatus status_;
+
+  /** TileDB storage manager. */
+  StorageManager* storage_manager_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /**
+   * Retrieves the position of the input attribute in `attribute_ids_`.
+   *
+   * @param attribute The attribute name.
+   * @param i The position to be retrieved.
+   * @return Status
+   */
+  Status attribute_pos(const std::string& attribute, unsigned int* i) const;
+
+  /** Clears the iterator. */
+  void clear();
+
+  /**
+   * Doubles the buffers of the attributes that overflowed. Invoked when no
+   * result fits the buffers, so that the iterator always makes progress.
+   */
+  Status grow_buffers();
+
+  /**
+   * Allocates the buffers within the memory budget and sets them to the
+   * read query. The budget is split so that every buffer can hold the same
+   * number of cells, assuming that a variable-sized cell occupies as many
+   * bytes as its offset.
+   */
+  Status init_buffers();
+
+  /** Returns `true` if the current batch holds some results. */
+  bool has_results() const;
+
+  /**
+   * Submits the read query, resubmitting it with larger buffers as long as no
+   * result fits the current ones.
+   */
+  Status submit_read_query();
+};
+
+}  // namespace tiledb
+
+#endif  // TILEDB_QUERY_ITER_H
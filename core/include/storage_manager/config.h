@@ -50,13 +50,37 @@ class Config {
   /** Storage manager parameters. */
   struct SMParams {
     uint64_t array_schema_cache_size_;
+    uint64_t compression_auto_bandwidth_;
+    std::string compression_auto_candidates_;
+    uint64_t consolidation_max_fragments_;
+    uint64_t consolidation_memory_budget_;
+    uint64_t consolidation_min_fragments_;
+    float consolidation_size_ratio_;
     uint64_t fragment_metadata_cache_size_;
+    uint64_t kv_bloom_filter_bits_per_key_;
+    bool lock_free_reads_;
+    uint64_t ordered_write_buffer_num_;
+    uint64_t query_iter_memory_budget_;
+    uint64_t thread_pool_size_;
     uint64_t tile_cache_size_;
+    std::string trace_file_;
 
     SMParams() {
       array_schema_cache_size_ = constants::array_schema_cache_size;
+      compression_auto_bandwidth_ = constants::compression_auto_bandwidth;
+      compression_auto_candidates_ = constants::compression_auto_candidates;
+      consolidation_max_fragments_ = constants::consolidation_max_fragments;
+      consolidation_memory_budget_ = constants::consolidation_memory_budget;
+      consolidation_min_fragments_ = constants::consolidation_min_fragments;
+      consolidation_size_ratio_ = constants::consolidation_size_ratio;
       fragment_metadata_cache_size_ = constants::fragment_metadata_cache_size;
+      kv_bloom_filter_bits_per_key_ = constants::kv_bloom_filter_bits_per_key;
+      lock_free_reads_ = constants::lock_free_reads;
+      ordered_write_buffer_num_ = constants::ordered_write_buffer_num;
+      query_iter_memory_budget_ = constants::query_iter_memory_budget;
+      thread_pool_size_ = constants::thread_pool_size;
       tile_cache_size_ = constants::tile_cache_size;
+      trace_file_ = constants::trace_file;
     }
   };
 
@@ -181,12 +205,79 @@ class Config {
   /** Sets the array metadata cache size, properly parsing the input value. */
   Status set_sm_array_schema_cache_size(const std::string& value);
 
+  /**
+   * Sets the storage read bandwidth (in bytes per second) assumed by the
+   * `AUTO` compressor, properly parsing the input value. Zero makes `AUTO`
+   * pick the compressor with the smallest output.
+   */
+  Status set_sm_compression_auto_bandwidth(const std::string& value);
+
+  /**
+   * Sets the comma-separated list of compressors the `AUTO` compressor
+   * picks from, properly parsing the input value.
+   */
+  Status set_sm_compression_auto_candidates(const std::string& value);
+
+  /**
+   * Sets the maximum number of fragments merged by a consolidation, properly
+   * parsing the input value. Zero means that there is no limit.
+   */
+  Status set_sm_consolidation_max_fragments(const std::string& value);
+
+  /**
+   * Sets the memory budget of the consolidation buffers, properly parsing
+   * the input value.
+   */
+  Status set_sm_consolidation_memory_budget(const std::string& value);
+
+  /**
+   * Sets the minimum number of fragments merged by a consolidation, properly
+   * parsing the input value.
+   */
+  Status set_sm_consolidation_min_fragments(const std::string& value);
+
+  /**
+   * Sets the maximum size ratio of the fragments merged by a consolidation,
+   * properly parsing the input value. Zero disables the size check.
+   */
+  Status set_sm_consolidation_size_ratio(const std::string& value);
+
   /** Sets the fragment metadata cache size, properly parsing the input value.*/
   Status set_sm_fragment_metadata_cache_size(const std::string& value);
 
+  /**
+   * Sets the number of bloom filter bits per key of the key-value store
+   * fragments, properly parsing the input value. Zero disables the filters.
+   */
+  Status set_sm_kv_bloom_filter_bits_per_key(const std::string& value);
+
+  /**
+   * Sets whether read queries skip the shared lock of the array, properly
+   * parsing the input value.
+   */
+  Status set_sm_lock_free_reads(const std::string& value);
+
+  /**
+   * Sets the number of local buffer sets used in ordered writes, properly
+   * parsing the input value.
+   */
+  Status set_sm_ordered_write_buffer_num(const std::string& value);
+
+  /**
+   * Sets the memory budget of the query iterator buffers, properly parsing
+   * the input value.
+   */
+  Status set_sm_query_iter_memory_budget(const std::string& value);
+
+  /** Sets the thread pool size, properly parsing the input value. */
+  Status set_sm_thread_pool_size(const std::string& value);
+
   /** Sets the tile cache size, properly parsing the input value. */
   Status set_sm_tile_cache_size(const std::string& value);
 
+  /** Sets the file the execution trace is dumped into. */
+  Status set_sm_trace_file(const std::string& value);
+
   /** Sets the S3 region. */
   Status set_vfs_s3_region(const std::string& value);
 
@@ -0,0 +1,145 @@
+/**
+ * @file   consolidated_fragment_metadata.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class ConsolidatedFragmentMetadata.
+ */
+
+
+#ifndef TILEDB_CONSOLIDATED_FRAGMENT_METADATA_H
+#define TILEDB_CONSOLIDATED_FRAGMENT_METADATA_H
+
+#include "array_schema.h"
+#include "buffer.h"
+#include "const_buffer.h"
+#include "fragment_metadata.h"
+#include "status.h"
+#include "uri.h"
+
+#include <map>
+#include <string>
+
+namespace tiledb {
+
+/**
+ * The serialized metadata of a set of fragments of an array, concatenated
+ * into a single object along with an index from fragment names to the
+ * positions of their metadata. Opening an array can then load the metadata
+ * of all the fragments with a single read, instead of one read per fragment.
+ * Since the metadata of a committed fragment never changes, the object
+ * remains valid for any fragment it contains even after new fragments are
+ * added or old ones are consolidated.
+ */
+class ConsolidatedFragmentMetadata {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** Constructor. */
+  ConsolidatedFragmentMetadata();
+
+  /** Destructor. */
+  ~ConsolidatedFragmentMetadata();
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Adds the serialized metadata of a fragment.
+   *
+   * @param fragment_uri The fragment URI.
+   * @param dense `true` if the fragment is dense.
+   * @param buff The serialized fragment metadata.
+   * @return Status
+   */
+  Status add(const URI& fragment_uri, bool dense, const Buffer* buff);
+
+  /**
+   * Deserializes the object from the input buffer.
+   *
+   * @param buff The buffer to deserialize from.
+   * @return Status
+   */
+  Status deserialize(ConstBuffer* buff);
+
+  /** Returns the number of fragments in the object. */
+  uint64_t fragment_num() const;
+
+  /**
+   * Creates the metadata of a fragment from the object.
+   *
+   * @param array_schema The schema of the array the fragment belongs to.
+   * @param fragment_uri The fragment URI.
+   * @param metadata The created fragment metadata, or `nullptr` if the
+   *     fragment is not in the object. The caller takes ownership.
+   * @return Status
+   */
+  Status get(
+      const ArraySchema* array_schema,
+      const URI& fragment_uri,
+      FragmentMetadata** metadata) const;
+
+  /**
+   * Serializes the object into the input buffer.
+   *
+   * @param buff The buffer to serialize into.
+   * @return Status
+   */
+  Status serialize(Buffer* buff) const;
+
+ private:
+  /* ********************************* */
+  /*          PRIVATE TYPES            */
+  /* ********************************* */
+
+  /** The position of the metadata of a fragment. */
+  struct Entry {
+    /** `true` if the fragment is dense. */
+    bool dense_;
+    /** The offset of the fragment metadata in `buff_`. */
+    uint64_t offset_;
+    /** The size of the serialized fragment metadata. */
+    uint64_t size_;
+  };
+
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The concatenated serialized fragment metadata. */
+  Buffer* buff_;
+
+  /** Map (fragment name) -> (metadata position). */
+  std::map<std::string, Entry> index_;
+};
+
+}  // namespace tiledb
+
+#endif  // TILEDB_CONSOLIDATED_FRAGMENT_METADATA_H
@@ -40,6 +40,7 @@
 namespace tiledb {
 
 class ArraySchema;
+class FragmentMetadata;
 class Query;
 class StorageManager;
 class URI;
@@ -65,10 +66,52 @@ class Consolidator {
   /*                API                */
   /* ********************************* */
 
-  /** Consolidates the fragments of the input array. */
-  Status consolidate(const char* array_name);
+  /**
+   * Consolidates the fragments of the input array. The fragments of sparse
+   * arrays are consolidated based on a size-tiered policy, configured by the
+   * `sm.consolidation_*` parameters of the storage manager. The policy
+   * merges only the run of adjacent-in-time fragments of similar sizes that
+   * contains the most fragments, leaving the rest of the fragments (e.g.,
+   * large old fragments) untouched. Dense arrays are always consolidated as
+   * a whole.
+   *
+   * The cells are copied in batches that fit in the
+   * `sm.consolidation_memory_budget`, with the next batch being read in the
+   * thread pool of the storage manager while the current one is written.
+   *
+   * @param array_name The array name.
+   * @param progress_callback If not `nullptr`, it is called after every
+   *     batch of cells written to the new fragment, with the numbers of
+   *     cells and bytes consolidated so far, and *progress_data*.
+   * @param progress_data The data passed to *progress_callback*.
+   * @return Status
+   */
+  Status consolidate(
+      const char* array_name,
+      void (*progress_callback)(uint64_t, uint64_t, void*) = nullptr,
+      void* progress_data = nullptr);
 
  private:
+  /* ********************************* */
+  /*         TYPE DEFINITIONS          */
+  /* ********************************* */
+
+  /** The progress of a consolidation. */
+  struct Progress {
+    /** Called upon progress (see `consolidate`). */
+    void (*callback_)(uint64_t, uint64_t, void*);
+    /** The data passed to the callback. */
+    void* data_;
+    /**
+     * The number of cells written so far for each attribute (plus the
+     * coordinates, for sparse arrays). The attributes of a cell may be
+     * written in different batches.
+     */
+    std::vector<uint64_t> cell_nums_;
+    /** The number of bytes consolidated so far. */
+    uint64_t byte_num_;
+  };
+
   /* ********************************* */
   /*        PRIVATE ATTRIBUTES         */
   /* ********************************* */
@@ -83,29 +126,77 @@ class Consolidator {
   /**
    * Copies the array by reading from the fragments to be consolidated
    * (with *query_r*) and writing to the new fragment (with *query_w*).
+   * The two batches of buffers are used alternately, so that the next batch
+   * of cells is read in the thread pool while the current one is written.
+   *
+   * @param query_r The read query.
+   * @param query_w The write query.
+   * @param buffers The two batches of buffers.
+   * @param buffer_sizes The corresponding buffer sizes.
+   * @param buffer_num The number of buffers in each batch.
+   * @param buffer_size The allocated size of every buffer.
+   * @param progress The consolidation progress to be updated.
+   * @return Status
+   */
+  Status copy_array(
+      Query* query_r,
+      Query* query_w,
+      void** buffers[2],
+      uint64_t* buffer_sizes[2],
+      unsigned int buffer_num,
+      uint64_t buffer_size,
+      Progress* progress);
+
+  /**
+   * Copies the fragments read by *query_r* into the new fragment of
+   * *query_w*. The fragments are first grouped into runs of fragments that
+   * overlap in the global cell order. A fragment that overlaps with no other
+   * has its tiles copied verbatim (without decompressing them), whereas the
+   * cells of the fragments of every other run are read and merged. If no
+   * fragment can be copied verbatim, the function falls back to
+   * `copy_array`.
    *
+   * @param array_name The array name.
+   * @param array_schema The array schema.
    * @param query_r The read query.
    * @param query_w The write query.
+   * @param buffers The two batches of buffers used for copying the cells.
+   * @param buffer_sizes The corresponding buffer sizes.
+   * @param buffer_num The number of buffers in each batch.
+   * @param buffer_size The allocated size of every buffer.
+   * @param progress The consolidation progress to be updated.
    * @return Status
    */
-  Status copy_array(Query* query_r, Query* query_w);
+  Status copy_fragments(
+      const char* array_name,
+      const ArraySchema* array_schema,
+      Query* query_r,
+      Query* query_w,
+      void** buffers[2],
+      uint64_t* buffer_sizes[2],
+      unsigned int buffer_num,
+      uint64_t buffer_size,
+      Progress* progress);
 
   /**
-   * Creates the buffers that will be used upon reading the input fragments and
-   * writing into the new fragment. It also retrieves the number of buffers
-   * created.
+   * Creates the two batches of buffers that will be used upon reading the
+   * input fragments and writing into the new fragment, splitting the
+   * `sm.consolidation_memory_budget` evenly across all buffers. It also
+   * retrieves the number of buffers in each batch and the buffer size.
    *
    * @param array_schema The array schema.
-   * @param buffers The buffers to be created.
+   * @param buffers The two batches of buffers to be created.
    * @param buffer_sizes The corresponding buffer sizes.
-   * @param buffer_num The number of buffers to be retrieved.
+   * @param buffer_num The number of buffers in each batch to be retrieved.
+   * @param buffer_size The allocated size of every buffer to be retrieved.
    * @return Status
    */
   Status create_buffers(
       ArraySchema* array_schema,
-      void*** buffers,
-      uint64_t** buffer_sizes,
-      unsigned int* buffer_num);
+      void** buffers[2],
+      uint64_t* buffer_sizes[2],
+      unsigned int* buffer_num,
+      uint64_t* buffer_size);
 
   /**
    * Creates the queries needed for consolidation. It also retrieves
@@ -116,6 +207,8 @@ class Consolidator {
    * @param array_name The array name.
    * @param buffers The buffers to be passed in the queries.
    * @param buffer_sizes The corresponding buffer sizes.
+   * @param fragment_uris The URIs of the fragments to be consolidated. If it
+   *     is `nullptr`, all the array fragments are consolidated.
    * @param fragment_num The number of fragments to be retrieved.
    * @return Status
    */
@@ -125,14 +218,18 @@ class Consolidator {
       const char* array_name,
       void** buffers,
       uint64_t* buffer_sizes,
+      const std::vector<URI>* fragment_uris,
       unsigned int* fragment_num);
 
   /**
-   * Deletes the old fragments that got consolidated.
+   * Deletes the old fragments that got consolidated, after waiting for the
+   * read snapshots that reference them to be released.
+   * @param array_uri The array URI.
    * @param uris The URIs of the old fragments.
    * @return Status
    */
-  Status delete_old_fragments(const std::vector<URI>& uris);
+  Status delete_old_fragments(
+      const URI& array_uri, const std::vector<URI>& uris);
 
   /** Finalizes the input queries. */
   Status finalize_queries(Query* query_r, Query* query_w);
@@ -147,12 +244,97 @@ class Consolidator {
   void free_buffers(
       unsigned int buffer_num, void** buffers, uint64_t* buffer_sizes);
 
+  /**
+   * Groups the input (sparse) fragments into runs, such that the fragments
+   * of different runs do not overlap in the global cell order. The runs are
+   * sorted in the global order, and the fragments of each run preserve their
+   * input (timestamp) order. Empty fragments are placed in runs of their own.
+   *
+   * @param array_schema The array schema.
+   * @param metadata The metadata of the fragments to be grouped.
+   * @param runs The resulting runs.
+   * @return Status
+   */
+  Status group_fragments(
+      const ArraySchema* array_schema,
+      const std::vector<FragmentMetadata*>& metadata,
+      std::vector<std::vector<FragmentMetadata*>>* runs) const;
+
+  /**
+   * Same as above, templated on the coordinates type.
+   *
+   * @tparam T The coordinates type.
+   * @param array_schema The array schema.
+   * @param metadata The metadata of the fragments to be grouped.
+   * @param runs The resulting runs.
+   */
+  template <class T>
+  void group_fragments(
+      const ArraySchema* array_schema,
+      const std::vector<FragmentMetadata*>& metadata,
+      std::vector<std::vector<FragmentMetadata*>>* runs) const;
+
+  /**
+   * Reads the next batch of cells with the input read query.
+   *
+   * @param query_r The read query.
+   * @param buffers The buffers to read the cells into.
+   * @param buffer_sizes The corresponding buffer sizes. They are reset to
+   *     *buffer_size* before reading.
+   * @param buffer_num The number of buffers.
+   * @param buffer_size The allocated size of every buffer.
+   * @return Status
+   */
+  Status read_batch(
+      Query* query_r,
+      void** buffers,
+      uint64_t* buffer_sizes,
+      unsigned int buffer_num,
+      uint64_t buffer_size);
+
   /**
    * Renames the new fragment URI. If the working thread id is different
    * from the one that created the input URI, the function does nothing.
    * Otherwise, it appends an extra `_` after the thread id.
    */
   Status rename_new_fragment_uri(URI* uri) const;
+
+  /**
+   * Adds the input numbers of cells and bytes to the consolidation progress
+   * and calls the progress callback, if any. The cells reported are those
+   * written for all the attributes.
+   *
+   * @param progress The consolidation progress.
+   * @param cell_nums The number of cells written for each attribute.
+   * @param byte_num The number of bytes written.
+   */
+  void report_progress(
+      Progress* progress,
+      const std::vector<uint64_t>& cell_nums,
+      uint64_t byte_num) const;
+
+  /**
+   * Selects the fragments to be consolidated based on the size-tiered
+   * policy. A run of adjacent fragments (in timestamp order) qualifies if
+   * it holds between `sm.consolidation_min_fragments` and
+   * `sm.consolidation_max_fragments` fragments, and the size of its largest
+   * fragment is at most `sm.consolidation_size_ratio` times the size of its
+   * smallest one. Among the qualifying runs, the one with the most fragments
+   * is selected, breaking ties in favor of the smallest total size.
+   *
+   * @param array_name The array name.
+   * @param array_schema The array schema.
+   * @param fragment_uris The URIs of the selected fragments. It is empty
+   *     if no run qualifies.
+   * @param all_fragments Set to `true` if all the fragments must be
+   *     consolidated, in which case *fragment_uris* is left empty.
+   * @return Status
+   */
+  Status select_fragments(
+      const char* array_name,
+      const ArraySchema* array_schema,
+      std::vector<URI>* fragment_uris,
+      bool* all_fragments) const;
 };
 
 }  // namespace tiledb
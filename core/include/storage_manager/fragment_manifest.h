@@ -0,0 +1,148 @@
+/**
+ * @file   fragment_manifest.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class FragmentManifest.
+ */
+
+
+#ifndef TILEDB_FRAGMENT_MANIFEST_H
+#define TILEDB_FRAGMENT_MANIFEST_H
+
+#include "status.h"
+#include "uri.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace tiledb {
+
+/**
+ * The fragment manifest of an array, i.e., the list of its committed
+ * fragments. The manifest is stored as an append-only log of records in the
+ * array directory, so that opening an array does not require listing the
+ * array directory and probing every entry. Appending the record of a
+ * fragment is what commits it, i.e., a fragment directory without a record
+ * is not part of the array. A fragment is removed from the manifest before
+ * it is deleted upon consolidation.
+ *
+ * Each record is a line of text of the form `add <d|s> <fragment name>`
+ * (`d` for dense and `s` for sparse fragments) or `del <fragment name>`.
+ * A trailing line without a newline character is the result of an
+ * interrupted append and it is ignored. A deleted fragment is never added
+ * back, so the records can be replayed in any order, and a manifest stored
+ * in several parts is loaded by deserializing each of them.
+ */
+class FragmentManifest {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** Constructor. */
+  FragmentManifest();
+
+  /** Destructor. */
+  ~FragmentManifest() = default;
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Returns the record adding a committed fragment to the manifest.
+   *
+   * @param fragment_uri The fragment URI.
+   * @param dense `true` if the fragment is dense.
+   * @return The serialized record.
+   */
+  static std::string add_record(const URI& fragment_uri, bool dense);
+
+  /**
+   * Returns the record removing a deleted fragment from the manifest.
+   *
+   * @param fragment_uri The fragment URI.
+   * @return The serialized record.
+   */
+  static std::string delete_record(const URI& fragment_uri);
+
+  /** Checks whether the manifest records the input fragment. */
+  bool contains(const URI& fragment_uri) const;
+
+  /** Checks whether the manifest records the deletion of a fragment. */
+  bool deleted(const URI& fragment_uri) const;
+
+  /**
+   * Checks whether a fragment of the manifest is dense.
+   *
+   * @param fragment_uri The fragment URI.
+   * @param dense Set to `true` if the fragment is dense.
+   * @return Status
+   */
+  Status dense(const URI& fragment_uri, bool* dense) const;
+
+  /**
+   * Parses the records of a manifest (or of a part of it), replaying them
+   * on top of the records parsed so far.
+   *
+   * @param array_uri The URI of the array the manifest belongs to.
+   * @param data The manifest contents.
+   * @param size The size of the manifest contents.
+   * @return Status
+   */
+  Status deserialize(const URI& array_uri, const char* data, uint64_t size);
+
+  /** Returns the URIs of the fragments in the manifest. */
+  std::vector<URI> fragment_uris() const;
+
+  /**
+   * Returns the records of the manifest in compact form, i.e., one per
+   * fragment in the manifest and one per deleted fragment.
+   */
+  std::string serialize() const;
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The URI of the array the manifest belongs to. */
+  URI array_uri_;
+
+  /** The names of the deleted fragments. */
+  std::set<std::string> deleted_;
+
+  /** Map (fragment name) -> (`true` if the fragment is dense). */
+  std::map<std::string, bool> fragments_;
+};
+
+}  // namespace tiledb
+
+#endif  // TILEDB_FRAGMENT_MANIFEST_H
@@ -34,6 +34,7 @@
 #ifndef TILEDB_OPEN_ARRAY_H
 #define TILEDB_OPEN_ARRAY_H
 
+#include <condition_variable>
 #include <map>
 #include <mutex>
 #include <vector>
@@ -95,6 +96,32 @@ class OpenArray {
   /** Sets an array schema. */
   void set_array_schema(const ArraySchema* array_schema);
 
+  /**
+   * Registers a read snapshot, i.e., a reader of the input fragments. The
+   * fragments are immutable, so the snapshot stays valid until it is
+   * released, unless the fragments are deleted.
+   *
+   * @param fragment_metadata The metadata of the fragments in the snapshot.
+   */
+  void snapshot_acquire(
+      const std::vector<FragmentMetadata*>& fragment_metadata);
+
+  /**
+   * Releases a read snapshot previously registered with `snapshot_acquire`.
+   *
+   * @param fragment_metadata The metadata of the fragments in the snapshot.
+   */
+  void snapshot_release(
+      const std::vector<FragmentMetadata*>& fragment_metadata);
+
+  /**
+   * Blocks until no read snapshot references any of the input fragments,
+   * so that they can be safely deleted.
+   *
+   * @param fragment_uris The URIs of the fragments.
+   */
+  void snapshot_wait(const std::vector<URI>& fragment_uris);
+
  private:
   /* ********************************* */
   /*         PRIVATE ATTRIBUTES        */
@@ -118,6 +145,18 @@ class OpenArray {
    */
   std::mutex mtx_;
 
+  /** Signals the release of read snapshots. */
+  std::condition_variable snapshot_cv_;
+
+  /** Protects the snapshot reference counts. */
+  std::mutex snapshot_mtx_;
+
+  /**
+   * The number of read snapshots referencing each fragment.
+   * Format: <fragment_name> --> (reference count)
+   */
+  std::map<std::string, uint64_t> snapshot_refs_;
+
   /* ********************************* */
   /*           PRIVATE METHODS         */
   /* ********************************* */
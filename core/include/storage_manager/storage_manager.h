@@ -35,6 +35,7 @@
 #define TILEDB_STORAGE_MANAGER_H
 
 #include <condition_variable>
+#include <cstdint>
 #include <functional>
 #include <list>
 #include <map>
@@ -45,13 +46,19 @@
 
 #include "array_schema.h"
 #include "config.h"
+#include "consolidated_fragment_metadata.h"
 #include "consolidator.h"
+#include "fragment_manifest.h"
 #include "locked_object.h"
 #include "lru_cache.h"
 #include "object_type.h"
 #include "open_array.h"
 #include "query.h"
+#include "stats.h"
 #include "status.h"
+#include "thread_pool.h"
+#include "tile_stats.h"
+#include "tracer.h"
 #include "uri.h"
 #include "vfs.h"
 #include "walk_order.h"
@@ -125,13 +132,68 @@ class StorageManager {
       unsigned attribute_num,
       uint64_t* buffer_sizes);
 
+  /**
+   * Computes an estimate of the buffer sizes required for a read query, for a
+   * given subarray and set of attributes, along with the upper bound computed
+   * by `array_compute_max_read_buffer_sizes`. The estimate is based on the
+   * fraction of every overlapping tile covered by the subarray and on the
+   * per-tile sizes of the variable-sized values, without reading any tile.
+   *
+   * @param array_uri The array URI.
+   * @param subarray The subarray to focus on. Note that it must have the same
+   *     underlying type as the array domain.
+   * @param attributes The attributes to focus on.
+   * @param attribute_num The number of attributes.
+   * @param est_buffer_sizes The estimated buffer sizes to be retrieved, with
+   *     the same layout as in `array_compute_max_read_buffer_sizes`.
+   * @param max_buffer_sizes The upper bounds on the buffer sizes to be
+   *     retrieved. It is ignored if it is `nullptr`.
+   * @return Status
+   */
+  Status array_compute_est_read_buffer_sizes(
+      const char* array_uri,
+      const void* subarray,
+      const char** attributes,
+      unsigned attribute_num,
+      uint64_t* est_buffer_sizes,
+      uint64_t* max_buffer_sizes);
+
   /**
    * Consolidates the fragments of an array into a single one.
    *
    * @param array_name The name of the array to be consolidated.
+   * @param progress_callback If not `nullptr`, it is called after every
+   *     batch of cells written to the consolidated fragment, with the
+   *     numbers of cells and bytes consolidated so far, and *progress_data*.
+   * @param progress_data The data passed to *progress_callback*.
+   * @return Status
+   */
+  Status array_consolidate(
+      const char* array_name,
+      void (*progress_callback)(uint64_t, uint64_t, void*) = nullptr,
+      void* progress_data = nullptr);
+
+  /**
+   * Consolidates the metadata of the current fragments of an array into a
+   * single object, so that subsequent array opens load the metadata of all
+   * these fragments with a single read. Unlike `array_consolidate`, the
+   * fragments themselves are left intact.
+   *
+   * @param array_name The name of the array.
+   * @return Status
+   */
+  Status array_consolidate_metadata(const char* array_name);
+
+  /**
+   * Waits until no read snapshot of an array references any of the input
+   * fragments, so that they can be safely deleted.
+   *
+   * @param array_uri The array URI.
+   * @param fragment_uris The URIs of the fragments.
    * @return Status
    */
-  Status array_consolidate(const char* array_name);
+  Status array_drain_snapshots(
+      const URI& array_uri, const std::vector<URI>& fragment_uris);
 
   /**
    * Creates a TileDB array storing its schema.
@@ -142,6 +204,41 @@ class StorageManager {
    */
   Status array_create(const URI& array_uri, ArraySchema* array_schema);
 
+  /**
+   * Retrieves the statistics of the values of a fixed-sized attribute of an
+   * array, merging the tile statistics stored in the fragment metadata
+   * without reading any tile.
+   *
+   * @param array_uri The array URI.
+   * @param attribute_name The attribute name.
+   * @param stats The statistics to be retrieved.
+   * @param type The attribute type to be retrieved.
+   * @param has_stats Set to `false` if some fragment does not store the
+   *     statistics of the attribute, in which case `stats` is meaningless.
+   * @return Status
+   */
+  Status array_get_attribute_stats(
+      const char* array_uri,
+      const char* attribute_name,
+      TileStats* stats,
+      Datatype* type,
+      bool* has_stats);
+
+  /**
+   * Retrieves the URIs and the sizes of the fragments of an array, in
+   * ascending timestamp order.
+   *
+   * @param array_uri The array URI.
+   * @param fragment_uris The fragment URIs to be retrieved.
+   * @param fragment_sizes The corresponding fragment sizes (in bytes) to be
+   *     retrieved.
+   * @return Status
+   */
+  Status array_get_fragment_sizes(
+      const char* array_uri,
+      std::vector<URI>* fragment_uris,
+      std::vector<uint64_t>* fragment_sizes);
+
   /**
    * Retrieves the non-empty domain from an array. This is the union of the
    * non-empty domains of the array fragments.
@@ -155,6 +252,21 @@ class StorageManager {
   Status array_get_non_empty_domain(
       const char* array_uri, void* domain, bool* is_empty);
 
+  /**
+   * Retrieves the bounding coordinates of the tiles of every sparse fragment
+   * of an array. These are the first and last coordinates of each tile in
+   * the global cell order.
+   *
+   * @param array_uri The array URI.
+   * @param bounding_coords The bounding coordinates to be retrieved, one
+   *     vector per fragment holding the bounding coordinates of its tiles
+   *     back to back, in the order the tiles are stored in the fragment.
+   * @return Status
+   */
+  Status array_get_tile_bounding_coords(
+      const char* array_uri,
+      std::vector<std::vector<uint8_t>>* bounding_coords);
+
   /**
    * Locks a TileDB object (array or group).
    *
@@ -199,6 +311,30 @@ class StorageManager {
   /** Deletes a fragment directory. */
   Status delete_fragment(const URI& uri) const;
 
+  /**
+   * Records a committed fragment in the fragment manifest of its array.
+   *
+   * @param fragment_uri The URI of the committed fragment.
+   * @param dense `true` if the fragment is dense.
+   * @return Status
+   */
+  Status fragment_manifest_add(const URI& fragment_uri, bool dense);
+
+  /**
+   * Records the deletion of fragments in the fragment manifest of their
+   * array. All fragments must belong to the same array.
+   *
+   * @param fragment_uris The URIs of the fragments to be deleted.
+   * @return Status
+   */
+  Status fragment_manifest_delete(const std::vector<URI>& fragment_uris);
+
+  /**
+   * Returns the timestamp (in ms) of the input fragment, which is stored in
+   * the end of the fragment name after the last `_`.
+   */
+  uint64_t fragment_timestamp(const URI& fragment_uri) const;
+
   /** Move (rename) a resource, skips check that resource is a valid TileDB
    * object */
   Status move_path(const URI& old_uri, const URI& new_uri);
@@ -353,9 +489,18 @@ class StorageManager {
    * @param query The query to initialize.
    * @param array_name The name of the array the query targets at.
    * @param type The query type.
+   * @param timestamp_start The smallest timestamp (in ms) of the fragments
+   *     the query sees (applicable only to reads).
+   * @param timestamp_end The largest timestamp (in ms) of the fragments the
+   *     query sees (applicable only to reads).
    * @return Status
    */
-  Status query_init(Query* query, const char* array_name, QueryType type);
+  Status query_init(
+      Query* query,
+      const char* array_name,
+      QueryType type,
+      uint64_t timestamp_start = 0,
+      uint64_t timestamp_end = UINT64_MAX);
 
   /**
    * Initializes a query.
@@ -373,6 +518,9 @@ class StorageManager {
    * @param consolidation_fragment_uri This is used only in write queries.
    *     If it is different than empty, then it indicates that the query will
    *     be writing into a consolidation fragment with the input name.
+   * @param fragment_uris This is used only in read queries. If it is not
+   *     `nullptr`, then the query reads only from the fragments with the
+   *     input URIs, instead of all the array fragments.
    * @return Status
    */
   Status query_init(
@@ -385,7 +533,8 @@ class StorageManager {
       unsigned int attribute_num,
       void** buffers,
       uint64_t* buffer_sizes,
-      const URI& consolidation_fragment_uri = URI(""));
+      const URI& consolidation_fragment_uri = URI(""),
+      const std::vector<URI>* fragment_uris = nullptr);
 
   /** Submits a query for (sync) execution. */
   Status query_submit(Query* query);
@@ -415,6 +564,8 @@ class StorageManager {
    * @param nbytes Number of bytes to be read.
    * @param in_cache This is set to `true` if the object is in the cache,
    *     and `false` otherwise.
+   * @param stats The stats to record the cache hit or miss in. If `nullptr`,
+   *     the stats of the storage manager are used.
    * @return Status.
    */
   Status read_from_cache(
@@ -422,7 +573,8 @@ class StorageManager {
       uint64_t offset,
       Buffer* buffer,
       uint64_t nbytes,
-      bool* in_cache) const;
+      bool* in_cache,
+      Stats* stats = nullptr) const;
 
   /**
    * Reads from a file into the input buffer.
@@ -432,10 +584,16 @@ class StorageManager {
    * @param buffer The buffer to write into. The function reallocates memory
    *     for the buffer, sets its size to *nbytes* and resets its offset.
    * @param nbytes The number of bytes to read.
+   * @param stats The stats to record the read in. If `nullptr`, the stats
+   *     of the storage manager are used.
    * @return Status.
    */
   Status read(
-      const URI& uri, uint64_t offset, Buffer* buffer, uint64_t nbytes) const;
+      const URI& uri,
+      uint64_t offset,
+      Buffer* buffer,
+      uint64_t nbytes,
+      Stats* stats = nullptr) const;
 
   /**
    * Stores an array schema into persistent storage.
@@ -456,9 +614,29 @@ class StorageManager {
   /** Closes a file, flushing its contents to persistent storage. */
   Status close_file(const URI& uri);
 
+  /**
+   * Returns the stats of the storage manager, which aggregate those of all
+   * the queries it processed, along with any reads not tied to a query
+   * (e.g., of array schemas and fragment metadata).
+   */
+  Stats* stats() const;
+
   /** Syncs a file or directory, flushing its contents to persistent storage. */
   Status sync(const URI& uri);
 
+  /**
+   * Returns the thread pool used for parallelizing internal CPU-bound work,
+   * such as re-arranging cells in ordered writes.
+   */
+  ThreadPool* thread_pool() const;
+
+  /**
+   * Returns the tracer recording the execution timeline, which is enabled
+   * by the `sm.trace_file` config parameter and dumped when the storage
+   * manager is destroyed.
+   */
+  Tracer* tracer() const;
+
   /** Returns the virtual filesystem object. */
   VFS* vfs() const;
 
@@ -507,9 +685,10 @@ class StorageManager {
 
   /**
    * Async query queue. The first is for user queries, the second for
-   * internal queries. The queries are processed in a FIFO manner.
+   * internal queries. The queries are processed in a FIFO manner. Each
+   * query is paired with the (tracer) time it was enqueued.
    */
-  std::queue<Query*> async_queue_[2];
+  std::queue<std::pair<Query*, uint64_t>> async_queue_[2];
 
   /**
    * Async mutex. The first is for the user queries thread, the second for
@@ -529,6 +708,9 @@ class StorageManager {
   /** Object that handles array consolidation. */
   Consolidator* consolidator_;
 
+  /** Mutex for serializing appends to the fragment manifests. */
+  std::mutex fragment_manifest_mtx_;
+
   /** A fragment metadata cache. */
   LRUCache* fragment_metadata_cache_;
 
@@ -550,9 +732,18 @@ class StorageManager {
    */
   std::map<std::string, OpenArray*> open_arrays_;
 
+  /** The stats aggregated over all the processed queries. */
+  Stats* stats_;
+
+  /** Thread pool for parallelizing internal CPU-bound work. */
+  ThreadPool* thread_pool_;
+
   /** A tile cache. */
   LRUCache* tile_cache_;
 
+  /** Records the execution timeline. */
+  Tracer* tracer_;
+
   /**
    * Virtual filesystem handler. It directs queries to the appropriate
    * filesystem backend. Note that this is stateful.
@@ -563,21 +754,74 @@ class StorageManager {
   /*         PRIVATE METHODS           */
   /* ********************************* */
 
-  /** Closes an array. */
-  Status array_close(URI array);
+  /**
+   * Closes an array, releasing the read snapshot of a read query and the
+   * shared lock of the array, if it was taken upon opening.
+   *
+   * @param array_uri The array URI.
+   * @param query_type The type of the query that opened the array.
+   * @param fragment_metadata The fragment metadata retrieved upon opening
+   *     the array.
+   * @return Status
+   */
+  Status array_close(
+      URI array_uri,
+      QueryType query_type,
+      const std::vector<FragmentMetadata*>& fragment_metadata);
 
   /**
-   * Computes an upper bound on the buffer sizes required for a read
-   * query, for a given subarray and set of attributes.
+   * Releases an open array entry, along with the read snapshot of a read
+   * query, without unlocking the array.
+   *
+   * @param array_uri The array URI.
+   * @param query_type The type of the query that opened the array.
+   * @param fragment_metadata The fragment metadata retrieved upon opening
+   *     the array.
+   * @return Status
+   */
+  Status array_close_entry(
+      const URI& array_uri,
+      QueryType query_type,
+      const std::vector<FragmentMetadata*>& fragment_metadata);
+
+  /**
+   * Computes the estimated and/or the maximum buffer sizes required for a
+   * read query, for a given subarray and set of attributes.
+   *
+   * @param array_uri The array URI.
+   * @param subarray The subarray to focus on.
+   * @param attributes The attributes to focus on.
+   * @param attribute_num The number of attributes.
+   * @param est_buffer_sizes The estimated buffer sizes to be retrieved. It is
+   *     ignored if it is `nullptr`.
+   * @param max_buffer_sizes The upper bounds on the buffer sizes to be
+   *     retrieved. It is ignored if it is `nullptr`.
+   * @return Status
+   */
+  Status array_compute_read_buffer_sizes(
+      const char* array_uri,
+      const void* subarray,
+      const char** attributes,
+      unsigned attribute_num,
+      uint64_t* est_buffer_sizes,
+      uint64_t* max_buffer_sizes);
+
+  /**
+   * Computes the estimated and/or the maximum buffer sizes required for a
+   * read query, for a given subarray and set of attributes.
    *
    * @tparam T The domain type.
+   * @param array_schema The array schema.
    * @param metadata The array fragment metadata.
    * @param subarray The subarray to focus on.
    * @param attributes The attributes to focus on.
    * @param attribute_num The number of attributes.
    * @param buffer_num The number of buffers corresponding to the input
    *     attributes.
-   * @param buffer_sizes The buffer sizes to be retrieved. Note that one
+   * @param est_buffer_sizes The estimated buffer sizes to be retrieved. It is
+   *     ignored if it is `nullptr`.
+   * @param max_buffer_sizes The upper bounds on the buffer sizes to be
+   *     retrieved. It is ignored if it is `nullptr`. Note that one
    *     buffer size corresponds to a fixed-sized attributes, and two
    *     buffer sizes for a variable-sized attribute (the first is the
    *     size of the offsets, whereas the second is the size of the
@@ -585,13 +829,15 @@ class StorageManager {
    * @return Status
    */
   template <class T>
-  Status array_compute_max_read_buffer_sizes(
+  Status array_compute_read_buffer_sizes(
+      const ArraySchema* array_schema,
       const std::vector<FragmentMetadata*>& metadata,
       const T* subarray,
       const char** attributes,
       unsigned attribute_num,
       unsigned buffer_num,
-      uint64_t* buffer_sizes);
+      uint64_t* est_buffer_sizes,
+      uint64_t* max_buffer_sizes);
 
   /**
    * Retrieves the non-empty domain from the input fragment metadata. This is
@@ -609,24 +855,44 @@ class StorageManager {
       T* domain);
 
   /**
-   * Opens an array, retrieving its schema and fragment metadata.
+   * Returns `true` if opening the array for the input query type locks it
+   * in shared mode, which holds for all queries but the reads when the
+   * `sm.lock_free_reads` parameter is set. The shared file lock keeps
+   * consolidations in other processes from deleting the fragments of
+   * ongoing reads, which the read snapshots guard only within this process.
+   */
+  bool array_locked(QueryType query_type) const;
+
+  /**
+   * Opens an array, retrieving its schema and fragment metadata. The array
+   * is locked in shared mode (see `array_locked`), and read queries also
+   * register a snapshot of the retrieved fragments in the open array.
    *
    * @param array_uri The array URI.
    * @param query_type The query type.
    * @param array_schema The array schema to be retrieved.
    * @param fragment_metadata The fragment metadat to be retrieved.
+   * @param fragment_uris If not `nullptr`, only the metadata of the fragments
+   *     with these URIs are retrieved (applicable only to reads).
+   * @param timestamp_start Only the metadata of the fragments with timestamps
+   *     in `[timestamp_start, timestamp_end]` are loaded and retrieved
+   *     (applicable only to reads).
+   * @param timestamp_end See *timestamp_start*.
    * @return
    */
   Status array_open(
       const URI& array_uri,
       QueryType query_type,
       const ArraySchema** array_schema,
-      std::vector<FragmentMetadata*>* fragment_metadata);
+      std::vector<FragmentMetadata*>* fragment_metadata,
+      const std::vector<URI>* fragment_uris = nullptr,
+      uint64_t timestamp_start = 0,
+      uint64_t timestamp_end = UINT64_MAX);
 
   /**
    * Invokes in case an error occurs in array_open. It is a clean-up function.
    */
-  Status array_open_error(OpenArray* open_array);
+  Status array_open_error(OpenArray* open_array, QueryType query_type);
 
   /**
    * Starts listening to async queries.
@@ -654,10 +920,107 @@ class StorageManager {
    */
   void async_process_queries(int i);
 
+  /**
+   * Loads the consolidated fragment metadata of an array.
+   *
+   * @param array_uri The array URI.
+   * @param consolidated The consolidated fragment metadata to be loaded.
+   * @param found Set to `true` if the array has consolidated fragment
+   *     metadata.
+   * @return Status
+   */
+  Status consolidated_fragment_metadata_load(
+      const URI& array_uri,
+      ConsolidatedFragmentMetadata* consolidated,
+      bool* found);
+
+  /**
+   * Removes from the input fragment URIs those with timestamps outside
+   * `[timestamp_start, timestamp_end]`, preserving the order of the rest.
+   */
+  void filter_fragment_uris(
+      std::vector<URI>* fragment_uris,
+      uint64_t timestamp_start,
+      uint64_t timestamp_end) const;
+
+  /**
+   * Appends records to the fragment manifest of an array. If the manifest
+   * does not exist (e.g., the array was created by an older version), it is
+   * first seeded with the fragments found by listing the array directory.
+   *
+   * @param array_uri The array URI.
+   * @param records The serialized records to append.
+   * @return Status
+   */
+  Status fragment_manifest_append(
+      const URI& array_uri, const std::string& records);
+
+  /**
+   * Appends records to a fragment manifest stored in parts, i.e., on an
+   * object store, by writing them as a new part. The parts are then
+   * compacted into one on a best-effort basis.
+   *
+   * @param array_uri The array URI.
+   * @param records The serialized records to append.
+   * @return Status
+   */
+  Status fragment_manifest_append_part(
+      const URI& array_uri, const std::string& records);
+
+  /**
+   * Loads the fragment manifest of an array.
+   *
+   * @param array_uri The array URI.
+   * @param manifest The manifest to be loaded.
+   * @param found Set to `true` if the array has a manifest.
+   * @return Status
+   */
+  Status fragment_manifest_load(
+      const URI& array_uri, FragmentManifest* manifest, bool* found) const;
+
+  /** Returns a new unique URI for a part of a fragment manifest. */
+  URI fragment_manifest_part_uri(const URI& array_uri) const;
+
+  /**
+   * Reads a fragment manifest file (or part).
+   *
+   * @param uri The URI of the file.
+   * @param contents The contents to be retrieved.
+   * @return Status
+   */
+  Status fragment_manifest_read(const URI& uri, std::string* contents) const;
+
+  /**
+   * Retrieves the records seeding the fragment manifest of an array that
+   * does not have one, i.e., one per fragment in the array directory.
+   *
+   * @param array_uri The array URI.
+   * @param records The serialized records to be retrieved.
+   * @return Status
+   */
+  Status fragment_manifest_seed(
+      const URI& array_uri, std::string* records) const;
+
   /** Retrieves all the fragment URI's of an array. */
   Status get_fragment_uris(
       const URI& array_uri, std::vector<URI>* fragment_uris) const;
 
+  /**
+   * Retrieves the URI's of the fragments of an array that are recorded in
+   * the fragment manifest and still exist, listing the array directory once.
+   * The deleted fragments and the fragments without a record, which are
+   * not committed, are skipped.
+   *
+   * @param array_uri The array URI.
+   * @param manifest The fragment manifest of the array.
+   * @param fragment_uris The retrieved fragment URIs.
+   * @return Status
+   */
+  Status get_fragment_uris(
+      const URI& array_uri,
+      const FragmentManifest& manifest,
+      std::vector<URI>* fragment_uris) const;
+
   /** Retrieves an open array entry for the given array URI. */
   Status open_array_get_entry(const URI& array_uri, OpenArray** open_array);
 
@@ -665,9 +1028,39 @@ class StorageManager {
   Status open_array_load_array_schema(
       const URI& array_uri, OpenArray* open_array);
 
-  /** Retrieves the fragment metadata of an open array for a given subarray. */
+  /**
+   * Retrieves the fragment metadata of an open array. The fragments are
+   * taken from the fragment manifest of the array, without listing the
+   * array directory. The directory is listed only if the manifest is
+   * missing, in which case every entry is probed, or if a fragment in the
+   * manifest cannot be loaded. Only the fragments with timestamps in
+   * `[timestamp_start, timestamp_end]` are retrieved.
+   */
+  Status open_array_load_fragment_metadata(
+      OpenArray* open_array,
+      std::vector<FragmentMetadata*>* fragment_metadata,
+      uint64_t timestamp_start,
+      uint64_t timestamp_end);
+
+  /**
+   * Retrieves the fragment metadata of the input fragments of an open array.
+   * The metadata of the fragments that are not already loaded is taken from
+   * the consolidated fragment metadata of the array, if it exists, and is
+   * otherwise read from each fragment.
+   *
+   * @param open_array The open array.
+   * @param fragment_uris The fragment URIs, sorted by timestamp.
+   * @param manifest The fragment manifest providing the fragment types. If
+   *     it is `nullptr` or it does not record a fragment, the type is
+   *     determined by probing the fragment.
+   * @param fragment_metadata The retrieved fragment metadata.
+   * @return Status
+   */
   Status open_array_load_fragment_metadata(
-      OpenArray* open_array, std::vector<FragmentMetadata*>* fragment_metadata);
+      OpenArray* open_array,
+      const std::vector<URI>& fragment_uris,
+      const FragmentManifest* manifest,
+      std::vector<FragmentMetadata*>* fragment_metadata);
 
   /**
    * Sorts the input fragment URIs in ascending timestamp order, breaking
@@ -155,12 +155,27 @@ class Tile {
    */
   void disown_buff();
 
+  /**
+   * Returns `true` if the tile holds variable-sized values that are
+   * dictionary-encoded in storage.
+   */
+  bool dict_encoded() const;
+
   /** Returns the number of dimensions (0 if this is an attribute tile). */
   unsigned int dim_num() const;
 
   /** Checks if the tile is empty. */
   bool empty() const;
 
+  /** Returns the filters of the tile, or `nullptr` if there are none. */
+  const FilterPipeline* filters() const;
+
+  /**
+   * Returns `true` if the tile is compressed or filtered upon writes, i.e.,
+   * if it is not stored verbatim.
+   */
+  bool filtered() const;
+
   /** Checks if the tile is full. */
   bool full() const;
 
@@ -179,6 +194,15 @@ class Tile {
   /** Resets the tile size. */
   void reset_size();
 
+  /** Sets whether the tile values are dictionary-encoded in storage. */
+  void set_dict_encoded(bool dict_encoded);
+
+  /**
+   * Sets the filters that run on the tile data prior to compression. The
+   * pipeline is not owned by the tile and must outlive it.
+   */
+  void set_filters(const FilterPipeline* filters);
+
   /** Sets the tile offset. */
   void set_offset(uint64_t offset);
 
@@ -191,8 +215,12 @@ class Tile {
   /**
    * Splits the coordinates such that all the values of each dimension
    * appear contiguously in the buffer.
+   *
+   * @param scratch Holds a copy of the tile during the split. It grows as
+   *     needed, so that reusing it across tiles avoids allocations.
+   * @return Status
    */
-  void split_coordinates();
+  Status split_coordinates(Buffer* scratch);
 
   /** Returns *true* if the tile stores coordinates. */
   bool stores_coords() const;
@@ -232,8 +260,12 @@ class Tile {
   /**
    * Zips the coordinate values such that a cell's coordinates across
    * all dimensions appear contiguously in the buffer.
+   *
+   * @param scratch Holds a copy of the tile during the zip. It grows as
+   *     needed, so that reusing it across tiles avoids allocations.
+   * @return Status
    */
-  void zip_coordinates();
+  Status zip_coordinates(Buffer* scratch);
 
  private:
   /* ********************************* */
@@ -252,12 +284,18 @@ class Tile {
   /** The compression level. */
   int compression_level_;
 
+  /** Whether the tile values are dictionary-encoded in storage. */
+  bool dict_encoded_;
+
   /**
    * The number of dimensions, in case the tile stores coordinates. It is 0
    * in case the tile stores attributes.
    */
   unsigned int dim_num_;
 
+  /** The filters of the tile, or `nullptr` if there are none. */
+  const FilterPipeline* filters_;
+
   /**
    * If *true* the tile object will delete *buff* upon
    * destruction, otherwise it will not delete it.
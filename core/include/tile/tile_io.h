@@ -33,10 +33,13 @@
 #ifndef TILEDB_TILE_IO_H
 #define TILEDB_TILE_IO_H
 
+#include "stats.h"
 #include "storage_manager.h"
 #include "tile.h"
 #include "uri.h"
 
+#include <vector>
+
 namespace tiledb {
 
 class StorageManager;
@@ -65,8 +68,14 @@ class TileIO {
    * @param storage_manager The storage manager.
    * @param uri The name of the file that stores data.
    * @param file_size The size of the file pointed by `uri`.
+   * @param stats The stats to record the tile reads in. If `nullptr`, the
+   *     stats of the storage manager are used.
    */
-  TileIO(StorageManager* storage_manager, const URI& uri, uint64_t file_size);
+  TileIO(
+      StorageManager* storage_manager,
+      const URI& uri,
+      uint64_t file_size,
+      Stats* stats = nullptr);
 
   /** Destructor. */
   ~TileIO();
@@ -168,9 +177,39 @@ class TileIO {
    */
   Buffer* buffer_;
 
+  /** The storage read bandwidth (in bytes/sec) weighed by `AUTO`. */
+  uint64_t auto_bandwidth_;
+
+  /**
+   * The compressors `AUTO` picks from, parsed from the configuration upon
+   * the first adaptively compressed tile.
+   */
+  std::vector<Compressor> auto_candidates_;
+
+  /** Holds a copy of a coordinates tile being split or zipped. */
+  Buffer* coords_scratch_;
+
+  /** Holds the dictionary-encoded values of a tile being decoded. */
+  Buffer* dict_buffer_;
+
+  /** Holds a copy of the chunk being filtered upon writes. */
+  Buffer* filter_buffer_;
+
+  /** Temporary space used by the filters. */
+  Buffer* filter_scratch_;
+
   /** The size of the file pointed by `uri_`. */
   uint64_t file_size_;
 
+  /** The stats the tile reads are recorded in. */
+  Stats* stats_;
+
+  /** Holds a sample compressed by an `AUTO` candidate. */
+  Buffer* sample_buffer_;
+
+  /** Holds a sample decompressed by an `AUTO` candidate. */
+  Buffer* sample_scratch_;
+
   /** The storage manager object. */
   StorageManager* storage_manager_;
 
@@ -181,6 +220,23 @@ class TileIO {
   /*          PRIVATE METHODS          */
   /* ********************************* */
 
+  /**
+   * Compresses a chunk with the input compressor.
+   *
+   * @param compressor The compressor, which cannot be `AUTO`.
+   * @param level The compression level.
+   * @param tile The tile the chunk belongs to.
+   * @param input_buffer The chunk to be compressed.
+   * @param output_buffer The buffer the compressed chunk is appended to.
+   * @return Status
+   */
+  Status compress_chunk(
+      Compressor compressor,
+      int level,
+      Tile* tile,
+      ConstBuffer* input_buffer,
+      Buffer* output_buffer);
+
   /**
    * Compresses a tile. The compressed data are written in buffer_.
    * Note that a coordinates tile must be split into one tile per
@@ -193,7 +249,10 @@ class TileIO {
   Status compress_tile(Tile* tile);
 
   /**
-   * Compresses a single tile. The compressed data are written in buffer_.
+   * Compresses a single tile, in chunks. The tile filters (if any) run on
+   * each chunk prior to compression. The compressed data are written in
+   * buffer_. An `AUTO` tile is compressed with the compressor picked on
+   * its first chunk, which is recorded in the header of every chunk.
    *
    * @param tile The tile to be compressed.
    * @return Status
@@ -215,6 +274,21 @@ class TileIO {
       uint64_t* max_chunk_size,
       uint64_t* overhead);
 
+  /**
+   * Decompresses a chunk with the input compressor.
+   *
+   * @param compressor The compressor, which cannot be `AUTO`.
+   * @param tile The tile the chunk belongs to.
+   * @param input_buffer The chunk to be decompressed.
+   * @param output_buffer The buffer the decompressed chunk is appended to.
+   * @return Status
+   */
+  Status decompress_chunk(
+      Compressor compressor,
+      Tile* tile,
+      ConstBuffer* input_buffer,
+      Buffer* output_buffer);
+
   /**
    * Decompresses buffer_ into a tile.
    * Note that a coordinates tile was split into one tile per
@@ -227,7 +301,8 @@ class TileIO {
   Status decompress_tile(Tile* tile);
 
   /**
-   * Decompresses buffer_ into a tile.
+   * Decompresses buffer_ into a tile, reverting the tile filters (if any)
+   * on each decompressed chunk.
    *
    * @param tile The tile where the decompressed data will be stored.
    * @return Status
@@ -236,6 +311,36 @@ class TileIO {
 
   /** Computes the compression overhead on *nbytes* of the input tile. */
   uint64_t overhead(Tile* tile, uint64_t nbytes) const;
+
+  /**
+   * Picks the compressor of an `AUTO` tile among the configured candidates
+   * that support the tile type. Each candidate compresses a sample of the
+   * chunk at its default level, and the one minimizing the sample size is
+   * picked. If a storage bandwidth is configured, the candidate minimizing
+   * the time to read and decompress the sample is picked instead.
+   *
+   * @param tile The tile to be compressed.
+   * @param chunk The first (filtered) chunk of the tile.
+   * @param chunk_size The size of the chunk.
+   * @param compressor The picked compressor. It is `NO_COMPRESSION` if no
+   *     candidate applies.
+   * @return Status
+   */
+  Status select_compressor(
+      Tile* tile,
+      const void* chunk,
+      uint64_t chunk_size,
+      Compressor* compressor);
+
+  /**
+   * Computes the overhead of the input compressor on *nbytes* of cells of
+   * size *cell_size*.
+   */
+  static uint64_t compressor_overhead(
+      Compressor compressor, uint64_t cell_size, uint64_t nbytes);
+
+  /** Returns `true` if `AUTO` may pick the compressor for the input type. */
+  static bool compressor_supports(Compressor compressor, Datatype type);
 };
 
 }  // namespace tiledb
@@ -0,0 +1,191 @@
+/**
+ * @file   tile_stats.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class TileStats.
+ */
+
+#ifndef TILEDB_TILE_STATS_H
+#define TILEDB_TILE_STATS_H
+
+#include "buffer.h"
+#include "const_buffer.h"
+#include "datatype.h"
+#include "status.h"
+
+#include <cinttypes>
+
+namespace tiledb {
+
+/**
+ * The statistics of the values of a tile of a fixed-sized attribute,
+ * namely their minimum, maximum, number and sum. In dense fragments, the
+ * values equal to the empty value of the attribute type (i.e., its maximum
+ * value, which is stored in the cells that were not written) are counted
+ * as nulls and are excluded from the other statistics. Sparse fragments
+ * store only written cells, so all their values are counted.
+ */
+class TileStats {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** Constructor. All statistics are zero. */
+  TileStats();
+
+  /** Destructor. */
+  ~TileStats() = default;
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Computes the statistics of the input values, replacing the current
+   * ones.
+   *
+   * @param type The type of the values.
+   * @param values The values.
+   * @param size The size of the values in bytes.
+   * @param dense `true` if the values belong to a dense fragment, in which
+   *     case the empty values are counted as nulls.
+   * @return Status
+   */
+  Status compute(
+      Datatype type, const void* values, uint64_t size, bool dense);
+
+  /** Returns the number of non-null values. */
+  uint64_t count() const;
+
+  /**
+   * Deserializes the statistics from the input buffer.
+   *
+   * @param buff The buffer to deserialize from.
+   * @return Status
+   */
+  Status deserialize(ConstBuffer* buff);
+
+  /**
+   * Returns `true` if the sum is maintained for the input type, which
+   * holds for all numeric types (i.e., all but `CHAR`).
+   */
+  static bool has_sum(Datatype type);
+
+  /**
+   * Returns the maximum non-null value, stored in the type of the values.
+   * It is meaningful only if `count()` is positive.
+   */
+  const void* max() const;
+
+  /**
+   * Merges the input statistics into these, so that they describe the
+   * values of both.
+   *
+   * @param type The type of the values.
+   * @param stats The statistics to merge.
+   * @return Status
+   */
+  Status merge(Datatype type, const TileStats& stats);
+
+  /**
+   * Returns the minimum non-null value, stored in the type of the values.
+   * It is meaningful only if `count()` is positive.
+   */
+  const void* min() const;
+
+  /** Returns the number of null values. */
+  uint64_t null_count() const;
+
+  /**
+   * Serializes the statistics into the input buffer.
+   *
+   * @param buff The buffer to serialize into.
+   * @return Status
+   */
+  Status serialize(Buffer* buff) const;
+
+  /**
+   * Returns the sum of the non-null values, stored as an `int64_t` for
+   * signed integer types, a `uint64_t` for unsigned integer types and a
+   * `double` for real types. Integer sums wrap around upon overflow.
+   */
+  const void* sum() const;
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The number of non-null values. */
+  uint64_t count_;
+
+  /** The maximum non-null value, in the type of the values. */
+  char max_[sizeof(uint64_t)];
+
+  /** The minimum non-null value, in the type of the values. */
+  char min_[sizeof(uint64_t)];
+
+  /** The number of null values. */
+  uint64_t null_count_;
+
+  /** The sum of the non-null values, in the sum type of the values. */
+  char sum_[sizeof(uint64_t)];
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /**
+   * Computes the statistics of the input values.
+   *
+   * @tparam T The type of the values.
+   * @tparam S The type of the sum.
+   * @param values The values.
+   * @param value_num The number of values.
+   * @param dense `true` if the empty values are counted as nulls.
+   * @return void
+   */
+  template <class T, class S>
+  void compute(const T* values, uint64_t value_num, bool dense);
+
+  /**
+   * Merges the input statistics into these.
+   *
+   * @tparam T The type of the values.
+   * @tparam S The type of the sum.
+   * @param stats The statistics to merge.
+   * @return void
+   */
+  template <class T, class S>
+  void merge(const TileStats& stats);
+};
+
+}  // namespace tiledb
+
+#endif  // TILEDB_TILE_STATS_H
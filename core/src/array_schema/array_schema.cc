@@ -272,6 +272,21 @@ Status ArraySchema::check() const {
         "Array schema check failed; Double delta compression can be used "
         "only with integer values"));
 
+  if (!check_bitpack_compressor())
+    return LOG_STATUS(Status::ArraySchemaError(
+        "Array schema check failed; Bit-packing compression can be used "
+        "only with integer values"));
+
+  if (!check_gorilla_compressor())
+    return LOG_STATUS(Status::ArraySchemaError(
+        "Array schema check failed; Gorilla compression can be used only "
+        "with real values"));
+
+  if (!check_dictionary_encoding())
+    return LOG_STATUS(Status::ArraySchemaError(
+        "Array schema check failed; Dictionary encoding can be used only "
+        "with variable-sized char attributes"));
+
   if (!check_attribute_dimension_names())
     return LOG_STATUS(
         Status::ArraySchemaError("Array schema check failed; Attributes "
@@ -542,7 +557,7 @@ Status ArraySchema::deserialize(ConstBuffer* buff, bool is_kv) {
   RETURN_NOT_OK(buff->read(&attribute_num_, sizeof(unsigned int)));
   for (unsigned int i = 0; i < attribute_num_; ++i) {
     auto attr = new Attribute();
-    attr->deserialize(buff);
+    RETURN_NOT_OK_ELSE(attr->deserialize(buff, version_), delete attr);
     attributes_.emplace_back(attr);
   }
 
@@ -667,7 +682,8 @@ Status ArraySchema::set_domain(Domain* domain) {
   // Potentially change the default coordinates compressor
   if ((domain_->type() == Datatype::FLOAT32 ||
        domain_->type() == Datatype::FLOAT64) &&
-      coords_compression_ == Compressor::DOUBLE_DELTA)
+      (coords_compression_ == Compressor::DOUBLE_DELTA ||
+       coords_compression_ == Compressor::BITPACK))
     coords_compression_ = constants::real_coords_compression;
 
   return Status::Ok();
@@ -691,6 +707,34 @@ bool ArraySchema::check_attribute_dimension_names() const {
   return (names.size() == attribute_num_ + dim_num);
 }
 
+bool ArraySchema::check_bitpack_compressor() const {
+  // Check coordinates
+  if ((domain_->type() == Datatype::FLOAT32 ||
+       domain_->type() == Datatype::FLOAT64) &&
+      coords_compression_ == Compressor::BITPACK)
+    return false;
+
+  // Check attributes
+  for (auto attr : attributes_) {
+    if ((attr->type() == Datatype::FLOAT32 ||
+         attr->type() == Datatype::FLOAT64) &&
+        attr->compressor() == Compressor::BITPACK)
+      return false;
+  }
+
+  return true;
+}
+
+bool ArraySchema::check_dictionary_encoding() const {
+  for (auto attr : attributes_) {
+    if (attr->dictionary_encoding() &&
+        (attr->type() != Datatype::CHAR || !attr->var_size()))
+      return false;
+  }
+
+  return true;
+}
+
 bool ArraySchema::check_double_delta_compressor() const {
   // Check coordinates
   if ((domain_->type() == Datatype::FLOAT32 ||
@@ -709,6 +753,24 @@ bool ArraySchema::check_double_delta_compressor() const {
   return true;
 }
 
+bool ArraySchema::check_gorilla_compressor() const {
+  // Check coordinates
+  if (domain_->type() != Datatype::FLOAT32 &&
+      domain_->type() != Datatype::FLOAT64 &&
+      coords_compression_ == Compressor::GORILLA)
+    return false;
+
+  // Check attributes
+  for (auto attr : attributes_) {
+    if (attr->type() != Datatype::FLOAT32 &&
+        attr->type() != Datatype::FLOAT64 &&
+        attr->compressor() == Compressor::GORILLA)
+      return false;
+  }
+
+  return true;
+}
+
 void ArraySchema::clear() {
   array_uri_ = URI();
   array_type_ = ArrayType::DENSE;
@@ -34,6 +34,7 @@
 #include "const_buffer.h"
 #include "utils.h"
 
+#include <algorithm>
 #include <cassert>
 
 namespace tiledb {
@@ -56,6 +57,7 @@ Attribute::Attribute(const char* name, Datatype type) {
   cell_val_num_ = 1;
   compressor_ = Compressor::NO_COMPRESSION;
   compression_level_ = -1;
+  dictionary_encoding_ = false;
 }
 
 Attribute::Attribute(const Attribute* attr) {
@@ -66,6 +68,8 @@ Attribute::Attribute(const Attribute* attr) {
   cell_val_num_ = attr->cell_val_num();
   compressor_ = attr->compressor();
   compression_level_ = attr->compression_level();
+  filters_ = *attr->filters();
+  dictionary_encoding_ = attr->dictionary_encoding();
 }
 
 Attribute::~Attribute() = default;
@@ -74,6 +78,10 @@ Attribute::~Attribute() = default;
 /*                API                */
 /* ********************************* */
 
+void Attribute::add_filter(FilterType type) {
+  filters_.add_filter(type);
+}
+
 uint64_t Attribute::cell_size() const {
   if (var_size())
     return constants::var_size;
@@ -85,6 +93,10 @@ unsigned int Attribute::cell_val_num() const {
   return cell_val_num_;
 }
 
+void Attribute::clear_filters() {
+  filters_.clear();
+}
+
 Compressor Attribute::compressor() const {
   return compressor_;
 }
@@ -100,7 +112,9 @@ int Attribute::compression_level() const {
 // compressor (char)
 // compression_level (int)
 // cell_val_num (unsigned int)
-Status Attribute::deserialize(ConstBuffer* buff) {
+// filter_pipeline - only from version 1.3.0
+// dictionary_encoding (char) - only from version 1.3.0
+Status Attribute::deserialize(ConstBuffer* buff, const int* version) {
   // Load attribute name
   unsigned int attribute_name_size;
   RETURN_NOT_OK(buff->read(&attribute_name_size, sizeof(unsigned int)));
@@ -121,9 +135,34 @@ Status Attribute::deserialize(ConstBuffer* buff) {
   // Load cell_val_num_
   RETURN_NOT_OK(buff->read(&cell_val_num_, sizeof(unsigned int)));
 
+  // Load filters, absent from older schemas
+  filters_.clear();
+  if (!std::lexicographical_compare(
+          version,
+          version + 3,
+          constants::filters_version,
+          constants::filters_version + 3))
+    RETURN_NOT_OK(filters_.deserialize(buff));
+
+  // Load dictionary encoding, absent from older schemas
+  dictionary_encoding_ = false;
+  if (!std::lexicographical_compare(
+          version,
+          version + 3,
+          constants::dictionary_encoding_version,
+          constants::dictionary_encoding_version + 3)) {
+    char dictionary_encoding;
+    RETURN_NOT_OK(buff->read(&dictionary_encoding, sizeof(char)));
+    dictionary_encoding_ = (dictionary_encoding != 0);
+  }
+
   return Status::Ok();
 }
 
+bool Attribute::dictionary_encoding() const {
+  return dictionary_encoding_;
+}
+
 void Attribute::dump(FILE* out) const {
   // Retrieve type and compressor strings
   const char* type_s = datatype_str(type_);
@@ -135,6 +174,10 @@ void Attribute::dump(FILE* out) const {
   fprintf(out, "- Type: %s\n", type_s);
   fprintf(out, "- Compressor: %s\n", compressor_s);
   fprintf(out, "- Compression level: %d\n", compression_level_);
+  if (!filters_.empty())
+    filters_.dump(out);
+  if (dictionary_encoding_)
+    fprintf(out, "- Dictionary encoding: true\n");
 
   if (!var_size())
     fprintf(out, "- Cell val num: %u\n", cell_val_num_);
@@ -142,6 +185,10 @@ void Attribute::dump(FILE* out) const {
     fprintf(out, "- Cell val num: var\n");
 }
 
+const FilterPipeline* Attribute::filters() const {
+  return &filters_;
+}
+
 const std::string& Attribute::name() const {
   return name_;
 }
@@ -158,6 +205,8 @@ bool Attribute::is_anonymous() const {
 // compressor (char)
 // compression_level (int)
 // cell_val_num (unsigned int)
+// filter_pipeline - only from version 1.3.0
+// dictionary_encoding (char) - only from version 1.3.0
 Status Attribute::serialize(Buffer* buff) {
   // Write attribute name
   auto attribute_name_size = (unsigned int)name_.size();
@@ -176,6 +225,13 @@ Status Attribute::serialize(Buffer* buff) {
   // Write cell_val_num_
   RETURN_NOT_OK(buff->write(&cell_val_num_, sizeof(unsigned int)));
 
+  // Write filters
+  RETURN_NOT_OK(filters_.serialize(buff));
+
+  // Write dictionary encoding
+  auto dictionary_encoding = (char)dictionary_encoding_;
+  RETURN_NOT_OK(buff->write(&dictionary_encoding, sizeof(char)));
+
   return Status::Ok();
 }
 
@@ -191,6 +247,10 @@ void Attribute::set_compression_level(int compression_level) {
   compression_level_ = compression_level;
 }
 
+void Attribute::set_dictionary_encoding(bool dictionary_encoding) {
+  dictionary_encoding_ = dictionary_encoding;
+}
+
 void Attribute::set_name(const std::string& name) {
   name_ = name;
 }
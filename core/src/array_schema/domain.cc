@@ -915,6 +915,10 @@ Datatype Domain::type() const {
 /* ****************************** */
 
 void Domain::compute_cell_num_per_tile() {
+  // Applicable only to integer domains
+  if (type_ == Datatype::FLOAT32 || type_ == Datatype::FLOAT64)
+    return;
+
   // Invoke the proper templated function
   switch (type_) {
     case Datatype::INT32:
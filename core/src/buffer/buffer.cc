@@ -65,6 +65,14 @@ Buffer::Buffer(void* data, uint64_t size, bool owns_data)
   owns_data_ = false;
 }
 
+Buffer::Buffer(void* data, uint64_t alloced_size)
+    : alloced_size_(alloced_size)
+    , data_(data) {
+  offset_ = 0;
+  owns_data_ = false;
+  size_ = 0;
+}
+
 Buffer::~Buffer() {
   clear();
 }
@@ -132,6 +140,8 @@ Status Buffer::read(void* buffer, uint64_t nbytes) {
 
 Status Buffer::realloc(uint64_t nbytes) {
   if (!owns_data_) {
+    if (nbytes <= alloced_size_)
+      return Status::Ok();
     return LOG_STATUS(Status::BufferError(
         "Cannot reallocate buffer; Buffer does not own data"));
   }
@@ -176,8 +186,8 @@ uint64_t Buffer::size() const {
 }
 
 Status Buffer::write(ConstBuffer* buff) {
-  // Sanity check
-  if (!owns_data_)
+  // Sanity check - non-owned memory is writable only within its capacity
+  if (!owns_data_ && alloced_size_ == 0)
     return LOG_STATUS(Status::BufferError(
         "Cannot write to buffer; Buffer does not own the already stored data"));
 
@@ -193,8 +203,8 @@ Status Buffer::write(ConstBuffer* buff) {
 }
 
 Status Buffer::write(ConstBuffer* buff, uint64_t nbytes) {
-  // Sanity check
-  if (!owns_data_)
+  // Sanity check - non-owned memory is writable only within its capacity
+  if (!owns_data_ && alloced_size_ == 0)
     return LOG_STATUS(Status::BufferError(
         "Cannot write to buffer; Buffer does not own the already stored data"));
 
@@ -209,8 +219,8 @@ Status Buffer::write(ConstBuffer* buff, uint64_t nbytes) {
 }
 
 Status Buffer::write(const void* buffer, uint64_t nbytes) {
-  // Sanity check
-  if (!owns_data_)
+  // Sanity check - non-owned memory is writable only within its capacity
+  if (!owns_data_ && alloced_size_ == 0)
     return LOG_STATUS(Status::BufferError(
         "Cannot write to buffer; Buffer does not own the already stored data"));
 
@@ -225,8 +235,8 @@ Status Buffer::write(const void* buffer, uint64_t nbytes) {
 }
 
 Status Buffer::write_with_shift(ConstBuffer* buff, uint64_t offset) {
-  // Sanity check
-  if (!owns_data_)
+  // Sanity check - non-owned memory is writable only within its capacity
+  if (!owns_data_ && alloced_size_ == 0)
     return LOG_STATUS(Status::BufferError(
         "Cannot write to buffer; Buffer does not own the already stored data"));
 
@@ -39,6 +39,7 @@
 #include "kv_iter.h"
 #include "logger.h"
 #include "query.h"
+#include "query_iter.h"
 #include "utils.h"
 
 #include <map>
@@ -113,6 +114,11 @@ struct tiledb_domain_t {
 
 struct tiledb_query_t {
   tiledb::Query* query_;
+  std::string stats_json_;
+};
+
+struct tiledb_query_iter_t {
+  tiledb::QueryIter* query_iter_;
 };
 
 struct tiledb_kv_schema_t {
@@ -286,6 +292,17 @@ inline int sanity_check(tiledb_ctx_t* ctx, const tiledb_query_t* query) {
   return TILEDB_OK;
 }
 
+inline int sanity_check(
+    tiledb_ctx_t* ctx, const tiledb_query_iter_t* query_iter) {
+  if (query_iter == nullptr || query_iter->query_iter_ == nullptr) {
+    auto st = tiledb::Status::Error("Invalid TileDB query iterator object");
+    LOG_STATUS(st);
+    save_error(ctx, st);
+    return TILEDB_ERR;
+  }
+  return TILEDB_OK;
+}
+
 inline int sanity_check(
     tiledb_ctx_t* ctx, const tiledb_kv_schema_t* kv_schema) {
   if (kv_schema == nullptr || kv_schema->array_schema_ == nullptr) {
@@ -684,6 +701,30 @@ int tiledb_ctx_is_supported_fs(
   return TILEDB_OK;
 }
 
+int tiledb_ctx_stats_dump(tiledb_ctx_t* ctx, FILE* out) {
+  if (sanity_check(ctx) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  auto json = ctx->storage_manager_->stats()->to_json();
+  if (fputs(json.c_str(), out) == EOF) {
+    auto st = tiledb::Status::Error("Cannot dump stats; Write failed");
+    LOG_STATUS(st);
+    save_error(ctx, st);
+    return TILEDB_ERR;
+  }
+
+  return TILEDB_OK;
+}
+
+int tiledb_ctx_stats_reset(tiledb_ctx_t* ctx) {
+  if (sanity_check(ctx) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  ctx->storage_manager_->stats()->reset();
+
+  return TILEDB_OK;
+}
+
 /* ****************************** */
 /*              GROUP             */
 /* ****************************** */
@@ -804,6 +845,79 @@ int tiledb_attribute_get_compressor(
   return TILEDB_OK;
 }
 
+int tiledb_attribute_add_filter(
+    tiledb_ctx_t* ctx, tiledb_attribute_t* attr, tiledb_filter_type_t filter) {
+  if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, attr) == TILEDB_ERR)
+    return TILEDB_ERR;
+  if (filter < TILEDB_FILTER_BYTESHUFFLE ||
+      filter > TILEDB_FILTER_DOUBLE_DELTA) {
+    auto st = tiledb::Status::FilterPipelineError(
+        "Cannot add filter to attribute; Invalid filter type");
+    LOG_STATUS(st);
+    save_error(ctx, st);
+    return TILEDB_ERR;
+  }
+  attr->attr_->add_filter(static_cast<tiledb::FilterType>(filter));
+  return TILEDB_OK;
+}
+
+int tiledb_attribute_clear_filters(
+    tiledb_ctx_t* ctx, tiledb_attribute_t* attr) {
+  if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, attr) == TILEDB_ERR)
+    return TILEDB_ERR;
+  attr->attr_->clear_filters();
+  return TILEDB_OK;
+}
+
+int tiledb_attribute_get_filter_num(
+    tiledb_ctx_t* ctx,
+    const tiledb_attribute_t* attr,
+    unsigned int* filter_num) {
+  if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, attr) == TILEDB_ERR)
+    return TILEDB_ERR;
+  *filter_num = attr->attr_->filters()->filter_num();
+  return TILEDB_OK;
+}
+
+int tiledb_attribute_get_filter_from_index(
+    tiledb_ctx_t* ctx,
+    const tiledb_attribute_t* attr,
+    unsigned int index,
+    tiledb_filter_type_t* filter) {
+  if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, attr) == TILEDB_ERR)
+    return TILEDB_ERR;
+  auto filters = attr->attr_->filters();
+  if (index >= filters->filter_num()) {
+    std::ostringstream errmsg;
+    errmsg << "Filter " << index << " out of bounds, attribute has "
+           << filters->filter_num() << " filters";
+    auto st = tiledb::Status::FilterPipelineError(errmsg.str());
+    LOG_STATUS(st);
+    save_error(ctx, st);
+    return TILEDB_ERR;
+  }
+  *filter = static_cast<tiledb_filter_type_t>(filters->filter(index));
+  return TILEDB_OK;
+}
+
+int tiledb_attribute_set_dictionary_encoding(
+    tiledb_ctx_t* ctx, tiledb_attribute_t* attr, int dictionary_encoding) {
+  if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, attr) == TILEDB_ERR)
+    return TILEDB_ERR;
+  attr->attr_->set_dictionary_encoding(dictionary_encoding != 0);
+  return TILEDB_OK;
+}
+
+int tiledb_attribute_get_dictionary_encoding(
+    tiledb_ctx_t* ctx,
+    const tiledb_attribute_t* attr,
+    int* dictionary_encoding) {
+  if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, attr) == TILEDB_ERR)
+    return TILEDB_ERR;
+  *dictionary_encoding = attr->attr_->dictionary_encoding() ? 1 : 0;
+  return TILEDB_OK;
+}
+
 int tiledb_attribute_get_cell_val_num(
     tiledb_ctx_t* ctx,
     const tiledb_attribute_t* attr,
@@ -1518,6 +1632,17 @@ int tiledb_query_create(
     tiledb_query_t** query,
     const char* array_uri,
     tiledb_query_type_t type) {
+  return tiledb_query_create_with_timestamp_range(
+      ctx, query, array_uri, type, 0, UINT64_MAX);
+}
+
+int tiledb_query_create_with_timestamp_range(
+    tiledb_ctx_t* ctx,
+    tiledb_query_t** query,
+    const char* array_uri,
+    tiledb_query_type_t type,
+    uint64_t timestamp_start,
+    uint64_t timestamp_end) {
   // Sanity check
   if (sanity_check(ctx) == TILEDB_ERR)
     return TILEDB_ERR;
@@ -1548,7 +1673,9 @@ int tiledb_query_create(
           ctx->storage_manager_->query_init(
               ((*query)->query_),
               array_uri,
-              static_cast<tiledb::QueryType>(type)))) {
+              static_cast<tiledb::QueryType>(type),
+              timestamp_start,
+              timestamp_end))) {
     delete (*query)->query_;
     delete *query;
     return TILEDB_ERR;
@@ -1606,6 +1733,26 @@ int tiledb_query_set_layout(
   return TILEDB_OK;
 }
 
+int tiledb_query_add_condition(
+    tiledb_ctx_t* ctx,
+    tiledb_query_t* query,
+    const char* attribute,
+    tiledb_query_condition_op_t op,
+    const void* value) {
+  // Sanity check
+  if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, query) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  // Add condition
+  if (save_error(
+          ctx,
+          query->query_->add_condition(
+              attribute, static_cast<tiledb::QueryConditionOp>(op), value)))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
 int tiledb_query_free(tiledb_ctx_t* ctx, tiledb_query_t* query) {
   // Trivial case
   if (query == nullptr)
@@ -1709,6 +1856,158 @@ int tiledb_query_get_attribute_status(
   return TILEDB_OK;
 }
 
+int tiledb_query_get_stats(
+    tiledb_ctx_t* ctx, tiledb_query_t* query, const char** stats_json) {
+  // Sanity check
+  if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, query) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  query->stats_json_ = query->query_->stats()->to_json();
+  *stats_json = query->stats_json_.c_str();
+
+  return TILEDB_OK;
+}
+
+/* ****************************** */
+/*            QUERY ITER          */
+/* ****************************** */
+
+int tiledb_query_iter_create(
+    tiledb_ctx_t* ctx,
+    tiledb_query_iter_t** query_iter,
+    const char* array_uri,
+    const void* subarray,
+    const char** attributes,
+    unsigned int attribute_num,
+    tiledb_layout_t layout) {
+  if (sanity_check(ctx) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  // Create QueryIter struct
+  *query_iter = new (std::nothrow) tiledb_query_iter_t;
+  if (*query_iter == nullptr) {
+    tiledb::Status st = tiledb::Status::Error(
+        "Failed to allocate TileDB query iterator object");
+    LOG_STATUS(st);
+    save_error(ctx, st);
+    return TILEDB_OOM;
+  }
+
+  // Create QueryIter object
+  (*query_iter)->query_iter_ =
+      new (std::nothrow) tiledb::QueryIter(ctx->storage_manager_);
+  if ((*query_iter)->query_iter_ == nullptr) {
+    tiledb::Status st = tiledb::Status::Error(
+        "Failed to allocate TileDB query iterator object");
+    LOG_STATUS(st);
+    save_error(ctx, st);
+    delete *query_iter;
+    return TILEDB_OOM;
+  }
+
+  // Initialize QueryIter object
+  if (save_error(
+          ctx,
+          (*query_iter)
+              ->query_iter_->init(
+                  array_uri,
+                  subarray,
+                  attributes,
+                  attribute_num,
+                  static_cast<tiledb::Layout>(layout)))) {
+    (*query_iter)->query_iter_->finalize();
+    delete (*query_iter)->query_iter_;
+    delete *query_iter;
+    return TILEDB_ERR;
+  }
+
+  // Success
+  return TILEDB_OK;
+}
+
+int tiledb_query_iter_free(tiledb_ctx_t* ctx, tiledb_query_iter_t* query_iter) {
+  // Trivial case
+  if (query_iter == nullptr)
+    return TILEDB_OK;
+
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, query_iter) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  int rc = TILEDB_OK;
+  if (save_error(ctx, query_iter->query_iter_->finalize()))
+    rc = TILEDB_ERR;
+
+  delete query_iter->query_iter_;
+  delete query_iter;
+
+  return rc;
+}
+
+int tiledb_query_iter_next(tiledb_ctx_t* ctx, tiledb_query_iter_t* query_iter) {
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, query_iter) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  if (save_error(ctx, query_iter->query_iter_->next()))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
+int tiledb_query_iter_done(
+    tiledb_ctx_t* ctx, tiledb_query_iter_t* query_iter, int* done) {
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, query_iter) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  *done = query_iter->query_iter_->done();
+
+  return TILEDB_OK;
+}
+
+int tiledb_query_iter_get_buffer(
+    tiledb_ctx_t* ctx,
+    tiledb_query_iter_t* query_iter,
+    const char* attribute,
+    void** buffer,
+    uint64_t* buffer_size) {
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, query_iter) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  if (save_error(
+          ctx, query_iter->query_iter_->buffer(attribute, buffer, buffer_size)))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
+int tiledb_query_iter_get_buffer_var(
+    tiledb_ctx_t* ctx,
+    tiledb_query_iter_t* query_iter,
+    const char* attribute,
+    uint64_t** buffer_off,
+    uint64_t* buffer_off_size,
+    void** buffer_val,
+    uint64_t* buffer_val_size) {
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, query_iter) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  if (save_error(
+          ctx,
+          query_iter->query_iter_->buffer_var(
+              attribute,
+              buffer_off,
+              buffer_off_size,
+              buffer_val,
+              buffer_val_size)))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
 /* ****************************** */
 /*              ARRAY             */
 /* ****************************** */
@@ -1753,6 +2052,77 @@ int tiledb_array_consolidate(tiledb_ctx_t* ctx, const char* array_uri) {
   return TILEDB_OK;
 }
 
+int tiledb_array_consolidate_with_progress(
+    tiledb_ctx_t* ctx,
+    const char* array_uri,
+    void (*callback)(uint64_t, uint64_t, void*),
+    void* callback_data) {
+  // Sanity checks
+  if (sanity_check(ctx) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  if (save_error(
+          ctx,
+          ctx->storage_manager_->array_consolidate(
+              array_uri, callback, callback_data)))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
+int tiledb_array_consolidate_metadata(
+    tiledb_ctx_t* ctx, const char* array_uri) {
+  // Sanity checks
+  if (sanity_check(ctx) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  if (save_error(
+          ctx, ctx->storage_manager_->array_consolidate_metadata(array_uri)))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
+int tiledb_array_get_attribute_stats(
+    tiledb_ctx_t* ctx,
+    const char* array_uri,
+    const char* attribute_name,
+    void* min,
+    void* max,
+    void* sum,
+    uint64_t* count,
+    uint64_t* null_count,
+    int* has_stats) {
+  if (sanity_check(ctx) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  tiledb::TileStats stats;
+  tiledb::Datatype type;
+  bool has_stats_b;
+
+  if (save_error(
+          ctx,
+          ctx->storage_manager_->array_get_attribute_stats(
+              array_uri, attribute_name, &stats, &type, &has_stats_b)))
+    return TILEDB_ERR;
+
+  *has_stats = (int)has_stats_b;
+  if (!has_stats_b)
+    return TILEDB_OK;
+
+  auto value_size = tiledb::datatype_size(type);
+  if (min != nullptr && stats.count() != 0)
+    std::memcpy(min, stats.min(), value_size);
+  if (max != nullptr && stats.count() != 0)
+    std::memcpy(max, stats.max(), value_size);
+  if (sum != nullptr && tiledb::TileStats::has_sum(type))
+    std::memcpy(sum, stats.sum(), sizeof(uint64_t));
+  *count = stats.count();
+  *null_count = stats.null_count();
+
+  return TILEDB_OK;
+}
+
 int tiledb_array_get_non_empty_domain(
     tiledb_ctx_t* ctx, const char* array_uri, void* domain, int* is_empty) {
   if (sanity_check(ctx) == TILEDB_ERR)
@@ -1790,6 +2160,31 @@ int tiledb_array_compute_max_read_buffer_sizes(
   return TILEDB_OK;
 }
 
+int tiledb_array_compute_est_read_buffer_sizes(
+    tiledb_ctx_t* ctx,
+    const char* array_uri,
+    const void* subarray,
+    const char** attributes,
+    unsigned attribute_num,
+    uint64_t* est_buffer_sizes,
+    uint64_t* max_buffer_sizes) {
+  if (sanity_check(ctx) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  if (save_error(
+          ctx,
+          ctx->storage_manager_->array_compute_est_read_buffer_sizes(
+              array_uri,
+              subarray,
+              attributes,
+              attribute_num,
+              est_buffer_sizes,
+              max_buffer_sizes)))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
 /* ****************************** */
 /*         OBJECT MANAGEMENT      */
 /* ****************************** */
@@ -2329,6 +2724,54 @@ int tiledb_kv_get_item(
   return TILEDB_OK;
 }
 
+int tiledb_kv_get_items(
+    tiledb_ctx_t* ctx,
+    tiledb_kv_t* kv,
+    tiledb_kv_item_t** kv_items,
+    const void** keys,
+    const tiledb_datatype_t* key_types,
+    const uint64_t* key_sizes,
+    unsigned key_num) {
+  if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, kv) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  // Get items from the key-value store
+  std::vector<tiledb::Datatype> types(key_num);
+  for (unsigned i = 0; i < key_num; ++i)
+    types[i] = static_cast<tiledb::Datatype>(key_types[i]);
+  std::vector<tiledb::KVItem*> items(key_num);
+  if (save_error(
+          ctx,
+          kv->kv_->get_items(
+              keys, types.data(), key_sizes, key_num, items.data())))
+    return TILEDB_ERR;
+
+  // Wrap the found items
+  for (unsigned i = 0; i < key_num; ++i) {
+    kv_items[i] = nullptr;
+    if (items[i] == nullptr)
+      continue;
+    kv_items[i] = new (std::nothrow) tiledb_kv_item_t;
+    if (kv_items[i] == nullptr) {
+      for (unsigned j = 0; j < i; ++j)
+        tiledb_kv_item_free(ctx, kv_items[j]);
+      for (unsigned j = i; j < key_num; ++j) {
+        delete items[j];
+        kv_items[j] = nullptr;
+      }
+      tiledb::Status st = tiledb::Status::Error(
+          "Failed to allocate TileDB key-value item object");
+      LOG_STATUS(st);
+      save_error(ctx, st);
+      return TILEDB_OOM;
+    }
+    kv_items[i]->kv_item_ = items[i];
+  }
+
+  // Success
+  return TILEDB_OK;
+}
+
 /* ****************************** */
 /*             KEY-VALUE          */
 /* ****************************** */
@@ -2371,6 +2814,17 @@ int tiledb_kv_consolidate(tiledb_ctx_t* ctx, const char* kv_uri) {
   return TILEDB_OK;
 }
 
+int tiledb_kv_consolidate_metadata(tiledb_ctx_t* ctx, const char* kv_uri) {
+  if (sanity_check(ctx) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  if (save_error(
+          ctx, ctx->storage_manager_->array_consolidate_metadata(kv_uri)))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
 int tiledb_kv_set_max_items(
     tiledb_ctx_t* ctx, tiledb_kv_t* kv, uint64_t max_items) {
   if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, kv) == TILEDB_ERR)
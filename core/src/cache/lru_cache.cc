@@ -46,11 +46,13 @@ namespace tiledb {
 LRUCache::LRUCache(
     uint64_t max_size,
     void *(*evict_callback)(LRUCacheItem *, void *),
-    void *evict_callback_data) {
+    void *evict_callback_data,
+    Stats *stats) {
   evict_callback_ = evict_callback;
   evict_callback_data_ = evict_callback_data;
   max_size_ = max_size;
   size_ = 0;
+  stats_ = stats;
 }
 
 LRUCache::~LRUCache() {
@@ -230,6 +232,9 @@ void LRUCache::evict() {
   item_map_.erase(item.key_);
   size_ -= item.size_;
   item_ll_.pop_front();
+
+  if (stats_ != nullptr)
+    stats_->add(Stats::Counter::TILE_CACHE_EVICT_NUM, 1);
 }
 
 }  // namespace tiledb
\ No newline at end of file
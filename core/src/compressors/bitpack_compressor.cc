@@ -0,0 +1,462 @@
+/**
+ * @file   bitpack_compressor.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements the frame-of-reference bit-packing compressor.
+ */
+
+#include "bitpack_compressor.h"
+#include "logger.h"
+
+#include <cstring>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace tiledb {
+
+const uint64_t BitPack::OVERHEAD = 17;
+
+/* ****************************** */
+/*          LANE KERNELS          */
+/* ****************************** */
+
+namespace {
+
+/** The number of lanes a block of offsets is distributed to. */
+const unsigned int LANE_NUM = 4;
+
+/** Portable implementation of the operations on 4 lanes of words. */
+template <class W>
+struct ScalarLanes {
+  W v_[LANE_NUM];
+
+  static ScalarLanes load(const char* p) {
+    ScalarLanes r;
+    std::memcpy(r.v_, p, sizeof(r.v_));
+    return r;
+  }
+
+  static ScalarLanes set1(W w) {
+    ScalarLanes r;
+    for (unsigned int i = 0; i < LANE_NUM; ++i)
+      r.v_[i] = w;
+    return r;
+  }
+
+  void store(char* p) const {
+    std::memcpy(p, v_, sizeof(v_));
+  }
+
+  ScalarLanes operator|(const ScalarLanes& o) const {
+    ScalarLanes r;
+    for (unsigned int i = 0; i < LANE_NUM; ++i)
+      r.v_[i] = v_[i] | o.v_[i];
+    return r;
+  }
+
+  ScalarLanes operator&(const ScalarLanes& o) const {
+    ScalarLanes r;
+    for (unsigned int i = 0; i < LANE_NUM; ++i)
+      r.v_[i] = v_[i] & o.v_[i];
+    return r;
+  }
+
+  ScalarLanes operator<<(unsigned int n) const {
+    ScalarLanes r;
+    for (unsigned int i = 0; i < LANE_NUM; ++i)
+      r.v_[i] = v_[i] << n;
+    return r;
+  }
+
+  ScalarLanes operator>>(unsigned int n) const {
+    ScalarLanes r;
+    for (unsigned int i = 0; i < LANE_NUM; ++i)
+      r.v_[i] = v_[i] >> n;
+    return r;
+  }
+};
+
+#if defined(__SSE2__)
+
+/** SSE2 implementation of the operations on 4 lanes of 32-bit words. */
+struct Sse2Lanes32 {
+  __m128i v_;
+
+  static Sse2Lanes32 load(const char* p) {
+    return {_mm_loadu_si128((const __m128i*)p)};
+  }
+
+  static Sse2Lanes32 set1(uint32_t w) {
+    return {_mm_set1_epi32((int)w)};
+  }
+
+  void store(char* p) const {
+    _mm_storeu_si128((__m128i*)p, v_);
+  }
+
+  Sse2Lanes32 operator|(const Sse2Lanes32& o) const {
+    return {_mm_or_si128(v_, o.v_)};
+  }
+
+  Sse2Lanes32 operator&(const Sse2Lanes32& o) const {
+    return {_mm_and_si128(v_, o.v_)};
+  }
+
+  Sse2Lanes32 operator<<(unsigned int n) const {
+    return {_mm_sll_epi32(v_, _mm_cvtsi32_si128((int)n))};
+  }
+
+  Sse2Lanes32 operator>>(unsigned int n) const {
+    return {_mm_srl_epi32(v_, _mm_cvtsi32_si128((int)n))};
+  }
+};
+
+/** SSE2 implementation of the operations on 4 lanes of 64-bit words. */
+struct Sse2Lanes64 {
+  __m128i lo_;
+  __m128i hi_;
+
+  static Sse2Lanes64 load(const char* p) {
+    return {_mm_loadu_si128((const __m128i*)p),
+            _mm_loadu_si128((const __m128i*)(p + 16))};
+  }
+
+  static Sse2Lanes64 set1(uint64_t w) {
+    return {_mm_set1_epi64x((long long)w), _mm_set1_epi64x((long long)w)};
+  }
+
+  void store(char* p) const {
+    _mm_storeu_si128((__m128i*)p, lo_);
+    _mm_storeu_si128((__m128i*)(p + 16), hi_);
+  }
+
+  Sse2Lanes64 operator|(const Sse2Lanes64& o) const {
+    return {_mm_or_si128(lo_, o.lo_), _mm_or_si128(hi_, o.hi_)};
+  }
+
+  Sse2Lanes64 operator&(const Sse2Lanes64& o) const {
+    return {_mm_and_si128(lo_, o.lo_), _mm_and_si128(hi_, o.hi_)};
+  }
+
+  Sse2Lanes64 operator<<(unsigned int n) const {
+    auto c = _mm_cvtsi32_si128((int)n);
+    return {_mm_sll_epi64(lo_, c), _mm_sll_epi64(hi_, c)};
+  }
+
+  Sse2Lanes64 operator>>(unsigned int n) const {
+    auto c = _mm_cvtsi32_si128((int)n);
+    return {_mm_srl_epi64(lo_, c), _mm_srl_epi64(hi_, c)};
+  }
+};
+
+template <class W>
+struct SimdLanes {
+  typedef ScalarLanes<W> type;
+};
+
+template <>
+struct SimdLanes<uint32_t> {
+  typedef Sse2Lanes32 type;
+};
+
+template <>
+struct SimdLanes<uint64_t> {
+  typedef Sse2Lanes64 type;
+};
+
+#else
+
+template <class W>
+struct SimdLanes {
+  typedef ScalarLanes<W> type;
+};
+
+#endif
+
+/**
+ * Packs the offsets of a block one word of every lane at a time. All
+ * lanes are shifted by the same amount, so the 4 lanes are processed
+ * as a single vector.
+ */
+template <class W, class L>
+void pack_lanes(const W* in, unsigned int bitwidth, char* out) {
+  const unsigned int word_bits = sizeof(W) * 8;
+  auto acc = L::set1(0);
+  unsigned int shift = 0;
+  for (unsigned int j = 0; j < word_bits; ++j) {
+    auto v = L::load((const char*)(in + LANE_NUM * j));
+    acc = acc | (v << shift);
+    shift += bitwidth;
+    if (shift >= word_bits) {
+      acc.store(out);
+      out += LANE_NUM * sizeof(W);
+      shift -= word_bits;
+      acc = (shift > 0) ? (v >> (bitwidth - shift)) : L::set1(0);
+    }
+  }
+}
+
+/** Reverses `pack_lanes`. */
+template <class W, class L>
+void unpack_lanes(const char* in, unsigned int bitwidth, W* out) {
+  const unsigned int word_bits = sizeof(W) * 8;
+  auto mask = L::set1(
+      (bitwidth == word_bits) ? ~W(0) : (W)((W(1) << bitwidth) - 1));
+  auto cur = L::load(in);
+  in += LANE_NUM * sizeof(W);
+  unsigned int shift = 0;
+  for (unsigned int j = 0; j < word_bits; ++j) {
+    auto v = cur >> shift;
+    shift += bitwidth;
+    if (shift >= word_bits) {
+      // The last offset of a block always ends at a word boundary
+      shift -= word_bits;
+      if (shift > 0 || j + 1 < word_bits) {
+        cur = L::load(in);
+        in += LANE_NUM * sizeof(W);
+      }
+      if (shift > 0)
+        v = v | (cur << (bitwidth - shift));
+    }
+    (v & mask).store((char*)(out + LANE_NUM * j));
+  }
+}
+
+}  // namespace
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+Status BitPack::compress(
+    Datatype type, ConstBuffer* input_buffer, Buffer* output_buffer) {
+  switch (type) {
+    case Datatype::CHAR:
+      return BitPack::compress<char, uint32_t>(input_buffer, output_buffer);
+    case Datatype::INT8:
+      return BitPack::compress<int8_t, uint32_t>(input_buffer, output_buffer);
+    case Datatype::UINT8:
+      return BitPack::compress<uint8_t, uint32_t>(input_buffer, output_buffer);
+    case Datatype::INT16:
+      return BitPack::compress<int16_t, uint32_t>(input_buffer, output_buffer);
+    case Datatype::UINT16:
+      return BitPack::compress<uint16_t, uint32_t>(
+          input_buffer, output_buffer);
+    case Datatype::INT32:
+      return BitPack::compress<int, uint32_t>(input_buffer, output_buffer);
+    case Datatype::UINT32:
+      return BitPack::compress<uint32_t, uint32_t>(
+          input_buffer, output_buffer);
+    case Datatype::INT64:
+      return BitPack::compress<int64_t, uint64_t>(input_buffer, output_buffer);
+    case Datatype::UINT64:
+      return BitPack::compress<uint64_t, uint64_t>(
+          input_buffer, output_buffer);
+    default:
+      return LOG_STATUS(Status::CompressionError(
+          "Cannot compress tile with BitPack; Not supported datatype"));
+  }
+}
+
+Status BitPack::decompress(
+    Datatype type, ConstBuffer* input_buffer, Buffer* output_buffer) {
+  switch (type) {
+    case Datatype::CHAR:
+      return BitPack::decompress<char, uint32_t>(input_buffer, output_buffer);
+    case Datatype::INT8:
+      return BitPack::decompress<int8_t, uint32_t>(
+          input_buffer, output_buffer);
+    case Datatype::UINT8:
+      return BitPack::decompress<uint8_t, uint32_t>(
+          input_buffer, output_buffer);
+    case Datatype::INT16:
+      return BitPack::decompress<int16_t, uint32_t>(
+          input_buffer, output_buffer);
+    case Datatype::UINT16:
+      return BitPack::decompress<uint16_t, uint32_t>(
+          input_buffer, output_buffer);
+    case Datatype::INT32:
+      return BitPack::decompress<int, uint32_t>(input_buffer, output_buffer);
+    case Datatype::UINT32:
+      return BitPack::decompress<uint32_t, uint32_t>(
+          input_buffer, output_buffer);
+    case Datatype::INT64:
+      return BitPack::decompress<int64_t, uint64_t>(
+          input_buffer, output_buffer);
+    case Datatype::UINT64:
+      return BitPack::decompress<uint64_t, uint64_t>(
+          input_buffer, output_buffer);
+    default:
+      return LOG_STATUS(Status::CompressionError(
+          "Cannot decompress tile with BitPack; Not supported datatype"));
+  }
+}
+
+uint64_t BitPack::overhead(uint64_t nbytes) {
+  // The packed values never take more space than the input
+  (void)nbytes;
+  return BitPack::OVERHEAD;
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+template <class T, class W>
+Status BitPack::compress(ConstBuffer* input_buffer, Buffer* output_buffer) {
+  typedef typename std::make_unsigned<T>::type U;
+  uint64_t value_size = sizeof(T);
+  if (input_buffer->size() % value_size != 0)
+    return LOG_STATUS(Status::CompressionError(
+        "Cannot compress with BitPack; Input size is not a multiple of the "
+        "value size"));
+
+  // Find the frame of reference and the bit width of the offsets
+  uint64_t num = input_buffer->size() / value_size;
+  auto in = (const T*)input_buffer->data();
+  T min = (num > 0) ? in[0] : T(0);
+  T max = min;
+  for (uint64_t i = 1; i < num; ++i) {
+    min = (in[i] < min) ? in[i] : min;
+    max = (in[i] > max) ? in[i] : max;
+  }
+  auto range = (uint64_t)(U)((U)max - (U)min);
+  uint8_t bitwidth = 0;
+  for (; range != 0; range >>= 1)
+    ++bitwidth;
+
+  // Write header
+  auto min_bits = (uint64_t)(U)min;
+  RETURN_NOT_OK(output_buffer->write(&bitwidth, sizeof(uint8_t)));
+  RETURN_NOT_OK(output_buffer->write(&num, sizeof(uint64_t)));
+  RETURN_NOT_OK(output_buffer->write(&min_bits, sizeof(uint64_t)));
+
+  // Make room for the packed blocks and the tail
+  const uint64_t block_value_num = LANE_NUM * sizeof(W) * 8;
+  const uint64_t block_size = LANE_NUM * bitwidth * sizeof(W);
+  uint64_t block_num = num / block_value_num;
+  uint64_t tail_num = num - block_num * block_value_num;
+  uint64_t nbytes = block_num * block_size + tail_num * value_size;
+  if (output_buffer->offset() + nbytes > output_buffer->alloced_size())
+    RETURN_NOT_OK(output_buffer->realloc(output_buffer->offset() + nbytes));
+  auto out = (char*)output_buffer->cur_data();
+
+  // Pack the blocks
+  W offsets[block_value_num];
+  for (uint64_t b = 0; bitwidth > 0 && b < block_num; ++b) {
+    auto block_in = in + b * block_value_num;
+    for (uint64_t i = 0; i < block_value_num; ++i)
+      offsets[i] = (W)(U)((U)block_in[i] - (U)min);
+    pack_block<W>(offsets, bitwidth, out + b * block_size);
+  }
+
+  // Copy the tail
+  std::memcpy(
+      out + block_num * block_size,
+      in + block_num * block_value_num,
+      tail_num * value_size);
+
+  output_buffer->advance_size(nbytes);
+  output_buffer->advance_offset(nbytes);
+
+  return Status::Ok();
+}
+
+template <class T, class W>
+Status BitPack::decompress(ConstBuffer* input_buffer, Buffer* output_buffer) {
+  typedef typename std::make_unsigned<T>::type U;
+  uint64_t value_size = sizeof(T);
+
+  // Read header
+  uint8_t bitwidth = 0;
+  uint64_t num = 0;
+  uint64_t min_bits = 0;
+  RETURN_NOT_OK(input_buffer->read(&bitwidth, sizeof(uint8_t)));
+  RETURN_NOT_OK(input_buffer->read(&num, sizeof(uint64_t)));
+  RETURN_NOT_OK(input_buffer->read(&min_bits, sizeof(uint64_t)));
+  auto min = (U)min_bits;
+
+  // Check the packed size
+  const uint64_t block_value_num = LANE_NUM * sizeof(W) * 8;
+  const uint64_t block_size = LANE_NUM * bitwidth * sizeof(W);
+  uint64_t block_num = num / block_value_num;
+  uint64_t tail_num = num - block_num * block_value_num;
+  if (bitwidth > sizeof(T) * 8 ||
+      input_buffer->nbytes_left_to_read() !=
+          block_num * block_size + tail_num * value_size)
+    return LOG_STATUS(Status::CompressionError(
+        "Cannot decompress with BitPack; Invalid compressed data"));
+
+  // Make room for the values
+  uint64_t nbytes = num * value_size;
+  if (output_buffer->offset() + nbytes > output_buffer->alloced_size())
+    RETURN_NOT_OK(output_buffer->realloc(output_buffer->offset() + nbytes));
+  auto out = (T*)output_buffer->cur_data();
+  auto in = (const char*)input_buffer->data() + input_buffer->offset();
+
+  // Unpack the blocks
+  W offsets[block_value_num];
+  for (uint64_t b = 0; b < block_num; ++b) {
+    auto block_out = out + b * block_value_num;
+    if (bitwidth == 0) {
+      for (uint64_t i = 0; i < block_value_num; ++i)
+        block_out[i] = (T)min;
+      continue;
+    }
+    unpack_block<W>(in + b * block_size, bitwidth, offsets);
+    for (uint64_t i = 0; i < block_value_num; ++i)
+      block_out[i] = (T)(U)((U)offsets[i] + min);
+  }
+
+  // Copy the tail
+  std::memcpy(
+      out + block_num * block_value_num,
+      in + block_num * block_size,
+      tail_num * value_size);
+
+  input_buffer->advance_offset(input_buffer->nbytes_left_to_read());
+  output_buffer->advance_size(nbytes);
+  output_buffer->advance_offset(nbytes);
+
+  return Status::Ok();
+}
+
+template <class W>
+void BitPack::pack_block(const W* in, unsigned int bitwidth, char* out) {
+  pack_lanes<W, typename SimdLanes<W>::type>(in, bitwidth, out);
+}
+
+template <class W>
+void BitPack::unpack_block(const char* in, unsigned int bitwidth, W* out) {
+  unpack_lanes<W, typename SimdLanes<W>::type>(in, bitwidth, out);
+}
+
+}  // namespace tiledb
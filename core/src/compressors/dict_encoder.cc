@@ -0,0 +1,244 @@
+/**
+ * @file   dict_encoder.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements the dictionary encoder of variable-sized cells.
+ */
+
+#include "dict_encoder.h"
+#include "logger.h"
+
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace tiledb {
+
+namespace {
+
+/** Returns the FNV-1a hash of the input bytes. */
+inline uint64_t hash_bytes(const char* data, uint64_t size) {
+  uint64_t h = 14695981039346656037ULL;
+  for (uint64_t i = 0; i < size; ++i) {
+    h ^= (unsigned char)data[i];
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+/** Copies the codes, stored in `code_size` bytes each, into `codes`. */
+template <class C>
+void load_codes(const char* data, std::vector<uint32_t>* codes) {
+  C code;
+  for (uint64_t i = 0; i < codes->size(); ++i) {
+    std::memcpy(&code, data + i * sizeof(C), sizeof(C));
+    (*codes)[i] = code;
+  }
+}
+
+/** Stores the codes into `data`, in `sizeof(C)` bytes each. */
+template <class C>
+void store_codes(const std::vector<uint32_t>& codes, char* data) {
+  for (uint64_t i = 0; i < codes.size(); ++i) {
+    auto code = (C)codes[i];
+    std::memcpy(data + i * sizeof(C), &code, sizeof(C));
+  }
+}
+
+}  // namespace
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+Status DictEncoder::encode(
+    ConstBuffer* offsets_buffer,
+    ConstBuffer* values_buffer,
+    Buffer* output_buffer) {
+  // For easy reference
+  uint64_t cell_num = offsets_buffer->size() / sizeof(uint64_t);
+  auto offsets = (const uint64_t*)offsets_buffer->data();
+  auto values = (const char*)values_buffer->data();
+  uint64_t values_size = values_buffer->size();
+
+  // Find the distinct values, using an open-addressing hash table whose
+  // slots hold one plus the index of a dictionary entry (zero if empty)
+  std::vector<uint64_t> dict_starts;
+  std::vector<uint64_t> dict_sizes;
+  std::vector<uint32_t> codes(cell_num);
+  uint64_t dict_values_size = 0;
+  bool encode =
+      (cell_num > 0 && cell_num < std::numeric_limits<uint32_t>::max());
+  if (encode) {
+    uint64_t slot_num = 1;
+    while (slot_num < 2 * cell_num)
+      slot_num <<= 1;
+    std::vector<uint32_t> slots(slot_num, 0);
+    uint64_t base = offsets[0];
+    for (uint64_t i = 0; i < cell_num; ++i) {
+      uint64_t start = offsets[i] - base;
+      uint64_t end = (i + 1 < cell_num) ? offsets[i + 1] - base : values_size;
+      if (start > end || end > values_size)
+        return LOG_STATUS(Status::CompressionError(
+            "Cannot dictionary-encode tile; Invalid cell offsets"));
+      uint64_t size = end - start;
+
+      uint64_t slot = hash_bytes(values + start, size) & (slot_num - 1);
+      for (; slots[slot] != 0; slot = (slot + 1) & (slot_num - 1)) {
+        auto entry = slots[slot] - 1;
+        if (dict_sizes[entry] == size &&
+            !std::memcmp(values + dict_starts[entry], values + start, size))
+          break;
+      }
+      if (slots[slot] == 0) {
+        slots[slot] = (uint32_t)dict_starts.size() + 1;
+        dict_starts.push_back(start);
+        dict_sizes.push_back(size);
+        dict_values_size += size;
+      }
+      codes[i] = slots[slot] - 1;
+    }
+  }
+
+  // Compute the encoded size and fall back to the plain values if the
+  // dictionary does not pay off
+  uint64_t dict_num = dict_starts.size();
+  uint8_t code_size = (dict_num <= 256) ? 1 : (dict_num <= 65536) ? 2 : 4;
+  uint64_t encoded_size = 1 + 3 * sizeof(uint64_t) + 1 +
+                          dict_num * sizeof(uint64_t) + dict_values_size +
+                          cell_num * code_size;
+  char flag = (encode && encoded_size < 1 + values_size) ? 1 : 0;
+  RETURN_NOT_OK(output_buffer->write(&flag, sizeof(char)));
+  if (flag == 0)
+    return output_buffer->write(values, values_size);
+
+  // Write header
+  RETURN_NOT_OK(output_buffer->write(&cell_num, sizeof(uint64_t)));
+  RETURN_NOT_OK(output_buffer->write(&dict_num, sizeof(uint64_t)));
+  RETURN_NOT_OK(output_buffer->write(&code_size, sizeof(uint8_t)));
+  RETURN_NOT_OK(output_buffer->write(&dict_values_size, sizeof(uint64_t)));
+
+  // Write dictionary
+  uint64_t dict_offset = 0;
+  for (uint64_t e = 0; e < dict_num; ++e) {
+    RETURN_NOT_OK(output_buffer->write(&dict_offset, sizeof(uint64_t)));
+    dict_offset += dict_sizes[e];
+  }
+  for (uint64_t e = 0; e < dict_num; ++e)
+    RETURN_NOT_OK(output_buffer->write(values + dict_starts[e], dict_sizes[e]));
+
+  // Write codes
+  uint64_t codes_size = cell_num * code_size;
+  if (output_buffer->offset() + codes_size > output_buffer->alloced_size())
+    RETURN_NOT_OK(output_buffer->realloc(output_buffer->offset() + codes_size));
+  auto out = (char*)output_buffer->cur_data();
+  if (code_size == 1)
+    store_codes<uint8_t>(codes, out);
+  else if (code_size == 2)
+    store_codes<uint16_t>(codes, out);
+  else
+    store_codes<uint32_t>(codes, out);
+  output_buffer->advance_offset(codes_size);
+  output_buffer->set_size(output_buffer->offset());
+
+  return Status::Ok();
+}
+
+Status DictEncoder::decode(ConstBuffer* input_buffer, Buffer* output_buffer) {
+  // Plain values
+  char flag;
+  RETURN_NOT_OK(input_buffer->read(&flag, sizeof(char)));
+  if (flag == 0)
+    return output_buffer->write(
+        input_buffer, input_buffer->nbytes_left_to_read());
+
+  // Read header
+  uint64_t cell_num, dict_num, dict_values_size;
+  uint8_t code_size;
+  RETURN_NOT_OK(input_buffer->read(&cell_num, sizeof(uint64_t)));
+  RETURN_NOT_OK(input_buffer->read(&dict_num, sizeof(uint64_t)));
+  RETURN_NOT_OK(input_buffer->read(&code_size, sizeof(uint8_t)));
+  RETURN_NOT_OK(input_buffer->read(&dict_values_size, sizeof(uint64_t)));
+  uint64_t left = input_buffer->nbytes_left_to_read();
+  if (flag != 1 || (code_size != 1 && code_size != 2 && code_size != 4) ||
+      dict_num > left / sizeof(uint64_t) || cell_num > left / code_size ||
+      dict_num * sizeof(uint64_t) + dict_values_size + cell_num * code_size !=
+          left)
+    return LOG_STATUS(Status::CompressionError(
+        "Cannot decode dictionary-encoded tile; Invalid encoded data"));
+
+  // Read dictionary
+  std::vector<uint64_t> dict_offsets(dict_num + 1);
+  RETURN_NOT_OK(
+      input_buffer->read(&dict_offsets[0], dict_num * sizeof(uint64_t)));
+
+  dict_offsets[dict_num] = dict_values_size;
+  for (uint64_t e = 0; e < dict_num; ++e) {
+    if (dict_offsets[e] > dict_offsets[e + 1])
+      return LOG_STATUS(Status::CompressionError(
+          "Cannot decode dictionary-encoded tile; Invalid dictionary"));
+  }
+  auto dict_values = (const char*)input_buffer->data() + input_buffer->offset();
+  input_buffer->advance_offset(dict_values_size);
+
+  // Read codes
+  std::vector<uint32_t> codes(cell_num);
+  auto codes_data = (const char*)input_buffer->data() + input_buffer->offset();
+  if (code_size == 1)
+    load_codes<uint8_t>(codes_data, &codes);
+  else if (code_size == 2)
+    load_codes<uint16_t>(codes_data, &codes);
+  else
+    load_codes<uint32_t>(codes_data, &codes);
+  input_buffer->advance_offset(cell_num * code_size);
+
+  // Compute the decoded size
+  uint64_t nbytes = 0;
+  for (auto code : codes) {
+    if (code >= dict_num)
+      return LOG_STATUS(Status::CompressionError(
+          "Cannot decode dictionary-encoded tile; Invalid code"));
+    nbytes += dict_offsets[code + 1] - dict_offsets[code];
+  }
+
+  // Decode
+  if (output_buffer->offset() + nbytes > output_buffer->alloced_size())
+    RETURN_NOT_OK(output_buffer->realloc(output_buffer->offset() + nbytes));
+  auto out = (char*)output_buffer->cur_data();
+  for (auto code : codes) {
+    uint64_t size = dict_offsets[code + 1] - dict_offsets[code];
+    std::memcpy(out, dict_values + dict_offsets[code], size);
+    out += size;
+  }
+  output_buffer->advance_offset(nbytes);
+  output_buffer->set_size(output_buffer->offset());
+
+  return Status::Ok();
+}
+
+}  // namespace tiledb
@@ -0,0 +1,341 @@
+/**
+ * @file   gorilla_compressor.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements the XOR (Gorilla) compressor for real values.
+ */
+
+#include "gorilla_compressor.h"
+#include "logger.h"
+
+#include <cstring>
+
+namespace tiledb {
+
+const uint64_t Gorilla::OVERHEAD = 8;
+
+/* ****************************** */
+/*           BIT STREAMS          */
+/* ****************************** */
+
+namespace {
+
+/** Returns the number of leading zeros of a non-zero value. */
+template <class U>
+inline unsigned int leading_zeros(U x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return (unsigned int)__builtin_clzll((uint64_t)x) -
+         (64 - 8 * (unsigned int)sizeof(U));
+#else
+  unsigned int n = 0;
+  for (U mask = U(1) << (8 * sizeof(U) - 1); !(x & mask); mask >>= 1)
+    ++n;
+  return n;
+#endif
+}
+
+/** Returns the number of trailing zeros of a non-zero value. */
+template <class U>
+inline unsigned int trailing_zeros(U x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return (unsigned int)__builtin_ctzll((uint64_t)x);
+#else
+  unsigned int n = 0;
+  for (; !(x & 1); x >>= 1)
+    ++n;
+  return n;
+#endif
+}
+
+/** Writes bits into 64-bit words, starting from the most significant bit. */
+class BitWriter {
+ public:
+  explicit BitWriter(char* out)
+      : acc_(0)
+      , bit_num_(0)
+      , out_(out) {
+  }
+
+  /** Writes the low `n` bits of `v`, where `n` is in [0, 64]. */
+  void write(uint64_t v, unsigned int n) {
+    if (bit_num_ + n <= 64) {
+      acc_ = (n == 64) ? v : ((acc_ << n) | v);
+      bit_num_ += n;
+      if (bit_num_ == 64)
+        flush();
+    } else {
+      unsigned int rest = bit_num_ + n - 64;
+      acc_ = (acc_ << (64 - bit_num_)) | (v >> rest);
+      flush();
+      acc_ = v & ((uint64_t(1) << rest) - 1);
+      bit_num_ = rest;
+    }
+  }
+
+  /** Writes the last partial word and returns the end of the output. */
+  char* finish() {
+    if (bit_num_ > 0) {
+      acc_ <<= 64 - bit_num_;
+      flush();
+    }
+    return out_;
+  }
+
+ private:
+  uint64_t acc_;
+  unsigned int bit_num_;
+  char* out_;
+
+  void flush() {
+    std::memcpy(out_, &acc_, sizeof(uint64_t));
+    out_ += sizeof(uint64_t);
+    acc_ = 0;
+    bit_num_ = 0;
+  }
+};
+
+/** Reads the bits written by a BitWriter. */
+class BitReader {
+ public:
+  BitReader(const char* in, const char* end)
+      : cur_(0)
+      , bit_num_(0)
+      , end_(end)
+      , in_(in) {
+  }
+
+  /**
+   * Reads `n` bits into the low bits of `v`, where `n` is in [0, 64].
+   * Returns `false` if the input is exhausted.
+   */
+  bool read(unsigned int n, uint64_t* v) {
+    if (n <= bit_num_) {
+      *v = (n == 0) ? 0 : (cur_ >> (64 - n));
+      cur_ = (n == 64) ? 0 : (cur_ << n);
+      bit_num_ -= n;
+      return true;
+    }
+
+    // Take the remaining bits of the current word and refill
+    unsigned int rest = n - bit_num_;
+    uint64_t hi = (bit_num_ == 0) ? 0 : (cur_ >> (64 - bit_num_));
+    if (in_ + sizeof(uint64_t) > end_)
+      return false;
+    std::memcpy(&cur_, in_, sizeof(uint64_t));
+    in_ += sizeof(uint64_t);
+    bit_num_ = 64;
+    uint64_t lo;
+    read(rest, &lo);
+    *v = (rest == 64) ? lo : ((hi << rest) | lo);
+    return true;
+  }
+
+ private:
+  uint64_t cur_;
+  unsigned int bit_num_;
+  const char* end_;
+  const char* in_;
+};
+
+}  // namespace
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+Status Gorilla::compress(
+    Datatype type, ConstBuffer* input_buffer, Buffer* output_buffer) {
+  switch (type) {
+    case Datatype::FLOAT32:
+      return Gorilla::compress<uint32_t>(input_buffer, output_buffer);
+    case Datatype::FLOAT64:
+      return Gorilla::compress<uint64_t>(input_buffer, output_buffer);
+    default:
+      return LOG_STATUS(Status::CompressionError(
+          "Cannot compress tile with Gorilla; Not supported datatype"));
+  }
+}
+
+Status Gorilla::decompress(
+    Datatype type, ConstBuffer* input_buffer, Buffer* output_buffer) {
+  switch (type) {
+    case Datatype::FLOAT32:
+      return Gorilla::decompress<uint32_t>(input_buffer, output_buffer);
+    case Datatype::FLOAT64:
+      return Gorilla::decompress<uint64_t>(input_buffer, output_buffer);
+    default:
+      return LOG_STATUS(Status::CompressionError(
+          "Cannot decompress tile with Gorilla; Not supported datatype"));
+  }
+}
+
+uint64_t Gorilla::overhead(uint64_t nbytes) {
+  // Every float32 value after the first takes at most 12 extra bits,
+  // plus a potential partially filled last word
+  return Gorilla::OVERHEAD + sizeof(uint64_t) + (nbytes * 3 + 7) / 8;
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+template <class U>
+Status Gorilla::compress(ConstBuffer* input_buffer, Buffer* output_buffer) {
+  const unsigned int value_bits = 8 * sizeof(U);
+  const unsigned int len_bits = (sizeof(U) == 4) ? 5 : 6;
+  uint64_t value_size = sizeof(U);
+  if (input_buffer->size() % value_size != 0)
+    return LOG_STATUS(Status::CompressionError(
+        "Cannot compress with Gorilla; Input size is not a multiple of the "
+        "value size"));
+
+  // Write number of values
+  uint64_t num = input_buffer->size() / value_size;
+  RETURN_NOT_OK(output_buffer->write(&num, sizeof(uint64_t)));
+  if (num == 0)
+    return Status::Ok();
+
+  // Make room for the worst case
+  uint64_t max_nbytes =
+      input_buffer->size() + overhead(input_buffer->size()) - OVERHEAD;
+  if (output_buffer->offset() + max_nbytes > output_buffer->alloced_size())
+    RETURN_NOT_OK(
+        output_buffer->realloc(output_buffer->offset() + max_nbytes));
+
+  // Write the first value as is
+  auto in = (const char*)input_buffer->data();
+  auto out = (char*)output_buffer->cur_data();
+  BitWriter writer(out);
+  U prev;
+  std::memcpy(&prev, in, value_size);
+  writer.write(prev, value_bits);
+
+  // Write the XOR of every value with the previous one
+  unsigned int window_lead = value_bits;
+  unsigned int window_trail = 0;
+  for (uint64_t i = 1; i < num; ++i) {
+    U cur;
+    std::memcpy(&cur, in + i * value_size, value_size);
+    U x = cur ^ prev;
+    prev = cur;
+    if (x == 0) {
+      writer.write(0, 1);
+      continue;
+    }
+
+    unsigned int lead = leading_zeros(x);
+    unsigned int trail = trailing_zeros(x);
+    if (lead >= window_lead && trail >= window_trail) {
+      // Reuse the previous window
+      writer.write(2, 2);
+      writer.write(
+          x >> window_trail, value_bits - window_lead - window_trail);
+    } else {
+      unsigned int len = value_bits - lead - trail;
+      writer.write(3, 2);
+      writer.write(lead, len_bits);
+      writer.write(len - 1, len_bits);
+      writer.write(x >> trail, len);
+      window_lead = lead;
+      window_trail = trail;
+    }
+  }
+
+  uint64_t nbytes = writer.finish() - out;
+  output_buffer->advance_size(nbytes);
+  output_buffer->advance_offset(nbytes);
+
+  return Status::Ok();
+}
+
+template <class U>
+Status Gorilla::decompress(ConstBuffer* input_buffer, Buffer* output_buffer) {
+  const unsigned int value_bits = 8 * sizeof(U);
+  const unsigned int len_bits = (sizeof(U) == 4) ? 5 : 6;
+  uint64_t value_size = sizeof(U);
+
+  // Read number of values
+  uint64_t num = 0;
+  RETURN_NOT_OK(input_buffer->read(&num, sizeof(uint64_t)));
+  if (num == 0)
+    return Status::Ok();
+
+  // Make room for the values
+  uint64_t nbytes = num * value_size;
+  if (output_buffer->offset() + nbytes > output_buffer->alloced_size())
+    RETURN_NOT_OK(output_buffer->realloc(output_buffer->offset() + nbytes));
+  auto out = (char*)output_buffer->cur_data();
+  auto in = (const char*)input_buffer->data() + input_buffer->offset();
+  BitReader reader(in, in + input_buffer->nbytes_left_to_read());
+
+  // Read the first value
+  uint64_t bits;
+  bool ok = reader.read(value_bits, &bits);
+  auto prev = (U)bits;
+  if (ok)
+    std::memcpy(out, &prev, value_size);
+
+  // Reconstruct the rest of the values from their XOR
+  unsigned int window_lead = value_bits;
+  unsigned int window_trail = 0;
+  for (uint64_t i = 1; ok && i < num; ++i) {
+    uint64_t ctrl;
+    ok = reader.read(1, &ctrl);
+    if (ok && ctrl != 0) {
+      ok = reader.read(1, &ctrl);
+      if (ok && ctrl != 0) {
+        // New window
+        uint64_t lead, len;
+        ok = reader.read(len_bits, &lead) && reader.read(len_bits, &len);
+        ok = ok && (lead + len + 1 <= value_bits);
+        if (ok) {
+          window_lead = (unsigned int)lead;
+          window_trail = value_bits - window_lead - (unsigned int)len - 1;
+        }
+      } else if (ok) {
+        ok = (window_lead < value_bits);
+      }
+      uint64_t x = 0;
+      ok = ok && reader.read(value_bits - window_lead - window_trail, &x);
+      prev ^= (U)(x << window_trail);
+    }
+    std::memcpy(out + i * value_size, &prev, value_size);
+  }
+
+  if (!ok)
+    return LOG_STATUS(Status::CompressionError(
+        "Cannot decompress with Gorilla; Invalid compressed data"));
+
+  input_buffer->advance_offset(input_buffer->nbytes_left_to_read());
+  output_buffer->advance_size(nbytes);
+  output_buffer->advance_offset(nbytes);
+
+  return Status::Ok();
+}
+
+}  // namespace tiledb
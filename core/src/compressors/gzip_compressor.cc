@@ -38,6 +38,35 @@
 
 namespace tiledb {
 
+namespace {
+
+/**
+ * The zlib streams of a thread, initialized upon first use and reset by all
+ * subsequent (de)compressions of the thread.
+ */
+struct GZipStreams {
+  /** The deflate stream. */
+  z_stream deflate_strm_;
+  /** The level of the deflate stream, or -1 if it is not initialized. */
+  int deflate_level_ = -1;
+  /** The inflate stream. */
+  z_stream inflate_strm_;
+  /** `true` if the inflate stream is initialized. */
+  bool inflate_init_ = false;
+
+  ~GZipStreams() {
+    if (deflate_level_ >= 0)
+      (void)deflateEnd(&deflate_strm_);
+    if (inflate_init_)
+      (void)inflateEnd(&inflate_strm_);
+  }
+};
+
+/** The zlib streams of the calling thread. */
+thread_local GZipStreams gzip_streams;
+
+}  // namespace
+
 Status GZip::compress(
     int level, ConstBuffer* input_buffer, Buffer* output_buffer) {
   // Sanity check
@@ -46,35 +75,44 @@ Status GZip::compress(
         "Failed compressing with GZip; invalid buffer format"));
 
   int ret;
-  z_stream strm;
-
-  // Allocate deflate state
-  strm.zalloc = Z_NULL;
-  strm.zfree = Z_NULL;
-  strm.opaque = Z_NULL;
-  ret = deflateInit(&strm, level < 0 ? GZip::default_level() : level);
-
-  if (ret != Z_OK) {
-    (void)deflateEnd(&strm);
-    return LOG_STATUS(Status::GZipError("Cannot compress with GZIP"));
+  auto strm = &gzip_streams.deflate_strm_;
+  level = level < 0 ? GZip::default_level() : level;
+
+  // Allocate the deflate state of the thread, or reset it for reuse
+  if (gzip_streams.deflate_level_ < 0) {
+    strm->zalloc = Z_NULL;
+    strm->zfree = Z_NULL;
+    strm->opaque = Z_NULL;
+    ret = deflateInit(strm, level);
+    if (ret != Z_OK) {
+      (void)deflateEnd(strm);
+      return LOG_STATUS(Status::GZipError("Cannot compress with GZIP"));
+    }
+    gzip_streams.deflate_level_ = level;
+  } else {
+    ret = deflateReset(strm);
+    if (ret == Z_OK && level != gzip_streams.deflate_level_) {
+      ret = deflateParams(strm, level, Z_DEFAULT_STRATEGY);
+      if (ret == Z_OK)
+        gzip_streams.deflate_level_ = level;
+    }
+    if (ret != Z_OK)
+      return LOG_STATUS(Status::GZipError("Cannot compress with GZIP"));
   }
 
   // Compress
-  strm.next_in = (unsigned char*)input_buffer->data();
-  strm.next_out = (unsigned char*)output_buffer->cur_data();
-  strm.avail_in = (uInt)input_buffer->size();
-  strm.avail_out = (uInt)output_buffer->free_space();
-  ret = deflate(&strm, Z_FINISH);
-
-  // Clean up
-  (void)deflateEnd(&strm);
+  strm->next_in = (unsigned char*)input_buffer->data();
+  strm->next_out = (unsigned char*)output_buffer->cur_data();
+  strm->avail_in = (uInt)input_buffer->size();
+  strm->avail_out = (uInt)output_buffer->free_space();
+  ret = deflate(strm, Z_FINISH);
 
   // Return
-  if (ret == Z_STREAM_ERROR || strm.avail_in != 0)
+  if (ret == Z_STREAM_ERROR || strm->avail_in != 0)
     return LOG_STATUS(Status::GZipError("Cannot compress with GZIP"));
 
   // Set size of compressed data
-  uint64_t compressed_size = output_buffer->free_space() - strm.avail_out;
+  uint64_t compressed_size = output_buffer->free_space() - strm->avail_out;
   output_buffer->advance_size(compressed_size);
   output_buffer->advance_offset(compressed_size);
 
@@ -88,26 +126,29 @@ Status GZip::decompress(ConstBuffer* input_buffer, Buffer* output_buffer) {
         "Failed decompressing with GZip; invalid buffer format"));
 
   int ret;
-  z_stream strm;
-
-  // Allocate deflate state
-  strm.zalloc = Z_NULL;
-  strm.zfree = Z_NULL;
-  strm.opaque = Z_NULL;
-  strm.avail_in = 0;
-  strm.next_in = Z_NULL;
-  ret = inflateInit(&strm);
-
-  if (ret != Z_OK) {
+  auto strm = &gzip_streams.inflate_strm_;
+
+  // Allocate the inflate state of the thread, or reset it for reuse
+  if (!gzip_streams.inflate_init_) {
+    strm->zalloc = Z_NULL;
+    strm->zfree = Z_NULL;
+    strm->opaque = Z_NULL;
+    strm->avail_in = 0;
+    strm->next_in = Z_NULL;
+    ret = inflateInit(strm);
+    if (ret != Z_OK)
+      return LOG_STATUS(Status::GZipError("Cannot decompress with GZIP"));
+    gzip_streams.inflate_init_ = true;
+  } else if (inflateReset(strm) != Z_OK) {
     return LOG_STATUS(Status::GZipError("Cannot decompress with GZIP"));
   }
 
   // Decompress
-  strm.next_in = (unsigned char*)input_buffer->data();
-  strm.next_out = (unsigned char*)output_buffer->cur_data();
-  strm.avail_in = (uInt)input_buffer->size();
-  strm.avail_out = (uInt)output_buffer->free_space();
-  ret = inflate(&strm, Z_FINISH);
+  strm->next_in = (unsigned char*)input_buffer->data();
+  strm->next_out = (unsigned char*)output_buffer->cur_data();
+  strm->avail_in = (uInt)input_buffer->size();
+  strm->avail_out = (uInt)output_buffer->free_space();
+  ret = inflate(strm, Z_FINISH);
 
   if (ret != Z_STREAM_END) {
     return LOG_STATUS(
@@ -115,13 +156,10 @@ Status GZip::decompress(ConstBuffer* input_buffer, Buffer* output_buffer) {
   }
 
   // Set size of decompressed data
-  uint64_t compressed_size = output_buffer->free_space() - strm.avail_out;
+  uint64_t compressed_size = output_buffer->free_space() - strm->avail_out;
   output_buffer->advance_size(compressed_size);
   output_buffer->advance_offset(compressed_size);
 
-  // Clean up
-  (void)inflateEnd(&strm);
-
   // Success
   return Status::Ok();
 }
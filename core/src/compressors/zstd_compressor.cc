@@ -38,6 +38,29 @@
 
 namespace tiledb {
 
+namespace {
+
+/**
+ * The zstd contexts of a thread, created upon first use and reused by all
+ * subsequent (de)compressions of the thread.
+ */
+struct ZStdContexts {
+  /** The compression context. */
+  ZSTD_CCtx* cctx_ = nullptr;
+  /** The decompression context. */
+  ZSTD_DCtx* dctx_ = nullptr;
+
+  ~ZStdContexts() {
+    ZSTD_freeCCtx(cctx_);
+    ZSTD_freeDCtx(dctx_);
+  }
+};
+
+/** The zstd contexts of the calling thread. */
+thread_local ZStdContexts zstd_contexts;
+
+}  // namespace
+
 Status ZStd::compress(
     int level, ConstBuffer* input_buffer, Buffer* output_buffer) {
   // Sanity check
@@ -45,8 +68,15 @@ Status ZStd::compress(
     return LOG_STATUS(Status::CompressionError(
         "Failed compressing with ZStd; invalid buffer format"));
 
+  // Get the compression context of the thread
+  auto& cctx = zstd_contexts.cctx_;
+  if (cctx == nullptr && (cctx = ZSTD_createCCtx()) == nullptr)
+    return LOG_STATUS(Status::CompressionError(
+        "ZStd compression failed: Cannot create context"));
+
   // Compress
-  uint64_t zstd_ret = ZSTD_compress(
+  uint64_t zstd_ret = ZSTD_compressCCtx(
+      cctx,
       output_buffer->cur_data(),
       output_buffer->free_space(),
       input_buffer->data(),
@@ -73,8 +103,15 @@ Status ZStd::decompress(ConstBuffer* input_buffer, Buffer* output_buffer) {
     return LOG_STATUS(Status::CompressionError(
         "Failed decompressing with ZStd; invalid buffer format"));
 
+  // Get the decompression context of the thread
+  auto& dctx = zstd_contexts.dctx_;
+  if (dctx == nullptr && (dctx = ZSTD_createDCtx()) == nullptr)
+    return LOG_STATUS(Status::CompressionError(
+        "ZStd decompression failed: Cannot create context"));
+
   // Decompress
-  uint64_t zstd_ret = ZSTD_decompress(
+  uint64_t zstd_ret = ZSTD_decompressDCtx(
+      dctx,
       output_buffer->cur_data(),
       output_buffer->free_space(),
       input_buffer->data(),
@@ -0,0 +1,333 @@
+/**
+ * @file   filter_pipeline.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class FilterPipeline.
+ */
+
+#include "filter_pipeline.h"
+#include "logger.h"
+
+#include <cassert>
+#include <cstring>
+
+namespace tiledb {
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+void FilterPipeline::add_filter(FilterType type) {
+  filters_.push_back(type);
+}
+
+void FilterPipeline::clear() {
+  filters_.clear();
+}
+
+// ===== FORMAT =====
+// filter_num (unsigned int)
+// filter #1 (char)
+// filter #2 (char)
+// ...
+Status FilterPipeline::deserialize(ConstBuffer* buff) {
+  filters_.clear();
+
+  unsigned int filter_num;
+  RETURN_NOT_OK(buff->read(&filter_num, sizeof(unsigned int)));
+  for (unsigned int i = 0; i < filter_num; ++i) {
+    char filter;
+    RETURN_NOT_OK(buff->read(&filter, sizeof(char)));
+    if ((unsigned char)filter > (unsigned char)FilterType::FILTER_DOUBLE_DELTA)
+      return LOG_STATUS(Status::FilterPipelineError(
+          "Cannot deserialize filter pipeline; Invalid filter type"));
+    filters_.push_back((FilterType)filter);
+  }
+
+  return Status::Ok();
+}
+
+void FilterPipeline::dump(FILE* out) const {
+  fprintf(out, "- Filters: ");
+  for (size_t i = 0; i < filters_.size(); ++i)
+    fprintf(out, "%s%s", (i == 0) ? "" : ", ", filter_type_str(filters_[i]));
+  fprintf(out, "\n");
+}
+
+bool FilterPipeline::empty() const {
+  return filters_.empty();
+}
+
+FilterType FilterPipeline::filter(unsigned int index) const {
+  assert(index < filters_.size());
+  return filters_[index];
+}
+
+unsigned int FilterPipeline::filter_num() const {
+  return (unsigned int)filters_.size();
+}
+
+Status FilterPipeline::run_forward(
+    Datatype type, void* data, uint64_t nbytes, Buffer* scratch) const {
+  auto value_size = datatype_size(type);
+  for (auto filter : filters_)
+    RETURN_NOT_OK(run_filter(
+        filter, false, value_size, (char*)data, nbytes, scratch));
+
+  return Status::Ok();
+}
+
+Status FilterPipeline::run_reverse(
+    Datatype type, void* data, uint64_t nbytes, Buffer* scratch) const {
+  auto value_size = datatype_size(type);
+  for (auto it = filters_.rbegin(); it != filters_.rend(); ++it)
+    RETURN_NOT_OK(
+        run_filter(*it, true, value_size, (char*)data, nbytes, scratch));
+
+  return Status::Ok();
+}
+
+// ===== FORMAT =====
+// filter_num (unsigned int)
+// filter #1 (char)
+// filter #2 (char)
+// ...
+Status FilterPipeline::serialize(Buffer* buff) const {
+  auto filter_num = (unsigned int)filters_.size();
+  RETURN_NOT_OK(buff->write(&filter_num, sizeof(unsigned int)));
+  for (auto filter : filters_) {
+    auto f = (char)filter;
+    RETURN_NOT_OK(buff->write(&f, sizeof(char)));
+  }
+
+  return Status::Ok();
+}
+
+const FilterPipeline* FilterPipeline::var_offsets_filters(
+    Compressor compressor) {
+  static const FilterPipeline delta = [] {
+    FilterPipeline filters;
+    filters.add_filter(FilterType::FILTER_DELTA);
+    return filters;
+  }();
+  static const FilterPipeline delta_shuffle = [] {
+    FilterPipeline filters;
+    filters.add_filter(FilterType::FILTER_DELTA);
+    filters.add_filter(FilterType::FILTER_BYTESHUFFLE);
+    return filters;
+  }();
+
+  switch (compressor) {
+    case Compressor::NO_COMPRESSION:
+    case Compressor::DOUBLE_DELTA:
+      return nullptr;
+    case Compressor::GZIP:
+    case Compressor::ZSTD:
+    case Compressor::LZ4:
+    case Compressor::BZIP2:
+      return &delta_shuffle;
+    default:
+      // Blosc shuffles on its own, and the remaining compressors work on
+      // whole values
+      return &delta;
+  }
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+/**
+ * Transposes the 8x8 bit matrix whose rows are the bytes of `x`. This is
+ * an involution, i.e., applying it twice restores `x`.
+ */
+static inline uint64_t transpose_8x8(uint64_t x) {
+  uint64_t t;
+  t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+  x = x ^ t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+  x = x ^ t ^ (t << 14);
+  t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+  x = x ^ t ^ (t << 28);
+  return x;
+}
+
+void FilterPipeline::bitshuffle(
+    const char* data, uint64_t value_num, uint64_t value_size, char* out) {
+  // Byte `j` of the values of group `g` (8 values) produces the `g`-th
+  // byte of the bit planes `8 * j` to `8 * j + 7`
+  uint64_t group_num = value_num / 8;
+  for (uint64_t g = 0; g < group_num; ++g) {
+    const auto group = (const unsigned char*)data + g * 8 * value_size;
+    for (uint64_t j = 0; j < value_size; ++j) {
+      uint64_t x = 0;
+      for (uint64_t k = 0; k < 8; ++k)
+        x |= (uint64_t)group[k * value_size + j] << (8 * k);
+      x = transpose_8x8(x);
+      for (uint64_t b = 0; b < 8; ++b)
+        out[(8 * j + b) * group_num + g] = (char)(x >> (8 * b));
+    }
+  }
+}
+
+void FilterPipeline::bitunshuffle(
+    const char* data, uint64_t value_num, uint64_t value_size, char* out) {
+  uint64_t group_num = value_num / 8;
+  for (uint64_t g = 0; g < group_num; ++g) {
+    auto group = (unsigned char*)out + g * 8 * value_size;
+    for (uint64_t j = 0; j < value_size; ++j) {
+      uint64_t x = 0;
+      for (uint64_t b = 0; b < 8; ++b)
+        x |= (uint64_t)(unsigned char)data[(8 * j + b) * group_num + g]
+             << (8 * b);
+      x = transpose_8x8(x);
+      for (uint64_t k = 0; k < 8; ++k)
+        group[k * value_size + j] = (unsigned char)(x >> (8 * k));
+    }
+  }
+}
+
+void FilterPipeline::byteshuffle(
+    const char* data, uint64_t value_num, uint64_t value_size, char* out) {
+  for (uint64_t i = 0; i < value_num; ++i)
+    for (uint64_t j = 0; j < value_size; ++j)
+      out[j * value_num + i] = data[i * value_size + j];
+}
+
+void FilterPipeline::byteunshuffle(
+    const char* data, uint64_t value_num, uint64_t value_size, char* out) {
+  for (uint64_t j = 0; j < value_size; ++j)
+    for (uint64_t i = 0; i < value_num; ++i)
+      out[i * value_size + j] = data[j * value_num + i];
+}
+
+template <class T>
+void FilterPipeline::delta_encode(char* data, uint64_t value_num) {
+  if (value_num < 2)
+    return;
+
+  // Values are copied in and out, since `data` may be unaligned
+  T prev, cur;
+  std::memcpy(&prev, data, sizeof(T));
+  for (uint64_t i = 1; i < value_num; ++i) {
+    std::memcpy(&cur, data + i * sizeof(T), sizeof(T));
+    T delta = (T)(cur - prev);
+    std::memcpy(data + i * sizeof(T), &delta, sizeof(T));
+    prev = cur;
+  }
+}
+
+template <class T>
+void FilterPipeline::delta_decode(char* data, uint64_t value_num) {
+  if (value_num < 2)
+    return;
+
+  T prev, cur;
+  std::memcpy(&prev, data, sizeof(T));
+  for (uint64_t i = 1; i < value_num; ++i) {
+    std::memcpy(&cur, data + i * sizeof(T), sizeof(T));
+    cur = (T)(cur + prev);
+    std::memcpy(data + i * sizeof(T), &cur, sizeof(T));
+    prev = cur;
+  }
+}
+
+Status FilterPipeline::run_filter(
+    FilterType filter,
+    bool reverse,
+    uint64_t value_size,
+    char* data,
+    uint64_t nbytes,
+    Buffer* scratch) {
+  uint64_t value_num = nbytes / value_size;
+
+  switch (filter) {
+    case FilterType::FILTER_BYTESHUFFLE:
+    case FilterType::FILTER_BITSHUFFLE: {
+      // Bit shuffling works on whole groups of 8 values
+      if (filter == FilterType::FILTER_BITSHUFFLE)
+        value_num = value_num / 8 * 8;
+      else if (value_size == 1)
+        return Status::Ok();
+      uint64_t shuffled_size = value_num * value_size;
+      if (shuffled_size == 0)
+        return Status::Ok();
+      if (scratch->alloced_size() < shuffled_size)
+        RETURN_NOT_OK(scratch->realloc(shuffled_size));
+      auto out = (char*)scratch->data();
+      if (filter == FilterType::FILTER_BYTESHUFFLE) {
+        if (reverse)
+          byteunshuffle(data, value_num, value_size, out);
+        else
+          byteshuffle(data, value_num, value_size, out);
+      } else {
+        if (reverse)
+          bitunshuffle(data, value_num, value_size, out);
+        else
+          bitshuffle(data, value_num, value_size, out);
+      }
+      std::memcpy(data, out, shuffled_size);
+      return Status::Ok();
+    }
+    case FilterType::FILTER_DELTA:
+      return run_delta(reverse, value_size, data, value_num);
+    case FilterType::FILTER_DOUBLE_DELTA:
+      RETURN_NOT_OK(run_delta(reverse, value_size, data, value_num));
+      return run_delta(reverse, value_size, data, value_num);
+  }
+
+  return LOG_STATUS(Status::FilterPipelineError(
+      "Cannot run filter pipeline; Invalid filter type"));
+}
+
+Status FilterPipeline::run_delta(
+    bool reverse, uint64_t value_size, char* data, uint64_t value_num) {
+  switch (value_size) {
+    case sizeof(uint8_t):
+      reverse ? delta_decode<uint8_t>(data, value_num) :
+                delta_encode<uint8_t>(data, value_num);
+      return Status::Ok();
+    case sizeof(uint16_t):
+      reverse ? delta_decode<uint16_t>(data, value_num) :
+                delta_encode<uint16_t>(data, value_num);
+      return Status::Ok();
+    case sizeof(uint32_t):
+      reverse ? delta_decode<uint32_t>(data, value_num) :
+                delta_encode<uint32_t>(data, value_num);
+      return Status::Ok();
+    case sizeof(uint64_t):
+      reverse ? delta_decode<uint64_t>(data, value_num) :
+                delta_encode<uint64_t>(data, value_num);
+      return Status::Ok();
+    default:
+      return LOG_STATUS(Status::FilterPipelineError(
+          "Cannot run delta filter; Unsupported value size"));
+  }
+}
+
+}  // namespace tiledb
@@ -82,6 +82,11 @@ URI Fragment::attr_var_uri(unsigned int attribute_id) const {
       attr->name() + "_var" + constants::file_suffix);
 }
 
+Status Fragment::copy_tiles(const FragmentMetadata* metadata) {
+  // Forward the copy command to the write state
+  return write_state_->copy_tiles(metadata);
+}
+
 URI Fragment::coords_uri() const {
   return fragment_uri_.join_path(
       std::string(constants::coords) + constants::file_suffix);
@@ -114,8 +119,12 @@ Status Fragment::finalize() {
     Status st = write_state_->finalize();
     if (st.ok())
       st = storage_manager->store_fragment_metadata(metadata_);
-    if (st.ok() && storage_manager->is_dir(fragment_uri_))
+    if (st.ok() && storage_manager->is_dir(fragment_uri_)) {
       st = storage_manager->create_fragment_file(fragment_uri_);
+      if (st.ok())
+        st = storage_manager->fragment_manifest_add(
+            fragment_uri_, metadata_->dense());
+    }
 
     return st;
   }
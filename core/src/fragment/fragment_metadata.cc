@@ -36,7 +36,9 @@
 #include "logger.h"
 #include "utils.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <iostream>
 
 /* ****************************** */
@@ -57,6 +59,7 @@ FragmentMetadata::FragmentMetadata(
     : array_schema_(array_schema)
     , dense_(dense)
     , fragment_uri_(fragment_uri) {
+  bloom_filter_ = nullptr;
   cell_num_in_domain_ = 0;
   domain_ = nullptr;
   non_empty_domain_ = nullptr;
@@ -64,6 +67,8 @@ FragmentMetadata::FragmentMetadata(
 }
 
 FragmentMetadata::~FragmentMetadata() {
+  delete bloom_filter_;
+
   if (domain_ != nullptr)
     std::free(domain_);
 
@@ -143,6 +148,15 @@ void FragmentMetadata::append_tile_offset(
   next_tile_offsets_[attribute_id] = new_offset;
 }
 
+void FragmentMetadata::append_tile_stats(
+    unsigned int attribute_id, const TileStats& stats) {
+  tile_stats_[attribute_id].push_back(stats);
+}
+
+void FragmentMetadata::append_tile_cell_num(uint64_t cell_num) {
+  tile_cell_nums_.push_back(cell_num);
+}
+
 void FragmentMetadata::append_tile_var_offset(
     unsigned int attribute_id, uint64_t step) {
   tile_var_offsets_[attribute_id].push_back(
@@ -156,6 +170,10 @@ void FragmentMetadata::append_tile_var_size(
   tile_var_sizes_[attribute_id].push_back(size);
 }
 
+const BloomFilter* FragmentMetadata::bloom_filter() const {
+  return bloom_filter_;
+}
+
 const std::vector<void*>& FragmentMetadata::bounding_coords() const {
   return bounding_coords_;
 }
@@ -164,6 +182,9 @@ uint64_t FragmentMetadata::cell_num(uint64_t tile_pos) const {
   if (dense_)
     return array_schema_->domain()->cell_num_per_tile();
 
+  if (!tile_cell_nums_.empty())
+    return tile_cell_nums_[tile_pos];
+
   uint64_t tile_num = this->tile_num();
   if (tile_pos != tile_num - 1)
     return array_schema_->capacity();
@@ -276,6 +297,72 @@ Status FragmentMetadata::compute_max_read_buffer_sizes_sparse(
   return Status::Ok();
 }
 
+template <class T>
+Status FragmentMetadata::compute_est_read_buffer_sizes(
+    const T* subarray,
+    const char** attributes,
+    unsigned attribute_num,
+    unsigned buffer_num,
+    uint64_t* buffer_sizes) const {
+  for (unsigned i = 0; i < buffer_num; ++i)
+    buffer_sizes[i] = 0;
+
+  // Calculate attribute ids and var sizes
+  std::vector<unsigned> attribute_ids;
+  std::vector<bool> var_sizes;
+  unsigned aid;
+  for (unsigned i = 0; i < attribute_num; ++i) {
+    RETURN_NOT_OK(array_schema_->attribute_id(attributes[i], &aid));
+    attribute_ids.emplace_back(aid);
+    var_sizes.push_back(array_schema_->var_size(aid));
+  }
+
+  // Calculate the overlapping tiles along with their coverage
+  std::vector<std::pair<uint64_t, double>> tile_covs;
+  if (dense_) {
+    tile_covs = compute_overlapping_tile_ids_cov(subarray);
+  } else {
+    uint64_t tid = 0;
+    auto dim_num = array_schema_->dim_num();
+    for (auto& mbr : mbrs_) {
+      auto ratio =
+          utils::overlap_ratio(static_cast<const T*>(mbr), subarray, dim_num);
+      if (ratio > 0)
+        tile_covs.emplace_back(tid, ratio);
+      ++tid;
+    }
+  }
+
+  // Estimate the number of result cells and variable-sized values
+  double cell_num = 0;
+  std::vector<double> var_sizes_est(attribute_num, 0);
+  for (auto& tile_cov : tile_covs) {
+    auto tid = tile_cov.first;
+    cell_num += tile_cov.second * this->cell_num(tid);
+    for (unsigned i = 0; i < attribute_num; ++i) {
+      if (var_sizes[i])
+        var_sizes_est[i] +=
+            tile_cov.second * tile_var_sizes_[attribute_ids[i]][tid];
+    }
+  }
+
+  // Compute buffer sizes
+  auto est_cell_num = (uint64_t)std::ceil(cell_num);
+  unsigned bid = 0;
+  for (unsigned i = 0; i < attribute_num; ++i) {
+    if (var_sizes[i]) {
+      buffer_sizes[bid++] = est_cell_num * constants::cell_var_offset_size;
+      buffer_sizes[bid++] = (uint64_t)std::ceil(var_sizes_est[i]);
+    } else {
+      buffer_sizes[bid++] =
+          est_cell_num * array_schema_->cell_size(attribute_ids[i]);
+    }
+  }
+  assert(bid == buffer_num);
+
+  return Status::Ok();
+}
+
 bool FragmentMetadata::dense() const {
   return dense_;
 }
@@ -291,6 +378,9 @@ Status FragmentMetadata::deserialize(ConstBuffer* buf) {
   RETURN_NOT_OK(load_last_tile_cell_num(buf));
   RETURN_NOT_OK(load_file_sizes(buf));
   RETURN_NOT_OK(load_file_var_sizes(buf));
+  RETURN_NOT_OK(load_bloom_filter(buf));
+  RETURN_NOT_OK(load_tile_cell_nums(buf));
+  RETURN_NOT_OK(load_tile_stats(buf));
 
   return Status::Ok();
 }
@@ -309,6 +399,16 @@ uint64_t FragmentMetadata::file_var_sizes(unsigned int attribute_id) const {
   return file_var_sizes_[attribute_id];
 }
 
+uint64_t FragmentMetadata::fragment_size() const {
+  uint64_t size = 0;
+  for (auto file_size : file_sizes_)
+    size += file_size;
+  for (auto file_var_size : file_var_sizes_)
+    size += file_var_size;
+
+  return size;
+}
+
 const URI& FragmentMetadata::fragment_uri() const {
   return fragment_uri_;
 }
@@ -358,6 +458,9 @@ Status FragmentMetadata::init(const void* non_empty_domain) {
   // Initialize variable tile sizes
   tile_var_sizes_.resize(attribute_num);
 
+  // Initialize tile value statistics
+  tile_stats_.resize(attribute_num);
+
   return Status::Ok();
 }
 
@@ -384,10 +487,18 @@ Status FragmentMetadata::serialize(Buffer* buf) {
   RETURN_NOT_OK(write_last_tile_cell_num(buf));
   RETURN_NOT_OK(write_file_sizes(buf));
   RETURN_NOT_OK(write_file_var_sizes(buf));
+  RETURN_NOT_OK(write_bloom_filter(buf));
+  RETURN_NOT_OK(write_tile_cell_nums(buf));
+  RETURN_NOT_OK(write_tile_stats(buf));
 
   return Status::Ok();
 }
 
+void FragmentMetadata::set_bloom_filter(BloomFilter* bloom_filter) {
+  delete bloom_filter_;
+  bloom_filter_ = bloom_filter;
+}
+
 void FragmentMetadata::set_last_tile_cell_num(uint64_t cell_num) {
   last_tile_cell_num_ = cell_num;
 }
@@ -404,6 +515,17 @@ const std::vector<std::vector<uint64_t>>& FragmentMetadata::tile_offsets()
   return tile_offsets_;
 }
 
+const TileStats* FragmentMetadata::tile_stats(
+    unsigned int attribute_id, uint64_t tile_pos) const {
+  // The statistics must have been appended for every tile
+  if (attribute_id >= tile_stats_.size() ||
+      tile_stats_[attribute_id].size() != tile_offsets_[attribute_id].size() ||
+      tile_pos >= tile_stats_[attribute_id].size())
+    return nullptr;
+
+  return &tile_stats_[attribute_id][tile_pos];
+}
+
 const std::vector<std::vector<uint64_t>>& FragmentMetadata::tile_var_offsets()
     const {
   return tile_var_offsets_;
@@ -414,6 +536,14 @@ const std::vector<std::vector<uint64_t>>& FragmentMetadata::tile_var_sizes()
   return tile_var_sizes_;
 }
 
+bool FragmentMetadata::var_offsets_filtered() const {
+  return !std::lexicographical_compare(
+      version_,
+      version_ + 3,
+      constants::var_offsets_filters_version,
+      constants::var_offsets_filters_version + 3);
+}
+
 /* ****************************** */
 /*        PRIVATE METHODS         */
 /* ****************************** */
@@ -455,6 +585,52 @@ std::vector<uint64_t> FragmentMetadata::compute_overlapping_tile_ids(
   return tids;
 }
 
+template <class T>
+std::vector<std::pair<uint64_t, double>>
+FragmentMetadata::compute_overlapping_tile_ids_cov(const T* subarray) const {
+  assert(dense_);
+  std::vector<std::pair<uint64_t, double>> tids;
+  auto dim_num = array_schema_->dim_num();
+  auto metadata_domain = static_cast<const T*>(domain_);
+
+  // Check if there is any overlap
+  if (!utils::overlap(subarray, metadata_domain, dim_num))
+    return tids;
+
+  // Initialize subarray tile domain
+  auto subarray_tile_domain = new T[2 * dim_num];
+  get_subarray_tile_domain(subarray, subarray_tile_domain);
+
+  // Initialize tile coordinates
+  auto tile_coords = new T[dim_num];
+  for (unsigned int i = 0; i < dim_num; ++i)
+    tile_coords[i] = subarray_tile_domain[2 * i];
+
+  // Walk through all tiles in subarray tile domain
+  auto domain = array_schema_->domain();
+  auto tile_extents = static_cast<const T*>(domain->tile_extents());
+  auto tile_subarray = new T[2 * dim_num];
+  uint64_t tile_pos;
+  do {
+    for (unsigned int i = 0; i < dim_num; ++i) {
+      tile_subarray[2 * i] =
+          metadata_domain[2 * i] + tile_coords[i] * tile_extents[i];
+      tile_subarray[2 * i + 1] = tile_subarray[2 * i] + tile_extents[i] - 1;
+    }
+    tile_pos = domain->get_tile_pos(metadata_domain, tile_coords);
+    tids.emplace_back(
+        tile_pos, utils::overlap_ratio(tile_subarray, subarray, dim_num));
+    domain->get_next_tile_coords(subarray_tile_domain, tile_coords);
+  } while (utils::coords_in_rect(tile_coords, subarray_tile_domain, dim_num));
+
+  // Clean up
+  delete[] subarray_tile_domain;
+  delete[] tile_coords;
+  delete[] tile_subarray;
+
+  return tids;
+}
+
 template <class T>
 void FragmentMetadata::get_subarray_tile_domain(
     const T* subarray, T* subarray_tile_domain) const {
@@ -518,6 +694,33 @@ Status FragmentMetadata::expand_non_empty_domain(const T* mbr) {
   return Status::Ok();
 }
 
+// ===== FORMAT =====
+//  has_bloom_filter (char)
+//  bloom_filter (BloomFilter) - only if has_bloom_filter is 1
+Status FragmentMetadata::load_bloom_filter(ConstBuffer* buff) {
+  // Metadata without a bloom filter section
+  if (buff->end())
+    return Status::Ok();
+
+  char has_bloom_filter;
+  Status st = buff->read(&has_bloom_filter, sizeof(char));
+  if (st.ok() && has_bloom_filter == 1) {
+    auto bloom_filter = new BloomFilter();
+    st = bloom_filter->deserialize(buff);
+    if (st.ok())
+      set_bloom_filter(bloom_filter);
+    else
+      delete bloom_filter;
+  }
+
+  if (!st.ok()) {
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot load fragment metadata; Reading bloom filter failed"));
+  }
+
+  return Status::Ok();
+}
+
 // ===== FORMAT =====
 //  bounding_coords_num (uint64_t)
 //  bounding_coords_#1 (void*) bounding_coords_#2 (void*) ...
@@ -664,6 +867,66 @@ Status FragmentMetadata::load_non_empty_domain(ConstBuffer* buff) {
   return Status::Ok();
 }
 
+// ===== FORMAT =====
+// has_tile_cell_nums (char)
+// tile_cell_num#1 (uint64_t) tile_cell_num#2 (uint64_t) ... - only if
+//     has_tile_cell_nums is 1, one per MBR
+Status FragmentMetadata::load_tile_cell_nums(ConstBuffer* buff) {
+  // Metadata without a tile cell number section
+  if (buff->end())
+    return Status::Ok();
+
+  char has_tile_cell_nums;
+  Status st = buff->read(&has_tile_cell_nums, sizeof(char));
+  if (st.ok() && has_tile_cell_nums == 1) {
+    tile_cell_nums_.resize(mbrs_.size());
+    st = buff->read(&tile_cell_nums_[0], mbrs_.size() * sizeof(uint64_t));
+  }
+
+  if (!st.ok()) {
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot load fragment metadata; Reading tile cell numbers failed"));
+  }
+
+  return Status::Ok();
+}
+
+// ===== FORMAT =====
+// tile_stats_attr#0_num (uint64_t)
+// tile_stats_attr#0_#1 (TileStats) tile_stats_attr#0_#2 (TileStats) ...
+// ...
+// tile_stats_attr#<attribute_num-1>_num (uint64_t)
+// tile_stats_attr#<attribute_num-1>_#1 (TileStats)
+// tile_stats_attr#<attribute_num-1>_#2 (TileStats) ...
+Status FragmentMetadata::load_tile_stats(ConstBuffer* buff) {
+  unsigned int attribute_num = array_schema_->attribute_num();
+  tile_stats_.resize(attribute_num);
+
+  // Metadata without a tile statistics section
+  if (buff->end())
+    return Status::Ok();
+
+  Status st;
+  for (unsigned int i = 0; i < attribute_num && st.ok(); ++i) {
+    uint64_t tile_stats_num;
+    st = buff->read(&tile_stats_num, sizeof(uint64_t));
+    if (st.ok() && tile_stats_num != 0 &&
+        tile_stats_num != tile_offsets_[i].size())
+      st = Status::FragmentMetadataError("Invalid number of tile statistics");
+    if (st.ok())
+      tile_stats_[i].resize(tile_stats_num);
+    for (uint64_t t = 0; t < tile_stats_num && st.ok(); ++t)
+      st = tile_stats_[i][t].deserialize(buff);
+  }
+
+  if (!st.ok()) {
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot load fragment metadata; Reading tile statistics failed"));
+  }
+
+  return Status::Ok();
+}
+
 // ===== FORMAT =====
 // tile_offsets_attr#0_num (uint64_t)
 // tile_offsets_attr#0_#1 (uint64_t) tile_offsets_attr#0_#2 (uint64_t) ...
@@ -792,6 +1055,23 @@ Status FragmentMetadata::load_version(ConstBuffer* buff) {
   return Status::Ok();
 }
 
+// ===== FORMAT =====
+// has_bloom_filter(char)
+// bloom_filter(BloomFilter) - only if has_bloom_filter is 1
+Status FragmentMetadata::write_bloom_filter(Buffer* buff) {
+  char has_bloom_filter = (bloom_filter_ != nullptr) ? 1 : 0;
+  Status st = buff->write(&has_bloom_filter, sizeof(char));
+  if (st.ok() && bloom_filter_ != nullptr)
+    st = bloom_filter_->serialize(buff);
+
+  if (!st.ok()) {
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot serialize fragment metadata; Writing bloom filter failed"));
+  }
+
+  return Status::Ok();
+}
+
 // ===== FORMAT =====
 // bounding_coords_num(uint64_t)
 // bounding_coords_#1(void*) bounding_coords_#2(void*) ...
@@ -860,6 +1140,9 @@ Status FragmentMetadata::write_last_tile_cell_num(Buffer* buff) {
   // Handle the case of zero
   uint64_t last_tile_cell_num =
       (last_tile_cell_num_ == 0) ? cell_num_per_tile : last_tile_cell_num_;
+  // The last tile may also have been copied from another fragment
+  if (!dense_ && !tile_cell_nums_.empty())
+    last_tile_cell_num = tile_cell_nums_.back();
   Status st = buff->write(&last_tile_cell_num, sizeof(uint64_t));
   if (!st.ok()) {
     return LOG_STATUS(
@@ -921,6 +1204,67 @@ Status FragmentMetadata::write_non_empty_domain(Buffer* buff) {
   return Status::Ok();
 }
 
+// ===== FORMAT =====
+// has_tile_cell_nums (char)
+// tile_cell_num#1 (uint64_t) tile_cell_num#2 (uint64_t) ... - only if
+//     has_tile_cell_nums is 1, one per MBR
+Status FragmentMetadata::write_tile_cell_nums(Buffer* buff) {
+  // The tile cell numbers are needed only if some tile other than the last
+  // one is not full
+  char has_tile_cell_nums = 0;
+  auto capacity = array_schema_->capacity();
+  if (!dense_ && tile_cell_nums_.size() == mbrs_.size()) {
+    for (size_t i = 0; i + 1 < tile_cell_nums_.size(); ++i) {
+      if (tile_cell_nums_[i] != capacity) {
+        has_tile_cell_nums = 1;
+        break;
+      }
+    }
+  }
+
+  Status st = buff->write(&has_tile_cell_nums, sizeof(char));
+  if (st.ok() && has_tile_cell_nums == 1)
+    st = buff->write(
+        &tile_cell_nums_[0], tile_cell_nums_.size() * sizeof(uint64_t));
+
+  if (!st.ok()) {
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot serialize fragment metadata; Writing tile cell numbers "
+        "failed"));
+  }
+
+  return Status::Ok();
+}
+
+// ===== FORMAT =====
+// tile_stats_attr#0_num (uint64_t)
+// tile_stats_attr#0_#1 (TileStats) tile_stats_attr#0_#2 (TileStats) ...
+// ...
+// tile_stats_attr#<attribute_num-1>_num (uint64_t)
+// tile_stats_attr#<attribute_num-1>_#1 (TileStats)
+// tile_stats_attr#<attribute_num-1>_#2 (TileStats) ...
+Status FragmentMetadata::write_tile_stats(Buffer* buff) {
+  Status st;
+  unsigned int attribute_num = array_schema_->attribute_num();
+  for (unsigned int i = 0; i < attribute_num && st.ok(); ++i) {
+    // The statistics of an attribute are dropped if some tile lacks them
+    uint64_t tile_stats_num =
+        (i < tile_stats_.size()) ? tile_stats_[i].size() : 0;
+    if (tile_stats_num != tile_offsets_[i].size())
+      tile_stats_num = 0;
+    st = buff->write(&tile_stats_num, sizeof(uint64_t));
+    for (uint64_t t = 0; t < tile_stats_num && st.ok(); ++t)
+      st = tile_stats_[i][t].serialize(buff);
+  }
+
+  if (!st.ok()) {
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot serialize fragment metadata; Writing tile statistics failed"));
+  }
+
+  return Status::Ok();
+}
+
 // ===== FORMAT =====
 // tile_offsets_attr#0_num(uint64_t)
 // tile_offsets_attr#0_#1 (uint64_t) tile_offsets_attr#0_#2 (uint64_t) ...
@@ -1052,6 +1396,67 @@ template Status FragmentMetadata::append_mbr<uint64_t>(const void* mbr);
 template Status FragmentMetadata::append_mbr<float>(const void* mbr);
 template Status FragmentMetadata::append_mbr<double>(const void* mbr);
 
+template Status FragmentMetadata::compute_est_read_buffer_sizes<int8_t>(
+    const int8_t* subarray,
+    const char** attributes,
+    unsigned attribute_num,
+    unsigned buffer_num,
+    uint64_t* buffer_sizes) const;
+template Status FragmentMetadata::compute_est_read_buffer_sizes<uint8_t>(
+    const uint8_t* subarray,
+    const char** attributes,
+    unsigned attribute_num,
+    unsigned buffer_num,
+    uint64_t* buffer_sizes) const;
+template Status FragmentMetadata::compute_est_read_buffer_sizes<int16_t>(
+    const int16_t* subarray,
+    const char** attributes,
+    unsigned attribute_num,
+    unsigned buffer_num,
+    uint64_t* buffer_sizes) const;
+template Status FragmentMetadata::compute_est_read_buffer_sizes<uint16_t>(
+    const uint16_t* subarray,
+    const char** attributes,
+    unsigned attribute_num,
+    unsigned buffer_num,
+    uint64_t* buffer_sizes) const;
+template Status FragmentMetadata::compute_est_read_buffer_sizes<int>(
+    const int* subarray,
+    const char** attributes,
+    unsigned attribute_num,
+    unsigned buffer_num,
+    uint64_t* buffer_sizes) const;
+template Status FragmentMetadata::compute_est_read_buffer_sizes<unsigned>(
+    const unsigned* subarray,
+    const char** attributes,
+    unsigned attribute_num,
+    unsigned buffer_num,
+    uint64_t* buffer_sizes) const;
+template Status FragmentMetadata::compute_est_read_buffer_sizes<int64_t>(
+    const int64_t* subarray,
+    const char** attributes,
+    unsigned attribute_num,
+    unsigned buffer_num,
+    uint64_t* buffer_sizes) const;
+template Status FragmentMetadata::compute_est_read_buffer_sizes<uint64_t>(
+    const uint64_t* subarray,
+    const char** attributes,
+    unsigned attribute_num,
+    unsigned buffer_num,
+    uint64_t* buffer_sizes) const;
+template Status FragmentMetadata::compute_est_read_buffer_sizes<float>(
+    const float* subarray,
+    const char** attributes,
+    unsigned attribute_num,
+    unsigned buffer_num,
+    uint64_t* buffer_sizes) const;
+template Status FragmentMetadata::compute_est_read_buffer_sizes<double>(
+    const double* subarray,
+    const char** attributes,
+    unsigned attribute_num,
+    unsigned buffer_num,
+    uint64_t* buffer_sizes) const;
+
 template Status FragmentMetadata::compute_max_read_buffer_sizes<int8_t>(
     const int8_t* subarray,
     const char** attributes,
@@ -90,6 +90,9 @@ ReadState::~ReadState() {
   for (auto& tile_var : tiles_var_)
     delete tile_var;
 
+  for (auto& tile : condition_tiles_)
+    delete tile;
+
   for (auto& tile_io : tile_io_)
     delete tile_io;
 
@@ -104,6 +107,47 @@ ReadState::~ReadState() {
 /*              API               */
 /* ****************************** */
 
+Status ReadState::apply_condition(
+    const QueryCondition& condition,
+    uint64_t tile_i,
+    const CellPosRange& cell_pos_range,
+    std::vector<CellPosRange>* result) {
+  // For easy reference
+  auto attribute_id = condition.attribute_id();
+
+  // An attribute missing from the fragment holds no value to satisfy
+  if (is_empty_attribute(attribute_id))
+    return Status::Ok();
+
+  // Decide the whole tile from its statistics, if possible
+  auto stats = metadata_->tile_stats(attribute_id, tile_i);
+  if (stats != nullptr) {
+    if (!condition.may_match(*stats)) {
+      query_->stats()->add(Stats::Counter::CONDITION_TILE_SKIP_NUM, 1);
+      return Status::Ok();
+    }
+    if (condition.matches_all(*stats)) {
+      result->push_back(cell_pos_range);
+      return Status::Ok();
+    }
+  }
+
+  // Prepare the condition tile
+  auto& tile = condition_tiles_[attribute_id];
+  if (tile == nullptr) {
+    const Attribute* attr = array_schema_->attribute(attribute_id);
+    tile = new Tile(attr->type(), attr->compressor(), attr->cell_size(), 0);
+    tile->set_filters(attr->filters());
+  }
+  if (tile_i != condition_fetched_tile_[attribute_id]) {
+    condition_fetched_tile_[attribute_id] = INVALID_UINT64;
+    RETURN_NOT_OK(read_tile(attribute_id, tile_i, tile));
+    condition_fetched_tile_[attribute_id] = tile_i;
+  }
+
+  return condition.apply(tile->data(), cell_pos_range, result);
+}
+
 Status ReadState::copy_cells(
     unsigned int attribute_id,
     uint64_t tile_i,
@@ -121,6 +165,25 @@ Status ReadState::copy_cells(
   // For easy reference
   uint64_t cell_size = array_schema_->cell_size(attribute_id);
 
+  // A tile read straight into the user buffer was written in full
+  if (tile_i == direct_read_tile_[attribute_id])
+    return Status::Ok();
+
+  // Read a dense tile that the range fully covers straight into the user
+  // buffer, rather than into the attribute tile and then copying it
+  uint64_t tile_size = metadata_->cell_num(tile_i) * cell_size;
+  if (dense() && attribute_id < attribute_num_ &&
+      tile_i != fetched_tile_[attribute_id] && cell_pos_range.first == 0 &&
+      (cell_pos_range.second + 1) * cell_size == tile_size &&
+      tile_size <= buffer_size - *buffer_offset) {
+    RETURN_NOT_OK(read_tile_into(
+        attribute_id, tile_i, static_cast<char*>(buffer) + *buffer_offset));
+    direct_read_tile_[attribute_id] = tile_i;
+    *buffer_offset += tile_size;
+    query_->stats()->add(Stats::Counter::DIRECT_READ_BYTES, tile_size);
+    return Status::Ok();
+  }
+
   // Prepare attribute tile
   RETURN_NOT_OK(read_tile(attribute_id, tile_i));
 
@@ -145,8 +208,11 @@ Status ReadState::copy_cells(
   // Copy and update current buffer and tile offsets
   char* buffer_c = static_cast<char*>(buffer) + *buffer_offset;
   if (bytes_to_copy != 0) {
+    ScopedTimer timer(query_->stats(), Stats::Timer::CELL_COPY);
+    TraceSpan span(query_->storage_manager()->tracer(), "cell_copy");
     RETURN_NOT_OK(tile->read(buffer_c, bytes_to_copy));
     *buffer_offset += bytes_to_copy;
+    query_->stats()->add(Stats::Counter::CELL_COPY_BYTES, bytes_to_copy);
   }
 
   // Handle buffer overflow
@@ -223,6 +289,8 @@ Status ReadState::copy_cells_var(
 
   // Copy and update current buffer and tile offsets
   if (bytes_to_copy != 0) {
+    ScopedTimer timer(query_->stats(), Stats::Timer::CELL_COPY);
+    TraceSpan span(query_->storage_manager()->tracer(), "cell_copy");
     RETURN_NOT_OK(tile->read(buffer_start, bytes_to_copy));
     *buffer_offset += bytes_to_copy;
 
@@ -233,6 +301,8 @@ Status ReadState::copy_cells_var(
     char* buffer_var_c = static_cast<char*>(buffer_var) + *buffer_var_offset;
     RETURN_NOT_OK(tile_var->read(buffer_var_c, bytes_var_to_copy));
     *buffer_var_offset += bytes_var_to_copy;
+    query_->stats()->add(
+        Stats::Counter::CELL_COPY_BYTES, bytes_to_copy + bytes_var_to_copy);
   }
 
   // Check for overflow
@@ -1312,8 +1382,12 @@ void ReadState::init_empty_attributes() {
 
 void ReadState::init_fetched_tiles() {
   fetched_tile_.resize(attribute_num_ + 2);
-  for (unsigned int i = 0; i < attribute_num_ + 2; ++i)
+  direct_read_tile_.resize(attribute_num_ + 2);
+  for (unsigned int i = 0; i < attribute_num_ + 2; ++i) {
     fetched_tile_[i] = INVALID_UINT64;
+    direct_read_tile_[i] = INVALID_UINT64;
+  }
+  condition_fetched_tile_.resize(attribute_num_, INVALID_UINT64);
 }
 
 void ReadState::init_overflow() {
@@ -1324,6 +1398,7 @@ void ReadState::init_overflow() {
 
 void ReadState::init_tiles() {
   auto dim_num = array_schema_->domain()->dim_num();
+  condition_tiles_.resize(attribute_num_, nullptr);
 
   for (unsigned int i = 0; i < attribute_num_; ++i) {
     const Attribute* attr = array_schema_->attribute(i);
@@ -1336,11 +1411,19 @@ void ReadState::init_tiles() {
         (var_size) ? constants::cell_var_offset_size : attr->cell_size(),
         0));
 
-    if (var_size)
+    // Fragments of older versions store the offsets unfiltered
+    if (var_size) {
+      if (metadata_->var_offsets_filtered())
+        tiles_.back()->set_filters(FilterPipeline::var_offsets_filters(
+            array_schema_->cell_var_offsets_compression()));
       tiles_var_.emplace_back(new Tile(
           attr->type(), attr->compressor(), datatype_size(attr->type()), 0));
-    else
+      tiles_var_.back()->set_filters(attr->filters());
+      tiles_var_.back()->set_dict_encoded(attr->dictionary_encoding());
+    } else {
+      tiles_.back()->set_filters(attr->filters());
       tiles_var_.emplace_back(nullptr);
+    }
   }
   tiles_.emplace_back(new Tile(
       array_schema_->coords_type(),
@@ -1361,23 +1444,27 @@ void ReadState::init_tile_io() {
     tile_io_.emplace_back(new TileIO(
         query_->storage_manager(),
         fragment_->attr_uri(i),
-        fragment_->file_size(i)));
+        fragment_->file_size(i),
+        query_->stats()));
     if (var_size)
       tile_io_var_.emplace_back(new TileIO(
           query_->storage_manager(),
           fragment_->attr_var_uri(i),
-          fragment_->file_var_size(i)));
+          fragment_->file_var_size(i),
+          query_->stats()));
     else
       tile_io_var_.emplace_back(nullptr);
   }
   tile_io_.emplace_back(new TileIO(
       query_->storage_manager(),
       fragment_->coords_uri(),
-      fragment_->file_coords_size()));
+      fragment_->file_coords_size(),
+      query_->stats()));
   tile_io_.emplace_back(new TileIO(
       query_->storage_manager(),
       fragment_->coords_uri(),
-      fragment_->file_coords_size()));
+      fragment_->file_coords_size(),
+      query_->stats()));
 }
 
 bool ReadState::is_empty_attribute(unsigned int attribute_id) const {
@@ -1405,7 +1492,17 @@ Status ReadState::read_tile(unsigned int attribute_id, uint64_t tile_i) {
   if (tile_i == fetched_tile_[attribute_id])
     return Status::Ok();
 
-  auto tile = tiles_[attribute_id];
+  Status st = read_tile(attribute_id, tile_i, tiles_[attribute_id]);
+
+  // Mark as fetched
+  if (st.ok())
+    fetched_tile_[attribute_id] = tile_i;
+
+  return st;
+}
+
+Status ReadState::read_tile(
+    unsigned int attribute_id, uint64_t tile_i, Tile* tile) {
   auto tile_io = tile_io_[attribute_id];
 
   // To handle the special case of the search tile
@@ -1421,13 +1518,27 @@ Status ReadState::read_tile(unsigned int attribute_id, uint64_t tile_i) {
   uint64_t tile_size =
       metadata_->cell_num(tile_i) * array_schema_->cell_size(attribute_id_real);
 
-  Status st = tile_io->read(tile, file_offset, tile_compressed_size, tile_size);
-
-  // Mark as fetched
-  if (st.ok())
-    fetched_tile_[attribute_id] = tile_i;
+  return tile_io->read(tile, file_offset, tile_compressed_size, tile_size);
+}
 
-  return st;
+Status ReadState::read_tile_into(
+    unsigned int attribute_id, uint64_t tile_i, void* buffer) {
+  // Wrap the memory into a tile configured like the attribute tile
+  auto tile = tiles_[attribute_id];
+  uint64_t tile_size =
+      metadata_->cell_num(tile_i) * array_schema_->cell_size(attribute_id);
+  Buffer buff(buffer, tile_size);
+  Tile direct_tile(
+      tile->type(),
+      tile->compressor(),
+      tile->compression_level(),
+      tile->cell_size(),
+      tile->dim_num(),
+      &buff,
+      false);
+  direct_tile.set_filters(tile->filters());
+
+  return read_tile(attribute_id, tile_i, &direct_tile);
 }
 
 Status ReadState::read_tile_var(unsigned int attribute_id, uint64_t tile_i) {
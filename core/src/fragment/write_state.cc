@@ -39,6 +39,7 @@
 
 #include "comparators.h"
 #include "const_buffer.h"
+#include "dict_encoder.h"
 #include "logger.h"
 #include "query.h"
 #include "tile.h"
@@ -87,6 +88,9 @@ WriteState::~WriteState() {
   for (auto& tile_var : tiles_var_)
     delete tile_var;
 
+  for (auto& tile_dict : tiles_dict_)
+    delete tile_dict;
+
   for (auto& tile_io : tile_io_)
     delete tile_io;
 
@@ -177,6 +181,85 @@ Status WriteState::close_files() {
   return Status::Ok();
 }
 
+Status WriteState::copy_tiles(const FragmentMetadata* metadata) {
+  // For easy reference
+  auto array_schema = fragment_->query()->array_schema();
+  auto attribute_num = array_schema->attribute_num();
+  auto storage_manager = fragment_->query()->storage_manager();
+  auto& fragment_uri = fragment_->fragment_uri();
+  auto& src_fragment_uri = metadata->fragment_uri();
+  auto tile_num = metadata->tile_num();
+
+  // Sanity checks
+  if (metadata_->dense() || metadata->dense())
+    return LOG_STATUS(Status::WriteStateError(
+        "Cannot copy tiles; Only sparse fragments are supported"));
+  if (array_schema->is_kv() && bloom_filter_bits_per_key() != 0)
+    return LOG_STATUS(Status::WriteStateError(
+        "Cannot copy tiles; The bloom filter of a key-value store fragment "
+        "must be built over all its coordinates"));
+  if (tile_num == 0)
+    return Status::Ok();
+
+  // Create fragment directory if it does not exist
+  if (!storage_manager->is_dir(fragment_uri))
+    RETURN_NOT_OK(storage_manager->create_dir(fragment_uri));
+
+  // The copied tiles must start at a tile boundary
+  if (tile_cell_num_[attribute_num] != 0)
+    RETURN_NOT_OK(write_current_tile());
+
+  // Copy the attribute files
+  for (unsigned int i = 0; i < attribute_num + 1; ++i) {
+    auto uri =
+        (i == attribute_num) ? fragment_->coords_uri() : fragment_->attr_uri(i);
+    RETURN_NOT_OK(copy_file(
+        src_fragment_uri.join_path(uri.last_path_part()),
+        uri,
+        metadata->file_sizes(i)));
+    if (array_schema->var_size(i)) {
+      auto var_uri = fragment_->attr_var_uri(i);
+      RETURN_NOT_OK(copy_file(
+          src_fragment_uri.join_path(var_uri.last_path_part()),
+          var_uri,
+          metadata->file_var_sizes(i)));
+      buffer_var_offsets_[i] += metadata->file_var_sizes(i);
+    }
+  }
+
+  // Append the tile metadata, with the tile offsets shifted by the size of
+  // the tiles written before the copied ones
+  auto& tile_offsets = metadata->tile_offsets();
+  auto& tile_var_offsets = metadata->tile_var_offsets();
+  auto& tile_var_sizes = metadata->tile_var_sizes();
+  uint64_t cell_num = 0;
+  for (uint64_t t = 0; t < tile_num; ++t) {
+    bool last = (t == tile_num - 1);
+    for (unsigned int i = 0; i < attribute_num + 1; ++i) {
+      auto end = last ? metadata->file_sizes(i) : tile_offsets[i][t + 1];
+      metadata_->append_tile_offset(i, end - tile_offsets[i][t]);
+      auto tile_stats = metadata->tile_stats(i, t);
+      if (tile_stats != nullptr)
+        metadata_->append_tile_stats(i, *tile_stats);
+      if (array_schema->var_size(i)) {
+        auto end_var =
+            last ? metadata->file_var_sizes(i) : tile_var_offsets[i][t + 1];
+        metadata_->append_tile_var_offset(i, end_var - tile_var_offsets[i][t]);
+        metadata_->append_tile_var_size(i, tile_var_sizes[i][t]);
+      }
+    }
+    RETURN_NOT_OK(metadata_->append_mbr(metadata->mbrs()[t]));
+    metadata_->append_bounding_coords(metadata->bounding_coords()[t]);
+    metadata_->append_tile_cell_num(metadata->cell_num(t));
+    cell_num += metadata->cell_num(t);
+  }
+
+  for (auto& cells_written : cells_written_)
+    cells_written += cell_num;
+
+  return Status::Ok();
+}
+
 Status WriteState::write(void** buffers, uint64_t* buffer_sizes) {
   // Create fragment directory if it does not exist
   auto& fragment_uri = fragment_->fragment_uri();
@@ -227,6 +310,55 @@ Status WriteState::write(void** buffers, uint64_t* buffer_sizes) {
 /*         PRIVATE METHODS        */
 /* ****************************** */
 
+Status WriteState::append_tile_stats(
+    unsigned int attribute_id, const Tile* tile) {
+  auto array_schema = fragment_->query()->array_schema();
+  if (attribute_id == array_schema->attribute_num())
+    return Status::Ok();
+
+  TileStats stats;
+  RETURN_NOT_OK(stats.compute(
+      array_schema->type(attribute_id),
+      tile->data(),
+      tile->size(),
+      metadata_->dense()));
+  metadata_->append_tile_stats(attribute_id, stats);
+
+  return Status::Ok();
+}
+
+uint64_t WriteState::bloom_filter_bits_per_key() const {
+  auto storage_manager = fragment_->query()->storage_manager();
+  return storage_manager->config().sm_params().kv_bloom_filter_bits_per_key_;
+}
+
+void WriteState::build_bloom_filter(const void* coords, uint64_t coords_size) {
+  auto array_schema = fragment_->query()->array_schema();
+  auto key_num = coords_size / array_schema->coords_size();
+  auto keys = static_cast<const uint64_t*>(coords);
+  auto bloom_filter = new BloomFilter();
+  bloom_filter->init(key_num, bloom_filter_bits_per_key());
+  for (uint64_t i = 0; i < key_num; ++i)
+    bloom_filter->add(keys[2 * i], keys[2 * i + 1]);
+  metadata_->set_bloom_filter(bloom_filter);
+}
+
+Status WriteState::copy_file(
+    const URI& src_uri, const URI& dst_uri, uint64_t size) const {
+  auto storage_manager = fragment_->query()->storage_manager();
+  auto buff = new Buffer();
+  for (uint64_t offset = 0; offset < size;) {
+    auto nbytes = std::min(size - offset, constants::consolidation_buffer_size);
+    RETURN_NOT_OK_ELSE(
+        storage_manager->read(src_uri, offset, buff, nbytes), delete buff);
+    RETURN_NOT_OK_ELSE(storage_manager->write(dst_uri, buff), delete buff);
+    offset += nbytes;
+  }
+  delete buff;
+
+  return Status::Ok();
+}
+
 template <class T>
 void WriteState::expand_mbr(const T* coords) {
   // For easy reference
@@ -263,7 +395,11 @@ void WriteState::init_tiles() {
         (var_size) ? constants::cell_var_offset_size : attr->cell_size(),
         0));
 
+    // The attribute filters run on the attribute values, whereas the
+    // offsets are filtered depending on their compressor
     if (var_size) {
+      tiles_.back()->set_filters(FilterPipeline::var_offsets_filters(
+          array_schema->cell_var_offsets_compression()));
       tiles_var_.emplace_back(new Tile(
           attr->type(),
           attr->compressor(),
@@ -271,9 +407,26 @@ void WriteState::init_tiles() {
           fragment_->tile_size(i),
           datatype_size(attr->type()),
           0));
+      tiles_var_.back()->set_filters(attr->filters());
     } else {
+      tiles_.back()->set_filters(attr->filters());
       tiles_var_.emplace_back(nullptr);
     }
+
+    // The dictionary-encoded values are filtered and compressed instead
+    // of the values themselves
+    if (attr->dictionary_encoding()) {
+      tiles_dict_.emplace_back(new Tile(
+          attr->type(),
+          attr->compressor(),
+          attr->compression_level(),
+          fragment_->tile_size(i),
+          datatype_size(attr->type()),
+          0));
+      tiles_dict_.back()->set_filters(attr->filters());
+    } else {
+      tiles_dict_.emplace_back(nullptr);
+    }
   }
   tiles_.emplace_back(new Tile(
       array_schema->coords_type(),
@@ -473,6 +626,7 @@ Status WriteState::update_metadata(const void* buffer, uint64_t buffer_size) {
     if (tile_cell_num == capacity) {
       RETURN_NOT_OK(metadata_->append_mbr<T>(mbr_));
       metadata_->append_bounding_coords(bounding_coords_);
+      metadata_->append_tile_cell_num(tile_cell_num);
       tile_cell_num = 0;
     }
   }
@@ -504,6 +658,7 @@ Status WriteState::write_attr(
   do {
     RETURN_NOT_OK(tile->write(buf));
     if (tile->full()) {
+      RETURN_NOT_OK(append_tile_stats(attribute_id, tile));
       RETURN_NOT_OK(tile_io->write(tile, &bytes_written));
       metadata_->append_tile_offset(attribute_id, bytes_written);
       tile->reset_offset();
@@ -527,6 +682,7 @@ Status WriteState::write_attr_last(unsigned int attribute_id) {
 
   // Fill tiles and dispatch them for writing
   uint64_t bytes_written;
+  RETURN_NOT_OK(append_tile_stats(attribute_id, tile));
   RETURN_NOT_OK(tile_io->write(tile, &bytes_written));
   metadata_->append_tile_offset(attribute_id, bytes_written);
   tile->reset_offset();
@@ -553,7 +709,6 @@ Status WriteState::write_attr_var(
   auto tile = tiles_[attribute_id];
   auto tile_var = tiles_var_[attribute_id];
   auto tile_io = tile_io_[attribute_id];
-  auto tile_io_var = tile_io_var_[attribute_id];
 
   // Fill tiles and dispatch them for writing
   uint64_t bytes_written = 0;
@@ -570,8 +725,8 @@ Status WriteState::write_attr_var(
     RETURN_NOT_OK(tile_var->write(buf_var, bytes_to_write_var));
 
     if (tile->full()) {
+      RETURN_NOT_OK(write_tile_var(attribute_id, &bytes_written_var));
       RETURN_NOT_OK(tile_io->write(tile, &bytes_written));
-      RETURN_NOT_OK(tile_io_var->write(tile_var, &bytes_written_var));
       metadata_->append_tile_offset(attribute_id, bytes_written);
       metadata_->append_tile_var_offset(attribute_id, bytes_written_var);
       metadata_->append_tile_var_size(attribute_id, tile_var->size());
@@ -597,12 +752,11 @@ Status WriteState::write_attr_var_last(unsigned int attribute_id) {
   auto tile = tiles_[attribute_id];
   auto tile_var = tiles_var_[attribute_id];
   auto tile_io = tile_io_[attribute_id];
-  auto tile_io_var = tile_io_var_[attribute_id];
 
   // Fill tiles and dispatch them for writing
   uint64_t bytes_written, bytes_written_var;
+  RETURN_NOT_OK(write_tile_var(attribute_id, &bytes_written_var));
   RETURN_NOT_OK(tile_io->write(tile, &bytes_written));
-  RETURN_NOT_OK(tile_io_var->write(tile_var, &bytes_written_var));
   metadata_->append_tile_offset(attribute_id, bytes_written);
   metadata_->append_tile_var_offset(attribute_id, bytes_written_var);
   metadata_->append_tile_var_size(attribute_id, tile_var->size());
@@ -612,28 +766,41 @@ Status WriteState::write_attr_var_last(unsigned int attribute_id) {
   return Status::Ok();
 }
 
-Status WriteState::write_last_tile() {
+Status WriteState::write_current_tile() {
   // For easy reference
   auto array_schema = fragment_->query()->array_schema();
   auto attribute_num = array_schema->attribute_num();
 
-  // Send last MBR, bounding coordinates and tile cell number to metadata
-  metadata_->append_mbr(mbr_);
+  // Send MBR, bounding coordinates and tile cell number to metadata
+  RETURN_NOT_OK(metadata_->append_mbr(mbr_));
   metadata_->append_bounding_coords(bounding_coords_);
-  metadata_->set_last_tile_cell_num(tile_cell_num_[attribute_num]);
+  metadata_->append_tile_cell_num(tile_cell_num_[attribute_num]);
+  tile_cell_num_[attribute_num] = 0;
 
-  // Flush the last tile for each compressed attribute (it is still in main
-  // memory
+  // Flush the current tile for each attribute (it is still in main memory)
   for (unsigned int i = 0; i < attribute_num + 1; ++i) {
-    RETURN_NOT_OK(write_attr_last(i));
-    if (array_schema->var_size(i))
+    if (array_schema->var_size(i)) {
       RETURN_NOT_OK(write_attr_var_last(i));
+      tiles_var_[i]->set_size(0);
+    } else {
+      RETURN_NOT_OK(write_attr_last(i));
+    }
+    tiles_[i]->set_size(0);
   }
 
   // Success
   return Status::Ok();
 }
 
+Status WriteState::write_last_tile() {
+  // For easy reference
+  auto array_schema = fragment_->query()->array_schema();
+  auto attribute_num = array_schema->attribute_num();
+
+  metadata_->set_last_tile_cell_num(tile_cell_num_[attribute_num]);
+  return write_current_tile();
+}
+
 Status WriteState::write_sparse_unsorted(
     void** buffers, uint64_t* buffer_sizes) {
   // For easy reference
@@ -651,6 +818,13 @@ Status WriteState::write_sparse_unsorted(
   sort_cell_pos(
       buffers[coords_buffer_i], buffer_sizes[coords_buffer_i], &cell_pos);
 
+  // A key-value store fragment is written in a single unordered submission,
+  // so its bloom filter is built over the input coordinates right away
+  if (array_schema->is_kv() && bloom_filter_bits_per_key() != 0 &&
+      buffer_sizes[coords_buffer_i] != 0)
+    build_bloom_filter(
+        buffers[coords_buffer_i], buffer_sizes[coords_buffer_i]);
+
   // Write each attribute individually
   int buffer_i = 0;
   for (int i = 0; i < attribute_id_num; ++i) {
@@ -811,4 +985,23 @@ Status WriteState::write_sparse_unsorted_attr_var(
   return st;
 }
 
+Status WriteState::write_tile_var(
+    unsigned int attribute_id, uint64_t* bytes_written) {
+  auto tile_var = tiles_var_[attribute_id];
+  auto tile_dict = tiles_dict_[attribute_id];
+  auto tile_io_var = tile_io_var_[attribute_id];
+  if (tile_dict == nullptr)
+    return tile_io_var->write(tile_var, bytes_written);
+
+  // Encode the values, whose cell offsets are in the offsets tile
+  auto tile = tiles_[attribute_id];
+  ConstBuffer offsets(tile->data(), tile->size());
+  ConstBuffer values(tile_var->data(), tile_var->size());
+  tile_dict->reset_offset();
+  tile_dict->reset_size();
+  RETURN_NOT_OK(DictEncoder::encode(&offsets, &values, tile_dict->buffer()));
+
+  return tile_io_var->write(tile_dict, bytes_written);
+}
+
 }  // namespace tiledb
@@ -33,6 +33,7 @@
 #include "kv.h"
 #include "logger.h"
 
+#include <algorithm>
 #include <cassert>
 
 namespace tiledb {
@@ -199,27 +200,15 @@ Status KV::get_item(
   }
 
   // Set values
-  unsigned bid = 0, aid = 0;
-  const void* value = nullptr;
-  uint64_t value_size = 0;
-  for (const auto& attr : attributes_) {
-    auto var = read_attribute_var_sizes_[aid];
-    value = read_buffers_[bid + int(var)];
-    value_size = read_buffer_sizes_[bid + (int)var];
-    st = (*kv_item)->set_value(
-        attr, value, read_attribute_types_[aid++], value_size);
-    if (!st.ok()) {
-      delete *kv_item;
-      *kv_item = nullptr;
-      mtx_.unlock();
-      return st;
-    }
-    bid += 1 + (int)var;
+  st = populate_item(0, (*kv_item)->hash(), *kv_item);
+  if (!st.ok()) {
+    delete *kv_item;
+    *kv_item = nullptr;
   }
 
   mtx_.unlock();
 
-  return Status::Ok();
+  return st;
 }
 
 Status KV::get_item(const KVItem::Hash& hash, KVItem** kv_item) {
@@ -239,60 +228,74 @@ Status KV::get_item(const KVItem::Hash& hash, KVItem** kv_item) {
   }
 
   // Set key and values
-  unsigned bid = 0, aid = 0;
-  const void* value = nullptr;
-  const void* key = nullptr;
-  uint64_t key_size = 0;
-  uint64_t value_size = 0;
-  Datatype key_type = Datatype::CHAR;
-  bool key_found = false;
-  bool key_type_found = false;
-  for (const auto& attr : attributes_) {
-    // Set key
-    if (attr == constants::key_attr_name) {
-      key = read_buffers_[bid + 1];
-      key_size = read_buffer_sizes_[bid + 1];
-      aid++;
-      bid += 2;
-      key_found = true;
-      continue;
-    }
+  st = populate_item(0, hash, *kv_item);
+  if (!st.ok()) {
+    delete *kv_item;
+    *kv_item = nullptr;
+  }
 
-    // Set key type
-    if (attr == constants::key_type_attr_name) {
-      key_type = static_cast<Datatype>(((char*)read_buffers_[bid])[0]);
-      aid++;
-      bid++;
-      key_type_found = true;
+  return st;
+}
+
+Status KV::get_items(
+    const void** keys,
+    const Datatype* key_types,
+    const uint64_t* key_sizes,
+    unsigned key_num,
+    KVItem** kv_items) {
+  for (unsigned i = 0; i < key_num; ++i)
+    kv_items[i] = nullptr;
+
+  mtx_.lock();
+
+  // Serve the buffered items and collect the hashes of the rest
+  auto st = Status::Ok();
+  std::vector<std::pair<KVItem::Hash, unsigned>> hashes;
+  KVItem::Hash hash;
+  for (unsigned i = 0; i < key_num; ++i) {
+    hash = KVItem::compute_hash(keys[i], key_types[i], key_sizes[i]);
+    auto it = items_.find(hash);
+    if (it == items_.end()) {
+      hashes.emplace_back(hash, i);
       continue;
     }
-
-    // Set values
-    auto var = read_attribute_var_sizes_[aid];
-    value = read_buffers_[bid + int(var)];
-    value_size = read_buffer_sizes_[bid + (int)var];
-    st = (*kv_item)->set_value(
-        attr, value, read_attribute_types_[aid++], value_size);
-    if (!st.ok()) {
-      delete *kv_item;
-      *kv_item = nullptr;
-      return st;
+    kv_items[i] = new (std::nothrow) KVItem();
+    if (kv_items[i] == nullptr) {
+      st = LOG_STATUS(
+          Status::KVError("Cannot get items; Memory allocation failed"));
+      break;
     }
-    bid += 1 + (int)var;
+    *kv_items[i] = *(it->second);
   }
 
-  // Set key
-  assert(key_found && key_type_found);
-  if (key_found && key_type_found) {
-    auto st = (*kv_item)->set_key(key, key_type, key_size, hash);
-    if (!st.ok()) {
-      delete *kv_item;
-      *kv_item = nullptr;
-      return st;
+  // Sort the hashes in the global cell order and resolve them in groups
+  std::vector<std::pair<size_t, size_t>> groups;
+  if (st.ok()) {
+    std::sort(hashes.begin(), hashes.end());
+    st = group_hashes(hashes, &groups);
+  }
+  for (size_t g = 0; st.ok() && g < groups.size(); ++g)
+    st = read_items(hashes, groups[g].first, groups[g].second, kv_items);
+
+  // Set the keys of the retrieved items
+  for (size_t h = 0; st.ok() && h < hashes.size(); ++h) {
+    auto i = hashes[h].second;
+    if (kv_items[i] != nullptr)
+      st = kv_items[i]->set_key(
+          keys[i], key_types[i], key_sizes[i], hashes[h].first);
+  }
+
+  // Clean up upon error
+  if (!st.ok()) {
+    for (unsigned i = 0; i < key_num; ++i) {
+      delete kv_items[i];
+      kv_items[i] = nullptr;
     }
   }
 
-  return Status::Ok();
+  mtx_.unlock();
+
+  return st;
 }
 
 Status KV::flush() {
@@ -430,6 +433,60 @@ void KV::clear_write_buffers() {
   write_buffer_sizes_ = nullptr;
 }
 
+Status KV::group_hashes(
+    const std::vector<std::pair<KVItem::Hash, unsigned>>& hashes,
+    std::vector<std::pair<size_t, size_t>>* groups) {
+  groups->clear();
+  if (hashes.empty())
+    return Status::Ok();
+
+  // Get the tile bounding coordinates of all fragments
+  std::vector<std::vector<uint8_t>> bounding_coords;
+  RETURN_NOT_OK(storage_manager_->array_get_tile_bounding_coords(
+      kv_uri_.c_str(), &bounding_coords));
+
+  // For each hash, find the tile that contains it in each fragment,
+  // comparing the bounding coordinates in the global (row-major) order
+  auto fragment_num = bounding_coords.size();
+  std::vector<uint64_t> tile_ids(fragment_num), prev_tile_ids(fragment_num);
+  bool in_tile, prev_in_tile = false;
+  for (size_t i = 0; i < hashes.size(); ++i) {
+    const auto& hash = hashes[i].first;
+    in_tile = false;
+    for (size_t f = 0; f < fragment_num; ++f) {
+      auto coords = (const uint64_t*)bounding_coords[f].data();
+      uint64_t tile_num = bounding_coords[f].size() / (4 * sizeof(uint64_t));
+      uint64_t lo = 0, hi = tile_num;
+      while (lo < hi) {  // First tile whose last coordinates are >= hash
+        auto mid = lo + (hi - lo) / 2;
+        KVItem::Hash last(coords[4 * mid + 2], coords[4 * mid + 3]);
+        if (last < hash)
+          lo = mid + 1;
+        else
+          hi = mid;
+      }
+      tile_ids[f] = lo;
+      if (lo < tile_num &&
+          KVItem::Hash(coords[4 * lo], coords[4 * lo + 1]) <= hash)
+        in_tile = true;
+      else
+        tile_ids[f] = tile_num;  // Not in any tile of this fragment
+    }
+
+    // Hashes outside every tile do not exist
+    if (in_tile) {
+      if (prev_in_tile && tile_ids == prev_tile_ids)
+        groups->back().second = i + 1;
+      else
+        groups->emplace_back(i, i + 1);
+    }
+    prev_in_tile = in_tile;
+    std::swap(tile_ids, prev_tile_ids);
+  }
+
+  return Status::Ok();
+}
+
 Status KV::init_read_buffers() {
   for (unsigned i = 0; i < read_buffer_num_; ++i) {
     auto buff = new Buffer();
@@ -440,6 +497,65 @@ Status KV::init_read_buffers() {
   return Status::Ok();
 }
 
+Status KV::populate_item(
+    uint64_t pos, const KVItem::Hash& hash, KVItem* kv_item) {
+  // The cell number is derived from the coordinates, which are last
+  uint64_t cell_num =
+      read_buffer_sizes_[read_buffer_num_ - 1] / (2 * sizeof(uint64_t));
+  assert(pos < cell_num);
+
+  unsigned bid = 0, aid = 0;
+  const void* value = nullptr;
+  const void* key = nullptr;
+  uint64_t key_size = 0;
+  uint64_t value_size = 0;
+  Datatype key_type = Datatype::CHAR;
+  bool key_found = false;
+  bool key_type_found = false;
+  for (const auto& attr : attributes_) {
+    // Locate the cell value
+    if (read_attribute_var_sizes_[aid]) {
+      auto offsets = (const uint64_t*)read_buffers_[bid];
+      auto start = offsets[pos];
+      auto end = (pos + 1 < cell_num) ? offsets[pos + 1] :
+                                        read_buffer_sizes_[bid + 1];
+      value = (const char*)read_buffers_[bid + 1] + start;
+      value_size = end - start;
+    } else {
+      value_size = read_buffer_sizes_[bid] / cell_num;
+      value = (const char*)read_buffers_[bid] + pos * value_size;
+    }
+    bid += 1 + (int)read_attribute_var_sizes_[aid];
+
+    // Set key
+    if (attr == constants::key_attr_name) {
+      key = value;
+      key_size = value_size;
+      aid++;
+      key_found = true;
+      continue;
+    }
+
+    // Set key type
+    if (attr == constants::key_type_attr_name) {
+      key_type = static_cast<Datatype>(((const char*)value)[0]);
+      aid++;
+      key_type_found = true;
+      continue;
+    }
+
+    // Set values
+    RETURN_NOT_OK(kv_item->set_value(
+        attr, value, read_attribute_types_[aid++], value_size));
+  }
+
+  // Set key
+  if (key_found && key_type_found)
+    RETURN_NOT_OK(kv_item->set_key(key, key_type, key_size, hash));
+
+  return Status::Ok();
+}
+
 Status KV::populate_write_buffers() {
   // Reset buffers
   for (auto buff : write_buff_vec_)
@@ -516,7 +632,8 @@ Status KV::prepare_query_attributes() {
 }
 
 Status KV::prepare_read_attributes() {
-  read_attribute_num_ = (unsigned)attributes_.size();
+  // +1 because of the coordinates
+  read_attribute_num_ = (unsigned)attributes_.size() + 1;
   read_attributes_ = new (std::nothrow) char*[read_attribute_num_];
   if (read_attributes_ == nullptr)
     return LOG_STATUS(Status::KVItemError(
@@ -533,6 +650,15 @@ Status KV::prepare_read_attributes() {
     read_attribute_var_sizes_[i++] = schema_->var_size(aid);
   }
 
+  // Coords
+  read_attributes_[i] = new (std::nothrow) char[strlen(constants::coords) + 1];
+  if (read_attributes_[i] == nullptr)
+    return LOG_STATUS(Status::KVItemError(
+        "Cannot prepare read attributes; Memory allocation failed"));
+  strcpy(read_attributes_[i], constants::coords);
+  read_attribute_types_[i] = schema_->coords_type();
+  read_attribute_var_sizes_[i] = false;
+
   return Status::Ok();
 }
 
@@ -612,9 +738,62 @@ Status KV::read_item(const KVItem::Hash& hash, bool* found) {
   return Status::Ok();
 }
 
-Status KV::realloc_read_buffers() {
+Status KV::read_items(
+    const std::vector<std::pair<KVItem::Hash, unsigned>>& hashes,
+    size_t start,
+    size_t end,
+    KVItem** kv_items) {
+  assert(start < end && end <= hashes.size());
+  RETURN_NOT_OK(prepare_read_buffers());
+
+  // The subarray is the bounding box of the group hashes
+  uint64_t subarray[4];
+  subarray[0] = hashes[start].first.first;
+  subarray[1] = hashes[end - 1].first.first;
+  subarray[2] = hashes[start].first.second;
+  subarray[3] = hashes[start].first.second;
+  for (auto i = start + 1; i < end; ++i) {
+    subarray[2] = std::min(subarray[2], hashes[i].first.second);
+    subarray[3] = std::max(subarray[3], hashes[i].first.second);
+  }
+
+  // A multi-cell read may overflow without zeroing any buffer size,
+  // hence all buffers are grown upon an incomplete query
+  QueryStatus query_status;
+  do {
+    RETURN_NOT_OK(submit_read_query(subarray, &query_status));
+    if (query_status == QueryStatus::INCOMPLETE)
+      RETURN_NOT_OK(realloc_read_buffers(true));
+  } while (query_status != QueryStatus::COMPLETED);
+
+  // Match the result cells against the group hashes. The bounding box
+  // may also contain cells of keys that were not requested.
+  auto coords = (const uint64_t*)read_buffers_[read_buffer_num_ - 1];
+  uint64_t cell_num =
+      read_buffer_sizes_[read_buffer_num_ - 1] / (2 * sizeof(uint64_t));
+  auto first = hashes.begin() + start;
+  auto last = hashes.begin() + end;
+  for (uint64_t c = 0; c < cell_num; ++c) {
+    KVItem::Hash hash(coords[2 * c], coords[2 * c + 1]);
+    auto it = std::lower_bound(
+        first, last, std::pair<KVItem::Hash, unsigned>(hash, 0));
+    for (; it != last && it->first == hash; ++it) {
+      auto& kv_item = kv_items[it->second];
+      delete kv_item;
+      kv_item = new (std::nothrow) KVItem();
+      if (kv_item == nullptr)
+        return LOG_STATUS(
+            Status::KVError("Cannot get items; Memory allocation failed"));
+      RETURN_NOT_OK(populate_item(c, hash, kv_item));
+    }
+  }
+
+  return Status::Ok();
+}
+
+Status KV::realloc_read_buffers(bool all) {
   for (unsigned i = 0; i < read_buffer_num_; ++i) {
-    if (read_buffer_sizes_[i] == 0) {
+    if (all || read_buffer_sizes_[i] == 0) {
       read_buff_vec_[i]->realloc(2 * read_buff_vec_[i]->alloced_size());
       read_buffers_[i] = read_buff_vec_[i]->data();
       read_buffer_sizes_[i] = read_buff_vec_[i]->alloced_size();
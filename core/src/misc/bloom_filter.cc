@@ -0,0 +1,111 @@
+/**
+ * @file   bloom_filter.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class BloomFilter.
+ */
+
+
+#include "bloom_filter.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tiledb {
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+BloomFilter::BloomFilter() {
+  bit_num_ = 0;
+  hash_num_ = 0;
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+void BloomFilter::add(uint64_t h1, uint64_t h2) {
+  for (uint32_t i = 0; i < hash_num_; ++i) {
+    auto pos = (h1 + i * h2) % bit_num_;
+    bits_[pos / 64] |= uint64_t(1) << (pos % 64);
+  }
+}
+
+uint64_t BloomFilter::bit_num() const {
+  return bit_num_;
+}
+
+// ===== FORMAT =====
+// bit_num (uint64_t)
+// hash_num (uint32_t)
+// bits_#1 (uint64_t) bits_#2 (uint64_t) ...
+Status BloomFilter::deserialize(ConstBuffer* buff) {
+  RETURN_NOT_OK(buff->read(&bit_num_, sizeof(uint64_t)));
+  RETURN_NOT_OK(buff->read(&hash_num_, sizeof(uint32_t)));
+  if (bit_num_ == 0 || bit_num_ % 64 != 0 || hash_num_ == 0)
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot deserialize bloom filter; Invalid filter parameters"));
+  bits_.resize(bit_num_ / 64);
+  return buff->read(&bits_[0], bits_.size() * sizeof(uint64_t));
+}
+
+uint32_t BloomFilter::hash_num() const {
+  return hash_num_;
+}
+
+void BloomFilter::init(uint64_t item_num, uint64_t bits_per_item) {
+  // Round the number of bits up to whole words
+  bit_num_ = std::max<uint64_t>(item_num * bits_per_item, 64);
+  bit_num_ = ((bit_num_ + 63) / 64) * 64;
+  bits_.assign(bit_num_ / 64, 0);
+
+  // The optimal number of probes is ln(2) * bits_per_item
+  auto hash_num = (uint32_t)std::lround(0.69314718 * bits_per_item);
+  hash_num_ = std::min<uint32_t>(std::max<uint32_t>(hash_num, 1), 30);
+}
+
+bool BloomFilter::may_contain(uint64_t h1, uint64_t h2) const {
+  for (uint32_t i = 0; i < hash_num_; ++i) {
+    auto pos = (h1 + i * h2) % bit_num_;
+    if ((bits_[pos / 64] & (uint64_t(1) << (pos % 64))) == 0)
+      return false;
+  }
+
+  return true;
+}
+
+Status BloomFilter::serialize(Buffer* buff) const {
+  RETURN_NOT_OK(buff->write(&bit_num_, sizeof(uint64_t)));
+  RETURN_NOT_OK(buff->write(&hash_num_, sizeof(uint32_t)));
+  return buff->write(&bits_[0], bits_.size() * sizeof(uint64_t));
+}
+
+}  // namespace tiledb
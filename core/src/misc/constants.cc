@@ -55,9 +55,28 @@ const char* array_schema_filename = "__array_schema.tdb";
 /** The key-value schema file name. */
 const char* kv_schema_filename = "__kv_schema.tdb";
 
+/** The consolidated fragment metadata file name. */
+const char* consolidated_fragment_metadata_filename =
+    "__consolidated_fragment_metadata.tdb";
+
 /** The fragment file name. */
 const char* fragment_filename = "__fragment.tdb";
 
+/**
+ * The fragment manifest directory name, used on object stores that do not
+ * support appends, where every append is an object of its own.
+ */
+const char* fragment_manifest_dirname = "__fragment_manifest";
+
+/** The fragment manifest file name. */
+const char* fragment_manifest_filename = "__fragment_manifest.tdb";
+
+/**
+ * The number of attempts to load a fragment manifest stored in parts, whose
+ * parts may be deleted by a concurrent compaction while being loaded.
+ */
+const unsigned fragment_manifest_load_attempts = 3;
+
 /** The fragment metadata file name. */
 const char* fragment_metadata_filename = "__fragment_metadata.tdb";
 
@@ -130,6 +149,9 @@ const uint64_t empty_uint64 = std::numeric_limits<uint64_t>::max();
 /** The file suffix used in TileDB. */
 const char* file_suffix = ".tdb";
 
+/** The suffix of temporary files, which are moved in place when complete. */
+const char* tmp_file_suffix = ".tmp";
+
 /** Default datatype for a generic tile. */
 const Datatype generic_tile_datatype = Datatype::CHAR;
 
@@ -183,6 +205,82 @@ const uint64_t fragment_metadata_cache_size = 10000000;
 /** The tile cache size. */
 const uint64_t tile_cache_size = 10000000;
 
+/** The number of threads in the storage manager thread pool. */
+const uint64_t thread_pool_size = 4;
+
+/**
+ * The file the execution trace is dumped into when the context is freed.
+ * Empty means that tracing is disabled.
+ */
+const char* trace_file = "";
+
+/** The number of trace spans buffered per thread. */
+const uint64_t trace_buffer_event_num = 65536;
+
+/**
+ * The number of local buffer sets used in ordered writes, i.e., the number of
+ * tile slabs that can be in flight at any time.
+ */
+const uint64_t ordered_write_buffer_num = 2;
+
+/** The memory budget (in bytes) for the buffers of a query iterator. */
+const uint64_t query_iter_memory_budget = 10000000;
+
+/**
+ * The compressors among which `Compressor::AUTO` picks one for every tile,
+ * as a comma-separated list of compressor names.
+ */
+const char* compression_auto_candidates =
+    "NO_COMPRESSION,LZ4,ZSTD,DOUBLE_DELTA,BITPACK,GORILLA";
+
+/**
+ * The storage read bandwidth (in bytes per second) against which
+ * `Compressor::AUTO` weighs the compressed size of a tile and its
+ * decompression time. Zero picks the compressor with the smallest output.
+ */
+const uint64_t compression_auto_bandwidth = 0;
+
+/** The number of bytes of a tile that `Compressor::AUTO` samples. */
+const uint64_t compression_auto_sample_size = 65536;
+
+/**
+ * The number of bloom filter bits per key built for every key-value store
+ * fragment. Zero disables the bloom filters.
+ */
+const uint64_t kv_bloom_filter_bits_per_key = 10;
+
+/**
+ * Whether read queries skip the shared lock of the array and rely only on
+ * the read snapshots registered in the process. Snapshots do not protect
+ * readers in other processes against a concurrent consolidation, so this
+ * is safe only if a single process reads and consolidates the array.
+ */
+const bool lock_free_reads = false;
+
+/**
+ * The maximum ratio between the sizes of the largest and the smallest
+ * fragment merged together by a consolidation. Zero disables the size
+ * check, i.e., fragments of any size are merged together.
+ */
+const float consolidation_size_ratio = 0.0f;
+
+/** The minimum number of fragments merged together by a consolidation. */
+const uint64_t consolidation_min_fragments = 2;
+
+/**
+ * The maximum number of fragments merged together by a consolidation. Zero
+ * means that there is no limit.
+ */
+const uint64_t consolidation_max_fragments = 0;
+
+/**
+ * The total memory budget (in bytes) of the buffers used by a consolidation.
+ * The budget is split evenly across the two batches of buffers that are
+ * used for overlapping reading with writing. Zero means that every buffer
+ * gets `consolidation_buffer_size` bytes.
+ */
+const uint64_t consolidation_memory_budget = 0;
+
 /** String describing GZIP. */
 const char* gzip_str = "GZIP";
 
@@ -219,6 +317,27 @@ const char* bzip2_str = "BZIP2";
 /** String describing DOUBLE_DELTA. */
 const char* double_delta_str = "DOUBLE_DELTA";
 
+/** String describing BITPACK. */
+const char* bitpack_str = "BITPACK";
+
+/** String describing GORILLA. */
+const char* gorilla_str = "GORILLA";
+
+/** String describing AUTO. */
+const char* auto_str = "AUTO";
+
+/** String describing FILTER_BYTESHUFFLE. */
+const char* filter_byteshuffle_str = "BYTESHUFFLE";
+
+/** String describing FILTER_BITSHUFFLE. */
+const char* filter_bitshuffle_str = "BITSHUFFLE";
+
+/** String describing FILTER_DELTA. */
+const char* filter_delta_str = "DELTA";
+
+/** String describing FILTER_DOUBLE_DELTA. */
+const char* filter_double_delta_str = "DOUBLE_DELTA";
+
 /** The string representation for type int32. */
 const char* int32_str = "INT32";
 
@@ -274,7 +393,22 @@ const char* unordered_str = "unordered";
 const char* null_str = "null";
 
 /** The version in format { major, minor, revision }. */
-const int version[3] = {1, 2, 0};
+const int version[3] = {1, 3, 0};
+
+/**
+ * The first version whose fragments filter the offsets tiles of the
+ * variable-sized attributes prior to compression.
+ */
+const int var_offsets_filters_version[3] = {1, 3, 0};
+
+/** The first version whose array schemas store the attribute filters. */
+const int filters_version[3] = {1, 3, 0};
+
+/**
+ * The first version whose array schemas store the dictionary encoding flag
+ * of the attributes.
+ */
+const int dictionary_encoding_version[3] = {1, 3, 0};
 
 /** The size of a tile chunk. */
 const uint64_t tile_chunk_size = (uint64_t)std::numeric_limits<int>::max();
@@ -0,0 +1,169 @@
+/**
+ * @file   stats.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements classes Stats and ScopedTimer.
+ */
+
+#include "stats.h"
+
+#include <sstream>
+
+namespace tiledb {
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+Stats::Stats() {
+  parent_ = nullptr;
+  reset();
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+void Stats::add(Counter counter, uint64_t value) {
+  for (auto stats = this; stats != nullptr; stats = stats->parent_)
+    stats->counters_[(unsigned int)counter].fetch_add(
+        value, std::memory_order_relaxed);
+}
+
+void Stats::add_time(Timer timer, uint64_t nanos) {
+  for (auto stats = this; stats != nullptr; stats = stats->parent_)
+    stats->timers_[(unsigned int)timer].fetch_add(
+        nanos, std::memory_order_relaxed);
+}
+
+uint64_t Stats::counter(Counter counter) const {
+  return counters_[(unsigned int)counter].load(std::memory_order_relaxed);
+}
+
+void Stats::reset() {
+  for (auto& c : counters_)
+    c.store(0, std::memory_order_relaxed);
+  for (auto& t : timers_)
+    t.store(0, std::memory_order_relaxed);
+}
+
+void Stats::set_parent(Stats* parent) {
+  parent_ = parent;
+}
+
+uint64_t Stats::timer(Timer timer) const {
+  return timers_[(unsigned int)timer].load(std::memory_order_relaxed);
+}
+
+std::string Stats::to_json() const {
+  std::stringstream ss;
+  ss << "{\n";
+  for (unsigned int i = 0; i < (unsigned int)Counter::COUNTER_NUM; ++i)
+    ss << "  \"" << counter_str((Counter)i) << "\": " << counter((Counter)i)
+       << ",\n";
+  for (unsigned int i = 0; i < (unsigned int)Timer::TIMER_NUM; ++i) {
+    ss << "  \"" << timer_str((Timer)i) << "\": " << timer((Timer)i);
+    ss << ((i + 1 < (unsigned int)Timer::TIMER_NUM) ? ",\n" : "\n");
+  }
+  ss << "}\n";
+
+  return ss.str();
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+const char* Stats::counter_str(Counter counter) {
+  switch (counter) {
+    case Counter::TILE_READ_NUM:
+      return "tile_read_num";
+    case Counter::TILE_CACHE_HIT_NUM:
+      return "tile_cache_hit_num";
+    case Counter::TILE_CACHE_MISS_NUM:
+      return "tile_cache_miss_num";
+    case Counter::TILE_CACHE_HIT_BYTES:
+      return "tile_cache_hit_bytes";
+    case Counter::TILE_CACHE_EVICT_NUM:
+      return "tile_cache_evict_num";
+    case Counter::VFS_READ_NUM:
+      return "vfs_read_num";
+    case Counter::VFS_READ_BYTES:
+      return "vfs_read_bytes";
+    case Counter::DECOMPRESSED_BYTES:
+      return "decompressed_bytes";
+    case Counter::CELL_COPY_BYTES:
+      return "cell_copy_bytes";
+    case Counter::DIRECT_READ_BYTES:
+      return "direct_read_bytes";
+    case Counter::CONDITION_TILE_SKIP_NUM:
+      return "condition_tile_skip_num";
+    default:
+      return "";
+  }
+}
+
+const char* Stats::timer_str(Timer timer) {
+  switch (timer) {
+    case Timer::QUERY_READ:
+      return "query_read_ns";
+    case Timer::VFS_READ:
+      return "vfs_read_ns";
+    case Timer::DECOMPRESS:
+      return "decompress_ns";
+    case Timer::FRAGMENT_MERGE:
+      return "fragment_merge_ns";
+    case Timer::CELL_COPY:
+      return "cell_copy_ns";
+    default:
+      return "";
+  }
+}
+
+/* ****************************** */
+/*           ScopedTimer          */
+/* ****************************** */
+
+ScopedTimer::ScopedTimer(Stats* stats, Stats::Timer timer)
+    : start_(std::chrono::steady_clock::now())
+    , stats_(stats)
+    , timer_(timer) {
+}
+
+ScopedTimer::~ScopedTimer() {
+  if (stats_ == nullptr)
+    return;
+
+  auto elapsed = std::chrono::steady_clock::now() - start_;
+  stats_->add_time(
+      timer_,
+      (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+          .count());
+}
+
+}  // namespace tiledb
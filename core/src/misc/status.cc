@@ -170,6 +170,9 @@ std::string Status::code_to_string() const {
     case StatusCode::KVIter:
       type = "[TileDB::KVIter] Error";
       break;
+    case StatusCode::QueryIter:
+      type = "[TileDB::QueryIter] Error";
+      break;
     case StatusCode::Config:
       type = "[TileDB::Config] Error";
       break;
@@ -182,6 +185,15 @@ std::string Status::code_to_string() const {
     case StatusCode::FS_HDFS:
       type = "[TileDB::HDFS] Error";
       break;
+    case StatusCode::ThreadPool:
+      type = "[TileDB::ThreadPool] Error";
+      break;
+    case StatusCode::Tracer:
+      type = "[TileDB::Tracer] Error";
+      break;
+    case StatusCode::FilterPipeline:
+      type = "[TileDB::FilterPipeline] Error";
+      break;
     default:
       type = "[TileDB::?] Error:";
   }
@@ -0,0 +1,144 @@
+/**
+ * @file   thread_pool.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class ThreadPool.
+ */
+
+#include "thread_pool.h"
+#include "logger.h"
+
+namespace tiledb {
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+ThreadPool::ThreadPool() {
+  should_terminate_ = false;
+}
+
+ThreadPool::~ThreadPool() {
+  terminate();
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+std::future<Status> ThreadPool::enqueue(
+    const std::function<Status()>& function) {
+  if (threads_.empty()) {
+    LOG_STATUS(Status::ThreadPoolError(
+        "Cannot enqueue task; Thread pool uninitialized"));
+    return std::future<Status>();
+  }
+
+  std::packaged_task<Status()> task(function);
+  auto future = task.get_future();
+  {
+    std::lock_guard<std::mutex> lck(queue_mtx_);
+    if (should_terminate_) {
+      LOG_STATUS(Status::ThreadPoolError(
+          "Cannot enqueue task; Thread pool is terminating"));
+      return std::future<Status>();
+    }
+    task_queue_.push(std::move(task));
+  }
+  queue_cv_.notify_one();
+
+  return future;
+}
+
+Status ThreadPool::init(uint64_t num_threads) {
+  if (num_threads == 0)
+    return LOG_STATUS(Status::ThreadPoolError(
+        "Cannot initialize thread pool; Number of threads must be positive"));
+  if (!threads_.empty())
+    return LOG_STATUS(Status::ThreadPoolError(
+        "Cannot initialize thread pool; Thread pool already initialized"));
+
+  for (uint64_t i = 0; i < num_threads; ++i)
+    threads_.emplace_back(worker, this);
+
+  return Status::Ok();
+}
+
+uint64_t ThreadPool::num_threads() const {
+  return threads_.size();
+}
+
+Status ThreadPool::wait_all(std::vector<std::future<Status>>& tasks) {
+  Status ret = Status::Ok();
+  for (auto& task : tasks) {
+    if (!task.valid()) {
+      ret = Status::ThreadPoolError("Cannot wait on task; Invalid future");
+      continue;
+    }
+    Status st = task.get();
+    if (!st.ok() && ret.ok())
+      ret = st;
+  }
+
+  return ret;
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+void ThreadPool::terminate() {
+  {
+    std::lock_guard<std::mutex> lck(queue_mtx_);
+    should_terminate_ = true;
+  }
+  queue_cv_.notify_all();
+
+  for (auto& t : threads_)
+    t.join();
+  threads_.clear();
+}
+
+void ThreadPool::worker(ThreadPool* pool) {
+  for (;;) {
+    std::packaged_task<Status()> task;
+    {
+      std::unique_lock<std::mutex> lck(pool->queue_mtx_);
+      pool->queue_cv_.wait(lck, [pool] {
+        return pool->should_terminate_ || !pool->task_queue_.empty();
+      });
+      if (pool->task_queue_.empty())
+        return;  // Terminating and no work is left
+      task = std::move(pool->task_queue_.front());
+      pool->task_queue_.pop();
+    }
+    task();
+  }
+}
+
+}  // namespace tiledb
@@ -0,0 +1,193 @@
+/**
+ * @file   tracer.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements classes Tracer and TraceSpan.
+ */
+
+#include "tracer.h"
+#include "logger.h"
+
+#include <fstream>
+#include <sstream>
+
+namespace tiledb {
+
+/** Source of the tracer ids; zero is never assigned. */
+static std::atomic<uint64_t> next_tracer_id(1);
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+Tracer::Tracer()
+    : start_(std::chrono::steady_clock::now()) {
+  buffer_event_num_ = 0;
+  enabled_ = false;
+  id_ = next_tracer_id++;
+}
+
+Tracer::~Tracer() {
+  for (auto buffer : buffers_) {
+    delete[] buffer->events_;
+    delete buffer;
+  }
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+Status Tracer::dump() const {
+  if (!enabled_)
+    return Status::Ok();
+
+  std::ofstream ofs(trace_file_);
+  if (!ofs.is_open()) {
+    std::stringstream msg;
+    msg << "Cannot dump trace; Failed to open file '" << trace_file_ << "'";
+    return LOG_STATUS(Status::TracerError(msg.str()));
+  }
+
+  // Chrome trace timestamps and durations are in microseconds
+  std::lock_guard<std::mutex> lck(buffers_mtx_);
+  ofs << "{\"traceEvents\":[";
+  bool first = true;
+  for (size_t tid = 0; tid < buffers_.size(); ++tid) {
+    auto buffer = buffers_[tid];
+    uint64_t event_num = buffer->event_num_.load(std::memory_order_acquire);
+    uint64_t begin =
+        (event_num > buffer_event_num_) ? event_num - buffer_event_num_ : 0;
+    for (uint64_t i = begin; i < event_num; ++i) {
+      const auto& event = buffer->events_[i % buffer_event_num_];
+      ofs << (first ? "\n" : ",\n");
+      ofs << "{\"name\":\"" << event.name_ << "\",\"ph\":\"X\",\"pid\":1"
+          << ",\"tid\":" << tid + 1 << ",\"ts\":" << event.start_ / 1000.0
+          << ",\"dur\":" << (event.end_ - event.start_) / 1000.0 << "}";
+      first = false;
+    }
+  }
+  ofs << "\n]}\n";
+
+  if (!ofs.good()) {
+    std::stringstream msg;
+    msg << "Cannot dump trace; Failed to write file '" << trace_file_ << "'";
+    return LOG_STATUS(Status::TracerError(msg.str()));
+  }
+
+  return Status::Ok();
+}
+
+bool Tracer::enabled() const {
+  return enabled_;
+}
+
+Status Tracer::init(const std::string& trace_file, uint64_t buffer_event_num) {
+  if (trace_file.empty())
+    return Status::Ok();
+  if (buffer_event_num == 0)
+    return LOG_STATUS(Status::TracerError(
+        "Cannot initialize tracer; The buffer size must be positive"));
+
+  trace_file_ = trace_file;
+  buffer_event_num_ = buffer_event_num;
+  enabled_ = true;
+
+  return Status::Ok();
+}
+
+uint64_t Tracer::now() const {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - start_)
+      .count();
+}
+
+void Tracer::record(const char* name, uint64_t start, uint64_t end) {
+  if (!enabled_)
+    return;
+
+  // Only the calling thread writes into its buffer
+  auto buffer = thread_buffer();
+  uint64_t event_num = buffer->event_num_.load(std::memory_order_relaxed);
+  auto& event = buffer->events_[event_num % buffer_event_num_];
+  event.name_ = name;
+  event.start_ = start;
+  event.end_ = end;
+  buffer->event_num_.store(event_num + 1, std::memory_order_release);
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+Tracer::ThreadBuffer* Tracer::thread_buffer() {
+  // Fast path: the calling thread last recorded into this tracer
+  static thread_local uint64_t cached_id = 0;
+  static thread_local ThreadBuffer* cached_buffer = nullptr;
+  if (cached_id == id_)
+    return cached_buffer;
+
+  auto thread_id = std::this_thread::get_id();
+  std::lock_guard<std::mutex> lck(buffers_mtx_);
+  ThreadBuffer* buffer = nullptr;
+  for (auto b : buffers_) {
+    if (b->thread_id_ == thread_id) {
+      buffer = b;
+      break;
+    }
+  }
+  if (buffer == nullptr) {
+    buffer = new ThreadBuffer();
+    buffer->events_ = new Event[buffer_event_num_];
+    buffer->event_num_ = 0;
+    buffer->thread_id_ = thread_id;
+    buffers_.push_back(buffer);
+  }
+
+  cached_id = id_;
+  cached_buffer = buffer;
+
+  return buffer;
+}
+
+/* ****************************** */
+/*            TraceSpan           */
+/* ****************************** */
+
+TraceSpan::TraceSpan(Tracer* tracer, const char* name)
+    : name_(name) {
+  tracer_ = (tracer != nullptr && tracer->enabled()) ? tracer : nullptr;
+  start_ = (tracer_ != nullptr) ? tracer_->now() : 0;
+}
+
+TraceSpan::~TraceSpan() {
+  if (tracer_ != nullptr)
+    tracer_->record(name_, start_, tracer_->now());
+}
+
+}  // namespace tiledb
@@ -34,9 +34,11 @@
 #include "utils.h"
 #include "logger.h"
 
+#include <algorithm>
 #include <iostream>
 #include <set>
 #include <sstream>
+#include <type_traits>
 
 #ifdef _WIN32
 #include <sys/timeb.h>
@@ -91,6 +93,50 @@ Status convert(const std::string& str, uint64_t* value) {
   return Status::Ok();
 }
 
+Status convert(const std::string& str, float* value) {
+  try {
+    size_t pos;
+    *value = std::stof(str, &pos);
+    if (pos != str.size())
+      return LOG_STATUS(Status::UtilsError(
+          "Failed to convert string to float; Invalid argument"));
+  } catch (std::invalid_argument& e) {
+    return LOG_STATUS(Status::UtilsError(
+        "Failed to convert string to float; Invalid argument"));
+  } catch (std::out_of_range& e) {
+    return LOG_STATUS(Status::UtilsError(
+        "Failed to convert string to float; Value out of range"));
+  }
+
+  return Status::Ok();
+}
+
+Status convert(const std::string& str, std::vector<Compressor>* value) {
+  value->clear();
+  std::string::size_type start = 0;
+  for (;;) {
+    auto end = str.find(',', start);
+    auto name = str.substr(start, end - start);
+    bool found = false;
+    for (int c = 0; *compressor_str((Compressor)c) != '\0'; ++c) {
+      if (name == compressor_str((Compressor)c)) {
+        value->push_back((Compressor)c);
+        found = true;
+        break;
+      }
+    }
+    if (!found)
+      return LOG_STATUS(Status::UtilsError(
+          "Failed to convert string to compressors; Unknown compressor '" +
+          name + "'"));
+    if (end == std::string::npos)
+      break;
+    start = end + 1;
+  }
+
+  return Status::Ok();
+}
+
 bool is_int(const std::string& str) {
   // Check if empty
   if (str.empty())
@@ -420,6 +466,28 @@ bool overlap(const T* a, const T* b, unsigned dim_num) {
   return true;
 }
 
+template <class T>
+double overlap_ratio(const T* a, const T* b, unsigned dim_num) {
+  double ratio = 1.0;
+  for (unsigned i = 0; i < dim_num; ++i) {
+    auto overlap_lo = std::max(a[2 * i], b[2 * i]);
+    auto overlap_hi = std::min(a[2 * i + 1], b[2 * i + 1]);
+    if (overlap_lo > overlap_hi)
+      return 0.0;
+
+    double a_width = double(a[2 * i + 1]) - a[2 * i];
+    double overlap_width = double(overlap_hi) - overlap_lo;
+    if (std::is_integral<T>::value) {
+      a_width += 1;
+      overlap_width += 1;
+    }
+    if (a_width > 0)
+      ratio *= overlap_width / a_width;
+  }
+
+  return ratio;
+}
+
 bool starts_with(const std::string& value, const std::string& prefix) {
   if (prefix.size() > value.size())
     return false;
@@ -830,6 +898,27 @@ template bool overlap<float>(const float* a, const float* b, unsigned dim_num);
 template bool overlap<double>(
     const double* a, const double* b, unsigned dim_num);
 
+template double overlap_ratio<int8_t>(
+    const int8_t* a, const int8_t* b, unsigned dim_num);
+template double overlap_ratio<uint8_t>(
+    const uint8_t* a, const uint8_t* b, unsigned dim_num);
+template double overlap_ratio<int16_t>(
+    const int16_t* a, const int16_t* b, unsigned dim_num);
+template double overlap_ratio<uint16_t>(
+    const uint16_t* a, const uint16_t* b, unsigned dim_num);
+template double overlap_ratio<int>(
+    const int* a, const int* b, unsigned dim_num);
+template double overlap_ratio<unsigned>(
+    const unsigned* a, const unsigned* b, unsigned dim_num);
+template double overlap_ratio<int64_t>(
+    const int64_t* a, const int64_t* b, unsigned dim_num);
+template double overlap_ratio<uint64_t>(
+    const uint64_t* a, const uint64_t* b, unsigned dim_num);
+template double overlap_ratio<float>(
+    const float* a, const float* b, unsigned dim_num);
+template double overlap_ratio<double>(
+    const double* a, const double* b, unsigned dim_num);
+
 }  // namespace utils
 
 }  // namespace tiledb
@@ -645,6 +645,8 @@ Status ArrayOrderedReadState::async_submit_query(unsigned int id) {
       buffers_[id],
       buffer_sizes_tmp_[id],
       add_coords));
+  async_query_[id]->set_conditions(query_->conditions());
+  async_query_[id]->stats()->set_parent(query_->stats());
   async_query_[id]->set_callback(async_done, &(async_data_[id]));
 
   // Send the async query
@@ -35,6 +35,8 @@
 #include "logger.h"
 #include "utils.h"
 
+#include <future>
+
 /* ****************************** */
 /*             MACROS             */
 /* ****************************** */
@@ -70,7 +72,18 @@ ArrayOrderedWriteState::ArrayOrderedWriteState(Query* query)
   buffer_sizes_ = nullptr;
   buffer_offsets_ = nullptr;
   buffers_ = nullptr;
-  for (unsigned int i = 0; i < 2; ++i) {
+  auto sm_params = query_->storage_manager()->config().sm_params();
+  tile_slab_num_ = (unsigned int)sm_params.ordered_write_buffer_num_;
+  async_cv_ = std::vector<std::condition_variable>(tile_slab_num_);
+  async_mtx_ = std::vector<std::mutex>(tile_slab_num_);
+  async_data_.resize(tile_slab_num_);
+  async_query_.resize(tile_slab_num_);
+  async_wait_ = new bool[tile_slab_num_];
+  tile_slab_.resize(tile_slab_num_);
+  tile_slab_init_ = new bool[tile_slab_num_];
+  tile_slab_norm_.resize(tile_slab_num_);
+  tile_slab_info_.resize(tile_slab_num_);
+  for (unsigned int i = 0; i < tile_slab_num_; ++i) {
     async_query_[i] = nullptr;
     tile_slab_[i] = std::malloc(2 * coords_size_);
     tile_slab_norm_[i] = std::malloc(2 * coords_size_);
@@ -108,7 +121,7 @@ ArrayOrderedWriteState::~ArrayOrderedWriteState() {
   std::free(tile_coords_);
   std::free(tile_domain_);
 
-  for (unsigned int i = 0; i < 2; ++i) {
+  for (unsigned int i = 0; i < tile_slab_num_; ++i) {
     if (async_query_[i] != nullptr)
       async_query_[i]->finalize();
     delete async_query_[i];
@@ -116,6 +129,8 @@ ArrayOrderedWriteState::~ArrayOrderedWriteState() {
     std::free(tile_slab_norm_[i]);
   }
 
+  delete[] async_wait_;
+  delete[] tile_slab_init_;
   delete[] buffer_offsets_;
 
   // Free tile slab info and state, and copy state
@@ -305,7 +320,7 @@ Status ArrayOrderedWriteState::write(void** buffers, uint64_t* buffer_sizes) {
   // Create buffers
   RETURN_NOT_OK(create_copy_state_buffers());
 
-  for (unsigned int i = 0; i < 2; ++i)
+  for (unsigned int i = 0; i < tile_slab_num_; ++i)
     async_data_[i] = {i, 0, this};
 
   // Call the appropriate templated write
@@ -465,7 +480,7 @@ Status ArrayOrderedWriteState::async_submit_query(unsigned int id) {
             copy_state_.buffer_offsets_[id]));
         async_query_[id]->set_callback(async_done, &(async_data_[id]));
       }
-    } else {  // id == 1
+    } else {  // Append to the fragment of the first query
       if (async_query_[id] == nullptr) {
         async_query_[id] = new Query(async_query_[0]);
         async_query_[id]->set_buffers(
@@ -488,6 +503,11 @@ void ArrayOrderedWriteState::async_wait(unsigned int id) {
   lk.unlock();
 }
 
+void ArrayOrderedWriteState::async_wait_all() {
+  for (unsigned int i = 0; i < tile_slab_num_; ++i)
+    async_wait(i);
+}
+
 void ArrayOrderedWriteState::calculate_buffer_num() {
   // For easy reference
   auto array_schema = query_->array_schema();
@@ -837,110 +857,186 @@ void ArrayOrderedWriteState::calculate_tile_slab_info_row(unsigned int id) {
   }
 }
 
-void ArrayOrderedWriteState::copy_tile_slab() {
+void ArrayOrderedWriteState::copy_cell_slabs(
+    unsigned int aid, unsigned int bid, uint64_t tid) {
   // For easy reference
-  auto array_schema = query_->array_schema();
-  auto nattributes = attribute_ids_.size();
+  Datatype coords_type = query_->array_schema()->coords_type();
 
-  // Copy tile slab for each attribute separately
-  for (unsigned int i = 0, b = 0; i < nattributes; ++i) {
-    Datatype type = array_schema->type(attribute_ids_.at(i));
-    if (!array_schema->var_size(attribute_ids_[i])) {
-      if (type == Datatype::INT32)
-        copy_tile_slab<int>(i, b);
-      else if (type == Datatype::INT64)
-        copy_tile_slab<int64_t>(i, b);
-      else if (type == Datatype::FLOAT32)
-        copy_tile_slab<float>(i, b);
-      else if (type == Datatype::FLOAT64)
-        copy_tile_slab<double>(i, b);
-      else if (type == Datatype::CHAR)
-        copy_tile_slab<char>(i, b);
-      else if (type == Datatype::INT8)
-        copy_tile_slab<int8_t>(i, b);
-      else if (type == Datatype::UINT8)
-        copy_tile_slab<uint8_t>(i, b);
-      else if (type == Datatype::INT16)
-        copy_tile_slab<int16_t>(i, b);
-      else if (type == Datatype::UINT16)
-        copy_tile_slab<uint16_t>(i, b);
-      else if (type == Datatype::UINT32)
-        copy_tile_slab<uint32_t>(i, b);
-      else if (type == Datatype::UINT64)
-        copy_tile_slab<uint64_t>(i, b);
-      ++b;
-    } else {
-      if (type == Datatype::INT32)
-        copy_tile_slab_var<int>(i, b);
-      else if (type == Datatype::INT64)
-        copy_tile_slab_var<int64_t>(i, b);
-      else if (type == Datatype::FLOAT32)
-        copy_tile_slab_var<float>(i, b);
-      else if (type == Datatype::FLOAT64)
-        copy_tile_slab_var<double>(i, b);
-      else if (type == Datatype::CHAR)
-        copy_tile_slab_var<char>(i, b);
-      else if (type == Datatype::INT8)
-        copy_tile_slab_var<int8_t>(i, b);
-      else if (type == Datatype::UINT8)
-        copy_tile_slab_var<uint8_t>(i, b);
-      else if (type == Datatype::INT16)
-        copy_tile_slab_var<int16_t>(i, b);
-      else if (type == Datatype::UINT16)
-        copy_tile_slab_var<uint16_t>(i, b);
-      else if (type == Datatype::UINT32)
-        copy_tile_slab_var<uint32_t>(i, b);
-      else if (type == Datatype::UINT64)
-        copy_tile_slab_var<uint64_t>(i, b);
-      b += 2;
-    }
-  }
+  // Invoke the proper templated function
+  if (coords_type == Datatype::INT32)
+    copy_cell_slabs<int>(aid, bid, tid);
+  else if (coords_type == Datatype::INT64)
+    copy_cell_slabs<int64_t>(aid, bid, tid);
+  else if (coords_type == Datatype::INT8)
+    copy_cell_slabs<int8_t>(aid, bid, tid);
+  else if (coords_type == Datatype::UINT8)
+    copy_cell_slabs<uint8_t>(aid, bid, tid);
+  else if (coords_type == Datatype::INT16)
+    copy_cell_slabs<int16_t>(aid, bid, tid);
+  else if (coords_type == Datatype::UINT16)
+    copy_cell_slabs<uint16_t>(aid, bid, tid);
+  else if (coords_type == Datatype::UINT32)
+    copy_cell_slabs<uint32_t>(aid, bid, tid);
+  else if (coords_type == Datatype::UINT64)
+    copy_cell_slabs<uint64_t>(aid, bid, tid);
+  else
+    assert(false);
 }
 
 template <class T>
-void ArrayOrderedWriteState::copy_tile_slab(
-    unsigned int aid, unsigned int bid) {
+void ArrayOrderedWriteState::copy_cell_slabs(
+    unsigned int aid, unsigned int bid, uint64_t tid) {
   // For easy reference
-  uint64_t& tid = tile_slab_state_.current_tile_[aid];
-  uint64_t& buffer_offset = buffer_offsets_[bid];
-  auto buffer = (char*)buffers_[bid];
+  const TileSlabInfo& info = tile_slab_info_[copy_id_];
+  auto range_overlap = (const T*)info.range_overlap_[tid];
+  auto tile_slab = (const T*)tile_slab_norm_[copy_id_];
+  auto tile_extents =
+      (const T*)query_->array_schema()->domain()->tile_extents();
+  const uint64_t* cell_offset_per_dim = info.cell_offset_per_dim_[tid];
+  uint64_t cell_slab_num = info.cell_slab_num_[tid];
+  uint64_t cell_slab_size = info.cell_slab_size_[aid][tid];
+  uint64_t start_offset = info.start_offsets_[aid][tid];
+  uint64_t attribute_size = attribute_sizes_[aid];
+  auto buffer = (const char*)buffers_[bid] + buffer_offsets_[bid];
   auto local_buffer = (char*)copy_state_.buffers_[copy_id_][bid];
-  uint64_t& local_buffer_offset = copy_state_.buffer_offsets_[copy_id_][bid];
-  uint64_t local_buffer_size = copy_state_.buffer_sizes_[copy_id_][bid];
-  ASWS_Data asws_data = {aid, bid, this};
-
-  // Fill with empty
-  fill_with_empty<T>(bid);
+  bool row = (query_->layout() == Layout::ROW_MAJOR);
 
-  // Important for initializing the current tile and offsets!
-  update_current_tile_and_offset(aid);
+  // Calculate the cell offsets per dimension in the user buffer, where the
+  // tile slab cells are laid out in the query layout
+  std::vector<uint64_t> user_offset_per_dim(dim_num_);
+  uint64_t user_offset = 1;
+  for (unsigned int i = 0; i < dim_num_; ++i) {
+    unsigned int d = (row) ? dim_num_ - 1 - i : i;
+    user_offset_per_dim[d] = user_offset;
+    user_offset *= tile_slab[2 * d + 1] - tile_slab[2 * d] + 1;
+  }
 
-  // Iterate over the tile slab cells
+  // Iterate over the cell slabs of the tile, following the query layout
+  std::vector<T> coords(dim_num_);
+  for (unsigned int i = 0; i < dim_num_; ++i)
+    coords[i] = range_overlap[2 * i];
   for (;;) {
-    // For easy reference
-    uint64_t cell_slab_size =
-        tile_slab_info_[copy_id_].cell_slab_size_[aid][tid];
-    uint64_t& local_buffer_offset_cur = tile_slab_state_.current_offsets_[aid];
+    // Calculate the cell position in the user and local buffers
+    uint64_t user_cid = 0;
+    uint64_t cid = 0;
+    for (unsigned int i = 0; i < dim_num_; ++i) {
+      user_cid += (coords[i] - tile_slab[2 * i]) * user_offset_per_dim[i];
+      cid += (coords[i] - (coords[i] / tile_extents[i]) * tile_extents[i]) *
+             cell_offset_per_dim[i];
+    }
 
     // Copy cell slab from user to local buffer
     std::memcpy(
-        local_buffer + local_buffer_offset_cur,
-        buffer + buffer_offset,
+        local_buffer + start_offset + cid * attribute_size,
+        buffer + user_cid * attribute_size,
         cell_slab_size);
 
-    // Update user buffer offset
-    buffer_offset += cell_slab_size;
+    // Advance to the next cell slab, checking if done
+    if (row) {
+      unsigned int d = dim_num_ - 1;
+      coords[d] += cell_slab_num;
+      while (d > 0 && coords[d] > range_overlap[2 * d + 1]) {
+        coords[d] = range_overlap[2 * d];
+        ++coords[--d];
+      }
+      if (coords[0] > range_overlap[1])
+        break;
+    } else {
+      unsigned int d = 0;
+      coords[d] += cell_slab_num;
+      while (d < dim_num_ - 1 && coords[d] > range_overlap[2 * d + 1]) {
+        coords[d] = range_overlap[2 * d];
+        ++coords[++d];
+      }
+      if (coords[dim_num_ - 1] > range_overlap[2 * (dim_num_ - 1) + 1])
+        break;
+    }
+  }
+}
 
-    // Prepare for new slab
-    (*advance_cell_slab_)(&asws_data);
+Status ArrayOrderedWriteState::copy_tile_slab() {
+  // For easy reference
+  auto array_schema = query_->array_schema();
+  auto thread_pool = query_->storage_manager()->thread_pool();
+  auto nattributes = attribute_ids_.size();
+  uint64_t tile_num = tile_slab_info_[copy_id_].tile_num_;
+  uint64_t tile_slab_cell_num =
+      array_schema->domain()->cell_num(tile_slab_[copy_id_]);
+
+  // Split the tiles of every fixed-sized attribute into (roughly) as many
+  // ranges as there are threads
+  uint64_t thread_num = thread_pool->num_threads();
+  uint64_t tiles_per_task = (tile_num + thread_num - 1) / thread_num;
+
+  // Dispatch a task per fixed-sized attribute and tile range, and a task
+  // per variable-sized attribute
+  std::vector<std::future<Status>> tasks;
+  for (unsigned int i = 0, b = 0; i < nattributes; ++i) {
+    if (!array_schema->var_size(attribute_ids_[i])) {
+      for (uint64_t t = 0; t < tile_num; t += tiles_per_task) {
+        uint64_t t_end = MIN(t + tiles_per_task, tile_num);
+        tasks.emplace_back(thread_pool->enqueue(
+            [this, i, b, t, t_end]() { return copy_tiles(i, b, t, t_end); }));
+      }
+      ++b;
+    } else {
+      tasks.emplace_back(thread_pool->enqueue(
+          [this, i, b]() { return copy_tile_slab_var(i, b); }));
+      b += 2;
+    }
+  }
+  RETURN_NOT_OK(thread_pool->wait_all(tasks));
 
-    // Terminating condition
-    if (tile_slab_state_.copy_tile_slab_done_[aid])
-      break;
+  // Advance the user buffer offsets of the fixed-sized attributes past the
+  // copied tile slab and set the local buffer offsets (the variable-sized
+  // attributes are handled while copying)
+  for (unsigned int i = 0, b = 0; i < nattributes; ++i) {
+    if (!array_schema->var_size(attribute_ids_[i])) {
+      buffer_offsets_[b] += tile_slab_cell_num * attribute_sizes_[i];
+      copy_state_.buffer_offsets_[copy_id_][b] =
+          copy_state_.buffer_sizes_[copy_id_][b];
+      ++b;
+    } else {
+      b += 2;
+    }
   }
 
-  // Set local buffer offset
-  local_buffer_offset = local_buffer_size;
+  return Status::Ok();
+}
+
+Status ArrayOrderedWriteState::copy_tile_slab_var(
+    unsigned int aid, unsigned int bid) {
+  // For easy reference
+  Datatype type = query_->array_schema()->type(attribute_ids_[aid]);
+
+  // Invoke the proper templated function
+  if (type == Datatype::INT32)
+    copy_tile_slab_var<int>(aid, bid);
+  else if (type == Datatype::INT64)
+    copy_tile_slab_var<int64_t>(aid, bid);
+  else if (type == Datatype::FLOAT32)
+    copy_tile_slab_var<float>(aid, bid);
+  else if (type == Datatype::FLOAT64)
+    copy_tile_slab_var<double>(aid, bid);
+  else if (type == Datatype::CHAR)
+    copy_tile_slab_var<char>(aid, bid);
+  else if (type == Datatype::INT8)
+    copy_tile_slab_var<int8_t>(aid, bid);
+  else if (type == Datatype::UINT8)
+    copy_tile_slab_var<uint8_t>(aid, bid);
+  else if (type == Datatype::INT16)
+    copy_tile_slab_var<int16_t>(aid, bid);
+  else if (type == Datatype::UINT16)
+    copy_tile_slab_var<uint16_t>(aid, bid);
+  else if (type == Datatype::UINT32)
+    copy_tile_slab_var<uint32_t>(aid, bid);
+  else if (type == Datatype::UINT64)
+    copy_tile_slab_var<uint64_t>(aid, bid);
+  else
+    return LOG_STATUS(
+        Status::ASWSError("Cannot copy tile slab; Invalid attribute type"));
+
+  return Status::Ok();
 }
 
 template <class T>
@@ -1041,6 +1137,65 @@ void ArrayOrderedWriteState::copy_tile_slab_var(
   local_buffer_offset = local_buffer_size;
 }
 
+Status ArrayOrderedWriteState::copy_tiles(
+    unsigned int aid,
+    unsigned int bid,
+    uint64_t tile_start,
+    uint64_t tile_end) {
+  // For easy reference
+  Datatype type = query_->array_schema()->type(attribute_ids_[aid]);
+
+  // Invoke the proper templated function
+  if (type == Datatype::INT32)
+    copy_tiles<int>(aid, bid, tile_start, tile_end);
+  else if (type == Datatype::INT64)
+    copy_tiles<int64_t>(aid, bid, tile_start, tile_end);
+  else if (type == Datatype::FLOAT32)
+    copy_tiles<float>(aid, bid, tile_start, tile_end);
+  else if (type == Datatype::FLOAT64)
+    copy_tiles<double>(aid, bid, tile_start, tile_end);
+  else if (type == Datatype::CHAR)
+    copy_tiles<char>(aid, bid, tile_start, tile_end);
+  else if (type == Datatype::INT8)
+    copy_tiles<int8_t>(aid, bid, tile_start, tile_end);
+  else if (type == Datatype::UINT8)
+    copy_tiles<uint8_t>(aid, bid, tile_start, tile_end);
+  else if (type == Datatype::INT16)
+    copy_tiles<int16_t>(aid, bid, tile_start, tile_end);
+  else if (type == Datatype::UINT16)
+    copy_tiles<uint16_t>(aid, bid, tile_start, tile_end);
+  else if (type == Datatype::UINT32)
+    copy_tiles<uint32_t>(aid, bid, tile_start, tile_end);
+  else if (type == Datatype::UINT64)
+    copy_tiles<uint64_t>(aid, bid, tile_start, tile_end);
+  else
+    return LOG_STATUS(
+        Status::ASWSError("Cannot copy tiles; Invalid attribute type"));
+
+  return Status::Ok();
+}
+
+template <class T>
+void ArrayOrderedWriteState::copy_tiles(
+    unsigned int aid,
+    unsigned int bid,
+    uint64_t tile_start,
+    uint64_t tile_end) {
+  // For easy reference
+  uint64_t tile_size = query_->array_schema()->domain()->cell_num_per_tile() *
+                       attribute_sizes_[aid];
+  uint64_t* start_offsets = tile_slab_info_[copy_id_].start_offsets_[aid];
+
+  for (uint64_t tid = tile_start; tid < tile_end; ++tid) {
+    // Fill the local tile with empty values, since the tile slab may not
+    // cover the entire tile
+    fill_with_empty<T>(bid, start_offsets[tid], tile_size);
+
+    // Copy the cell slabs of the tile
+    copy_cell_slabs(aid, bid, tid);
+  }
+}
+
 Status ArrayOrderedWriteState::create_copy_state_buffers() {
   // For easy reference
   auto array_schema = query_->array_schema();
@@ -1074,7 +1229,7 @@ Status ArrayOrderedWriteState::create_copy_state_buffers() {
   }
 
   // Allocate buffers
-  for (unsigned int j = 0; j < 2; ++j) {
+  for (unsigned int j = 0; j < tile_slab_num_; ++j) {
     copy_state_.buffers_[j] = (void**)std::malloc(buffer_num_ * sizeof(void*));
     if (copy_state_.buffers_[j] == nullptr) {
       return LOG_STATUS(Status::ASWSError("Cannot create local buffers"));
@@ -1102,153 +1257,156 @@ void ArrayOrderedWriteState::create_user_buffers(
 }
 
 template <>
-void ArrayOrderedWriteState::fill_with_empty<int>(unsigned int bid) {
+void ArrayOrderedWriteState::fill_with_empty<int>(
+    unsigned int bid, uint64_t offset, uint64_t size) {
   // For easy reference
-  auto local_buffer = (int*)copy_state_.buffers_[copy_id_][bid];
-  uint64_t local_buffer_size = copy_state_.buffer_sizes_[copy_id_][bid];
+  auto local_buffer =
+      (int*)((char*)copy_state_.buffers_[copy_id_][bid] + offset);
+  uint64_t cell_num = size / sizeof(int);
   int empty = constants::empty_int32;
 
   // Fill with empty values
-  uint64_t offset = 0;
-  for (uint64_t i = 0; offset < local_buffer_size; offset += sizeof(int), ++i)
+  for (uint64_t i = 0; i < cell_num; ++i)
     local_buffer[i] = empty;
 }
 
 template <>
-void ArrayOrderedWriteState::fill_with_empty<int64_t>(unsigned int bid) {
+void ArrayOrderedWriteState::fill_with_empty<int64_t>(
+    unsigned int bid, uint64_t offset, uint64_t size) {
   // For easy reference
-  auto local_buffer = (int64_t*)copy_state_.buffers_[copy_id_][bid];
-  uint64_t local_buffer_size = copy_state_.buffer_sizes_[copy_id_][bid];
+  auto local_buffer =
+      (int64_t*)((char*)copy_state_.buffers_[copy_id_][bid] + offset);
+  uint64_t cell_num = size / sizeof(int64_t);
   int64_t empty = constants::empty_int64;
 
   // Fill with empty values
-  uint64_t offset = 0;
-  for (uint64_t i = 0; offset < local_buffer_size;
-       offset += sizeof(int64_t), ++i)
+  for (uint64_t i = 0; i < cell_num; ++i)
     local_buffer[i] = empty;
 }
 
 template <>
-void ArrayOrderedWriteState::fill_with_empty<float>(unsigned int bid) {
+void ArrayOrderedWriteState::fill_with_empty<float>(
+    unsigned int bid, uint64_t offset, uint64_t size) {
   // For easy reference
-  auto local_buffer = (float*)copy_state_.buffers_[copy_id_][bid];
-  uint64_t local_buffer_size = copy_state_.buffer_sizes_[copy_id_][bid];
+  auto local_buffer =
+      (float*)((char*)copy_state_.buffers_[copy_id_][bid] + offset);
+  uint64_t cell_num = size / sizeof(float);
   float empty = constants::empty_float32;
 
   // Fill with empty values
-  uint64_t offset = 0;
-  for (uint64_t i = 0; offset < local_buffer_size; offset += sizeof(float), ++i)
+  for (uint64_t i = 0; i < cell_num; ++i)
     local_buffer[i] = empty;
 }
 
 template <>
-void ArrayOrderedWriteState::fill_with_empty<double>(unsigned int bid) {
+void ArrayOrderedWriteState::fill_with_empty<double>(
+    unsigned int bid, uint64_t offset, uint64_t size) {
   // For easy reference
-  auto local_buffer = (double*)copy_state_.buffers_[copy_id_][bid];
-  uint64_t local_buffer_size = copy_state_.buffer_sizes_[copy_id_][bid];
+  auto local_buffer =
+      (double*)((char*)copy_state_.buffers_[copy_id_][bid] + offset);
+  uint64_t cell_num = size / sizeof(double);
   double empty = constants::empty_float64;
 
   // Fill with empty values
-  uint64_t offset = 0;
-  for (uint64_t i = 0; offset < local_buffer_size;
-       offset += sizeof(double), ++i)
+  for (uint64_t i = 0; i < cell_num; ++i)
     local_buffer[i] = empty;
 }
 
 template <>
-void ArrayOrderedWriteState::fill_with_empty<char>(unsigned int bid) {
+void ArrayOrderedWriteState::fill_with_empty<char>(
+    unsigned int bid, uint64_t offset, uint64_t size) {
   // For easy reference
-  auto local_buffer = (char*)copy_state_.buffers_[copy_id_][bid];
-  uint64_t local_buffer_size = copy_state_.buffer_sizes_[copy_id_][bid];
+  auto local_buffer =
+      (char*)((char*)copy_state_.buffers_[copy_id_][bid] + offset);
+  uint64_t cell_num = size / sizeof(char);
   char empty = constants::empty_char;
 
   // Fill with empty values
-  uint64_t offset = 0;
-  for (uint64_t i = 0; offset < local_buffer_size; offset += sizeof(char), ++i)
+  for (uint64_t i = 0; i < cell_num; ++i)
     local_buffer[i] = empty;
 }
 
 template <>
-void ArrayOrderedWriteState::fill_with_empty<int8_t>(unsigned int bid) {
+void ArrayOrderedWriteState::fill_with_empty<int8_t>(
+    unsigned int bid, uint64_t offset, uint64_t size) {
   // For easy reference
-  auto local_buffer = (int8_t*)copy_state_.buffers_[copy_id_][bid];
-  uint64_t local_buffer_size = copy_state_.buffer_sizes_[copy_id_][bid];
+  auto local_buffer =
+      (int8_t*)((char*)copy_state_.buffers_[copy_id_][bid] + offset);
+  uint64_t cell_num = size / sizeof(int8_t);
   int8_t empty = constants::empty_int8;
 
   // Fill with empty values
-  uint64_t offset = 0;
-  for (uint64_t i = 0; offset < local_buffer_size;
-       offset += sizeof(int8_t), ++i)
+  for (uint64_t i = 0; i < cell_num; ++i)
     local_buffer[i] = empty;
 }
 
 template <>
-void ArrayOrderedWriteState::fill_with_empty<uint8_t>(unsigned int bid) {
+void ArrayOrderedWriteState::fill_with_empty<uint8_t>(
+    unsigned int bid, uint64_t offset, uint64_t size) {
   // For easy reference
-  auto local_buffer = (uint8_t*)copy_state_.buffers_[copy_id_][bid];
-  uint64_t local_buffer_size = copy_state_.buffer_sizes_[copy_id_][bid];
+  auto local_buffer =
+      (uint8_t*)((char*)copy_state_.buffers_[copy_id_][bid] + offset);
+  uint64_t cell_num = size / sizeof(uint8_t);
   uint8_t empty = constants::empty_uint8;
 
   // Fill with empty values
-  uint64_t offset = 0;
-  for (uint64_t i = 0; offset < local_buffer_size;
-       offset += sizeof(uint8_t), ++i)
+  for (uint64_t i = 0; i < cell_num; ++i)
     local_buffer[i] = empty;
 }
 
 template <>
-void ArrayOrderedWriteState::fill_with_empty<int16_t>(unsigned int bid) {
+void ArrayOrderedWriteState::fill_with_empty<int16_t>(
+    unsigned int bid, uint64_t offset, uint64_t size) {
   // For easy reference
-  auto local_buffer = (int16_t*)copy_state_.buffers_[copy_id_][bid];
-  uint64_t local_buffer_size = copy_state_.buffer_sizes_[copy_id_][bid];
+  auto local_buffer =
+      (int16_t*)((char*)copy_state_.buffers_[copy_id_][bid] + offset);
+  uint64_t cell_num = size / sizeof(int16_t);
   int16_t empty = constants::empty_int16;
 
   // Fill with empty values
-  uint64_t offset = 0;
-  for (uint64_t i = 0; offset < local_buffer_size;
-       offset += sizeof(int16_t), ++i)
+  for (uint64_t i = 0; i < cell_num; ++i)
     local_buffer[i] = empty;
 }
 
 template <>
-void ArrayOrderedWriteState::fill_with_empty<uint16_t>(unsigned int bid) {
+void ArrayOrderedWriteState::fill_with_empty<uint16_t>(
+    unsigned int bid, uint64_t offset, uint64_t size) {
   // For easy reference
-  auto local_buffer = (uint16_t*)copy_state_.buffers_[copy_id_][bid];
-  uint64_t local_buffer_size = copy_state_.buffer_sizes_[copy_id_][bid];
+  auto local_buffer =
+      (uint16_t*)((char*)copy_state_.buffers_[copy_id_][bid] + offset);
+  uint64_t cell_num = size / sizeof(uint16_t);
   uint16_t empty = constants::empty_uint16;
 
   // Fill with empty values
-  uint64_t offset = 0;
-  for (uint64_t i = 0; offset < local_buffer_size;
-       offset += sizeof(uint16_t), ++i)
+  for (uint64_t i = 0; i < cell_num; ++i)
     local_buffer[i] = empty;
 }
 
 template <>
-void ArrayOrderedWriteState::fill_with_empty<uint32_t>(unsigned int bid) {
+void ArrayOrderedWriteState::fill_with_empty<uint32_t>(
+    unsigned int bid, uint64_t offset, uint64_t size) {
   // For easy reference
-  auto local_buffer = (uint32_t*)copy_state_.buffers_[copy_id_][bid];
-  uint64_t local_buffer_size = copy_state_.buffer_sizes_[copy_id_][bid];
+  auto local_buffer =
+      (uint32_t*)((char*)copy_state_.buffers_[copy_id_][bid] + offset);
+  uint64_t cell_num = size / sizeof(uint32_t);
   uint32_t empty = constants::empty_uint32;
 
   // Fill with empty values
-  uint64_t offset = 0;
-  for (uint64_t i = 0; offset < local_buffer_size;
-       offset += sizeof(uint32_t), ++i)
+  for (uint64_t i = 0; i < cell_num; ++i)
     local_buffer[i] = empty;
 }
 
 template <>
-void ArrayOrderedWriteState::fill_with_empty<uint64_t>(unsigned int bid) {
+void ArrayOrderedWriteState::fill_with_empty<uint64_t>(
+    unsigned int bid, uint64_t offset, uint64_t size) {
   // For easy reference
-  auto local_buffer = (uint64_t*)copy_state_.buffers_[copy_id_][bid];
-  uint64_t local_buffer_size = copy_state_.buffer_sizes_[copy_id_][bid];
+  auto local_buffer =
+      (uint64_t*)((char*)copy_state_.buffers_[copy_id_][bid] + offset);
+  uint64_t cell_num = size / sizeof(uint64_t);
   uint64_t empty = constants::empty_uint64;
 
   // Fill with empty values
-  uint64_t offset = 0;
-  for (uint64_t i = 0; offset < local_buffer_size;
-       offset += sizeof(uint64_t), ++i)
+  for (uint64_t i = 0; i < cell_num; ++i)
     local_buffer[i] = empty;
 }
 
@@ -1394,7 +1552,7 @@ void ArrayOrderedWriteState::fill_with_empty_var<uint64_t>(unsigned int bid) {
 }
 
 void ArrayOrderedWriteState::free_copy_state() {
-  for (unsigned int i = 0; i < 2; ++i) {
+  for (unsigned int i = 0; i < tile_slab_num_; ++i) {
     delete[] copy_state_.buffer_offsets_[i];
     if (copy_state_.buffer_sizes_[i] != nullptr)
       delete[] copy_state_.buffer_sizes_[i];
@@ -1508,7 +1666,10 @@ bool ArrayOrderedWriteState::separate_fragments() const {
 }
 
 void ArrayOrderedWriteState::init_copy_state() {
-  for (unsigned int j = 0; j < 2; ++j) {
+  copy_state_.buffer_offsets_.resize(tile_slab_num_);
+  copy_state_.buffer_sizes_.resize(tile_slab_num_);
+  copy_state_.buffers_.resize(tile_slab_num_);
+  for (unsigned int j = 0; j < tile_slab_num_; ++j) {
     copy_state_.buffer_offsets_[j] = new uint64_t[buffer_num_];
     copy_state_.buffer_sizes_[j] = new uint64_t[buffer_num_];
     copy_state_.buffers_[j] = new void*[buffer_num_];
@@ -1600,11 +1761,11 @@ bool ArrayOrderedWriteState::next_tile_slab_col() {
   auto domain = static_cast<const T*>(array_schema->domain()->domain());
   auto tile_extents =
       static_cast<const T*>(array_schema->domain()->tile_extents());
-  T* tile_slab[2];
+  std::vector<T*> tile_slab(tile_slab_num_);
   auto tile_slab_norm = static_cast<T*>(tile_slab_norm_[copy_id_]);
-  for (unsigned int i = 0; i < 2; ++i)
+  for (unsigned int i = 0; i < tile_slab_num_; ++i)
     tile_slab[i] = static_cast<T*>(tile_slab_[i]);
-  unsigned int prev_id = (copy_id_ + 1) % 2;
+  unsigned int prev_id = (copy_id_ + tile_slab_num_ - 1) % tile_slab_num_;
   T tile_start;
 
   // Check again if done, this time based on the tile slab and subarray
@@ -1671,11 +1832,11 @@ bool ArrayOrderedWriteState::next_tile_slab_row() {
   auto domain = static_cast<const T*>(array_schema->domain()->domain());
   auto tile_extents =
       static_cast<const T*>(array_schema->domain()->tile_extents());
-  T* tile_slab[2];
+  std::vector<T*> tile_slab(tile_slab_num_);
   auto tile_slab_norm = static_cast<T*>(tile_slab_norm_[copy_id_]);
-  for (unsigned int i = 0; i < 2; ++i)
+  for (unsigned int i = 0; i < tile_slab_num_; ++i)
     tile_slab[i] = static_cast<T*>(tile_slab_[i]);
-  unsigned int prev_id = (copy_id_ + 1) % 2;
+  unsigned int prev_id = (copy_id_ + tile_slab_num_ - 1) % tile_slab_num_;
   T tile_start;
 
   // Check again if done, this time based on the tile slab and subarray
@@ -1758,14 +1919,17 @@ Status ArrayOrderedWriteState::write_sorted_col() {
     async_wait(copy_id_);
     reset_tile_slab_state<T>();
     reset_copy_state();
-    copy_tile_slab();
+    RETURN_NOT_OK_ELSE(copy_tile_slab(), async_wait_all());
     async_wait_[copy_id_] = true;
-    async_submit_query(copy_id_);
-    copy_id_ = (copy_id_ + 1) % 2;
+    RETURN_NOT_OK_ELSE(async_submit_query(copy_id_), {
+      async_notify(copy_id_);
+      async_wait_all();
+    });
+    copy_id_ = (copy_id_ + 1) % tile_slab_num_;
   }
 
-  // Wait for last async query to finish
-  async_wait((copy_id_ + 1) % 2);
+  // Wait for all async queries to finish
+  async_wait_all();
 
   // Success
   return Status::Ok();
@@ -1788,14 +1952,17 @@ Status ArrayOrderedWriteState::write_sorted_row() {
     async_wait(copy_id_);
     reset_tile_slab_state<T>();
     reset_copy_state();
-    copy_tile_slab();
+    RETURN_NOT_OK_ELSE(copy_tile_slab(), async_wait_all());
     async_wait_[copy_id_] = true;
-    async_submit_query(copy_id_);
-    copy_id_ = (copy_id_ + 1) % 2;
+    RETURN_NOT_OK_ELSE(async_submit_query(copy_id_), {
+      async_notify(copy_id_);
+      async_wait_all();
+    });
+    copy_id_ = (copy_id_ + 1) % tile_slab_num_;
   }
 
-  // Wait for last async query to finish
-  async_wait((copy_id_ + 1) % 2);
+  // Wait for all async queries to finish
+  async_wait_all();
 
   // Success
   return Status::Ok();
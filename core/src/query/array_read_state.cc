@@ -71,6 +71,7 @@ ArrayReadState::ArrayReadState(Query* query)
   empty_cells_written_.resize(attribute_num_ + 1);
   fragment_cell_pos_ranges_vec_pos_.resize(attribute_num_ + 1);
   min_bounding_coords_end_ = nullptr;
+  overflow_.resize(attribute_num_ + 1);
   read_round_done_.resize(attribute_num_);
   subarray_tile_coords_ = nullptr;
   subarray_tile_domain_ = nullptr;
@@ -78,6 +79,7 @@ ArrayReadState::ArrayReadState(Query* query)
   for (unsigned int i = 0; i < attribute_num_ + 1; ++i) {
     empty_cells_written_[i] = 0;
     fragment_cell_pos_ranges_vec_pos_[i] = 0;
+    overflow_[i] = false;
     read_round_done_[i] = true;
   }
 
@@ -154,6 +156,36 @@ Status ArrayReadState::read(void** buffers, uint64_t* buffer_sizes) {
 /*         PRIVATE METHODS        */
 /* ****************************** */
 
+Status ArrayReadState::apply_conditions(
+    FragmentCellPosRanges* fragment_cell_pos_ranges) {
+  // Trivial case
+  if (query_->conditions().empty())
+    return Status::Ok();
+
+  TraceSpan span(query_->storage_manager()->tracer(), "query_condition");
+
+  // Each condition refines the ranges the previous ones kept
+  std::vector<CellPosRange> cell_pos_ranges;
+  for (const auto& condition : query_->conditions()) {
+    FragmentCellPosRanges result;
+    for (const auto& fragment_cell_pos_range : *fragment_cell_pos_ranges) {
+      unsigned int fragment_id = fragment_cell_pos_range.first.first;
+      uint64_t tile_pos = fragment_cell_pos_range.first.second;
+      cell_pos_ranges.clear();
+      RETURN_NOT_OK(fragment_read_states_[fragment_id]->apply_condition(
+          condition,
+          tile_pos,
+          fragment_cell_pos_range.second,
+          &cell_pos_ranges));
+      for (const auto& cell_pos_range : cell_pos_ranges)
+        result.emplace_back(fragment_cell_pos_range.first, cell_pos_range);
+    }
+    fragment_cell_pos_ranges->swap(result);
+  }
+
+  return Status::Ok();
+}
+
 void ArrayReadState::clean_up_processed_fragment_cell_pos_ranges() {
   // Find the minimum overlapping tile position across all attributes
   auto& attribute_ids = query_->attribute_ids();
@@ -1050,6 +1082,9 @@ Status ArrayReadState::get_next_fragment_cell_ranges_dense() {
   if (done_)
     return Status::Ok();
 
+  ScopedTimer timer(query_->stats(), Stats::Timer::FRAGMENT_MERGE);
+  TraceSpan span(query_->storage_manager()->tracer(), "fragment_merge");
+
   // Get the next overlapping tile for each fragment
   get_next_overlapping_tiles_dense<T>();
 
@@ -1088,6 +1123,9 @@ Status ArrayReadState::get_next_fragment_cell_ranges_sparse() {
   if (done_)
     return Status::Ok();
 
+  ScopedTimer timer(query_->stats(), Stats::Timer::FRAGMENT_MERGE);
+  TraceSpan span(query_->storage_manager()->tracer(), "fragment_merge");
+
   // Gets the next overlapping tiles in the fragment read states
   get_next_overlapping_tiles_sparse<T>();
 
@@ -1113,6 +1151,11 @@ Status ArrayReadState::get_next_fragment_cell_ranges_sparse() {
   RETURN_NOT_OK(compute_fragment_cell_pos_ranges<T>(
       &fragment_cell_ranges, fragment_cell_pos_ranges));
 
+  // Keep only the cells satisfying the query conditions
+  RETURN_NOT_OK_ELSE(
+      apply_conditions(fragment_cell_pos_ranges),
+      delete fragment_cell_pos_ranges);
+
   // Insert cell pos ranges in the state
   fragment_cell_pos_ranges_vec_.push_back(fragment_cell_pos_ranges);
 
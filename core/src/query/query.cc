@@ -34,6 +34,7 @@
 #include "logger.h"
 #include "utils.h"
 
+#include <atomic>
 #include <set>
 #include <sstream>
 
@@ -71,6 +72,7 @@ Query::Query(Query* common_query) {
   callback_data_ = nullptr;
   fragments_init_ = false;
   storage_manager_ = common_query->storage_manager();
+  stats_.set_parent(storage_manager_->stats());
   fragments_borrowed_ = false;
   array_schema_ = common_query->array_schema();
   type_ = common_query->type();
@@ -94,6 +96,39 @@ Query::~Query() {
 /*               API              */
 /* ****************************** */
 
+Status Query::add_condition(
+    const char* attribute, QueryConditionOp op, const void* value) {
+  // Sanity checks
+  if (array_schema_ == nullptr)
+    return LOG_STATUS(
+        Status::QueryError("Cannot add condition; Array metadata not set"));
+  if (type_ != QueryType::READ)
+    return LOG_STATUS(Status::QueryError(
+        "Cannot add condition; Conditions apply only to read queries"));
+  if (array_schema_->dense())
+    return LOG_STATUS(Status::QueryError(
+        "Cannot add condition; Conditions apply only to sparse arrays"));
+  if (attribute == nullptr || value == nullptr)
+    return LOG_STATUS(Status::QueryError(
+        "Cannot add condition; Attribute and value must not be null"));
+
+  // Check the attribute
+  unsigned int attribute_id;
+  RETURN_NOT_OK(array_schema_->attribute_id(attribute, &attribute_id));
+  if (attribute_id == array_schema_->attribute_num())
+    return LOG_STATUS(Status::QueryError(
+        "Cannot add condition; Conditions cannot apply to the coordinates"));
+  auto attr = array_schema_->attribute(attribute_id);
+  if (attr->var_size() || attr->cell_val_num() != 1)
+    return LOG_STATUS(
+        Status::QueryError("Cannot add condition; Conditions apply only to "
+                           "attributes with a single fixed-sized value"));
+
+  conditions_.emplace_back(attribute_id, attr->type(), op, value);
+
+  return Status::Ok();
+}
+
 const ArraySchema* Query::array_schema() const {
   return array_schema_;
 }
@@ -165,6 +200,22 @@ Status Query::clear_fragments() {
   return st_last;
 }
 
+const std::vector<QueryCondition>& Query::conditions() const {
+  return conditions_;
+}
+
+Status Query::copy_tiles(const FragmentMetadata* metadata) {
+  // Sanity checks
+  if (type_ != QueryType::WRITE || layout_ != Layout::GLOBAL_ORDER) {
+    return LOG_STATUS(Status::QueryError(
+        "Cannot copy tiles; Only global order writes are supported"));
+  }
+  if (fragment_num() == 0)
+    return LOG_STATUS(Status::QueryError("Cannot copy tiles; No fragment"));
+
+  return fragments_[0]->copy_tiles(metadata);
+}
+
 Status Query::coords_buffer_i(int* coords_buffer_i) const {
   int buffer_i = 0;
   auto attribute_id_num = attribute_ids_.size();
@@ -267,6 +318,7 @@ Status Query::init(
     uint64_t* buffer_sizes,
     const URI& consolidation_fragment_uri) {
   storage_manager_ = storage_manager;
+  stats_.set_parent(storage_manager->stats());
   array_schema_ = array_schema;
   type_ = type;
   layout_ = layout;
@@ -295,6 +347,7 @@ Status Query::init(
     uint64_t* buffer_sizes,
     bool add_coords) {
   storage_manager_ = storage_manager;
+  stats_.set_parent(storage_manager->stats());
   array_schema_ = array_schema;
   type_ = type;
   layout_ = layout;
@@ -327,9 +380,11 @@ bool Query::overflow() const {
   if (type_ != QueryType::READ)
     return false;
 
-  // Check overflow
+  // Check overflow. Note that an ordered read may be served by the array
+  // read state, when the subarray is contained in a single tile slab
   if (array_ordered_read_state_ != nullptr)
-    return array_ordered_read_state_->overflow();
+    return array_ordered_read_state_->overflow() ||
+           array_read_state_->overflow();
 
   return array_read_state_->overflow();
 }
@@ -343,7 +398,8 @@ bool Query::overflow(unsigned int attribute_id) const {
 
   // Check overflow
   if (array_ordered_read_state_ != nullptr)
-    return array_ordered_read_state_->overflow(attribute_id);
+    return array_ordered_read_state_->overflow(attribute_id) ||
+           array_read_state_->overflow(attribute_id);
 
   return array_read_state_->overflow(attribute_id);
 }
@@ -465,6 +521,10 @@ void Query::set_callback(
   callback_data_ = callback_data;
 }
 
+void Query::set_conditions(const std::vector<QueryCondition>& conditions) {
+  conditions_ = conditions;
+}
+
 Status Query::set_fragment_metadata(
     const std::vector<FragmentMetadata*>& fragment_metadata) {
   fragment_metadata_ = fragment_metadata;
@@ -495,6 +555,7 @@ void Query::set_status(QueryStatus status) {
 
 void Query::set_storage_manager(StorageManager* storage_manager) {
   storage_manager_ = storage_manager;
+  stats_.set_parent(storage_manager->stats());
 }
 
 Status Query::set_subarray(const void* subarray) {
@@ -521,6 +582,10 @@ void Query::set_type(QueryType type) {
   type_ = type;
 }
 
+Stats* Query::stats() {
+  return &stats_;
+}
+
 QueryStatus Query::status() const {
   return status_;
 }
@@ -713,6 +778,7 @@ Status Query::init_fragments(
   if (fragments_init_)
     return Status::Ok();
 
+  TraceSpan span(storage_manager_->tracer(), "fragment_open");
   if (type_ == QueryType::WRITE) {
     RETURN_NOT_OK(new_fragment());
   } else if (type_ == QueryType::READ) {
@@ -776,16 +842,21 @@ Status Query::new_fragment() {
 }
 
 std::string Query::new_fragment_name() const {
+  // The sequence number keeps the names unique when the same thread creates
+  // several fragments within the same millisecond (e.g., ordered writes)
+  static std::atomic<uint64_t> seq(0);
   uint64_t ms = utils::timestamp_ms();
   std::stringstream ss;
   ss << array_schema_->array_uri().to_string() << "/__"
-     << std::this_thread::get_id() << "_" << ms;
+     << std::this_thread::get_id() << "_" << seq++ << "_" << ms;
   return ss.str();
 }
 
 Status Query::open_fragments(const std::vector<FragmentMetadata*>& metadata) {
   // Create a fragment object for each fragment directory
   for (auto meta : metadata) {
+    if (skip_fragment(meta))
+      continue;
     auto fragment = new Fragment(this);
     RETURN_NOT_OK(fragment->init(meta->fragment_uri(), meta));
     fragments_.emplace_back(fragment);
@@ -826,6 +897,20 @@ Status Query::set_attributes(
   return Status::Ok();
 }
 
+bool Query::skip_fragment(const FragmentMetadata* metadata) const {
+  // Applicable only to point lookups on key-value stores
+  auto bloom_filter = metadata->bloom_filter();
+  if (!array_schema_->is_kv() || bloom_filter == nullptr ||
+      subarray_ == nullptr)
+    return false;
+
+  auto subarray = static_cast<const uint64_t*>(subarray_);
+  if (subarray[0] != subarray[1] || subarray[2] != subarray[3])
+    return false;
+
+  return !bloom_filter->may_contain(subarray[0], subarray[2]);
+}
+
 void Query::zero_out_buffer_sizes(uint64_t* buffer_sizes) const {
   unsigned int buffer_i = 0;
   auto attribute_id_num = (unsigned int)attribute_ids_.size();
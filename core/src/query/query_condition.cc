@@ -0,0 +1,287 @@
+/**
+ * @file   query_condition.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class QueryCondition.
+ */
+
+#include "query_condition.h"
+#include "logger.h"
+
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+
+namespace tiledb {
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+QueryCondition::QueryCondition(
+    unsigned int attribute_id,
+    Datatype type,
+    QueryConditionOp op,
+    const void* value)
+    : attribute_id_(attribute_id)
+    , op_(op)
+    , type_(type) {
+  std::memset(value_, 0, sizeof(value_));
+  std::memcpy(value_, value, datatype_size(type));
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+Status QueryCondition::apply(
+    const void* values,
+    const CellPosRange& cell_pos_range,
+    std::vector<CellPosRange>* result) const {
+  switch (type_) {
+    case Datatype::INT32:
+      apply_op(static_cast<const int*>(values), cell_pos_range, result);
+      break;
+    case Datatype::INT64:
+      apply_op(static_cast<const int64_t*>(values), cell_pos_range, result);
+      break;
+    case Datatype::FLOAT32:
+      apply_op(static_cast<const float*>(values), cell_pos_range, result);
+      break;
+    case Datatype::FLOAT64:
+      apply_op(static_cast<const double*>(values), cell_pos_range, result);
+      break;
+    case Datatype::CHAR:
+      apply_op(static_cast<const char*>(values), cell_pos_range, result);
+      break;
+    case Datatype::INT8:
+      apply_op(static_cast<const int8_t*>(values), cell_pos_range, result);
+      break;
+    case Datatype::UINT8:
+      apply_op(static_cast<const uint8_t*>(values), cell_pos_range, result);
+      break;
+    case Datatype::INT16:
+      apply_op(static_cast<const int16_t*>(values), cell_pos_range, result);
+      break;
+    case Datatype::UINT16:
+      apply_op(static_cast<const uint16_t*>(values), cell_pos_range, result);
+      break;
+    case Datatype::UINT32:
+      apply_op(static_cast<const uint32_t*>(values), cell_pos_range, result);
+      break;
+    case Datatype::UINT64:
+      apply_op(static_cast<const uint64_t*>(values), cell_pos_range, result);
+      break;
+    default:
+      return LOG_STATUS(Status::QueryError(
+          "Cannot apply query condition; Unsupported datatype"));
+  }
+
+  return Status::Ok();
+}
+
+unsigned int QueryCondition::attribute_id() const {
+  return attribute_id_;
+}
+
+bool QueryCondition::matches_all(const TileStats& stats) const {
+  switch (type_) {
+    case Datatype::INT32:
+      return matches_all<int>(stats);
+    case Datatype::INT64:
+      return matches_all<int64_t>(stats);
+    case Datatype::FLOAT32:
+      return matches_all<float>(stats);
+    case Datatype::FLOAT64:
+      return matches_all<double>(stats);
+    case Datatype::CHAR:
+      return matches_all<char>(stats);
+    case Datatype::INT8:
+      return matches_all<int8_t>(stats);
+    case Datatype::UINT8:
+      return matches_all<uint8_t>(stats);
+    case Datatype::INT16:
+      return matches_all<int16_t>(stats);
+    case Datatype::UINT16:
+      return matches_all<uint16_t>(stats);
+    case Datatype::UINT32:
+      return matches_all<uint32_t>(stats);
+    case Datatype::UINT64:
+      return matches_all<uint64_t>(stats);
+    default:
+      return false;
+  }
+}
+
+bool QueryCondition::may_match(const TileStats& stats) const {
+  switch (type_) {
+    case Datatype::INT32:
+      return may_match<int>(stats);
+    case Datatype::INT64:
+      return may_match<int64_t>(stats);
+    case Datatype::FLOAT32:
+      return may_match<float>(stats);
+    case Datatype::FLOAT64:
+      return may_match<double>(stats);
+    case Datatype::CHAR:
+      return may_match<char>(stats);
+    case Datatype::INT8:
+      return may_match<int8_t>(stats);
+    case Datatype::UINT8:
+      return may_match<uint8_t>(stats);
+    case Datatype::INT16:
+      return may_match<int16_t>(stats);
+    case Datatype::UINT16:
+      return may_match<uint16_t>(stats);
+    case Datatype::UINT32:
+      return may_match<uint32_t>(stats);
+    case Datatype::UINT64:
+      return may_match<uint64_t>(stats);
+    default:
+      return true;
+  }
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+template <class T>
+void QueryCondition::apply_op(
+    const T* values,
+    const CellPosRange& cell_pos_range,
+    std::vector<CellPosRange>* result) const {
+  switch (op_) {
+    case QueryConditionOp::LT:
+      apply_cmp(values, cell_pos_range, std::less<T>(), result);
+      break;
+    case QueryConditionOp::LE:
+      apply_cmp(values, cell_pos_range, std::less_equal<T>(), result);
+      break;
+    case QueryConditionOp::GT:
+      apply_cmp(values, cell_pos_range, std::greater<T>(), result);
+      break;
+    case QueryConditionOp::GE:
+      apply_cmp(values, cell_pos_range, std::greater_equal<T>(), result);
+      break;
+    case QueryConditionOp::EQ:
+      apply_cmp(values, cell_pos_range, std::equal_to<T>(), result);
+      break;
+    case QueryConditionOp::NE:
+      apply_cmp(values, cell_pos_range, std::not_equal_to<T>(), result);
+      break;
+  }
+}
+
+template <class T, class Cmp>
+void QueryCondition::apply_cmp(
+    const T* values,
+    const CellPosRange& cell_pos_range,
+    Cmp cmp,
+    std::vector<CellPosRange>* result) const {
+  T value;
+  std::memcpy(&value, value_, sizeof(T));
+  bool has_nan = std::numeric_limits<T>::has_quiet_NaN;
+
+  uint64_t run_start = 0;
+  bool in_run = false;
+  for (uint64_t i = cell_pos_range.first; i <= cell_pos_range.second; ++i) {
+    auto v = values[i];
+    bool match = !(has_nan && std::isnan((double)v)) && cmp(v, value);
+    if (match && !in_run) {
+      run_start = i;
+      in_run = true;
+    } else if (!match && in_run) {
+      result->emplace_back(run_start, i - 1);
+      in_run = false;
+    }
+  }
+
+  if (in_run)
+    result->emplace_back(run_start, cell_pos_range.second);
+}
+
+template <class T>
+bool QueryCondition::matches_all(const TileStats& stats) const {
+  // Real tiles may hold NaNs, which the statistics do not bound, and dense
+  // tiles may hold empty cells, which the statistics count as nulls
+  if (stats.count() == 0 || stats.null_count() != 0 ||
+      !std::numeric_limits<T>::is_integer)
+    return false;
+
+  T min, max, value;
+  std::memcpy(&min, stats.min(), sizeof(T));
+  std::memcpy(&max, stats.max(), sizeof(T));
+  std::memcpy(&value, value_, sizeof(T));
+  switch (op_) {
+    case QueryConditionOp::LT:
+      return max < value;
+    case QueryConditionOp::LE:
+      return max <= value;
+    case QueryConditionOp::GT:
+      return min > value;
+    case QueryConditionOp::GE:
+      return min >= value;
+    case QueryConditionOp::EQ:
+      return min == value && max == value;
+    case QueryConditionOp::NE:
+      return value < min || value > max;
+  }
+
+  return false;
+}
+
+template <class T>
+bool QueryCondition::may_match(const TileStats& stats) const {
+  if (stats.count() == 0)
+    return false;
+
+  T min, max, value;
+  std::memcpy(&min, stats.min(), sizeof(T));
+  std::memcpy(&max, stats.max(), sizeof(T));
+  std::memcpy(&value, value_, sizeof(T));
+  switch (op_) {
+    case QueryConditionOp::LT:
+      return min < value;
+    case QueryConditionOp::LE:
+      return min <= value;
+    case QueryConditionOp::GT:
+      return max > value;
+    case QueryConditionOp::GE:
+      return max >= value;
+    case QueryConditionOp::EQ:
+      return min <= value && value <= max;
+    case QueryConditionOp::NE:
+      return min != value || max != value;
+  }
+
+  return true;
+}
+
+}  // namespace tiledb
@@ -0,0 +1,312 @@
+/**
+ * @file   query_iter.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class QueryIter.
+ */
+
+#include "query_iter.h"
+#include "logger.h"
+
+#include <cstdlib>
+
+namespace tiledb {
+
+/* ********************************* */
+/*     CONSTRUCTORS & DESTRUCTORS    */
+/* ********************************* */
+
+QueryIter::QueryIter(StorageManager* storage_manager)
+    : storage_manager_(storage_manager) {
+  batch_ = false;
+  buffer_num_ = 0;
+  buffers_ = nullptr;
+  buffer_sizes_ = nullptr;
+  query_ = nullptr;
+  status_ = QueryStatus::INPROGRESS;
+}
+
+QueryIter::~QueryIter() {
+  clear();
+}
+
+/* ********************************* */
+/*                API                */
+/* ********************************* */
+
+Status QueryIter::buffer(
+    const std::string& attribute, void** buffer, uint64_t* buffer_size) const {
+  unsigned int i;
+  RETURN_NOT_OK(attribute_pos(attribute, &i));
+  if (query_->array_schema()->var_size(attribute_ids_[i]))
+    return LOG_STATUS(Status::QueryIterError(
+        std::string("Cannot get buffer; Attribute '") + attribute +
+        "' is variable-sized"));
+
+  auto b = buffer_idx_[i];
+  *buffer = buffers_[b];
+  *buffer_size = (batch_) ? buffer_sizes_[b] : 0;
+
+  return Status::Ok();
+}
+
+Status QueryIter::buffer_var(
+    const std::string& attribute,
+    uint64_t** buffer_off,
+    uint64_t* buffer_off_size,
+    void** buffer_val,
+    uint64_t* buffer_val_size) const {
+  unsigned int i;
+  RETURN_NOT_OK(attribute_pos(attribute, &i));
+  if (!query_->array_schema()->var_size(attribute_ids_[i]))
+    return LOG_STATUS(Status::QueryIterError(
+        std::string("Cannot get variable-sized buffers; Attribute '") +
+        attribute + "' is fixed-sized"));
+
+  auto b = buffer_idx_[i];
+  *buffer_off = (uint64_t*)buffers_[b];
+  *buffer_off_size = (batch_) ? buffer_sizes_[b] : 0;
+  *buffer_val = buffers_[b + 1];
+  *buffer_val_size = (batch_) ? buffer_sizes_[b + 1] : 0;
+
+  return Status::Ok();
+}
+
+bool QueryIter::done() const {
+  return !batch_;
+}
+
+Status QueryIter::finalize() {
+  Status st = Status::Ok();
+  if (query_ != nullptr)
+    st = storage_manager_->query_finalize(query_);
+  clear();
+
+  return st;
+}
+
+Status QueryIter::init(
+    const std::string& array_uri,
+    const void* subarray,
+    const char** attributes,
+    unsigned int attribute_num,
+    Layout layout) {
+  // Create and init query
+  query_ = new (std::nothrow) Query();
+  if (query_ == nullptr)
+    return LOG_STATUS(Status::QueryIterError(
+        "Cannot initialize query iterator; Memory allocation failed"));
+  RETURN_NOT_OK(storage_manager_->query_init(
+      query_, array_uri.c_str(), QueryType::READ));
+  RETURN_NOT_OK(query_->set_subarray(subarray));
+  RETURN_NOT_OK(query_->set_layout(layout));
+
+  // Get attributes
+  auto array_schema = query_->array_schema();
+  if (attributes == nullptr) {  // Default: all attributes
+    attributes_ = array_schema->attribute_names();
+    if (!array_schema->dense())
+      attributes_.emplace_back(constants::coords);
+  } else {
+    for (unsigned int i = 0; i < attribute_num; ++i) {
+      if (attributes[i] == nullptr)
+        return LOG_STATUS(Status::QueryIterError(
+            "Cannot initialize query iterator; Attributes cannot be null"));
+      attributes_.emplace_back(attributes[i]);
+    }
+  }
+  RETURN_NOT_OK(array_schema->get_attribute_ids(attributes_, attribute_ids_));
+
+  RETURN_NOT_OK(init_buffers());
+
+  return submit_read_query();
+}
+
+Status QueryIter::next() {
+  // The last batch was retrieved
+  if (status_ != QueryStatus::INCOMPLETE) {
+    batch_ = false;
+    return Status::Ok();
+  }
+
+  return submit_read_query();
+}
+
+/* ********************************* */
+/*           PRIVATE METHODS         */
+/* ********************************* */
+
+Status QueryIter::attribute_pos(
+    const std::string& attribute, unsigned int* i) const {
+  auto attribute_num = (unsigned int)attributes_.size();
+  for (*i = 0; *i < attribute_num; ++(*i)) {
+    if (attributes_[*i] == attribute)
+      return Status::Ok();
+  }
+
+  return LOG_STATUS(Status::QueryIterError(
+      std::string("Cannot get buffer; Attribute '") + attribute +
+      "' is not read by the iterator"));
+}
+
+void QueryIter::clear() {
+  delete query_;
+  query_ = nullptr;
+
+  if (buffers_ != nullptr) {
+    for (unsigned int i = 0; i < buffer_num_; ++i)
+      std::free(buffers_[i]);
+  }
+  delete[] buffers_;
+  buffers_ = nullptr;
+  delete[] buffer_sizes_;
+  buffer_sizes_ = nullptr;
+  buffer_num_ = 0;
+
+  alloced_sizes_.clear();
+  attribute_ids_.clear();
+  attributes_.clear();
+  buffer_idx_.clear();
+  batch_ = false;
+  status_ = QueryStatus::INPROGRESS;
+}
+
+Status QueryIter::grow_buffers() {
+  bool grown = false;
+  auto attribute_num = (unsigned int)attribute_ids_.size();
+  for (unsigned int i = 0; i < attribute_num; ++i) {
+    auto aid = attribute_ids_[i];
+    if (!query_->overflow(aid))
+      continue;
+
+    // Grow the values buffer for variable-sized attributes
+    auto b = buffer_idx_[i];
+    if (query_->array_schema()->var_size(aid))
+      ++b;
+
+    auto new_size = 2 * alloced_sizes_[b];
+    auto new_buffer = std::realloc(buffers_[b], new_size);
+    if (new_buffer == nullptr)
+      return LOG_STATUS(Status::QueryIterError(
+          "Cannot grow query iterator buffer; Memory allocation failed"));
+    buffers_[b] = new_buffer;
+    alloced_sizes_[b] = new_size;
+    grown = true;
+  }
+
+  if (!grown)
+    return LOG_STATUS(Status::QueryIterError(
+        "Cannot submit read query; The query made no progress"));
+
+  return Status::Ok();
+}
+
+Status QueryIter::init_buffers() {
+  // Compute the number of bytes a cell occupies across all buffers
+  auto array_schema = query_->array_schema();
+  uint64_t bytes_per_cell = 0;
+  buffer_num_ = 0;
+  for (auto aid : attribute_ids_) {
+    buffer_idx_.push_back(buffer_num_);
+    if (array_schema->var_size(aid)) {
+      bytes_per_cell += 2 * constants::cell_var_offset_size;
+      buffer_num_ += 2;
+    } else {
+      bytes_per_cell += array_schema->cell_size(aid);
+      ++buffer_num_;
+    }
+  }
+
+  // Compute the number of cells that fit in the budget
+  auto budget =
+      storage_manager_->config().sm_params().query_iter_memory_budget_;
+  auto cell_num = std::max(budget / bytes_per_cell, uint64_t(1));
+
+  // Allocate buffers
+  buffers_ = new (std::nothrow) void*[buffer_num_];
+  buffer_sizes_ = new (std::nothrow) uint64_t[buffer_num_];
+  if (buffers_ == nullptr || buffer_sizes_ == nullptr)
+    return LOG_STATUS(Status::QueryIterError(
+        "Cannot initialize query iterator buffers; Memory allocation failed"));
+  for (unsigned int b = 0; b < buffer_num_; ++b)
+    buffers_[b] = nullptr;
+
+  auto attribute_num = (unsigned int)attribute_ids_.size();
+  for (unsigned int i = 0; i < attribute_num; ++i) {
+    auto aid = attribute_ids_[i];
+    if (array_schema->var_size(aid)) {
+      alloced_sizes_.push_back(cell_num * constants::cell_var_offset_size);
+      alloced_sizes_.push_back(cell_num * constants::cell_var_offset_size);
+    } else {
+      alloced_sizes_.push_back(cell_num * array_schema->cell_size(aid));
+    }
+  }
+  for (unsigned int b = 0; b < buffer_num_; ++b) {
+    buffers_[b] = std::malloc(alloced_sizes_[b]);
+    if (buffers_[b] == nullptr)
+      return LOG_STATUS(Status::QueryIterError(
+          "Cannot initialize query iterator buffers; Memory allocation "
+          "failed"));
+  }
+
+  // Set buffers to the query
+  std::vector<const char*> attributes;
+  for (const auto& attr : attributes_)
+    attributes.push_back(attr.c_str());
+  return query_->set_buffers(
+      &attributes[0], attribute_num, buffers_, buffer_sizes_);
+}
+
+bool QueryIter::has_results() const {
+  for (unsigned int b = 0; b < buffer_num_; ++b) {
+    if (buffer_sizes_[b] != 0)
+      return true;
+  }
+
+  return false;
+}
+
+Status QueryIter::submit_read_query() {
+  do {
+    // Always reset the buffer sizes to the allocated ones
+    for (unsigned int b = 0; b < buffer_num_; ++b)
+      buffer_sizes_[b] = alloced_sizes_[b];
+
+    RETURN_NOT_OK(storage_manager_->query_submit(query_));
+    status_ = query_->status();
+    batch_ = has_results();
+
+    // Nothing fit in the buffers
+    if (status_ == QueryStatus::INCOMPLETE && !batch_)
+      RETURN_NOT_OK(grow_buffers());
+  } while (status_ == QueryStatus::INCOMPLETE && !batch_);
+
+  return Status::Ok();
+}
+
+}  // namespace tiledb
@@ -150,8 +150,32 @@ Status Config::set(const std::string& param, const std::string& value) {
     RETURN_NOT_OK(set_sm_tile_cache_size(value));
   } else if (param == "sm.array_schema_cache_size") {
     RETURN_NOT_OK(set_sm_array_schema_cache_size(value));
+  } else if (param == "sm.compression_auto_bandwidth") {
+    RETURN_NOT_OK(set_sm_compression_auto_bandwidth(value));
+  } else if (param == "sm.compression_auto_candidates") {
+    RETURN_NOT_OK(set_sm_compression_auto_candidates(value));
+  } else if (param == "sm.consolidation_max_fragments") {
+    RETURN_NOT_OK(set_sm_consolidation_max_fragments(value));
+  } else if (param == "sm.consolidation_memory_budget") {
+    RETURN_NOT_OK(set_sm_consolidation_memory_budget(value));
+  } else if (param == "sm.consolidation_min_fragments") {
+    RETURN_NOT_OK(set_sm_consolidation_min_fragments(value));
+  } else if (param == "sm.consolidation_size_ratio") {
+    RETURN_NOT_OK(set_sm_consolidation_size_ratio(value));
   } else if (param == "sm.fragment_metadata_cache_size") {
     RETURN_NOT_OK(set_sm_fragment_metadata_cache_size(value));
+  } else if (param == "sm.kv_bloom_filter_bits_per_key") {
+    RETURN_NOT_OK(set_sm_kv_bloom_filter_bits_per_key(value));
+  } else if (param == "sm.lock_free_reads") {
+    RETURN_NOT_OK(set_sm_lock_free_reads(value));
+  } else if (param == "sm.ordered_write_buffer_num") {
+    RETURN_NOT_OK(set_sm_ordered_write_buffer_num(value));
+  } else if (param == "sm.query_iter_memory_budget") {
+    RETURN_NOT_OK(set_sm_query_iter_memory_budget(value));
+  } else if (param == "sm.thread_pool_size") {
+    RETURN_NOT_OK(set_sm_thread_pool_size(value));
+  } else if (param == "sm.trace_file") {
+    RETURN_NOT_OK(set_sm_trace_file(value));
   } else if (param == "vfs.s3.region") {
     RETURN_NOT_OK(set_vfs_s3_region(value));
   } else if (param == "vfs.s3.scheme") {
@@ -207,9 +231,39 @@ Status Config::unset(const std::string& param) {
     sm_params_.tile_cache_size_ = constants::tile_cache_size;
   } else if (param == "sm.array_schema_cache_size") {
     sm_params_.array_schema_cache_size_ = constants::array_schema_cache_size;
+  } else if (param == "sm.compression_auto_bandwidth") {
+    sm_params_.compression_auto_bandwidth_ =
+        constants::compression_auto_bandwidth;
+  } else if (param == "sm.compression_auto_candidates") {
+    sm_params_.compression_auto_candidates_ =
+        constants::compression_auto_candidates;
+  } else if (param == "sm.consolidation_max_fragments") {
+    sm_params_.consolidation_max_fragments_ =
+        constants::consolidation_max_fragments;
+  } else if (param == "sm.consolidation_memory_budget") {
+    sm_params_.consolidation_memory_budget_ =
+        constants::consolidation_memory_budget;
+  } else if (param == "sm.consolidation_min_fragments") {
+    sm_params_.consolidation_min_fragments_ =
+        constants::consolidation_min_fragments;
+  } else if (param == "sm.consolidation_size_ratio") {
+    sm_params_.consolidation_size_ratio_ = constants::consolidation_size_ratio;
   } else if (param == "sm.fragment_metadata_cache_size") {
     sm_params_.fragment_metadata_cache_size_ =
         constants::fragment_metadata_cache_size;
+  } else if (param == "sm.kv_bloom_filter_bits_per_key") {
+    sm_params_.kv_bloom_filter_bits_per_key_ =
+        constants::kv_bloom_filter_bits_per_key;
+  } else if (param == "sm.lock_free_reads") {
+    sm_params_.lock_free_reads_ = constants::lock_free_reads;
+  } else if (param == "sm.ordered_write_buffer_num") {
+    sm_params_.ordered_write_buffer_num_ = constants::ordered_write_buffer_num;
+  } else if (param == "sm.query_iter_memory_budget") {
+    sm_params_.query_iter_memory_budget_ = constants::query_iter_memory_budget;
+  } else if (param == "sm.thread_pool_size") {
+    sm_params_.thread_pool_size_ = constants::thread_pool_size;
+  } else if (param == "sm.trace_file") {
+    sm_params_.trace_file_ = constants::trace_file;
   } else if (param == "vfs.s3.region") {
     vfs_params_.s3_params_.region_ = constants::s3_region;
   } else if (param == "vfs.s3.scheme") {
@@ -254,10 +308,58 @@ void Config::set_default_param_values() {
   param_values_["sm.array_schema_cache_size"] = value.str();
   value.str(std::string());
 
+  value << sm_params_.compression_auto_bandwidth_;
+  param_values_["sm.compression_auto_bandwidth"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.compression_auto_candidates_;
+  param_values_["sm.compression_auto_candidates"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.consolidation_max_fragments_;
+  param_values_["sm.consolidation_max_fragments"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.consolidation_memory_budget_;
+  param_values_["sm.consolidation_memory_budget"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.consolidation_min_fragments_;
+  param_values_["sm.consolidation_min_fragments"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.consolidation_size_ratio_;
+  param_values_["sm.consolidation_size_ratio"] = value.str();
+  value.str(std::string());
+
   value << sm_params_.fragment_metadata_cache_size_;
   param_values_["sm.fragment_metadata_cache_size"] = value.str();
   value.str(std::string());
 
+  value << sm_params_.kv_bloom_filter_bits_per_key_;
+  param_values_["sm.kv_bloom_filter_bits_per_key"] = value.str();
+  value.str(std::string());
+
+  value << ((sm_params_.lock_free_reads_) ? "true" : "false");
+  param_values_["sm.lock_free_reads"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.ordered_write_buffer_num_;
+  param_values_["sm.ordered_write_buffer_num"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.query_iter_memory_budget_;
+  param_values_["sm.query_iter_memory_budget"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.thread_pool_size_;
+  param_values_["sm.thread_pool_size"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.trace_file_;
+  param_values_["sm.trace_file"] = value.str();
+  value.str(std::string());
+
   value << vfs_params_.s3_params_.region_;
   param_values_["vfs.s3.region"] = value.str();
   value.str(std::string());
@@ -308,6 +410,72 @@ Status Config::set_sm_array_schema_cache_size(const std::string& value) {
   return Status::Ok();
 }
 
+Status Config::set_sm_compression_auto_bandwidth(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  sm_params_.compression_auto_bandwidth_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_compression_auto_candidates(const std::string& value) {
+  std::vector<Compressor> v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  for (auto c : v) {
+    if (c == Compressor::AUTO)
+      return LOG_STATUS(Status::ConfigError(
+          "Cannot set parameter; AUTO cannot be an AUTO compression "
+          "candidate"));
+  }
+  sm_params_.compression_auto_candidates_ = value;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_consolidation_max_fragments(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  if (v == 1)
+    return LOG_STATUS(Status::ConfigError(
+        "Cannot set parameter; Maximum consolidation fragment number must be "
+        "zero or at least 2"));
+  sm_params_.consolidation_max_fragments_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_consolidation_memory_budget(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  sm_params_.consolidation_memory_budget_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_consolidation_min_fragments(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  if (v < 2)
+    return LOG_STATUS(Status::ConfigError(
+        "Cannot set parameter; Minimum consolidation fragment number must be "
+        "at least 2"));
+  sm_params_.consolidation_min_fragments_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_consolidation_size_ratio(const std::string& value) {
+  float v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  if (v != 0.0f && !(v >= 1.0f))
+    return LOG_STATUS(Status::ConfigError(
+        "Cannot set parameter; Consolidation size ratio must be zero or at "
+        "least 1"));
+  sm_params_.consolidation_size_ratio_ = v;
+
+  return Status::Ok();
+}
+
 Status Config::set_sm_fragment_metadata_cache_size(const std::string& value) {
   uint64_t v;
   RETURN_NOT_OK(utils::parse::convert(value, &v));
@@ -316,6 +484,56 @@ Status Config::set_sm_fragment_metadata_cache_size(const std::string& value) {
   return Status::Ok();
 }
 
+Status Config::set_sm_kv_bloom_filter_bits_per_key(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  sm_params_.kv_bloom_filter_bits_per_key_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_lock_free_reads(const std::string& value) {
+  if (value != "true" && value != "false")
+    return LOG_STATUS(Status::ConfigError(
+        "Cannot set parameter; Invalid lock-free reads value"));
+
+  sm_params_.lock_free_reads_ = (value == "true");
+  return Status::Ok();
+}
+
+Status Config::set_sm_ordered_write_buffer_num(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  if (v == 0)
+    return LOG_STATUS(Status::ConfigError(
+        "Cannot set parameter; Ordered write buffer number must be positive"));
+  sm_params_.ordered_write_buffer_num_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_query_iter_memory_budget(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  if (v == 0)
+    return LOG_STATUS(Status::ConfigError(
+        "Cannot set parameter; Query iterator memory budget must be positive"));
+  sm_params_.query_iter_memory_budget_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_thread_pool_size(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  if (v == 0)
+    return LOG_STATUS(Status::ConfigError(
+        "Cannot set parameter; Thread pool size must be positive"));
+  sm_params_.thread_pool_size_ = v;
+
+  return Status::Ok();
+}
+
 Status Config::set_sm_tile_cache_size(const std::string& value) {
   uint64_t v;
   RETURN_NOT_OK(utils::parse::convert(value, &v));
@@ -324,6 +542,11 @@ Status Config::set_sm_tile_cache_size(const std::string& value) {
   return Status::Ok();
 }
 
+Status Config::set_sm_trace_file(const std::string& value) {
+  sm_params_.trace_file_ = value;
+  return Status::Ok();
+}
+
 Status Config::set_vfs_s3_region(const std::string& value) {
   vfs_params_.s3_params_.region_ = value;
   return Status::Ok();
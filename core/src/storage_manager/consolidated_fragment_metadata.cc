@@ -0,0 +1,159 @@
+/**
+ * @file   consolidated_fragment_metadata.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class ConsolidatedFragmentMetadata.
+ */
+
+
+#include "consolidated_fragment_metadata.h"
+#include "logger.h"
+
+namespace tiledb {
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+ConsolidatedFragmentMetadata::ConsolidatedFragmentMetadata() {
+  buff_ = new Buffer();
+}
+
+ConsolidatedFragmentMetadata::~ConsolidatedFragmentMetadata() {
+  delete buff_;
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+Status ConsolidatedFragmentMetadata::add(
+    const URI& fragment_uri, bool dense, const Buffer* buff) {
+  Entry entry;
+  entry.dense_ = dense;
+  entry.offset_ = buff_->size();
+  entry.size_ = buff->size();
+  RETURN_NOT_OK(buff_->write(buff->data(), buff->size()));
+  index_[fragment_uri.last_path_part()] = entry;
+
+  return Status::Ok();
+}
+
+// ===== FORMAT =====
+// fragment_num (uint64_t)
+// name_size#1 (uint64_t) name#1 (char[])
+// dense#1 (char) offset#1 (uint64_t) size#1 (uint64_t)
+// name_size#2 (uint64_t) name#2 (char[])
+// dense#2 (char) offset#2 (uint64_t) size#2 (uint64_t)
+// ...
+// data_size (uint64_t)
+// data (char[])
+Status ConsolidatedFragmentMetadata::deserialize(ConstBuffer* buff) {
+  index_.clear();
+  buff_->reset_size();
+
+  uint64_t fragment_num;
+  RETURN_NOT_OK(buff->read(&fragment_num, sizeof(uint64_t)));
+  for (uint64_t i = 0; i < fragment_num; ++i) {
+    uint64_t name_size;
+    RETURN_NOT_OK(buff->read(&name_size, sizeof(uint64_t)));
+    if (name_size > buff->nbytes_left_to_read())
+      return LOG_STATUS(Status::StorageManagerError(
+          "Cannot deserialize consolidated fragment metadata; Invalid "
+          "fragment name size"));
+    std::string name(name_size, '\0');
+    RETURN_NOT_OK(buff->read(&name[0], name_size));
+    char dense;
+    Entry entry;
+    RETURN_NOT_OK(buff->read(&dense, sizeof(char)));
+    RETURN_NOT_OK(buff->read(&entry.offset_, sizeof(uint64_t)));
+    RETURN_NOT_OK(buff->read(&entry.size_, sizeof(uint64_t)));
+    entry.dense_ = (dense == 1);
+    index_[name] = entry;
+  }
+
+  uint64_t data_size;
+  RETURN_NOT_OK(buff->read(&data_size, sizeof(uint64_t)));
+  if (data_size > buff->nbytes_left_to_read())
+    return LOG_STATUS(Status::StorageManagerError(
+        "Cannot deserialize consolidated fragment metadata; Invalid size"));
+  RETURN_NOT_OK(buff_->write(buff, data_size));
+  for (const auto& entry : index_) {
+    if (entry.second.offset_ + entry.second.size_ > data_size)
+      return LOG_STATUS(Status::StorageManagerError(
+          "Cannot deserialize consolidated fragment metadata; Invalid "
+          "fragment offset"));
+  }
+
+  return Status::Ok();
+}
+
+uint64_t ConsolidatedFragmentMetadata::fragment_num() const {
+  return index_.size();
+}
+
+Status ConsolidatedFragmentMetadata::get(
+    const ArraySchema* array_schema,
+    const URI& fragment_uri,
+    FragmentMetadata** metadata) const {
+  *metadata = nullptr;
+  auto it = index_.find(fragment_uri.last_path_part());
+  if (it == index_.end())
+    return Status::Ok();
+
+  auto fragment_metadata =
+      new FragmentMetadata(array_schema, it->second.dense_, fragment_uri);
+  ConstBuffer cbuff(buff_->data(it->second.offset_), it->second.size_);
+  RETURN_NOT_OK_ELSE(
+      fragment_metadata->deserialize(&cbuff), delete fragment_metadata);
+  *metadata = fragment_metadata;
+
+  return Status::Ok();
+}
+
+Status ConsolidatedFragmentMetadata::serialize(Buffer* buff) const {
+  uint64_t fragment_num = index_.size();
+  RETURN_NOT_OK(buff->write(&fragment_num, sizeof(uint64_t)));
+  for (const auto& entry : index_) {
+    uint64_t name_size = entry.first.size();
+    auto dense = (char)entry.second.dense_;
+    RETURN_NOT_OK(buff->write(&name_size, sizeof(uint64_t)));
+    RETURN_NOT_OK(buff->write(entry.first.data(), name_size));
+    RETURN_NOT_OK(buff->write(&dense, sizeof(char)));
+    RETURN_NOT_OK(buff->write(&entry.second.offset_, sizeof(uint64_t)));
+    RETURN_NOT_OK(buff->write(&entry.second.size_, sizeof(uint64_t)));
+  }
+
+  uint64_t data_size = buff_->size();
+  RETURN_NOT_OK(buff->write(&data_size, sizeof(uint64_t)));
+  RETURN_NOT_OK(buff->write(buff_->data(), data_size));
+
+  return Status::Ok();
+}
+
+}  // namespace tiledb
@@ -35,6 +35,8 @@
 #include "storage_manager.h"
 #include "utils.h"
 
+#include <algorithm>
+#include <future>
 #include <sstream>
 
 /* ****************************** */
@@ -57,7 +59,10 @@ Consolidator::~Consolidator() = default;
 /*               API              */
 /* ****************************** */
 
-Status Consolidator::consolidate(const char* array_name) {
+Status Consolidator::consolidate(
+    const char* array_name,
+    void (*progress_callback)(uint64_t, uint64_t, void*),
+    void* progress_data) {
   std::vector<URI> old_fragment_uris;
   URI new_fragment_uri;
   URI array_uri = URI(array_name);
@@ -66,29 +71,64 @@ Status Consolidator::consolidate(const char* array_name) {
   auto array_schema = (ArraySchema*)nullptr;
   RETURN_NOT_OK(storage_manager_->load_array_schema(array_uri, &array_schema));
 
+  // Select the fragments to consolidate
+  std::vector<URI> fragment_uris;
+  bool all_fragments;
+  RETURN_NOT_OK_ELSE(
+      select_fragments(
+          array_name, array_schema, &fragment_uris, &all_fragments),
+      delete array_schema);
+  if (!all_fragments && fragment_uris.empty()) {  // Nothing to consolidate
+    delete array_schema;
+    return Status::Ok();
+  }
+
   // Prepare buffers
-  void** buffers;
-  uint64_t* buffer_sizes;
+  void** buffers[2];
+  uint64_t* buffer_sizes[2];
   unsigned int buffer_num;
+  uint64_t buffer_size;
   RETURN_NOT_OK_ELSE(
-      create_buffers(array_schema, &buffers, &buffer_sizes, &buffer_num),
+      create_buffers(
+          array_schema, buffers, buffer_sizes, &buffer_num, &buffer_size),
       delete array_schema);
+  Progress progress = {
+      progress_callback, progress_data, std::vector<uint64_t>(), 0};
 
   // Create queries
   unsigned int fragment_num;
+  auto min_fragments =
+      storage_manager_->config().sm_params().consolidation_min_fragments_;
   auto query_r = new Query();
   auto query_w = new Query();
   Status st = create_queries(
-      query_r, query_w, array_name, buffers, buffer_sizes, &fragment_num);
+      query_r,
+      query_w,
+      array_name,
+      buffers[0],
+      buffer_sizes[0],
+      all_fragments ? nullptr : &fragment_uris,
+      &fragment_num);
   if (!st.ok())
     goto clean_up;
 
   // Check number of fragments
-  if (fragment_num <= 1)  // Nothing to consolidate
+  if (fragment_num < min_fragments) {  // Nothing to consolidate
+    st = storage_manager_->query_finalize(query_r);
     goto clean_up;
+  }
 
   // Read from one array and write to the other
-  st = copy_array(query_r, query_w);
+  st = copy_fragments(
+      array_name,
+      array_schema,
+      query_r,
+      query_w,
+      buffers,
+      buffer_sizes,
+      buffer_num,
+      buffer_size,
+      &progress);
   if (!st.ok())
     goto clean_up;
 
@@ -106,7 +146,7 @@ Status Consolidator::consolidate(const char* array_name) {
     goto clean_up;
 
   // Delete old fragments
-  st = delete_old_fragments(old_fragment_uris);
+  st = delete_old_fragments(array_uri, old_fragment_uris);
   if (!st.ok()) {
     storage_manager_->object_unlock(array_uri, StorageManager::XLOCK);
     goto clean_up;
@@ -115,10 +155,15 @@ Status Consolidator::consolidate(const char* array_name) {
   // Unlock the array
   st = storage_manager_->object_unlock(array_uri, StorageManager::XLOCK);
 
+  // Consolidate the metadata of the remaining fragments
+  if (st.ok())
+    st = storage_manager_->array_consolidate_metadata(array_name);
+
 // Clean up
 clean_up:
   delete array_schema;
-  free_buffers(buffer_num, buffers, buffer_sizes);
+  free_buffers(buffer_num, buffers[0], buffer_sizes[0]);
+  free_buffers(buffer_num, buffers[1], buffer_sizes[1]);
   delete query_r;
   delete query_w;
 
@@ -129,23 +174,176 @@ clean_up:
 /*        PRIVATE METHODS         */
 /* ****************************** */
 
-Status Consolidator::copy_array(Query* query_r, Query* query_w) {
-  do {
-    RETURN_NOT_OK(storage_manager_->query_submit(query_r));
-    RETURN_NOT_OK(storage_manager_->query_submit(query_w));
-  } while (query_r->status() == QueryStatus::INCOMPLETE);
+Status Consolidator::copy_array(
+    Query* query_r,
+    Query* query_w,
+    void** buffers[2],
+    uint64_t* buffer_sizes[2],
+    unsigned int buffer_num,
+    uint64_t buffer_size,
+    Progress* progress) {
+  // For easy reference
+  auto array_schema = query_r->array_schema();
+  auto thread_pool = storage_manager_->thread_pool();
+  auto attribute_num = array_schema->attribute_num();
+  auto dense = array_schema->dense();
+
+  // Read the first batch
+  int cur = 0;
+  RETURN_NOT_OK(read_batch(
+      query_r, buffers[cur], buffer_sizes[cur], buffer_num, buffer_size));
+
+  // Write every batch, while reading the next one in the thread pool
+  for (;;) {
+    int next = 1 - cur;
+    bool incomplete = (query_r->status() == QueryStatus::INCOMPLETE);
+    std::vector<std::future<Status>> tasks;
+    if (incomplete) {
+      tasks.emplace_back(thread_pool->enqueue([&, next]() {
+        return read_batch(
+            query_r,
+            buffers[next],
+            buffer_sizes[next],
+            buffer_num,
+            buffer_size);
+      }));
+    }
+
+    query_w->set_buffers(buffers[cur], buffer_sizes[cur]);
+    Status st = storage_manager_->query_submit(query_w);
+    if (st.ok()) {
+      std::vector<uint64_t> cell_nums;
+      uint64_t byte_num = 0;
+      for (unsigned int i = 0, b = 0; i < attribute_num + (dense ? 0 : 1);
+           ++i) {
+        if (array_schema->var_size(i)) {
+          cell_nums.push_back(
+              buffer_sizes[cur][b] / constants::cell_var_offset_size);
+          byte_num += buffer_sizes[cur][b] + buffer_sizes[cur][b + 1];
+          b += 2;
+        } else {
+          cell_nums.push_back(
+              buffer_sizes[cur][b] / array_schema->cell_size(i));
+          byte_num += buffer_sizes[cur][b];
+          ++b;
+        }
+      }
+      report_progress(progress, cell_nums, byte_num);
+    }
+
+    // The read must complete before returning, even upon error, since it
+    // references the buffers
+    Status st_read = thread_pool->wait_all(tasks);
+    RETURN_NOT_OK(st);
+    RETURN_NOT_OK(st_read);
+    if (!incomplete)
+      break;
+    cur = next;
+  }
+
+  return Status::Ok();
+}
+
+Status Consolidator::copy_fragments(
+    const char* array_name,
+    const ArraySchema* array_schema,
+    Query* query_r,
+    Query* query_w,
+    void** buffers[2],
+    uint64_t* buffer_sizes[2],
+    unsigned int buffer_num,
+    uint64_t buffer_size,
+    Progress* progress) {
+  // Tiles can be copied verbatim only for sparse fragments, and only if the
+  // new fragment needs no per-key bloom filter
+  auto bloom_bits =
+      storage_manager_->config().sm_params().kv_bloom_filter_bits_per_key_;
+  if (array_schema->dense() || (array_schema->is_kv() && bloom_bits != 0))
+    return copy_array(
+        query_r,
+        query_w,
+        buffers,
+        buffer_sizes,
+        buffer_num,
+        buffer_size,
+        progress);
+
+  // Group the fragments into non-overlapping runs
+  std::vector<std::vector<FragmentMetadata*>> runs;
+  RETURN_NOT_OK(
+      group_fragments(array_schema, query_r->fragment_metadata(), &runs));
+  auto copyable = std::any_of(
+      runs.begin(), runs.end(), [](const std::vector<FragmentMetadata*>& r) {
+        return r.size() == 1 && r[0]->var_offsets_filtered();
+      });
+  if (!copyable)
+    return copy_array(
+        query_r,
+        query_w,
+        buffers,
+        buffer_sizes,
+        buffer_num,
+        buffer_size,
+        progress);
+
+  for (const auto& run : runs) {
+    // Copy the tiles of a fragment that overlaps with no other, unless it
+    // stores its offsets in an older format
+    if (run.size() == 1 && run[0]->var_offsets_filtered()) {
+      RETURN_NOT_OK(query_w->copy_tiles(run[0]));
+      uint64_t cell_num = 0;
+      for (uint64_t t = 0; t < run[0]->tile_num(); ++t)
+        cell_num += run[0]->cell_num(t);
+      std::vector<uint64_t> cell_nums(array_schema->attribute_num() + 1);
+      std::fill(cell_nums.begin(), cell_nums.end(), cell_num);
+      report_progress(progress, cell_nums, run[0]->fragment_size());
+      continue;
+    }
+
+    // Merge the cells of the overlapping fragments
+    std::vector<URI> run_uris;
+    for (auto meta : run)
+      run_uris.push_back(meta->fragment_uri());
+    Query query_run;
+    RETURN_NOT_OK(storage_manager_->query_init(
+        &query_run,
+        array_name,
+        QueryType::READ,
+        Layout::GLOBAL_ORDER,
+        nullptr,
+        nullptr,
+        0,
+        buffers[0],
+        buffer_sizes[0],
+        URI(""),
+        &run_uris));
+    Status st = copy_array(
+        &query_run,
+        query_w,
+        buffers,
+        buffer_sizes,
+        buffer_num,
+        buffer_size,
+        progress);
+    Status st_finalize = storage_manager_->query_finalize(&query_run);
+    RETURN_NOT_OK(st);
+    RETURN_NOT_OK(st_finalize);
+  }
 
   return Status::Ok();
 }
 
 Status Consolidator::create_buffers(
     ArraySchema* array_meta,
-    void*** buffers,
-    uint64_t** buffer_sizes,
-    unsigned int* buffer_num) {
+    void** buffers[2],
+    uint64_t* buffer_sizes[2],
+    unsigned int* buffer_num,
+    uint64_t* buffer_size) {
   // For easy reference
   auto attribute_num = array_meta->attribute_num();
   auto dense = array_meta->dense();
+  auto memory_budget =
+      storage_manager_->config().sm_params().consolidation_memory_budget_;
 
   // Calculate number of buffers
   *buffer_num = 0;
@@ -153,32 +351,44 @@ Status Consolidator::create_buffers(
     *buffer_num += (array_meta->var_size(i)) ? 2 : 1;
   *buffer_num += (dense) ? 0 : 1;
 
-  // Create buffers
-  *buffers = (void**)std::malloc(*buffer_num * sizeof(void*));
-  if (*buffers == nullptr) {
+  // Split the memory budget evenly across the buffers of both batches
+  *buffer_size = (memory_budget == 0) ? constants::consolidation_buffer_size :
+                                        memory_budget / (2 * *buffer_num);
+  if (*buffer_size == 0) {
     return LOG_STATUS(Status::ConsolidationError(
-        "Cannot create consolidation buffers; Memory allocation failed"));
+        "Cannot create consolidation buffers; Memory budget is too small"));
   }
-  *buffer_sizes = new uint64_t[*buffer_num];
-  if (*buffer_sizes == nullptr) {
-    return LOG_STATUS(Status::ConsolidationError(
-        "Cannot create consolidation buffer sizes; Memory allocation failed"));
+
+  // Create buffers
+  for (int b = 0; b < 2; ++b) {
+    buffers[b] = (void**)std::malloc(*buffer_num * sizeof(void*));
+    if (buffers[b] == nullptr) {
+      if (b == 1)
+        free_buffers(*buffer_num, buffers[0], buffer_sizes[0]);
+      return LOG_STATUS(Status::ConsolidationError(
+          "Cannot create consolidation buffers; Memory allocation failed"));
+    }
+    buffer_sizes[b] = new uint64_t[*buffer_num];
   }
 
   // Allocate space for each buffer
   bool error = false;
-  for (unsigned int i = 0; i < *buffer_num; ++i) {
-    (*buffers)[i] = std::malloc(constants::consolidation_buffer_size);
-    if ((*buffers)[i] == nullptr)  // The loop should continue to
-      error = true;                // allocate nullptr to each buffer
-    (*buffer_sizes)[i] = constants::consolidation_buffer_size;
+  for (int b = 0; b < 2; ++b) {
+    for (unsigned int i = 0; i < *buffer_num; ++i) {
+      buffers[b][i] = std::malloc(*buffer_size);
+      if (buffers[b][i] == nullptr)  // The loop should continue to
+        error = true;                // allocate nullptr to each buffer
+      buffer_sizes[b][i] = *buffer_size;
+    }
   }
 
   // Clean up upon error
   if (error) {
-    free_buffers(*buffer_num, *buffers, *buffer_sizes);
-    *buffers = nullptr;
-    *buffer_sizes = nullptr;
+    for (int b = 0; b < 2; ++b) {
+      free_buffers(*buffer_num, buffers[b], buffer_sizes[b]);
+      buffers[b] = nullptr;
+      buffer_sizes[b] = nullptr;
+    }
     return LOG_STATUS(Status::ConsolidationError(
         "Cannot create consolidation buffers; Memory allocation failed"));
   }
@@ -193,6 +403,7 @@ Status Consolidator::create_queries(
     const char* array_name,
     void** buffers,
     uint64_t* buffer_sizes,
+    const std::vector<URI>* fragment_uris,
     unsigned int* fragment_num) {
   // Create read query
   RETURN_NOT_OK(storage_manager_->query_init(
@@ -204,11 +415,16 @@ Status Consolidator::create_queries(
       nullptr,
       0,
       buffers,
-      buffer_sizes));
+      buffer_sizes,
+      URI(""),
+      fragment_uris));
 
-  // Get fragment num and terminate with success if it is <=1
+  // Get fragment num and terminate with success if there are too few
+  // fragments to consolidate
   *fragment_num = query_r->fragment_num();
-  if (*fragment_num <= 1)
+  auto min_fragments =
+      storage_manager_->config().sm_params().consolidation_min_fragments_;
+  if (*fragment_num < min_fragments)
     return Status::Ok();
 
   // Get last fragment URI, which will be the URI of the consolidated fragment
@@ -231,7 +447,13 @@ Status Consolidator::create_queries(
   return Status::Ok();
 }
 
-Status Consolidator::delete_old_fragments(const std::vector<URI>& uris) {
+Status Consolidator::delete_old_fragments(
+    const URI& array_uri, const std::vector<URI>& uris) {
+  // Remove the fragments from the manifest, so that new readers do not see
+  // them, and wait for the current readers before deleting them
+  RETURN_NOT_OK(storage_manager_->fragment_manifest_delete(uris));
+  RETURN_NOT_OK(storage_manager_->array_drain_snapshots(array_uri, uris));
+
   for (auto& uri : uris)
     RETURN_NOT_OK(storage_manager_->delete_fragment(uri));
 
@@ -255,6 +477,136 @@ void Consolidator::free_buffers(
   delete[] buffer_sizes;
 }
 
+Status Consolidator::group_fragments(
+    const ArraySchema* array_schema,
+    const std::vector<FragmentMetadata*>& metadata,
+    std::vector<std::vector<FragmentMetadata*>>* runs) const {
+  switch (array_schema->coords_type()) {
+    case Datatype::INT32:
+      group_fragments<int>(array_schema, metadata, runs);
+      break;
+    case Datatype::INT64:
+      group_fragments<int64_t>(array_schema, metadata, runs);
+      break;
+    case Datatype::FLOAT32:
+      group_fragments<float>(array_schema, metadata, runs);
+      break;
+    case Datatype::FLOAT64:
+      group_fragments<double>(array_schema, metadata, runs);
+      break;
+    case Datatype::INT8:
+      group_fragments<int8_t>(array_schema, metadata, runs);
+      break;
+    case Datatype::UINT8:
+      group_fragments<uint8_t>(array_schema, metadata, runs);
+      break;
+    case Datatype::INT16:
+      group_fragments<int16_t>(array_schema, metadata, runs);
+      break;
+    case Datatype::UINT16:
+      group_fragments<uint16_t>(array_schema, metadata, runs);
+      break;
+    case Datatype::UINT32:
+      group_fragments<uint32_t>(array_schema, metadata, runs);
+      break;
+    case Datatype::UINT64:
+      group_fragments<uint64_t>(array_schema, metadata, runs);
+      break;
+    default:
+      return LOG_STATUS(Status::ConsolidationError(
+          "Cannot group fragments; Unsupported coordinates type"));
+  }
+
+  return Status::Ok();
+}
+
+template <class T>
+void Consolidator::group_fragments(
+    const ArraySchema* array_schema,
+    const std::vector<FragmentMetadata*>& metadata,
+    std::vector<std::vector<FragmentMetadata*>>* runs) const {
+  // For easy reference
+  auto domain = array_schema->domain();
+  auto dim_num = array_schema->dim_num();
+  std::vector<T> tile_coords(dim_num);
+  auto first = [](const FragmentMetadata* meta) {
+    return static_cast<const T*>(meta->bounding_coords().front());
+  };
+  auto last = [dim_num](const FragmentMetadata* meta) {
+    return static_cast<const T*>(meta->bounding_coords().back()) + dim_num;
+  };
+
+  // Sort the non-empty fragments on their first coordinates
+  std::vector<FragmentMetadata*> sorted;
+  runs->clear();
+  for (auto meta : metadata) {
+    if (meta->bounding_coords().empty())
+      runs->push_back({meta});
+    else
+      sorted.push_back(meta);
+  }
+  std::stable_sort(
+      sorted.begin(),
+      sorted.end(),
+      [&](const FragmentMetadata* a, const FragmentMetadata* b) {
+        return domain->tile_cell_order_cmp(
+                   first(a), first(b), &tile_coords[0]) < 0;
+      });
+
+  // Sweep the fragments, starting a new run whenever a fragment begins
+  // after the last coordinates of the current run
+  const T* run_last = nullptr;
+  for (auto meta : sorted) {
+    if (run_last == nullptr ||
+        domain->tile_cell_order_cmp(first(meta), run_last, &tile_coords[0]) >
+            0) {
+      runs->emplace_back();
+      run_last = last(meta);
+    } else if (
+        domain->tile_cell_order_cmp(last(meta), run_last, &tile_coords[0]) >
+        0) {
+      run_last = last(meta);
+    }
+    runs->back().push_back(meta);
+  }
+
+  // Restore the timestamp order within each run
+  for (auto& run : *runs) {
+    std::sort(
+        run.begin(),
+        run.end(),
+        [&metadata](const FragmentMetadata* a, const FragmentMetadata* b) {
+          return std::find(metadata.begin(), metadata.end(), a) <
+                 std::find(metadata.begin(), metadata.end(), b);
+        });
+  }
+}
+
+Status Consolidator::read_batch(
+    Query* query_r,
+    void** buffers,
+    uint64_t* buffer_sizes,
+    unsigned int buffer_num,
+    uint64_t buffer_size) {
+  for (unsigned int i = 0; i < buffer_num; ++i)
+    buffer_sizes[i] = buffer_size;
+  query_r->set_buffers(buffers, buffer_sizes);
+  RETURN_NOT_OK(storage_manager_->query_submit(query_r));
+
+  // An incomplete read that fits no cell in the buffers would never end
+  if (query_r->status() == QueryStatus::INCOMPLETE) {
+    bool empty = true;
+    for (unsigned int i = 0; i < buffer_num; ++i)
+      empty = empty && (buffer_sizes[i] == 0);
+    if (empty)
+      return LOG_STATUS(Status::ConsolidationError(
+          "Cannot read cells to consolidate; Memory budget is too small to "
+          "hold a single cell"));
+  }
+
+  return Status::Ok();
+}
+
 Status Consolidator::rename_new_fragment_uri(URI* uri) const {
   // Get timestamp
   std::string name = uri->last_path_part();
@@ -271,4 +623,87 @@ Status Consolidator::rename_new_fragment_uri(URI* uri) const {
   return Status::Ok();
 }
 
+void Consolidator::report_progress(
+    Progress* progress,
+    const std::vector<uint64_t>& cell_nums,
+    uint64_t byte_num) const {
+  auto& total_cell_nums = progress->cell_nums_;
+  total_cell_nums.resize(cell_nums.size());
+  for (size_t i = 0; i < cell_nums.size(); ++i)
+    total_cell_nums[i] += cell_nums[i];
+  progress->byte_num_ += byte_num;
+
+  if (progress->callback_ != nullptr) {
+    auto cell_num =
+        *std::min_element(total_cell_nums.begin(), total_cell_nums.end());
+    progress->callback_(cell_num, progress->byte_num_, progress->data_);
+  }
+}
+
+Status Consolidator::select_fragments(
+    const char* array_name,
+    const ArraySchema* array_schema,
+    std::vector<URI>* fragment_uris,
+    bool* all_fragments) const {
+  // For easy reference
+  auto sm_params = storage_manager_->config().sm_params();
+  auto size_ratio = (double)sm_params.consolidation_size_ratio_;
+  auto min_fragments = sm_params.consolidation_min_fragments_;
+  auto max_fragments = sm_params.consolidation_max_fragments_;
+
+  // A dense fragment covers its entire subarray, thus consolidating only a
+  // subset of the dense fragments could hide cells of older fragments
+  // behind empty cells. Dense arrays are therefore consolidated as a whole.
+  fragment_uris->clear();
+  *all_fragments =
+      array_schema->dense() || (size_ratio == 0 && max_fragments == 0);
+  if (*all_fragments)
+    return Status::Ok();
+
+  // Get the fragment sizes in ascending timestamp order
+  std::vector<URI> uris;
+  std::vector<uint64_t> sizes;
+  RETURN_NOT_OK(
+      storage_manager_->array_get_fragment_sizes(array_name, &uris, &sizes));
+  uint64_t fragment_num = uris.size();
+  std::vector<uint64_t> timestamps;
+  for (const auto& uri : uris)
+    timestamps.push_back(storage_manager_->fragment_timestamp(uri));
+
+  // Find the best run of adjacent fragments
+  uint64_t best_start = 0, best_num = 0, best_size = 0;
+  for (uint64_t i = 0; i < fragment_num; ++i) {
+    uint64_t min_size = sizes[i], max_size = sizes[i], total_size = 0;
+    for (uint64_t j = i; j < fragment_num; ++j) {
+      uint64_t num = j - i + 1;
+      min_size = std::min(min_size, sizes[j]);
+      max_size = std::max(max_size, sizes[j]);
+      total_size += sizes[j];
+      if (max_fragments != 0 && num > max_fragments)
+        break;
+      if (size_ratio != 0 && max_size > size_ratio * min_size)
+        break;
+      if (num < min_fragments)
+        continue;
+
+      // The consolidated fragment takes the timestamp of the last fragment
+      // in the run, which must order it strictly between its neighbors
+      if ((i > 0 && timestamps[i - 1] >= timestamps[j]) ||
+          (j + 1 < fragment_num && timestamps[j + 1] <= timestamps[j]))
+        continue;
+
+      if (num > best_num || (num == best_num && total_size < best_size)) {
+        best_start = i;
+        best_num = num;
+        best_size = total_size;
+      }
+    }
+  }
+
+  for (uint64_t i = 0; i < best_num; ++i)
+    fragment_uris->push_back(uris[best_start + i]);
+
+  return Status::Ok();
+}
+
 }  // namespace tiledb
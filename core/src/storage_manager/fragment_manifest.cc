@@ -0,0 +1,125 @@
+/**
+ * @file   fragment_manifest.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class FragmentManifest.
+ */
+
+
+#include "fragment_manifest.h"
+#include "logger.h"
+
+namespace tiledb {
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+FragmentManifest::FragmentManifest() = default;
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+std::string FragmentManifest::add_record(const URI& fragment_uri, bool dense) {
+  return std::string("add ") + (dense ? "d " : "s ") +
+         fragment_uri.last_path_part() + "\n";
+}
+
+std::string FragmentManifest::delete_record(const URI& fragment_uri) {
+  return std::string("del ") + fragment_uri.last_path_part() + "\n";
+}
+
+bool FragmentManifest::contains(const URI& fragment_uri) const {
+  return fragments_.find(fragment_uri.last_path_part()) != fragments_.end();
+}
+
+bool FragmentManifest::deleted(const URI& fragment_uri) const {
+  return deleted_.find(fragment_uri.last_path_part()) != deleted_.end();
+}
+
+Status FragmentManifest::dense(const URI& fragment_uri, bool* dense) const {
+  auto it = fragments_.find(fragment_uri.last_path_part());
+  if (it == fragments_.end())
+    return LOG_STATUS(Status::StorageManagerError(
+        "Cannot get fragment type; Fragment not in manifest"));
+  *dense = it->second;
+
+  return Status::Ok();
+}
+
+Status FragmentManifest::deserialize(
+    const URI& array_uri, const char* data, uint64_t size) {
+  array_uri_ = array_uri;
+
+  uint64_t start = 0;
+  for (uint64_t i = 0; i < size; ++i) {
+    if (data[i] != '\n')
+      continue;
+
+    // Replay record
+    std::string record(data + start, i - start);
+    start = i + 1;
+    if (record.size() > 6 && record.compare(0, 4, "add ") == 0 &&
+        (record[4] == 'd' || record[4] == 's') && record[5] == ' ') {
+      auto name = record.substr(6);
+      if (deleted_.find(name) == deleted_.end())
+        fragments_[name] = (record[4] == 'd');
+    } else if (record.size() > 4 && record.compare(0, 4, "del ") == 0) {
+      auto name = record.substr(4);
+      deleted_.insert(name);
+      fragments_.erase(name);
+    } else {
+      return LOG_STATUS(Status::StorageManagerError(
+          "Cannot load fragment manifest; Invalid record '" + record + "'"));
+    }
+  }
+
+  return Status::Ok();
+}
+
+std::vector<URI> FragmentManifest::fragment_uris() const {
+  std::vector<URI> uris;
+  for (const auto& fragment : fragments_)
+    uris.emplace_back(array_uri_.join_path(fragment.first));
+
+  return uris;
+}
+
+std::string FragmentManifest::serialize() const {
+  std::string records;
+  for (const auto& fragment : fragments_)
+    records +=
+        add_record(array_uri_.join_path(fragment.first), fragment.second);
+  for (const auto& name : deleted_)
+    records += delete_record(array_uri_.join_path(name));
+
+  return records;
+}
+
+}  // namespace tiledb
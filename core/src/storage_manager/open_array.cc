@@ -98,6 +98,37 @@ void OpenArray::set_array_schema(const ArraySchema* array_schema) {
   array_schema_ = array_schema;
 }
 
+void OpenArray::snapshot_acquire(
+    const std::vector<FragmentMetadata*>& fragment_metadata) {
+  std::lock_guard<std::mutex> lck(snapshot_mtx_);
+  for (auto metadata : fragment_metadata)
+    ++snapshot_refs_[metadata->fragment_uri().last_path_part()];
+}
+
+void OpenArray::snapshot_release(
+    const std::vector<FragmentMetadata*>& fragment_metadata) {
+  {
+    std::lock_guard<std::mutex> lck(snapshot_mtx_);
+    for (auto metadata : fragment_metadata) {
+      auto it = snapshot_refs_.find(metadata->fragment_uri().last_path_part());
+      if (it != snapshot_refs_.end() && --it->second == 0)
+        snapshot_refs_.erase(it);
+    }
+  }
+  snapshot_cv_.notify_all();
+}
+
+void OpenArray::snapshot_wait(const std::vector<URI>& fragment_uris) {
+  std::unique_lock<std::mutex> lck(snapshot_mtx_);
+  snapshot_cv_.wait(lck, [this, &fragment_uris] {
+    for (const auto& uri : fragment_uris) {
+      if (snapshot_refs_.count(uri.last_path_part()) != 0)
+        return false;
+    }
+    return true;
+  });
+}
+
 /* ****************************** */
 /*        PRIVATE METHODS         */
 /* ****************************** */
@@ -32,7 +32,10 @@
  */
 
 #include <algorithm>
+#include <atomic>
+#include <set>
 #include <sstream>
+#include <thread>
 
 #include "logger.h"
 #include "storage_manager.h"
@@ -51,7 +54,10 @@ StorageManager::StorageManager() {
   consolidator_ = nullptr;
   array_schema_cache_ = nullptr;
   fragment_metadata_cache_ = nullptr;
+  stats_ = new Stats();
+  thread_pool_ = nullptr;
   tile_cache_ = nullptr;
+  tracer_ = new Tracer();
   vfs_ = nullptr;
 }
 
@@ -62,10 +68,14 @@ StorageManager::~StorageManager() {
   delete array_schema_cache_;
   delete consolidator_;
   delete fragment_metadata_cache_;
+  delete thread_pool_;
+  tracer_->dump();
+  delete tracer_;
   delete tile_cache_;
   delete vfs_;
   for (auto& open_array : open_arrays_)
     delete open_array.second;
+  delete stats_;
 }
 
 /* ****************************** */
@@ -78,126 +88,30 @@ Status StorageManager::array_compute_max_read_buffer_sizes(
     const char** attributes,
     unsigned attribute_num,
     uint64_t* buffer_sizes) {
-  // Open the array
-  auto uri = URI(array_uri);
-  std::vector<FragmentMetadata*> metadata;
-  auto array_schema = (const ArraySchema*)nullptr;
-  RETURN_NOT_OK(array_open(uri, QueryType::READ, &array_schema, &metadata));
-
-  // Zero out all buffer sizes
-  unsigned buffer_num;
-  RETURN_NOT_OK_ELSE(
-      array_schema->buffer_num(attributes, attribute_num, &buffer_num),
-      array_close(uri));
-  for (unsigned i = 0; i < buffer_num; ++i)
-    buffer_sizes[i] = 0;
-
-  // Return if there are no metadata
-  if (metadata.empty())
-    return Status::Ok();
-
-  // Compute buffer sizes
-  switch (array_schema->coords_type()) {
-    case Datatype::INT32:
-      array_compute_max_read_buffer_sizes<int>(
-          metadata,
-          static_cast<const int*>(subarray),
-          attributes,
-          attribute_num,
-          buffer_num,
-          buffer_sizes);
-      break;
-    case Datatype::INT64:
-      array_compute_max_read_buffer_sizes<int64_t>(
-          metadata,
-          static_cast<const int64_t*>(subarray),
-          attributes,
-          attribute_num,
-          buffer_num,
-          buffer_sizes);
-      break;
-    case Datatype::FLOAT32:
-      array_compute_max_read_buffer_sizes<float>(
-          metadata,
-          static_cast<const float*>(subarray),
-          attributes,
-          attribute_num,
-          buffer_num,
-          buffer_sizes);
-      break;
-    case Datatype::FLOAT64:
-      array_compute_max_read_buffer_sizes<double>(
-          metadata,
-          static_cast<const double*>(subarray),
-          attributes,
-          attribute_num,
-          buffer_num,
-          buffer_sizes);
-      break;
-    case Datatype::INT8:
-      array_compute_max_read_buffer_sizes<int8_t>(
-          metadata,
-          static_cast<const int8_t*>(subarray),
-          attributes,
-          attribute_num,
-          buffer_num,
-          buffer_sizes);
-      break;
-    case Datatype::UINT8:
-      array_compute_max_read_buffer_sizes<uint8_t>(
-          metadata,
-          static_cast<const uint8_t*>(subarray),
-          attributes,
-          attribute_num,
-          buffer_num,
-          buffer_sizes);
-      break;
-    case Datatype::INT16:
-      array_compute_max_read_buffer_sizes<int16_t>(
-          metadata,
-          static_cast<const int16_t*>(subarray),
-          attributes,
-          attribute_num,
-          buffer_num,
-          buffer_sizes);
-      break;
-    case Datatype::UINT16:
-      array_compute_max_read_buffer_sizes<uint16_t>(
-          metadata,
-          static_cast<const uint16_t*>(subarray),
-          attributes,
-          attribute_num,
-          buffer_num,
-          buffer_sizes);
-      break;
-    case Datatype::UINT32:
-      array_compute_max_read_buffer_sizes<unsigned>(
-          metadata,
-          static_cast<const unsigned*>(subarray),
-          attributes,
-          attribute_num,
-          buffer_num,
-          buffer_sizes);
-      break;
-    case Datatype::UINT64:
-      array_compute_max_read_buffer_sizes<uint64_t>(
-          metadata,
-          static_cast<const uint64_t*>(subarray),
-          attributes,
-          attribute_num,
-          buffer_num,
-          buffer_sizes);
-      break;
-    default:
-      return LOG_STATUS(Status::StorageManagerError(
-          "Cannot compute max read buffer sizes; Invalid coordinates type"));
-  }
+  return array_compute_read_buffer_sizes(
+      array_uri, subarray, attributes, attribute_num, nullptr, buffer_sizes);
+}
 
-  // Close array
-  return array_close(uri);
+Status StorageManager::array_compute_est_read_buffer_sizes(
+    const char* array_uri,
+    const void* subarray,
+    const char** attributes,
+    unsigned attribute_num,
+    uint64_t* est_buffer_sizes,
+    uint64_t* max_buffer_sizes) {
+  return array_compute_read_buffer_sizes(
+      array_uri,
+      subarray,
+      attributes,
+      attribute_num,
+      est_buffer_sizes,
+      max_buffer_sizes);
 }
 
-Status StorageManager::array_consolidate(const char* array_name) {
+Status StorageManager::array_consolidate(
+    const char* array_name,
+    void (*progress_callback)(uint64_t, uint64_t, void*),
+    void* progress_data) {
   // Check array URI
   URI array_uri(array_name);
   if (array_uri.is_invalid()) {
@@ -210,7 +124,86 @@ Status StorageManager::array_consolidate(const char* array_name) {
     return LOG_STATUS(Status::StorageManagerError(
         "Cannot consolidate array; Array does not exist"));
   }
-  return consolidator_->consolidate(array_name);
+  return consolidator_->consolidate(
+      array_name, progress_callback, progress_data);
+}
+
+Status StorageManager::array_consolidate_metadata(const char* array_name) {
+  // Check array URI
+  URI array_uri(array_name);
+  if (array_uri.is_invalid()) {
+    return LOG_STATUS(Status::StorageManagerError(
+        "Cannot consolidate array metadata; Invalid URI"));
+  }
+  // Check if array exists
+  auto obj_type = object_type(array_uri);
+  if (obj_type != ObjectType::ARRAY && obj_type != ObjectType::KEY_VALUE) {
+    return LOG_STATUS(Status::StorageManagerError(
+        "Cannot consolidate array metadata; Array does not exist"));
+  }
+
+  // Collect the serialized metadata of the current fragments
+  std::vector<FragmentMetadata*> metadata;
+  auto array_schema = (const ArraySchema*)nullptr;
+  RETURN_NOT_OK(
+      array_open(array_uri, QueryType::READ, &array_schema, &metadata));
+  ConsolidatedFragmentMetadata consolidated;
+  for (auto m : metadata) {
+    URI metadata_uri =
+        m->fragment_uri().join_path(constants::fragment_metadata_filename);
+    auto tile_io = new TileIO(this, metadata_uri);
+    auto tile = (Tile*)nullptr;
+    Status st = tile_io->read_generic(&tile, 0);
+    if (st.ok())
+      st = consolidated.add(m->fragment_uri(), m->dense(), tile->buffer());
+    delete tile;
+    delete tile_io;
+    RETURN_NOT_OK_ELSE(
+        st, array_close(array_uri, QueryType::READ, metadata));
+  }
+  RETURN_NOT_OK(array_close(array_uri, QueryType::READ, metadata));
+
+  // Serialize
+  auto buff = new Buffer();
+  RETURN_NOT_OK_ELSE(consolidated.serialize(buff), delete buff);
+
+  // Write the object to a temporary file that is then moved in place, so
+  // that array opens never observe a partially written object. The
+  // exclusive lock serializes concurrent metadata consolidations.
+  RETURN_NOT_OK_ELSE(object_lock(array_uri, XLOCK), delete buff);
+  URI uri =
+      array_uri.join_path(constants::consolidated_fragment_metadata_filename);
+  URI tmp_uri = URI(uri.to_string() + constants::tmp_file_suffix);
+  Status st = Status::Ok();
+  if (vfs_->is_file(tmp_uri))
+    st = vfs_->remove_file(tmp_uri);
+  if (st.ok()) {
+    buff->reset_offset();
+    auto tile = new Tile(
+        constants::generic_tile_datatype,
+        constants::generic_tile_compressor,
+        constants::generic_tile_compression_level,
+        constants::generic_tile_cell_size,
+        0,
+        buff,
+        false);
+    auto tile_io = new TileIO(this, tmp_uri);
+    st = tile_io->write_generic(tile);
+    if (st.ok())
+      st = close_file(tmp_uri);
+    if (st.ok())
+      st = vfs_->move_path(tmp_uri, uri, true);
+    delete tile;
+    delete tile_io;
+  }
+  delete buff;
+
+  if (st.ok())
+    st = object_unlock(array_uri, XLOCK);
+  else
+    object_unlock(array_uri, XLOCK);
+
+  return st;
 }
 
 Status StorageManager::array_create(
@@ -254,12 +247,109 @@ Status StorageManager::array_create(
     return st;
   }
 
+  // Create empty fragment manifest
+  URI manifest_uri =
+      array_uri.is_s3() ?
+          fragment_manifest_part_uri(array_uri) :
+          array_uri.join_path(constants::fragment_manifest_filename);
+  st = vfs_->create_file(manifest_uri);
+  if (!st.ok()) {
+    vfs_->remove_path(array_uri);
+    object_create_mtx_.unlock();
+    return st;
+  }
+
   object_create_mtx_.unlock();
 
   // Success
   return Status::Ok();
 }
 
+Status StorageManager::array_drain_snapshots(
+    const URI& array_uri, const std::vector<URI>& fragment_uris) {
+  // Pin the open array entry, if the array is open
+  open_array_mtx_.lock();
+  auto it = open_arrays_.find(array_uri.to_string());
+  if (it == open_arrays_.end()) {
+    open_array_mtx_.unlock();
+    return Status::Ok();
+  }
+  OpenArray* open_array = it->second;
+  open_array->mtx_lock();
+  open_array->incr_cnt();
+  open_array->mtx_unlock();
+  open_array_mtx_.unlock();
+
+  // Wait for the snapshots and unpin the entry
+  open_array->snapshot_wait(fragment_uris);
+  return array_close_entry(array_uri, QueryType::READ, {});
+}
+
+Status StorageManager::array_get_attribute_stats(
+    const char* array_uri,
+    const char* attribute_name,
+    TileStats* stats,
+    Datatype* type,
+    bool* has_stats) {
+  // Open the array
+  *has_stats = false;
+  auto uri = URI(array_uri);
+  std::vector<FragmentMetadata*> metadata;
+  auto array_schema = (const ArraySchema*)nullptr;
+  RETURN_NOT_OK(array_open(uri, QueryType::READ, &array_schema, &metadata));
+
+  // Get the attribute
+  unsigned int attribute_id = 0;
+  Status st = array_schema->attribute_id(attribute_name, &attribute_id);
+  if (st.ok() && (attribute_id == array_schema->attribute_num() ||
+                  array_schema->var_size(attribute_id)))
+    st = LOG_STATUS(Status::StorageManagerError(
+        "Cannot get attribute statistics; The attribute must be fixed-sized"));
+  RETURN_NOT_OK_ELSE(st, array_close(uri, QueryType::READ, metadata));
+  *type = array_schema->type(attribute_id);
+
+  // Merge the statistics of every tile of every fragment
+  *stats = TileStats();
+  bool complete = true;
+  for (auto meta : metadata) {
+    auto tile_num = meta->tile_offsets()[attribute_id].size();
+    for (uint64_t t = 0; t < tile_num && complete && st.ok(); ++t) {
+      auto tile_stats = meta->tile_stats(attribute_id, t);
+      if (tile_stats != nullptr)
+        st = stats->merge(*type, *tile_stats);
+      else
+        complete = false;
+    }
+  }
+  RETURN_NOT_OK_ELSE(st, array_close(uri, QueryType::READ, metadata));
+  *has_stats = complete;
+
+  // Close array
+  return array_close(uri, QueryType::READ, metadata);
+}
+
+Status StorageManager::array_get_fragment_sizes(
+    const char* array_uri,
+    std::vector<URI>* fragment_uris,
+    std::vector<uint64_t>* fragment_sizes) {
+  // Open the array
+  auto uri = URI(array_uri);
+  std::vector<FragmentMetadata*> metadata;
+  auto array_schema = (const ArraySchema*)nullptr;
+  RETURN_NOT_OK(array_open(uri, QueryType::READ, &array_schema, &metadata));
+
+  // The metadata are already sorted on their timestamps
+  fragment_uris->clear();
+  fragment_sizes->clear();
+  for (auto meta : metadata) {
+    fragment_uris->push_back(meta->fragment_uri());
+    fragment_sizes->push_back(meta->fragment_size());
+  }
+
+  // Close array
+  return array_close(uri, QueryType::READ, metadata);
+}
+
 Status StorageManager::array_get_non_empty_domain(
     const char* array_uri, void* domain, bool* is_empty) {
   // Open the array
@@ -324,7 +414,38 @@ Status StorageManager::array_get_non_empty_domain(
   *is_empty = false;
 
   // Close array
-  return array_close(uri);
+  return array_close(uri, QueryType::READ, metadata);
+}
+
+Status StorageManager::array_get_tile_bounding_coords(
+    const char* array_uri,
+    std::vector<std::vector<uint8_t>>* bounding_coords) {
+  // Open the array
+  auto uri = URI(array_uri);
+  std::vector<FragmentMetadata*> metadata;
+  auto array_schema = (const ArraySchema*)nullptr;
+  RETURN_NOT_OK(array_open(uri, QueryType::READ, &array_schema, &metadata));
+
+  // Copy the bounding coordinates, since the metadata are owned by the
+  // open array
+  auto bounding_coords_size = 2 * array_schema->coords_size();
+  bounding_coords->clear();
+  for (auto meta : metadata) {
+    if (meta->dense())
+      continue;
+    bounding_coords->emplace_back();
+    auto& fragment_coords = bounding_coords->back();
+    const auto& tile_coords = meta->bounding_coords();
+    fragment_coords.resize(tile_coords.size() * bounding_coords_size);
+    for (size_t i = 0; i < tile_coords.size(); ++i)
+      std::memcpy(
+          &fragment_coords[i * bounding_coords_size],
+          tile_coords[i],
+          bounding_coords_size);
+  }
+
+  // Close array
+  return array_close(uri, QueryType::READ, metadata);
 }
 
 Status StorageManager::object_lock(const URI& uri, LockType lock_type) {
@@ -394,7 +515,7 @@ Status StorageManager::async_push_query(Query* query, int i) {
   // Push request
   {
     std::lock_guard<std::mutex> lock(async_mtx_[i]);
-    async_queue_[i].emplace(query);
+    async_queue_[i].emplace(query, tracer_->now());
   }
 
   // Signal AIO thread
@@ -428,6 +549,38 @@ Status StorageManager::delete_fragment(const URI& uri) const {
   return vfs_->remove_path(uri);
 }
 
+Status StorageManager::fragment_manifest_add(
+    const URI& fragment_uri, bool dense) {
+  return fragment_manifest_append(
+      fragment_uri.parent(), FragmentManifest::add_record(fragment_uri, dense));
+}
+
+Status StorageManager::fragment_manifest_delete(
+    const std::vector<URI>& fragment_uris) {
+  if (fragment_uris.empty())
+    return Status::Ok();
+
+  std::string records;
+  for (const auto& uri : fragment_uris)
+    records += FragmentManifest::delete_record(uri);
+
+  return fragment_manifest_append(fragment_uris[0].parent(), records);
+}
+
+uint64_t StorageManager::fragment_timestamp(const URI& fragment_uri) const {
+  // Get fragment name
+  std::string fragment_name = fragment_uri.last_path_part();
+  assert(utils::starts_with(fragment_name, "__"));
+
+  // Get timestamp in the end of the name after '_'
+  assert(fragment_name.find_last_of('_') != std::string::npos);
+  std::string t_str = fragment_name.substr(fragment_name.find_last_of('_') + 1);
+  uint64_t t = 0;
+  sscanf(t_str.c_str(), "%lld", (long long int*)&t);
+
+  return t;
+}
+
 Status StorageManager::remove_path(const URI& uri) const {
   if (object_type(uri) == ObjectType::INVALID) {
     return LOG_STATUS(Status::StorageManagerError(
@@ -480,7 +633,12 @@ Status StorageManager::init(Config* config) {
   array_schema_cache_ = new LRUCache(sm_params.array_schema_cache_size_);
   fragment_metadata_cache_ =
       new LRUCache(sm_params.fragment_metadata_cache_size_);
-  tile_cache_ = new LRUCache(sm_params.tile_cache_size_);
+  tile_cache_ =
+      new LRUCache(sm_params.tile_cache_size_, nullptr, nullptr, stats_);
+  thread_pool_ = new ThreadPool();
+  RETURN_NOT_OK(thread_pool_->init(sm_params.thread_pool_size_));
+  RETURN_NOT_OK(tracer_->init(
+      sm_params.trace_file_, constants::trace_buffer_event_num));
   async_thread_[0] = new std::thread(async_start, this, 0);
   async_thread_[1] = new std::thread(async_start, this, 1);
   vfs_ = new VFS();
@@ -557,7 +715,7 @@ Status StorageManager::load_array_schema(
   Status st = (*array_schema)->deserialize(cbuff, is_kv);
   delete cbuff;
   if (!st.ok()) {
-    delete array_schema;
+    delete *array_schema;
     *array_schema = nullptr;
   }
 
@@ -575,6 +733,7 @@ Status StorageManager::load_array_schema(
 
 Status StorageManager::load_fragment_metadata(
     FragmentMetadata* fragment_metadata) {
+  TraceSpan span(tracer_, "fragment_metadata_load");
   const URI& fragment_uri = fragment_metadata->fragment_uri();
 
   if (!vfs_->is_dir(fragment_uri))
@@ -786,7 +945,10 @@ Status StorageManager::object_iter_next_preorder(
 
 Status StorageManager::query_finalize(Query* query) {
   auto st_query = query->finalize();
-  auto st_array = array_close(query->array_schema()->array_uri());
+  auto st_array = array_close(
+      query->array_schema()->array_uri(),
+      query->type(),
+      query->fragment_metadata());
 
   if (!st_query.ok())
     return st_query;
@@ -796,12 +958,32 @@ Status StorageManager::query_finalize(Query* query) {
 }
 
 Status StorageManager::query_init(
-    Query* query, const char* array_name, QueryType type) {
+    Query* query,
+    const char* array_name,
+    QueryType type,
+    uint64_t timestamp_start,
+    uint64_t timestamp_end) {
+  // Check timestamp range
+  if (timestamp_start != 0 || timestamp_end != UINT64_MAX) {
+    if (type != QueryType::READ)
+      return LOG_STATUS(Status::StorageManagerError(
+          "Cannot initialize query; Timestamp ranges apply only to reads"));
+    if (timestamp_start > timestamp_end)
+      return LOG_STATUS(Status::StorageManagerError(
+          "Cannot initialize query; Invalid timestamp range"));
+  }
+
   // Open the array
   std::vector<FragmentMetadata*> fragment_metadata;
   auto array_schema = (const ArraySchema*)nullptr;
-  RETURN_NOT_OK(
-      array_open(URI(array_name), type, &array_schema, &fragment_metadata));
+  RETURN_NOT_OK(array_open(
+      URI(array_name),
+      type,
+      &array_schema,
+      &fragment_metadata,
+      nullptr,
+      timestamp_start,
+      timestamp_end));
 
   // Set basic query members
   query->set_storage_manager(this);
@@ -822,12 +1004,17 @@ Status StorageManager::query_init(
     unsigned int attribute_num,
     void** buffers,
     uint64_t* buffer_sizes,
-    const URI& consolidation_fragment_uri) {
+    const URI& consolidation_fragment_uri,
+    const std::vector<URI>* fragment_uris) {
   // Open the array
   std::vector<FragmentMetadata*> fragment_metadata;
   auto array_schema = (const ArraySchema*)nullptr;
-  RETURN_NOT_OK(
-      array_open(URI(array_name), type, &array_schema, &fragment_metadata));
+  RETURN_NOT_OK(array_open(
+      URI(array_name),
+      type,
+      &array_schema,
+      &fragment_metadata,
+      fragment_uris));
 
   // Initialize query
   return query->init(
@@ -845,14 +1032,18 @@ Status StorageManager::query_init(
 }
 
 Status StorageManager::query_submit(Query* query) {
+  TraceSpan span(tracer_, "query_submit");
+
   // Initialize query
   if (query->status() != QueryStatus::INCOMPLETE)
     RETURN_NOT_OK(query->init());
 
   // Based on the query type, invoke the appropriate call
   QueryType query_type = query->type();
-  if (query_type == QueryType::READ)
+  if (query_type == QueryType::READ) {
+    ScopedTimer timer(query->stats(), Stats::Timer::QUERY_READ);
     return query->read();
+  }
 
   return query->write();
 }
@@ -873,7 +1064,8 @@ Status StorageManager::read_from_cache(
     uint64_t offset,
     Buffer* buffer,
     uint64_t nbytes,
-    bool* in_cache) const {
+    bool* in_cache,
+    Stats* stats) const {
   std::stringstream key;
   key << uri.to_string() << "+" << offset;
   RETURN_NOT_OK(buffer->realloc(nbytes));
@@ -882,16 +1074,38 @@ Status StorageManager::read_from_cache(
   buffer->set_size(nbytes);
   buffer->reset_offset();
 
+  // Record the cache hit or miss
+  if (stats == nullptr)
+    stats = stats_;
+  if (*in_cache) {
+    stats->add(Stats::Counter::TILE_CACHE_HIT_NUM, 1);
+    stats->add(Stats::Counter::TILE_CACHE_HIT_BYTES, nbytes);
+  } else {
+    stats->add(Stats::Counter::TILE_CACHE_MISS_NUM, 1);
+  }
+
   return Status::Ok();
 }
 
 Status StorageManager::read(
-    const URI& uri, uint64_t offset, Buffer* buffer, uint64_t nbytes) const {
+    const URI& uri,
+    uint64_t offset,
+    Buffer* buffer,
+    uint64_t nbytes,
+    Stats* stats) const {
+  if (stats == nullptr)
+    stats = stats_;
+  ScopedTimer timer(stats, Stats::Timer::VFS_READ);
+  TraceSpan span(tracer_, "vfs_read");
+
   RETURN_NOT_OK(buffer->realloc(nbytes));
   RETURN_NOT_OK(vfs_->read(uri, offset, buffer->data(), nbytes));
   buffer->set_size(nbytes);
   buffer->reset_offset();
 
+  stats->add(Stats::Counter::VFS_READ_NUM, 1);
+  stats->add(Stats::Counter::VFS_READ_BYTES, nbytes);
+
   return Status::Ok();
 }
 
@@ -970,10 +1184,22 @@ Status StorageManager::close_file(const URI& uri) {
   return vfs_->close_file(uri);
 }
 
+Stats* StorageManager::stats() const {
+  return stats_;
+}
+
 Status StorageManager::sync(const URI& uri) {
   return vfs_->sync(uri);
 }
 
+ThreadPool* StorageManager::thread_pool() const {
+  return thread_pool_;
+}
+
+Tracer* StorageManager::tracer() const {
+  return tracer_;
+}
+
 VFS* StorageManager::vfs() const {
   return vfs_;
 }
@@ -988,6 +1214,7 @@ Status StorageManager::write_to_cache(
   // Do not write metadata to cache
   std::string filename = uri.last_path_part();
   if (filename == constants::fragment_metadata_filename ||
+      filename == constants::consolidated_fragment_metadata_filename ||
       filename == constants::array_schema_filename ||
       filename == constants::kv_schema_filename) {
     return Status::Ok();
@@ -1016,7 +1243,23 @@ Status StorageManager::write(const URI& uri, Buffer* buffer) const {
 /*         PRIVATE METHODS        */
 /* ****************************** */
 
-Status StorageManager::array_close(URI array_uri) {
+Status StorageManager::array_close(
+    URI array_uri,
+    QueryType query_type,
+    const std::vector<FragmentMetadata*>& fragment_metadata) {
+  RETURN_NOT_OK(array_close_entry(array_uri, query_type, fragment_metadata));
+
+  // Unlock the array, unless it was opened by a lock-free read
+  if (array_locked(query_type))
+    RETURN_NOT_OK(object_unlock(array_uri, SLOCK));
+
+  return Status::Ok();
+}
+
+Status StorageManager::array_close_entry(
+    const URI& array_uri,
+    QueryType query_type,
+    const std::vector<FragmentMetadata*>& fragment_metadata) {
   // Lock mutex
   open_array_mtx_.lock();
 
@@ -1033,6 +1276,10 @@ Status StorageManager::array_close(URI array_uri) {
   // For easy reference
   OpenArray* open_array = it->second;
 
+  // Release the read snapshot
+  if (query_type == QueryType::READ)
+    open_array->snapshot_release(fragment_metadata);
+
   // Lock the mutex of the array
   open_array->mtx_lock();
 
@@ -1052,31 +1299,217 @@ Status StorageManager::array_close(URI array_uri) {
   // Unlock mutex
   open_array_mtx_.unlock();
 
-  // Unlock the array
-  RETURN_NOT_OK(object_unlock(array_uri, SLOCK));
-
   return Status::Ok();
 }
 
+Status StorageManager::array_compute_read_buffer_sizes(
+    const char* array_uri,
+    const void* subarray,
+    const char** attributes,
+    unsigned attribute_num,
+    uint64_t* est_buffer_sizes,
+    uint64_t* max_buffer_sizes) {
+  // Open the array
+  auto uri = URI(array_uri);
+  std::vector<FragmentMetadata*> metadata;
+  auto array_schema = (const ArraySchema*)nullptr;
+  RETURN_NOT_OK(array_open(uri, QueryType::READ, &array_schema, &metadata));
+
+  // Zero out all buffer sizes
+  unsigned buffer_num;
+  RETURN_NOT_OK_ELSE(
+      array_schema->buffer_num(attributes, attribute_num, &buffer_num),
+      array_close(uri, QueryType::READ, metadata));
+  for (unsigned i = 0; i < buffer_num; ++i) {
+    if (est_buffer_sizes != nullptr)
+      est_buffer_sizes[i] = 0;
+    if (max_buffer_sizes != nullptr)
+      max_buffer_sizes[i] = 0;
+  }
+
+  // Return if there are no metadata
+  if (metadata.empty())
+    return array_close(uri, QueryType::READ, metadata);
+
+  // Compute buffer sizes
+  Status st;
+  switch (array_schema->coords_type()) {
+    case Datatype::INT32:
+      st = array_compute_read_buffer_sizes<int>(
+          array_schema,
+          metadata,
+          static_cast<const int*>(subarray),
+          attributes,
+          attribute_num,
+          buffer_num,
+          est_buffer_sizes,
+          max_buffer_sizes);
+      break;
+    case Datatype::INT64:
+      st = array_compute_read_buffer_sizes<int64_t>(
+          array_schema,
+          metadata,
+          static_cast<const int64_t*>(subarray),
+          attributes,
+          attribute_num,
+          buffer_num,
+          est_buffer_sizes,
+          max_buffer_sizes);
+      break;
+    case Datatype::FLOAT32:
+      st = array_compute_read_buffer_sizes<float>(
+          array_schema,
+          metadata,
+          static_cast<const float*>(subarray),
+          attributes,
+          attribute_num,
+          buffer_num,
+          est_buffer_sizes,
+          max_buffer_sizes);
+      break;
+    case Datatype::FLOAT64:
+      st = array_compute_read_buffer_sizes<double>(
+          array_schema,
+          metadata,
+          static_cast<const double*>(subarray),
+          attributes,
+          attribute_num,
+          buffer_num,
+          est_buffer_sizes,
+          max_buffer_sizes);
+      break;
+    case Datatype::INT8:
+      st = array_compute_read_buffer_sizes<int8_t>(
+          array_schema,
+          metadata,
+          static_cast<const int8_t*>(subarray),
+          attributes,
+          attribute_num,
+          buffer_num,
+          est_buffer_sizes,
+          max_buffer_sizes);
+      break;
+    case Datatype::UINT8:
+      st = array_compute_read_buffer_sizes<uint8_t>(
+          array_schema,
+          metadata,
+          static_cast<const uint8_t*>(subarray),
+          attributes,
+          attribute_num,
+          buffer_num,
+          est_buffer_sizes,
+          max_buffer_sizes);
+      break;
+    case Datatype::INT16:
+      st = array_compute_read_buffer_sizes<int16_t>(
+          array_schema,
+          metadata,
+          static_cast<const int16_t*>(subarray),
+          attributes,
+          attribute_num,
+          buffer_num,
+          est_buffer_sizes,
+          max_buffer_sizes);
+      break;
+    case Datatype::UINT16:
+      st = array_compute_read_buffer_sizes<uint16_t>(
+          array_schema,
+          metadata,
+          static_cast<const uint16_t*>(subarray),
+          attributes,
+          attribute_num,
+          buffer_num,
+          est_buffer_sizes,
+          max_buffer_sizes);
+      break;
+    case Datatype::UINT32:
+      st = array_compute_read_buffer_sizes<unsigned>(
+          array_schema,
+          metadata,
+          static_cast<const unsigned*>(subarray),
+          attributes,
+          attribute_num,
+          buffer_num,
+          est_buffer_sizes,
+          max_buffer_sizes);
+      break;
+    case Datatype::UINT64:
+      st = array_compute_read_buffer_sizes<uint64_t>(
+          array_schema,
+          metadata,
+          static_cast<const uint64_t*>(subarray),
+          attributes,
+          attribute_num,
+          buffer_num,
+          est_buffer_sizes,
+          max_buffer_sizes);
+      break;
+    default:
+      st = LOG_STATUS(Status::StorageManagerError(
+          "Cannot compute read buffer sizes; Invalid coordinates type"));
+  }
+
+  // Close array
+  RETURN_NOT_OK_ELSE(st, array_close(uri, QueryType::READ, metadata));
+  return array_close(uri, QueryType::READ, metadata);
+}
+
 template <class T>
-Status StorageManager::array_compute_max_read_buffer_sizes(
+Status StorageManager::array_compute_read_buffer_sizes(
+    const ArraySchema* array_schema,
     const std::vector<FragmentMetadata*>& metadata,
     const T* subarray,
     const char** attributes,
     unsigned attribute_num,
     unsigned buffer_num,
-    uint64_t* buffer_sizes) {
+    uint64_t* est_buffer_sizes,
+    uint64_t* max_buffer_sizes) {
   auto meta_buffer_sizes = new uint64_t[buffer_num];
   for (auto& meta : metadata) {
-    RETURN_NOT_OK_ELSE(
-        meta->compute_max_read_buffer_sizes(
-            subarray, attributes, attribute_num, buffer_num, meta_buffer_sizes),
-        delete[] meta_buffer_sizes);
-    for (unsigned i = 0; i < buffer_num; ++i)
-      buffer_sizes[i] += meta_buffer_sizes[i];
+    if (max_buffer_sizes != nullptr) {
+      RETURN_NOT_OK_ELSE(
+          meta->compute_max_read_buffer_sizes(
+              subarray,
+              attributes,
+              attribute_num,
+              buffer_num,
+              meta_buffer_sizes),
+          delete[] meta_buffer_sizes);
+      for (unsigned i = 0; i < buffer_num; ++i)
+        max_buffer_sizes[i] += meta_buffer_sizes[i];
+    }
+    if (est_buffer_sizes != nullptr) {
+      RETURN_NOT_OK_ELSE(
+          meta->compute_est_read_buffer_sizes(
+              subarray,
+              attributes,
+              attribute_num,
+              buffer_num,
+              meta_buffer_sizes),
+          delete[] meta_buffer_sizes);
+      for (unsigned i = 0; i < buffer_num; ++i)
+        est_buffer_sizes[i] += meta_buffer_sizes[i];
+    }
   }
   delete[] meta_buffer_sizes;
 
+  // A dense read returns exactly one value per cell in the subarray, which
+  // is a tighter estimate than the one summed over (overlapping) fragments
+  if (est_buffer_sizes != nullptr && array_schema->dense()) {
+    auto cell_num =
+        array_schema->domain()->cell_num(static_cast<const void*>(subarray));
+    unsigned aid, bid = 0;
+    for (unsigned i = 0; i < attribute_num; ++i) {
+      RETURN_NOT_OK(array_schema->attribute_id(attributes[i], &aid));
+      if (array_schema->var_size(aid)) {
+        est_buffer_sizes[bid] = cell_num * constants::cell_var_offset_size;
+        bid += 2;
+      } else {
+        est_buffer_sizes[bid++] = cell_num * array_schema->cell_size(aid);
+      }
+    }
+  }
+
   return Status::Ok();
 }
 
@@ -1107,19 +1540,31 @@ void StorageManager::array_get_non_empty_domain(
   delete[] coords;
 }
 
+bool StorageManager::array_locked(QueryType query_type) const {
+  return query_type != QueryType::READ || !config_.sm_params().lock_free_reads_;
+}
+
 Status StorageManager::array_open(
     const URI& array_uri,
-    QueryType type,
+    QueryType query_type,
     const ArraySchema** array_schema,
-    std::vector<FragmentMetadata*>* fragment_metadata) {
+    std::vector<FragmentMetadata*>* fragment_metadata,
+    const std::vector<URI>* fragment_uris,
+    uint64_t timestamp_start,
+    uint64_t timestamp_end) {
+  TraceSpan span(tracer_, "array_open");
+
   // Check if array exists
   if (!is_array(array_uri) && !is_kv(array_uri)) {
     return LOG_STATUS(
         Status::StorageManagerError("Cannot open array; Array does not exist"));
   }
 
-  // Lock the array in shared mode
-  RETURN_NOT_OK(object_lock(array_uri, SLOCK));
+  // Lock the array in shared mode. Lock-free reads rely only on their
+  // snapshot of immutable fragments, which a consolidation in this process
+  // deletes only after the snapshots referencing them are released.
+  if (array_locked(query_type))
+    RETURN_NOT_OK(object_lock(array_uri, SLOCK));
 
   // Lock mutex
   open_array_mtx_.lock();
@@ -1144,14 +1589,31 @@ Status StorageManager::array_open(
   // Load array schema
   RETURN_NOT_OK_ELSE(
       open_array_load_array_schema(array_uri, open_array),
-      array_open_error(open_array));
+      array_open_error(open_array, query_type));
   *array_schema = open_array->array_schema();
 
-  // Get fragment metadata only in read mode
-  if (type == QueryType::READ)
+  // Get fragment metadata and register the snapshot only in read mode
+  if (query_type == QueryType::READ) {
     RETURN_NOT_OK_ELSE(
-        open_array_load_fragment_metadata(open_array, fragment_metadata),
-        array_open_error(open_array));
+        open_array_load_fragment_metadata(
+            open_array, fragment_metadata, timestamp_start, timestamp_end),
+        array_open_error(open_array, query_type));
+
+    // Keep only the requested fragments
+    if (fragment_uris != nullptr) {
+      std::set<std::string> uris;
+      for (const auto& uri : *fragment_uris)
+        uris.insert(uri.to_string());
+      std::vector<FragmentMetadata*> selected;
+      for (auto meta : *fragment_metadata) {
+        if (uris.count(meta->fragment_uri().to_string()) != 0)
+          selected.push_back(meta);
+      }
+      *fragment_metadata = selected;
+    }
+
+    open_array->snapshot_acquire(*fragment_metadata);
+  }
 
   // Unlock the array mutex
   open_array->mtx_unlock();
@@ -1159,12 +1621,15 @@ Status StorageManager::array_open(
   return Status::Ok();
 }
 
-Status StorageManager::array_open_error(OpenArray* open_array) {
+Status StorageManager::array_open_error(
+    OpenArray* open_array, QueryType query_type) {
   open_array->mtx_unlock();
-  return array_close(open_array->array_uri());
+  return array_close(open_array->array_uri(), query_type, {});
 }
 
 void StorageManager::async_process_query(Query* query) {
+  TraceSpan span(tracer_, "async_process");
+
   // For easy reference
   Status st = query->async_process();
   if (!st.ok())
@@ -1178,9 +1643,11 @@ void StorageManager::async_process_queries(int i) {
         lock, [this, i] { return !async_queue_[i].empty() || async_done_; });
     if (async_done_)
       break;
-    auto query = async_queue_[i].front();
+    auto query = async_queue_[i].front().first;
+    auto push_time = async_queue_[i].front().second;
     async_queue_[i].pop();
     lock.unlock();
+    tracer_->record("async_queue_wait", push_time, tracer_->now());
     async_process_query(query);
   }
 }
@@ -1201,6 +1668,180 @@ void StorageManager::async_stop() {
   async_thread_[1]->join();
 }
 
+Status StorageManager::consolidated_fragment_metadata_load(
+    const URI& array_uri,
+    ConsolidatedFragmentMetadata* consolidated,
+    bool* found) {
+  *found = false;
+  URI uri =
+      array_uri.join_path(constants::consolidated_fragment_metadata_filename);
+  if (!vfs_->is_file(uri))
+    return Status::Ok();
+
+  auto tile_io = new TileIO(this, uri);
+  auto tile = (Tile*)nullptr;
+  RETURN_NOT_OK_ELSE(tile_io->read_generic(&tile, 0), delete tile_io);
+  auto cbuff = new ConstBuffer(tile->buffer());
+  Status st = consolidated->deserialize(cbuff);
+  delete cbuff;
+  delete tile;
+  delete tile_io;
+  *found = st.ok();
+
+  return st;
+}
+
+void StorageManager::filter_fragment_uris(
+    std::vector<URI>* fragment_uris,
+    uint64_t timestamp_start,
+    uint64_t timestamp_end) const {
+  // Trivial case
+  if (timestamp_start == 0 && timestamp_end == UINT64_MAX)
+    return;
+
+  std::vector<URI> fragment_uris_filtered;
+  for (auto& uri : *fragment_uris) {
+    auto t = fragment_timestamp(uri);
+    if (t >= timestamp_start && t <= timestamp_end)
+      fragment_uris_filtered.push_back(uri);
+  }
+  *fragment_uris = fragment_uris_filtered;
+}
+
+Status StorageManager::fragment_manifest_append(
+    const URI& array_uri, const std::string& records) {
+  std::lock_guard<std::mutex> lock(fragment_manifest_mtx_);
+
+  // S3 objects cannot be appended to, so each append is an object of its own
+  if (array_uri.is_s3())
+    return fragment_manifest_append_part(array_uri, records);
+
+  URI manifest_uri = array_uri.join_path(constants::fragment_manifest_filename);
+  std::string contents;
+  if (!vfs_->is_file(manifest_uri))
+    RETURN_NOT_OK(fragment_manifest_seed(array_uri, &contents));
+  contents += records;
+
+  RETURN_NOT_OK(vfs_->write(manifest_uri, contents.data(), contents.size()));
+  return vfs_->close_file(manifest_uri);
+}
+
+Status StorageManager::fragment_manifest_append_part(
+    const URI& array_uri, const std::string& records) {
+  URI manifest_uri = array_uri.join_path(constants::fragment_manifest_dirname);
+  std::vector<URI> part_uris;
+  RETURN_NOT_OK(vfs_->ls(manifest_uri, &part_uris));
+  std::string contents;
+  if (part_uris.empty())
+    RETURN_NOT_OK(fragment_manifest_seed(array_uri, &contents));
+  contents += records;
+
+  // Writing the part commits the records
+  URI part_uri = fragment_manifest_part_uri(array_uri);
+  RETURN_NOT_OK(vfs_->write(part_uri, contents.data(), contents.size()));
+  RETURN_NOT_OK(vfs_->close_file(part_uri));
+
+  // Compact the parts into a single one, so that loading the manifest takes
+  // a constant number of requests. A part is deleted only after a part with
+  // its records is in place, and the compaction is abandoned if a concurrent
+  // compaction has already deleted one of the parts.
+  if (part_uris.empty())
+    return Status::Ok();
+  part_uris.push_back(part_uri);
+  FragmentManifest manifest;
+  for (const auto& uri : part_uris) {
+    if (!fragment_manifest_read(uri, &contents).ok() ||
+        !manifest.deserialize(array_uri, contents.data(), contents.size())
+             .ok())
+      return Status::Ok();
+  }
+  contents = manifest.serialize();
+  part_uri = fragment_manifest_part_uri(array_uri);
+  if (!vfs_->write(part_uri, contents.data(), contents.size()).ok() ||
+      !vfs_->close_file(part_uri).ok())
+    return Status::Ok();
+  for (const auto& uri : part_uris)
+    vfs_->remove_file(uri);
+
+  return Status::Ok();
+}
+
+URI StorageManager::fragment_manifest_part_uri(const URI& array_uri) const {
+  static std::atomic<uint64_t> seq(0);
+  std::stringstream ss;
+  ss << "__" << utils::timestamp_ms() << "_" << std::this_thread::get_id()
+     << "_" << seq++;
+  return array_uri.join_path(constants::fragment_manifest_dirname)
+      .join_path(ss.str());
+}
+
+Status StorageManager::fragment_manifest_load(
+    const URI& array_uri, FragmentManifest* manifest, bool* found) const {
+  *found = false;
+  std::string contents;
+
+  // The parts of a manifest on S3 may be deleted by a concurrent compaction
+  // between the listing and the reads, in which case the listing is retried
+  if (array_uri.is_s3()) {
+    URI manifest_uri =
+        array_uri.join_path(constants::fragment_manifest_dirname);
+    Status st;
+    for (unsigned i = 0; i < constants::fragment_manifest_load_attempts; ++i) {
+      std::vector<URI> part_uris;
+      RETURN_NOT_OK(vfs_->ls(manifest_uri, &part_uris));
+      *manifest = FragmentManifest();
+      for (const auto& uri : part_uris) {
+        st = fragment_manifest_read(uri, &contents);
+        if (!st.ok())
+          break;
+        RETURN_NOT_OK(
+            manifest->deserialize(array_uri, contents.data(), contents.size()));
+      }
+      if (st.ok()) {
+        *found = !part_uris.empty();
+        return Status::Ok();
+      }
+    }
+    return st;
+  }
+
+  URI manifest_uri = array_uri.join_path(constants::fragment_manifest_filename);
+  if (!vfs_->is_file(manifest_uri))
+    return Status::Ok();
+  RETURN_NOT_OK(fragment_manifest_read(manifest_uri, &contents));
+  RETURN_NOT_OK(
+      manifest->deserialize(array_uri, contents.data(), contents.size()));
+  *found = true;
+
+  return Status::Ok();
+}
+
+Status StorageManager::fragment_manifest_read(
+    const URI& uri, std::string* contents) const {
+  uint64_t size;
+  RETURN_NOT_OK(vfs_->file_size(uri, &size));
+  contents->assign(size, '\0');
+  if (size != 0)
+    RETURN_NOT_OK(vfs_->read(uri, 0, &(*contents)[0], size));
+
+  return Status::Ok();
+}
+
+Status StorageManager::fragment_manifest_seed(
+    const URI& array_uri, std::string* records) const {
+  std::vector<URI> fragment_uris;
+  RETURN_NOT_OK(get_fragment_uris(array_uri, &fragment_uris));
+  sort_fragment_uris(&fragment_uris);
+  for (const auto& uri : fragment_uris) {
+    URI coords_uri = uri.join_path(
+        std::string("/") + constants::coords + constants::file_suffix);
+    bool dense = !vfs_->is_file(coords_uri);
+    *records += FragmentManifest::add_record(uri, dense);
+  }
+
+  return Status::Ok();
+}
+
 Status StorageManager::get_fragment_uris(
     const URI& array_uri, std::vector<URI>* fragment_uris) const {
   // Get all uris in the array directory
@@ -1218,6 +1859,23 @@ Status StorageManager::get_fragment_uris(
   return Status::Ok();
 }
 
+Status StorageManager::get_fragment_uris(
+    const URI& array_uri,
+    const FragmentManifest& manifest,
+    std::vector<URI>* fragment_uris) const {
+  // Get all uris in the array directory
+  std::vector<URI> uris;
+  RETURN_NOT_OK(vfs_->ls(array_uri, &uris));
+
+  // Get only the committed fragment uris
+  for (auto& uri : uris) {
+    if (manifest.contains(uri))
+      fragment_uris->push_back(uri);
+  }
+
+  return Status::Ok();
+}
+
 Status StorageManager::open_array_get_entry(
     const URI& array_uri, OpenArray** open_array) {
   // Find the open array entry
@@ -1247,31 +1905,88 @@ Status StorageManager::open_array_load_array_schema(
 }
 
 Status StorageManager::open_array_load_fragment_metadata(
-    OpenArray* open_array, std::vector<FragmentMetadata*>* fragment_metadata) {
-  // Get all the fragment uris, sorted by timestamp
-  std::vector<URI> fragment_uris;
+    OpenArray* open_array,
+    std::vector<FragmentMetadata*>* fragment_metadata,
+    uint64_t timestamp_start,
+    uint64_t timestamp_end) {
+  // Get the fragment uris from the manifest, sorted by timestamp
   const URI& array_uri = open_array->array_uri();
-  RETURN_NOT_OK(get_fragment_uris(array_uri, &fragment_uris));
-  sort_fragment_uris(&fragment_uris);
+  FragmentManifest manifest;
+  bool found = false;
+  if (!fragment_manifest_load(array_uri, &manifest, &found).ok())
+    found = false;
+  std::vector<URI> fragment_uris;
+  if (found) {
+    fragment_uris = manifest.fragment_uris();
+    sort_fragment_uris(&fragment_uris);
+    filter_fragment_uris(&fragment_uris, timestamp_start, timestamp_end);
+    if (open_array_load_fragment_metadata(
+            open_array, fragment_uris, &manifest, fragment_metadata)
+            .ok())
+      return Status::Ok();
+
+    // Some fragment in the manifest cannot be loaded, so retrieve only the
+    // committed fragments that still exist
+    fragment_uris.clear();
+    fragment_metadata->clear();
+    RETURN_NOT_OK(get_fragment_uris(array_uri, manifest, &fragment_uris));
+  } else {
+    // Recover from a missing manifest by listing the array directory
+    RETURN_NOT_OK(get_fragment_uris(array_uri, &fragment_uris));
+  }
 
-  if (fragment_uris.empty())
-    return Status::Ok();
+  sort_fragment_uris(&fragment_uris);
+  filter_fragment_uris(&fragment_uris, timestamp_start, timestamp_end);
+  return open_array_load_fragment_metadata(
+      open_array,
+      fragment_uris,
+      found ? &manifest : nullptr,
+      fragment_metadata);
+}
 
+Status StorageManager::open_array_load_fragment_metadata(
+    OpenArray* open_array,
+    const std::vector<URI>& fragment_uris,
+    const FragmentManifest* manifest,
+    std::vector<FragmentMetadata*>* fragment_metadata) {
   // Load the metadata for each fragment
+  ConsolidatedFragmentMetadata consolidated;
+  bool consolidated_loaded = false, consolidated_found = false;
   for (auto& uri : fragment_uris) {
     // Find metadata entry in open array
     auto metadata = open_array->fragment_metadata_get(uri);
-    // If not found, load metadata and store in open array
+    if (metadata != nullptr) {
+      fragment_metadata->push_back(metadata);
+      continue;
+    }
+
+    // Try the consolidated fragment metadata, loaded upon the first miss.
+    // If it cannot be loaded, the metadata is read from each fragment.
+    if (!consolidated_loaded) {
+      consolidated_loaded = true;
+      consolidated_fragment_metadata_load(
+          open_array->array_uri(), &consolidated, &consolidated_found);
+    }
+    if (consolidated_found)
+      RETURN_NOT_OK(
+          consolidated.get(open_array->array_schema(), uri, &metadata));
+
+    // If not found, load metadata from the fragment
     if (metadata == nullptr) {
-      URI coords_uri = uri.join_path(
-          std::string("/") + constants::coords + constants::file_suffix);
-      bool dense = !vfs_->is_file(coords_uri);
+      bool dense;
+      if (manifest != nullptr && manifest->contains(uri)) {
+        RETURN_NOT_OK(manifest->dense(uri, &dense));
+      } else {
+        URI coords_uri = uri.join_path(
+            std::string("/") + constants::coords + constants::file_suffix);
+        dense = !vfs_->is_file(coords_uri);
+      }
       metadata = new FragmentMetadata(open_array->array_schema(), dense, uri);
       RETURN_NOT_OK_ELSE(load_fragment_metadata(metadata), delete metadata);
-      open_array->fragment_metadata_add(metadata);
     }
 
-    // Add to list
+    // Store in open array and add to list
+    open_array->fragment_metadata_add(metadata);
     fragment_metadata->push_back(metadata);
   }
 
@@ -1284,23 +1999,12 @@ void StorageManager::sort_fragment_uris(std::vector<URI>* fragment_uris) const {
   if (fragment_num == 0)
     return;
 
-  // Initializations
-  std::string t_str;
-  uint64_t t, pos = 0;
-  std::vector<std::pair<uint64_t, uint64_t>> t_pos_vec;
-
   // Get the timestamp for each fragment
-  for (auto& uri : *fragment_uris) {
-    // Get fragment name
-    std::string fragment_name = uri.last_path_part();
-    assert(utils::starts_with(fragment_name, "__"));
-
-    // Get timestamp in the end of the name after '_'
-    assert(fragment_name.find_last_of("_") != std::string::npos);
-    t_str = fragment_name.substr(fragment_name.find_last_of('_') + 1);
-    sscanf(t_str.c_str(), "%lld", (long long int*)&t);
-    t_pos_vec.emplace_back(std::pair<uint64_t, uint64_t>(t, pos++));
-  }
+  uint64_t pos = 0;
+  std::vector<std::pair<uint64_t, uint64_t>> t_pos_vec;
+  for (auto& uri : *fragment_uris)
+    t_pos_vec.emplace_back(
+        std::pair<uint64_t, uint64_t>(fragment_timestamp(uri), pos++));
 
   // Sort the names based on the timestamps
   std::sort(t_pos_vec.begin(), t_pos_vec.end());
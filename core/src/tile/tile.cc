@@ -47,6 +47,8 @@ Tile::Tile(unsigned int dim_num) {
   compressor_ = Compressor::NO_COMPRESSION;
   compression_level_ = -1;
   dim_num_ = dim_num;
+  dict_encoded_ = false;
+  filters_ = nullptr;
   owns_buff_ = true;
   type_ = Datatype::INT32;
 }
@@ -66,6 +68,8 @@ Tile::Tile(
     , dim_num_(dim_num)
     , owns_buff_(owns_buff)
     , type_(type) {
+  dict_encoded_ = false;
+  filters_ = nullptr;
 }
 
 Tile::Tile(
@@ -82,6 +86,8 @@ Tile::Tile(
     , type_(type) {
   buffer_ = new Buffer();
   buffer_->realloc(tile_size);
+  dict_encoded_ = false;
+  filters_ = nullptr;
   owns_buff_ = true;
 }
 
@@ -96,6 +102,8 @@ Tile::Tile(
     , type_(type) {
   buffer_ = new Buffer();
   compression_level_ = -1;
+  dict_encoded_ = false;
+  filters_ = nullptr;
   owns_buff_ = true;
 }
 
@@ -144,6 +152,10 @@ void Tile::disown_buff() {
   owns_buff_ = false;
 }
 
+bool Tile::dict_encoded() const {
+  return dict_encoded_;
+}
+
 bool Tile::empty() const {
   return buffer_->size() == 0;
 }
@@ -153,6 +165,15 @@ bool Tile::full() const {
          (buffer_->offset() == buffer_->alloced_size());
 }
 
+const FilterPipeline* Tile::filters() const {
+  return filters_;
+}
+
+bool Tile::filtered() const {
+  return compressor_ != Compressor::NO_COMPRESSION ||
+         (filters_ != nullptr && !filters_->empty());
+}
+
 uint64_t Tile::offset() const {
   return buffer_->offset();
 }
@@ -175,6 +196,14 @@ void Tile::reset_size() {
   buffer_->reset_size();
 }
 
+void Tile::set_dict_encoded(bool dict_encoded) {
+  dict_encoded_ = dict_encoded;
+}
+
+void Tile::set_filters(const FilterPipeline* filters) {
+  filters_ = filters;
+}
+
 void Tile::set_offset(uint64_t offset) {
   buffer_->set_offset(offset);
 }
@@ -186,7 +215,7 @@ void Tile::set_size(uint64_t size) {
 uint64_t Tile::size() const {
   return buffer_->size();
 }
-void Tile::split_coordinates() {
+Status Tile::split_coordinates(Buffer* scratch) {
   assert(dim_num_ > 0);
 
   // For easy reference
@@ -196,8 +225,10 @@ void Tile::split_coordinates() {
   auto tile_c = (char*)buffer_->data();
   uint64_t ptr = 0, ptr_tmp = 0;
 
-  // Create a tile clone
-  auto tile_tmp = (char*)malloc(tile_size);
+  // Copy the tile into the scratch space
+  if (scratch->alloced_size() < tile_size)
+    RETURN_NOT_OK(scratch->realloc(tile_size));
+  auto tile_tmp = (char*)scratch->data();
   std::memcpy(tile_tmp, tile_c, tile_size);
 
   // Split coordinates
@@ -210,8 +241,7 @@ void Tile::split_coordinates() {
     }
   }
 
-  // Clean up
-  std::free((void*)tile_tmp);
+  return Status::Ok();
 }
 
 bool Tile::stores_coords() const {
@@ -240,7 +270,7 @@ Status Tile::write_with_shift(ConstBuffer* buf, uint64_t offset) {
   return Status::Ok();
 }
 
-void Tile::zip_coordinates() {
+Status Tile::zip_coordinates(Buffer* scratch) {
   assert(dim_num_ > 0);
 
   // For easy reference
@@ -250,8 +280,10 @@ void Tile::zip_coordinates() {
   auto tile_c = (char*)buffer_->data();
   uint64_t ptr = 0, ptr_tmp = 0;
 
-  // Create a tile clone
-  auto tile_tmp = (char*)malloc(tile_size);
+  // Copy the tile into the scratch space
+  if (scratch->alloced_size() < tile_size)
+    RETURN_NOT_OK(scratch->realloc(tile_size));
+  auto tile_tmp = (char*)scratch->data();
   std::memcpy(tile_tmp, tile_c, tile_size);
 
   // Zip coordinates
@@ -264,8 +296,7 @@ void Tile::zip_coordinates() {
     }
   }
 
-  // Clean up
-  std::free((void*)tile_tmp);
+  return Status::Ok();
 }
 
 /* ****************************** */
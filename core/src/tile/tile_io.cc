@@ -31,19 +31,27 @@
  */
 
 #include "tile_io.h"
+#include "bitpack_compressor.h"
 #include "blosc_compressor.h"
 #include "bzip_compressor.h"
 #include "dd_compressor.h"
+#include "dict_encoder.h"
+#include "gorilla_compressor.h"
 #include "gzip_compressor.h"
 #include "logger.h"
 #include "lz4_compressor.h"
 #include "rle_compressor.h"
+#include "utils.h"
 #include "zstd_compressor.h"
 
+#include <chrono>
+#include <limits>
+
 /* ****************************** */
 /*             MACROS             */
 /* ****************************** */
 
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 
 namespace tiledb {
@@ -57,18 +65,43 @@ TileIO::TileIO(StorageManager* storage_manager, const URI& uri)
     , uri_(uri) {
   file_size_ = 0;
   buffer_ = new Buffer();
+  dict_buffer_ = new Buffer();
+  filter_buffer_ = new Buffer();
+  filter_scratch_ = new Buffer();
+  sample_buffer_ = new Buffer();
+  sample_scratch_ = new Buffer();
+  coords_scratch_ = new Buffer();
+  auto_bandwidth_ = 0;
+  stats_ = storage_manager->stats();
 }
 
 TileIO::TileIO(
-    StorageManager* storage_manager, const URI& uri, uint64_t file_size)
+    StorageManager* storage_manager,
+    const URI& uri,
+    uint64_t file_size,
+    Stats* stats)
     : file_size_(file_size)
     , storage_manager_(storage_manager)
     , uri_(uri) {
   buffer_ = new Buffer();
+  dict_buffer_ = new Buffer();
+  filter_buffer_ = new Buffer();
+  filter_scratch_ = new Buffer();
+  sample_buffer_ = new Buffer();
+  sample_scratch_ = new Buffer();
+  coords_scratch_ = new Buffer();
+  auto_bandwidth_ = 0;
+  stats_ = (stats != nullptr) ? stats : storage_manager->stats();
 }
 
 TileIO::~TileIO() {
   delete buffer_;
+  delete dict_buffer_;
+  delete filter_buffer_;
+  delete filter_scratch_;
+  delete sample_buffer_;
+  delete sample_scratch_;
+  delete coords_scratch_;
 }
 
 /* ****************************** */
@@ -84,27 +117,60 @@ Status TileIO::read(
     uint64_t file_offset,
     uint64_t compressed_size,
     uint64_t tile_size) {
+  TraceSpan span(storage_manager_->tracer(), "tile_read");
+  stats_->add(Stats::Counter::TILE_READ_NUM, 1);
+
   // Try to read from cache
   bool in_cache;
   RETURN_NOT_OK(storage_manager_->read_from_cache(
-      uri_, file_offset, tile->buffer(), tile_size, &in_cache));
+      uri_, file_offset, tile->buffer(), tile_size, &in_cache, stats_));
   if (in_cache)
     return Status::Ok();
 
-  // No compression
-  if (tile->compressor() == Compressor::NO_COMPRESSION) {
-    RETURN_NOT_OK(
-        storage_manager_->read(uri_, file_offset, tile->buffer(), tile_size));
+  // No compression or filtering
+  bool dict_encoded = tile->dict_encoded();
+  if (!tile->filtered()) {
+    RETURN_NOT_OK(storage_manager_->read(
+        uri_,
+        file_offset,
+        dict_encoded ? dict_buffer_ : tile->buffer(),
+        dict_encoded ? compressed_size : tile_size,
+        stats_));
   } else {  // Compression
-    RETURN_NOT_OK(
-        storage_manager_->read(uri_, file_offset, buffer_, compressed_size));
+    RETURN_NOT_OK(storage_manager_->read(
+        uri_, file_offset, buffer_, compressed_size, stats_));
 
-    // Decompress tile
+    // Decompress tile. The encoded values of a dictionary-encoded tile are
+    // never larger than its cell values plus the encoding flag.
     tile->reset_offset();
     tile->reset_size();
     buffer_->reset_offset();
+    RETURN_NOT_OK(tile->realloc(dict_encoded ? tile_size + 1 : tile_size));
+    {
+      ScopedTimer timer(stats_, Stats::Timer::DECOMPRESS);
+      TraceSpan span(storage_manager_->tracer(), "decompress");
+      RETURN_NOT_OK(decompress_tile(tile));
+    }
+    stats_->add(Stats::Counter::DECOMPRESSED_BYTES, tile_size);
+    tile->reset_offset();
+
+    if (dict_encoded) {
+      dict_buffer_->reset_offset();
+      dict_buffer_->reset_size();
+      RETURN_NOT_OK(dict_buffer_->write(tile->data(), tile->size()));
+    }
+  }
+
+  // Decode the dictionary-encoded values into the tile
+  if (dict_encoded) {
+    ConstBuffer input(dict_buffer_);
+    tile->reset_offset();
+    tile->reset_size();
     RETURN_NOT_OK(tile->realloc(tile_size));
-    RETURN_NOT_OK(decompress_tile(tile));
+    RETURN_NOT_OK(DictEncoder::decode(&input, tile->buffer()));
+    if (tile->size() != tile_size)
+      return LOG_STATUS(Status::TileIOError(
+          "Cannot read tile; Decoded size does not match the tile size"));
     tile->reset_offset();
   }
 
@@ -142,7 +208,8 @@ Status TileIO::read_generic_tile_header(
   // Read header from file
   auto header_buff = new Buffer();
   RETURN_NOT_OK_ELSE(
-      storage_manager_->read(uri_, file_offset, header_buff, *header_size),
+      storage_manager_->read(
+          uri_, file_offset, header_buff, *header_size, stats_),
       delete header_buff);
 
   // Read header individual values
@@ -173,13 +240,12 @@ Status TileIO::write(Tile* tile, uint64_t* bytes_written) {
   buffer_->reset_offset();
 
   // Compress tile
-  Compressor compressor = tile->compressor();
-  if (compressor != Compressor::NO_COMPRESSION)
+  bool filtered = tile->filtered();
+  if (filtered)
     RETURN_NOT_OK(compress_tile(tile));
 
   // Prepare to write
-  auto buffer =
-      (compressor == Compressor::NO_COMPRESSION) ? tile->buffer() : buffer_;
+  auto buffer = filtered ? buffer_ : tile->buffer();
   *bytes_written = buffer->size();
 
   RETURN_NOT_OK(storage_manager_->write(uri_, buffer));
@@ -194,12 +260,11 @@ Status TileIO::write_generic(Tile* tile) {
   buffer_->reset_offset();
 
   // Compress tile
-  Compressor compressor = tile->compressor();
-  if (compressor != Compressor::NO_COMPRESSION)
+  bool filtered = tile->filtered();
+  if (filtered)
     RETURN_NOT_OK(compress_tile(tile));
 
-  auto buffer =
-      (compressor == Compressor::NO_COMPRESSION) ? tile->buffer() : buffer_;
+  auto buffer = filtered ? buffer_ : tile->buffer();
 
   RETURN_NOT_OK(write_generic_tile_header(tile, buffer->size()));
   RETURN_NOT_OK(storage_manager_->write(uri_, buffer));
@@ -243,41 +308,102 @@ Status TileIO::compress_tile(Tile* tile) {
     return compress_one_tile(tile);
 
   // Split coordinates
-  tile->split_coordinates();
+  RETURN_NOT_OK(tile->split_coordinates(coords_scratch_));
 
   // Compress each dimension tile
   auto dim_num = tile->dim_num();
   auto dim_tile_size = tile->size() / dim_num;
   auto coord_size = tile->cell_size() / dim_num;
-  Status st;
   for (unsigned int i = 0; i < dim_num; ++i) {
-    auto buff = new Buffer(tile->cur_data(), dim_tile_size, false);
-    auto dim_tile = new Tile(
+    Buffer buff(tile->cur_data(), dim_tile_size, false);
+    Tile dim_tile(
         tile->type(),
         tile->compressor(),
         tile->compression_level(),
         coord_size,
         dim_num,
-        buff,
+        &buff,
         false);
-    st = compress_one_tile(dim_tile);
-    delete buff;
-    delete dim_tile;
-    RETURN_NOT_OK(st);
+    RETURN_NOT_OK(compress_one_tile(&dim_tile));
     tile->advance_offset(dim_tile_size);
   }
 
   return Status::Ok();
 }
 
+Status TileIO::compress_chunk(
+    Compressor compressor,
+    int level,
+    Tile* tile,
+    ConstBuffer* input_buffer,
+    Buffer* output_buffer) {
+  // For easy reference
+  auto type = tile->type();
+  auto type_size = datatype_size(type);
+
+  // Invoke the proper compressor
+  switch (compressor) {
+    case Compressor::NO_COMPRESSION:
+      return output_buffer->write(input_buffer->data(), input_buffer->size());
+    case Compressor::GZIP:
+      return GZip::compress(level, input_buffer, output_buffer);
+    case Compressor::ZSTD:
+      return ZStd::compress(level, input_buffer, output_buffer);
+    case Compressor::LZ4:
+      return LZ4::compress(level, input_buffer, output_buffer);
+    case Compressor::BLOSC:
+      return Blosc::compress(
+          "blosclz", type_size, level, input_buffer, output_buffer);
+#undef BLOSC_LZ4
+    case Compressor::BLOSC_LZ4:
+      return Blosc::compress(
+          "lz4", type_size, level, input_buffer, output_buffer);
+#undef BLOSC_LZ4HC
+    case Compressor::BLOSC_LZ4HC:
+      return Blosc::compress(
+          "lz4hc", type_size, level, input_buffer, output_buffer);
+#undef BLOSC_SNAPPY
+    case Compressor::BLOSC_SNAPPY:
+      return Blosc::compress(
+          "snappy", type_size, level, input_buffer, output_buffer);
+#undef BLOSC_ZLIB
+    case Compressor::BLOSC_ZLIB:
+      return Blosc::compress(
+          "zlib", type_size, level, input_buffer, output_buffer);
+#undef BLOSC_ZSTD
+    case Compressor::BLOSC_ZSTD:
+      return Blosc::compress(
+          "zstd", type_size, level, input_buffer, output_buffer);
+    case Compressor::RLE:
+      return RLE::compress(tile->cell_size(), input_buffer, output_buffer);
+    case Compressor::BZIP2:
+      return BZip::compress(level, input_buffer, output_buffer);
+    case Compressor::DOUBLE_DELTA:
+      return DoubleDelta::compress(type, input_buffer, output_buffer);
+    case Compressor::BITPACK:
+      return BitPack::compress(type, input_buffer, output_buffer);
+    case Compressor::GORILLA:
+      return Gorilla::compress(type, input_buffer, output_buffer);
+    default:
+      return LOG_STATUS(Status::TileIOError(
+          "Cannot compress chunk; Invalid chunk compressor"));
+  }
+}
+
 Status TileIO::compress_one_tile(Tile* tile) {
   // For easy reference
   auto level = tile->compression_level();
-  auto type_size = datatype_size(tile->type());
   auto compressor = tile->compressor();
   auto type = tile->type();
-  auto cell_size = tile->cell_size();
   auto tile_size = tile->size();
+  auto filters = tile->filters();
+  bool has_filters = filters != nullptr && !filters->empty();
+
+  // The compressor of an adaptive tile is picked upon its first chunk and
+  // recorded in the header of every chunk, always at the default level
+  bool adaptive = (compressor == Compressor::AUTO);
+  if (adaptive)
+    level = -1;
 
   // Compute necessary info for chunking
   uint64_t chunk_num, max_chunk_size, overhead;
@@ -291,7 +417,6 @@ Status TileIO::compress_one_tile(Tile* tile) {
   RETURN_NOT_OK(buffer_->write(&chunk_num, sizeof(uint64_t)));
 
   // Compress in chunks
-  Status st;
   uint64_t compressed_chunk_size = 0;
   uint64_t left_to_compress = tile_size;
   for (uint64_t i = 0; i < chunk_num; ++i) {
@@ -302,63 +427,33 @@ Status TileIO::compress_one_tile(Tile* tile) {
     uint64_t buffer_offset = buffer_->offset();  // Will be used later
     RETURN_NOT_OK(buffer_->write(&compressed_chunk_size, sizeof(uint64_t)));
 
-    // Create const buffer
-    auto input_buffer = new ConstBuffer(tile->cur_data(), chunk_size);
-
-    // Invoke the proper compressor
-    switch (compressor) {
-      case Compressor::GZIP:
-        st = GZip::compress(level, input_buffer, buffer_);
-        break;
-      case Compressor::ZSTD:
-        st = ZStd::compress(level, input_buffer, buffer_);
-        break;
-      case Compressor::LZ4:
-        st = LZ4::compress(level, input_buffer, buffer_);
-        break;
-      case Compressor::BLOSC:
-        st =
-            Blosc::compress("blosclz", type_size, level, input_buffer, buffer_);
-        break;
-#undef BLOSC_LZ4
-      case Compressor::BLOSC_LZ4:
-        st = Blosc::compress("lz4", type_size, level, input_buffer, buffer_);
-        break;
-#undef BLOSC_LZ4HC
-      case Compressor::BLOSC_LZ4HC:
-        st = Blosc::compress("lz4hc", type_size, level, input_buffer, buffer_);
-        break;
-#undef BLOSC_SNAPPY
-      case Compressor::BLOSC_SNAPPY:
-        st = Blosc::compress("snappy", type_size, level, input_buffer, buffer_);
-        break;
-#undef BLOSC_ZLIB
-      case Compressor::BLOSC_ZLIB:
-        st = Blosc::compress("zlib", type_size, level, input_buffer, buffer_);
-        break;
-#undef BLOSC_ZSTD
-      case Compressor::BLOSC_ZSTD:
-        st = Blosc::compress("zstd", type_size, level, input_buffer, buffer_);
-        break;
-      case Compressor::RLE:
-        st = RLE::compress(cell_size, input_buffer, buffer_);
-        break;
-      case Compressor::BZIP2:
-        st = BZip::compress(level, input_buffer, buffer_);
-        break;
-      case Compressor::DOUBLE_DELTA:
-        st = DoubleDelta::compress(type, input_buffer, buffer_);
-        break;
-      default:
-        assert(0);
+    // Run the filters on a copy of the chunk
+    auto chunk = tile->cur_data();
+    if (has_filters) {
+      if (filter_buffer_->alloced_size() < chunk_size)
+        RETURN_NOT_OK(filter_buffer_->realloc(chunk_size));
+      std::memcpy(filter_buffer_->data(), chunk, chunk_size);
+      RETURN_NOT_OK(filters->run_forward(
+          type, filter_buffer_->data(), chunk_size, filter_scratch_));
+      chunk = filter_buffer_->data();
+    }
+
+    // Pick and record the compressor of an adaptive tile
+    if (adaptive) {
+      if (i == 0)
+        RETURN_NOT_OK(select_compressor(tile, chunk, chunk_size, &compressor));
+      auto chunk_compressor = (char)compressor;
+      RETURN_NOT_OK(buffer_->write(&chunk_compressor, sizeof(char)));
     }
 
-    delete input_buffer;
-    RETURN_NOT_OK(st);
+    // Compress the chunk
+    uint64_t data_offset = buffer_->offset();
+    ConstBuffer input_buffer(chunk, chunk_size);
+    RETURN_NOT_OK(
+        compress_chunk(compressor, level, tile, &input_buffer, buffer_));
 
     // Write compressed chunk size
-    compressed_chunk_size =
-        buffer_->size() - (buffer_offset + sizeof(uint64_t));
+    compressed_chunk_size = buffer_->size() - data_offset;
     std::memcpy(
         buffer_->data(buffer_offset), &compressed_chunk_size, sizeof(uint64_t));
 
@@ -404,9 +499,10 @@ Status TileIO::compute_chunking_info(
   *chunk_num = tile_size / (*max_chunk_size) +
                uint64_t(bool(tile_size % (*max_chunk_size)));
 
-  // Compute overhead: equal to the compression overhead per chunk, plus 2
-  // values per chunk that store the original and compressed chunk size,
-  // plus a single value in the beginning for the total number of chunks.
+  // Compute overhead: equal to the compression overhead per chunk (which
+  // includes the recorded compressor of an adaptive chunk), plus 2 values
+  // per chunk that store the original and compressed chunk size, plus a
+  // single value in the beginning for the total number of chunks.
   *overhead =
       (*chunk_num) * chunk_overhead * 2 * sizeof(uint64_t) + sizeof(uint64_t);
 
@@ -424,9 +520,53 @@ Status TileIO::decompress_tile(Tile* tile) {
     RETURN_NOT_OK(decompress_one_tile(tile));
 
   // Zip coordinates
-  tile->zip_coordinates();
+  return tile->zip_coordinates(coords_scratch_);
+}
 
-  return Status::Ok();
+Status TileIO::decompress_chunk(
+    Compressor compressor,
+    Tile* tile,
+    ConstBuffer* input_buffer,
+    Buffer* output_buffer) {
+  // For easy reference
+  auto type = tile->type();
+
+  // Invoke the proper decompressor
+  switch (compressor) {
+    case Compressor::NO_COMPRESSION:
+      return output_buffer->write(input_buffer, input_buffer->size());
+    case Compressor::GZIP:
+      return GZip::decompress(input_buffer, output_buffer);
+    case Compressor::ZSTD:
+      return ZStd::decompress(input_buffer, output_buffer);
+    case Compressor::LZ4:
+      return LZ4::decompress(input_buffer, output_buffer);
+    case Compressor::BLOSC:
+#undef BLOSC_LZ4
+    case Compressor::BLOSC_LZ4:
+#undef BLOSC_LZ4HC
+    case Compressor::BLOSC_LZ4HC:
+#undef BLOSC_SNAPPY
+    case Compressor::BLOSC_SNAPPY:
+#undef BLOSC_ZLIB
+    case Compressor::BLOSC_ZLIB:
+#undef BLOSC_ZSTD
+    case Compressor::BLOSC_ZSTD:
+      return Blosc::decompress(input_buffer, output_buffer);
+    case Compressor::RLE:
+      return RLE::decompress(tile->cell_size(), input_buffer, output_buffer);
+    case Compressor::BZIP2:
+      return BZip::decompress(input_buffer, output_buffer);
+    case Compressor::DOUBLE_DELTA:
+      return DoubleDelta::decompress(type, input_buffer, output_buffer);
+    case Compressor::BITPACK:
+      return BitPack::decompress(type, input_buffer, output_buffer);
+    case Compressor::GORILLA:
+      return Gorilla::decompress(type, input_buffer, output_buffer);
+    default:
+      return LOG_STATUS(Status::TileIOError(
+          "Cannot decompress chunk; Invalid chunk compressor"));
+  }
 }
 
 Status TileIO::decompress_one_tile(Tile* tile) {
@@ -436,66 +576,111 @@ Status TileIO::decompress_one_tile(Tile* tile) {
   RETURN_NOT_OK(buffer_->read(&chunk_num, sizeof(uint64_t)));
   assert(chunk_num > 0);
 
-  Status st;
   Datatype type = tile->type();
+  auto filters = tile->filters();
   for (uint64_t i = 0; i < chunk_num; ++i) {
     // Read original and compressed chunk size
     uint64_t chunk_size, compressed_chunk_size;
     RETURN_NOT_OK(buffer_->read(&chunk_size, sizeof(uint64_t)));
     RETURN_NOT_OK(buffer_->read(&compressed_chunk_size, sizeof(uint64_t)));
 
-    auto input_buffer =
-        new ConstBuffer(buffer_->cur_data(), compressed_chunk_size);
-
-    // Invoke the proper decompressor
-    switch (tile->compressor()) {
-      case Compressor::NO_COMPRESSION:
-        assert(0);
-        break;
-      case Compressor::GZIP:
-        st = GZip::decompress(input_buffer, tile->buffer());
-        break;
-      case Compressor::ZSTD:
-        st = ZStd::decompress(input_buffer, tile->buffer());
-        break;
-      case Compressor::LZ4:
-        st = LZ4::decompress(input_buffer, tile->buffer());
-        break;
-      case Compressor::BLOSC:
-#undef BLOSC_LZ4
-      case Compressor::BLOSC_LZ4:
-#undef BLOSC_LZ4HC
-      case Compressor::BLOSC_LZ4HC:
-#undef BLOSC_SNAPPY
-      case Compressor::BLOSC_SNAPPY:
-#undef BLOSC_ZLIB
-      case Compressor::BLOSC_ZLIB:
-#undef BLOSC_ZSTD
-      case Compressor::BLOSC_ZSTD:
-        st = Blosc::decompress(input_buffer, tile->buffer());
-        break;
-      case Compressor::RLE:
-        st = RLE::decompress(tile->cell_size(), input_buffer, tile->buffer());
-        break;
-      case Compressor::BZIP2:
-        st = BZip::decompress(input_buffer, tile->buffer());
-        break;
-      case Compressor::DOUBLE_DELTA:
-        st = DoubleDelta::decompress(type, input_buffer, tile->buffer());
-        break;
+    // Read the compressor of an adaptively compressed chunk
+    auto compressor = tile->compressor();
+    if (compressor == Compressor::AUTO) {
+      char chunk_compressor;
+      RETURN_NOT_OK(buffer_->read(&chunk_compressor, sizeof(char)));
+      compressor = (Compressor)chunk_compressor;
+      if (compressor == Compressor::AUTO)
+        return LOG_STATUS(Status::TileIOError(
+            "Cannot decompress tile; Invalid chunk compressor"));
     }
 
-    delete input_buffer;
-    RETURN_NOT_OK(st);
+    ConstBuffer input_buffer(buffer_->cur_data(), compressed_chunk_size);
+    uint64_t chunk_offset = tile->buffer()->offset();
+    RETURN_NOT_OK(
+        decompress_chunk(compressor, tile, &input_buffer, tile->buffer()));
+
+    // Revert the filters on the decompressed chunk
+    if (filters != nullptr && !filters->empty())
+      RETURN_NOT_OK(filters->run_reverse(
+          type,
+          tile->buffer()->data(chunk_offset),
+          chunk_size,
+          filter_scratch_));
 
     buffer_->advance_offset(compressed_chunk_size);
   }
 
-  return st;
+  return Status::Ok();
 }
 
 uint64_t TileIO::overhead(Tile* tile, uint64_t nbytes) const {
-  switch (tile->compressor()) {
+  return compressor_overhead(tile->compressor(), tile->cell_size(), nbytes);
+}
+
+Status TileIO::select_compressor(
+    Tile* tile,
+    const void* chunk,
+    uint64_t chunk_size,
+    Compressor* compressor) {
+  // Parse the candidates upon the first adaptive tile
+  if (auto_candidates_.empty()) {
+    auto sm_params = storage_manager_->config().sm_params();
+    RETURN_NOT_OK(utils::parse::convert(
+        sm_params.compression_auto_candidates_, &auto_candidates_));
+    auto_bandwidth_ = sm_params.compression_auto_bandwidth_;
+  }
+
+  // The sample holds the first whole cells of the chunk
+  auto cell_size = tile->cell_size();
+  uint64_t sample_cell_num =
+      MAX(constants::compression_auto_sample_size / cell_size, 1);
+  uint64_t sample_size = MIN(sample_cell_num * cell_size, chunk_size);
+
+  // Pick the candidate of minimum cost on the sample, i.e., the smallest
+  // output or, given a storage bandwidth, the fastest to read and decode
+  *compressor = Compressor::NO_COMPRESSION;
+  double min_cost = std::numeric_limits<double>::max();
+  for (auto candidate : auto_candidates_) {
+    if (!compressor_supports(candidate, tile->type()))
+      continue;
+
+    // Compress the sample
+    sample_buffer_->reset_size();
+    sample_buffer_->reset_offset();
+    RETURN_NOT_OK(sample_buffer_->realloc(
+        sample_size + compressor_overhead(candidate, cell_size, sample_size)));
+    ConstBuffer sample(chunk, sample_size);
+    if (!compress_chunk(candidate, -1, tile, &sample, sample_buffer_).ok())
+      continue;
+    double cost = (double)sample_buffer_->size();
+
+    // Time the decompression of the sample
+    if (auto_bandwidth_ > 0) {
+      sample_scratch_->reset_size();
+      sample_scratch_->reset_offset();
+      RETURN_NOT_OK(sample_scratch_->realloc(sample_size));
+      ConstBuffer compressed(sample_buffer_->data(), sample_buffer_->size());
+      auto start = std::chrono::steady_clock::now();
+      if (!decompress_chunk(candidate, tile, &compressed, sample_scratch_).ok())
+        continue;
+      std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start;
+      cost = cost / auto_bandwidth_ + elapsed.count();
+    }
+
+    if (cost < min_cost) {
+      min_cost = cost;
+      *compressor = candidate;
+    }
+  }
+
+  return Status::Ok();
+}
+
+uint64_t TileIO::compressor_overhead(
+    Compressor compressor, uint64_t cell_size, uint64_t nbytes) {
+  switch (compressor) {
     case Compressor::GZIP:
       return GZip::overhead(nbytes);
     case Compressor::ZSTD:
@@ -515,15 +700,43 @@ uint64_t TileIO::overhead(Tile* tile, uint64_t nbytes) const {
     case Compressor::BLOSC_ZSTD:
       return Blosc::overhead(nbytes);
     case Compressor::RLE:
-      return RLE::overhead(nbytes, tile->cell_size());
+      return RLE::overhead(nbytes, cell_size);
     case Compressor::BZIP2:
       return BZip::overhead(nbytes);
     case Compressor::DOUBLE_DELTA:
       return DoubleDelta::overhead(nbytes);
+    case Compressor::BITPACK:
+      return BitPack::overhead(nbytes);
+    case Compressor::GORILLA:
+      return Gorilla::overhead(nbytes);
+    case Compressor::AUTO: {
+      // Any candidate may be picked, plus the compressor in the chunk header
+      uint64_t overhead = 0;
+      for (int c = 0; (Compressor)c != Compressor::AUTO; ++c) {
+        auto c_overhead = compressor_overhead((Compressor)c, cell_size, nbytes);
+        overhead = MAX(overhead, c_overhead);
+      }
+      return overhead + sizeof(char);
+    }
     default:
       // No compression
       return 0;
   }
 }
 
+bool TileIO::compressor_supports(Compressor compressor, Datatype type) {
+  bool real = (type == Datatype::FLOAT32 || type == Datatype::FLOAT64);
+  switch (compressor) {
+    case Compressor::DOUBLE_DELTA:
+    case Compressor::BITPACK:
+      return !real;
+    case Compressor::GORILLA:
+      return real;
+    case Compressor::AUTO:
+      return false;
+    default:
+      return true;
+  }
+}
+
 }  // namespace tiledb
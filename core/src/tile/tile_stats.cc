@@ -0,0 +1,263 @@
+/**
+ * @file   tile_stats.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class TileStats.
+ */
+
+#include "tile_stats.h"
+#include "logger.h"
+
+#include <cstring>
+#include <limits>
+
+namespace tiledb {
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+TileStats::TileStats() {
+  count_ = 0;
+  null_count_ = 0;
+  std::memset(max_, 0, sizeof(max_));
+  std::memset(min_, 0, sizeof(min_));
+  std::memset(sum_, 0, sizeof(sum_));
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+Status TileStats::compute(
+    Datatype type, const void* values, uint64_t size, bool dense) {
+  auto value_num = size / datatype_size(type);
+  switch (type) {
+    case Datatype::INT32:
+      compute<int, int64_t>(static_cast<const int*>(values), value_num, dense);
+      break;
+    case Datatype::INT64:
+      compute<int64_t, int64_t>(
+          static_cast<const int64_t*>(values), value_num, dense);
+      break;
+    case Datatype::FLOAT32:
+      compute<float, double>(
+          static_cast<const float*>(values), value_num, dense);
+      break;
+    case Datatype::FLOAT64:
+      compute<double, double>(
+          static_cast<const double*>(values), value_num, dense);
+      break;
+    case Datatype::CHAR:
+      compute<char, int64_t>(
+          static_cast<const char*>(values), value_num, dense);
+      std::memset(sum_, 0, sizeof(sum_));
+      break;
+    case Datatype::INT8:
+      compute<int8_t, int64_t>(
+          static_cast<const int8_t*>(values), value_num, dense);
+      break;
+    case Datatype::UINT8:
+      compute<uint8_t, uint64_t>(
+          static_cast<const uint8_t*>(values), value_num, dense);
+      break;
+    case Datatype::INT16:
+      compute<int16_t, int64_t>(
+          static_cast<const int16_t*>(values), value_num, dense);
+      break;
+    case Datatype::UINT16:
+      compute<uint16_t, uint64_t>(
+          static_cast<const uint16_t*>(values), value_num, dense);
+      break;
+    case Datatype::UINT32:
+      compute<uint32_t, uint64_t>(
+          static_cast<const uint32_t*>(values), value_num, dense);
+      break;
+    case Datatype::UINT64:
+      compute<uint64_t, uint64_t>(
+          static_cast<const uint64_t*>(values), value_num, dense);
+      break;
+    default:
+      return LOG_STATUS(Status::TileError(
+          "Cannot compute tile statistics; Unsupported datatype"));
+  }
+
+  return Status::Ok();
+}
+
+uint64_t TileStats::count() const {
+  return count_;
+}
+
+// ===== FORMAT =====
+// count (uint64_t)
+// null_count (uint64_t)
+// min (8 bytes, holding a value of the attribute type)
+// max (8 bytes, holding a value of the attribute type)
+// sum (8 bytes, holding a value of the sum type)
+Status TileStats::deserialize(ConstBuffer* buff) {
+  RETURN_NOT_OK(buff->read(&count_, sizeof(uint64_t)));
+  RETURN_NOT_OK(buff->read(&null_count_, sizeof(uint64_t)));
+  RETURN_NOT_OK(buff->read(min_, sizeof(min_)));
+  RETURN_NOT_OK(buff->read(max_, sizeof(max_)));
+  return buff->read(sum_, sizeof(sum_));
+}
+
+bool TileStats::has_sum(Datatype type) {
+  return type != Datatype::CHAR;
+}
+
+const void* TileStats::max() const {
+  return max_;
+}
+
+Status TileStats::merge(Datatype type, const TileStats& stats) {
+  switch (type) {
+    case Datatype::INT32:
+      merge<int, int64_t>(stats);
+      break;
+    case Datatype::INT64:
+      merge<int64_t, int64_t>(stats);
+      break;
+    case Datatype::FLOAT32:
+      merge<float, double>(stats);
+      break;
+    case Datatype::FLOAT64:
+      merge<double, double>(stats);
+      break;
+    case Datatype::CHAR:
+      merge<char, int64_t>(stats);
+      break;
+    case Datatype::INT8:
+      merge<int8_t, int64_t>(stats);
+      break;
+    case Datatype::UINT8:
+      merge<uint8_t, uint64_t>(stats);
+      break;
+    case Datatype::INT16:
+      merge<int16_t, int64_t>(stats);
+      break;
+    case Datatype::UINT16:
+      merge<uint16_t, uint64_t>(stats);
+      break;
+    case Datatype::UINT32:
+      merge<uint32_t, uint64_t>(stats);
+      break;
+    case Datatype::UINT64:
+      merge<uint64_t, uint64_t>(stats);
+      break;
+    default:
+      return LOG_STATUS(Status::TileError(
+          "Cannot merge tile statistics; Unsupported datatype"));
+  }
+
+  return Status::Ok();
+}
+
+const void* TileStats::min() const {
+  return min_;
+}
+
+uint64_t TileStats::null_count() const {
+  return null_count_;
+}
+
+Status TileStats::serialize(Buffer* buff) const {
+  RETURN_NOT_OK(buff->write(&count_, sizeof(uint64_t)));
+  RETURN_NOT_OK(buff->write(&null_count_, sizeof(uint64_t)));
+  RETURN_NOT_OK(buff->write(min_, sizeof(min_)));
+  RETURN_NOT_OK(buff->write(max_, sizeof(max_)));
+  return buff->write(sum_, sizeof(sum_));
+}
+
+const void* TileStats::sum() const {
+  return sum_;
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+template <class T, class S>
+void TileStats::compute(const T* values, uint64_t value_num, bool dense) {
+  // The empty value of every type is its maximum
+  auto empty = std::numeric_limits<T>::max();
+  T min = empty;
+  T max = std::numeric_limits<T>::lowest();
+  S sum = 0;
+  uint64_t count = 0;
+  for (uint64_t i = 0; i < value_num; ++i) {
+    auto value = values[i];
+    if (dense && value == empty)
+      continue;
+    min = (value < min) ? value : min;
+    max = (value > max) ? value : max;
+    sum += (S)value;
+    ++count;
+  }
+
+  if (count == 0)
+    min = max = 0;
+  count_ = count;
+  null_count_ = value_num - count;
+  std::memcpy(min_, &min, sizeof(T));
+  std::memcpy(max_, &max, sizeof(T));
+  std::memcpy(sum_, &sum, sizeof(S));
+}
+
+template <class T, class S>
+void TileStats::merge(const TileStats& stats) {
+  null_count_ += stats.null_count_;
+  if (stats.count_ == 0)
+    return;
+
+  T min, max, stats_min, stats_max;
+  S sum, stats_sum;
+  std::memcpy(&stats_min, stats.min_, sizeof(T));
+  std::memcpy(&stats_max, stats.max_, sizeof(T));
+  std::memcpy(&stats_sum, stats.sum_, sizeof(S));
+  if (count_ == 0) {
+    min = stats_min;
+    max = stats_max;
+    sum = stats_sum;
+  } else {
+    std::memcpy(&min, min_, sizeof(T));
+    std::memcpy(&max, max_, sizeof(T));
+    std::memcpy(&sum, sum_, sizeof(S));
+    min = (stats_min < min) ? stats_min : min;
+    max = (stats_max > max) ? stats_max : max;
+    sum += stats_sum;
+  }
+
+  count_ += stats.count_;
+  std::memcpy(min_, &min, sizeof(T));
+  std::memcpy(max_, &max, sizeof(T));
+  std::memcpy(sum_, &sum, sizeof(S));
+}
+
+}  // namespace tiledb
@@ -0,0 +1,85 @@
+/**
+ * @file unit-bloom_filter.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file unit-tests class BloomFilter.
+ */
+
+
+#include "bloom_filter.h"
+#include "catch.hpp"
+
+#include <random>
+
+using namespace tiledb;
+
+TEST_CASE("BloomFilter: Test lookups", "[bloom-filter]") {
+  BloomFilter filter;
+  filter.init(1000, 10);
+  CHECK(filter.bit_num() == 10048);
+  CHECK(filter.hash_num() == 7);
+
+  // Added items are always found
+  std::mt19937_64 gen(0);
+  std::vector<std::pair<uint64_t, uint64_t>> items;
+  for (int i = 0; i < 1000; ++i) {
+    items.emplace_back(gen(), gen());
+    filter.add(items.back().first, items.back().second);
+  }
+  for (const auto& item : items)
+    CHECK(filter.may_contain(item.first, item.second));
+
+  // About 1% of the absent items are false positives
+  int false_positives = 0;
+  for (int i = 0; i < 10000; ++i)
+    false_positives += filter.may_contain(gen(), gen());
+  CHECK(false_positives < 300);
+}
+
+TEST_CASE("BloomFilter: Test serialization", "[bloom-filter]") {
+  BloomFilter filter;
+  filter.init(100, 8);
+  for (uint64_t i = 0; i < 100; ++i)
+    filter.add(i * 7919, i * 104729);
+
+  Buffer buff;
+  REQUIRE(filter.serialize(&buff).ok());
+
+  BloomFilter filter_copy;
+  ConstBuffer cbuff(&buff);
+  REQUIRE(filter_copy.deserialize(&cbuff).ok());
+  CHECK(cbuff.end());
+  CHECK(filter_copy.bit_num() == filter.bit_num());
+  CHECK(filter_copy.hash_num() == filter.hash_num());
+  for (uint64_t i = 0; i < 100; ++i)
+    CHECK(filter_copy.may_contain(i * 7919, i * 104729));
+
+  // Truncated input
+  ConstBuffer truncated(buff.data(), buff.size() - 1);
+  CHECK(!filter_copy.deserialize(&truncated).ok());
+}
@@ -37,6 +37,7 @@
 #include <iostream>
 #include <sstream>
 #include <thread>
+#include <vector>
 
 #include "catch.hpp"
 #ifdef _WIN32
@@ -821,3 +822,418 @@ TEST_CASE_METHOD(
   rc = tiledb_array_schema_free(ctx_, array_schema);
   CHECK(rc == TILEDB_OK);
 }
+
+TEST_CASE_METHOD(
+    ArraySchemaFx,
+    "C API: Test attribute filters",
+    "[capi], [array-schema], [filter]") {
+  // Set filters
+  tiledb_attribute_t* attr;
+  int rc = tiledb_attribute_create(ctx_, &attr, "a", TILEDB_INT32);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_attribute_add_filter(ctx_, attr, TILEDB_FILTER_DELTA);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_attribute_add_filter(ctx_, attr, TILEDB_FILTER_BYTESHUFFLE);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_attribute_add_filter(ctx_, attr, (tiledb_filter_type_t)100);
+  CHECK(rc == TILEDB_ERR);
+  rc = tiledb_attribute_set_compressor(ctx_, attr, TILEDB_ZSTD, -1);
+  REQUIRE(rc == TILEDB_OK);
+
+  // Get filters
+  unsigned int filter_num = 0;
+  rc = tiledb_attribute_get_filter_num(ctx_, attr, &filter_num);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(filter_num == 2);
+  tiledb_filter_type_t filter;
+  rc = tiledb_attribute_get_filter_from_index(ctx_, attr, 1, &filter);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(filter == TILEDB_FILTER_BYTESHUFFLE);
+  rc = tiledb_attribute_get_filter_from_index(ctx_, attr, 2, &filter);
+  CHECK(rc == TILEDB_ERR);
+
+  // Var-sized attribute with a filter and no compressor
+  tiledb_attribute_t* attr_var;
+  rc = tiledb_attribute_create(ctx_, &attr_var, "b", TILEDB_CHAR);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_attribute_set_cell_val_num(ctx_, attr_var, TILEDB_VAR_NUM);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_attribute_add_filter(ctx_, attr_var, TILEDB_FILTER_BITSHUFFLE);
+  REQUIRE(rc == TILEDB_OK);
+
+  // Create array
+  int64_t dim_domain[] = {1, 100};
+  int64_t tile_extent = 50;
+  tiledb_dimension_t* d1;
+  rc = tiledb_dimension_create(
+      ctx_, &d1, "d1", TILEDB_INT64, dim_domain, &tile_extent);
+  REQUIRE(rc == TILEDB_OK);
+  tiledb_domain_t* domain;
+  rc = tiledb_domain_create(ctx_, &domain);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_domain_add_dimension(ctx_, domain, d1);
+  REQUIRE(rc == TILEDB_OK);
+  tiledb_array_schema_t* array_schema;
+  rc = tiledb_array_schema_create(ctx_, &array_schema, TILEDB_DENSE);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_schema_set_domain(ctx_, array_schema, domain);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_schema_add_attribute(ctx_, array_schema, attr);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_schema_add_attribute(ctx_, array_schema, attr_var);
+  REQUIRE(rc == TILEDB_OK);
+
+  std::string temp_dir = FILE_URI_PREFIX + FILE_TEMP_DIR;
+  std::string array_name = temp_dir + "filters";
+  create_temp_dir(temp_dir);
+  rc = tiledb_array_create(ctx_, array_name.c_str(), array_schema);
+  REQUIRE(rc == TILEDB_OK);
+
+  // Write
+  const char* attributes[] = {"a", "b"};
+  int a[100];
+  uint64_t b_off[100];
+  char b_val[100 * 3];
+  uint64_t b_size = 0;
+  for (int i = 0; i < 100; ++i) {
+    a[i] = 1000 + 3 * i;
+    b_off[i] = b_size;
+    for (int j = 0; j <= i % 3; ++j)
+      b_val[b_size++] = (char)('a' + (i + j) % 26);
+  }
+  void* write_buffers[] = {a, b_off, b_val};
+  uint64_t write_buffer_sizes[] = {sizeof(a), sizeof(b_off), b_size};
+  tiledb_query_t* query;
+  rc = tiledb_query_create(ctx_, &query, array_name.c_str(), TILEDB_WRITE);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_buffers(
+      ctx_, query, attributes, 2, write_buffers, write_buffer_sizes);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_layout(ctx_, query, TILEDB_ROW_MAJOR);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_submit(ctx_, query);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_free(ctx_, query);
+  REQUIRE(rc == TILEDB_OK);
+
+  // Read
+  int r_a[100];
+  uint64_t r_b_off[100];
+  char r_b_val[100 * 3];
+  void* read_buffers[] = {r_a, r_b_off, r_b_val};
+  uint64_t read_buffer_sizes[] = {
+      sizeof(r_a), sizeof(r_b_off), sizeof(r_b_val)};
+  rc = tiledb_query_create(ctx_, &query, array_name.c_str(), TILEDB_READ);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_buffers(
+      ctx_, query, attributes, 2, read_buffers, read_buffer_sizes);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_layout(ctx_, query, TILEDB_ROW_MAJOR);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_submit(ctx_, query);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_free(ctx_, query);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(read_buffer_sizes[2] == b_size);
+  CHECK(!memcmp(r_a, a, sizeof(a)));
+  CHECK(!memcmp(r_b_off, b_off, sizeof(b_off)));
+  CHECK(!memcmp(r_b_val, b_val, b_size));
+
+  // The filters are persisted in the array schema
+  tiledb_array_schema_t* loaded_schema;
+  rc = tiledb_array_schema_load(ctx_, &loaded_schema, array_name.c_str());
+  REQUIRE(rc == TILEDB_OK);
+  tiledb_attribute_t* loaded_attr;
+  rc = tiledb_array_schema_get_attribute_from_name(
+      ctx_, loaded_schema, "a", &loaded_attr);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_attribute_get_filter_num(ctx_, loaded_attr, &filter_num);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(filter_num == 2);
+  rc = tiledb_attribute_get_filter_from_index(ctx_, loaded_attr, 0, &filter);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(filter == TILEDB_FILTER_DELTA);
+
+  // Clear filters
+  rc = tiledb_attribute_clear_filters(ctx_, attr);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_attribute_get_filter_num(ctx_, attr, &filter_num);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(filter_num == 0);
+
+  // Clean up
+  remove_temp_dir(temp_dir);
+  CHECK(tiledb_attribute_free(ctx_, loaded_attr) == TILEDB_OK);
+  CHECK(tiledb_array_schema_free(ctx_, loaded_schema) == TILEDB_OK);
+  CHECK(tiledb_attribute_free(ctx_, attr) == TILEDB_OK);
+  CHECK(tiledb_attribute_free(ctx_, attr_var) == TILEDB_OK);
+  CHECK(tiledb_dimension_free(ctx_, d1) == TILEDB_OK);
+  CHECK(tiledb_domain_free(ctx_, domain) == TILEDB_OK);
+  CHECK(tiledb_array_schema_free(ctx_, array_schema) == TILEDB_OK);
+}
+
+TEST_CASE_METHOD(
+    ArraySchemaFx,
+    "C API: Test array schema with type-specific compressors",
+    "[capi], [array-schema]") {
+  // Returns the result of checking a sparse array schema with an integer
+  // domain and a single attribute
+  auto check = [this](
+                   tiledb_datatype_t attr_type,
+                   tiledb_compressor_t attr_compressor,
+                   tiledb_compressor_t coords_compressor) {
+    tiledb_array_schema_t* array_schema;
+    int rc = tiledb_array_schema_create(ctx_, &array_schema, TILEDB_SPARSE);
+    REQUIRE(rc == TILEDB_OK);
+    tiledb_dimension_t* d1;
+    rc = tiledb_dimension_create(
+        ctx_, &d1, "d1", TILEDB_INT64, &DIM_DOMAIN[0], &TILE_EXTENTS[0]);
+    REQUIRE(rc == TILEDB_OK);
+    tiledb_domain_t* domain;
+    rc = tiledb_domain_create(ctx_, &domain);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_domain_add_dimension(ctx_, domain, d1);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_array_schema_set_domain(ctx_, array_schema, domain);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_array_schema_set_coords_compressor(
+        ctx_, array_schema, coords_compressor, -1);
+    REQUIRE(rc == TILEDB_OK);
+    tiledb_attribute_t* attr;
+    rc = tiledb_attribute_create(ctx_, &attr, "a", attr_type);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_attribute_set_compressor(ctx_, attr, attr_compressor, -1);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_array_schema_add_attribute(ctx_, array_schema, attr);
+    REQUIRE(rc == TILEDB_OK);
+
+    rc = tiledb_array_schema_check(ctx_, array_schema);
+
+    CHECK(tiledb_attribute_free(ctx_, attr) == TILEDB_OK);
+    CHECK(tiledb_dimension_free(ctx_, d1) == TILEDB_OK);
+    CHECK(tiledb_domain_free(ctx_, domain) == TILEDB_OK);
+    CHECK(tiledb_array_schema_free(ctx_, array_schema) == TILEDB_OK);
+    return rc;
+  };
+
+  // Bit-packing is for integers only
+  CHECK(check(TILEDB_INT32, TILEDB_BITPACK, TILEDB_BITPACK) == TILEDB_OK);
+  CHECK(check(TILEDB_FLOAT32, TILEDB_BITPACK, TILEDB_ZSTD) == TILEDB_ERR);
+
+  // Gorilla is for reals only
+  CHECK(check(TILEDB_FLOAT64, TILEDB_GORILLA, TILEDB_ZSTD) == TILEDB_OK);
+  CHECK(check(TILEDB_INT64, TILEDB_GORILLA, TILEDB_ZSTD) == TILEDB_ERR);
+  CHECK(check(TILEDB_FLOAT64, TILEDB_GORILLA, TILEDB_GORILLA) == TILEDB_ERR);
+}
+
+TEST_CASE_METHOD(
+    ArraySchemaFx,
+    "C API: Test attribute dictionary encoding",
+    "[capi], [array-schema], [dict]") {
+  tiledb_compressor_t compressor = TILEDB_NO_COMPRESSION;
+  SECTION("- no compression") {
+    compressor = TILEDB_NO_COMPRESSION;
+  }
+  SECTION("- zstd") {
+    compressor = TILEDB_ZSTD;
+  }
+
+  // Dictionary-encoded attribute
+  tiledb_attribute_t* attr;
+  int rc = tiledb_attribute_create(ctx_, &attr, "a", TILEDB_CHAR);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_attribute_set_cell_val_num(ctx_, attr, TILEDB_VAR_NUM);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_attribute_set_compressor(ctx_, attr, compressor, -1);
+  REQUIRE(rc == TILEDB_OK);
+  int dictionary_encoding = 0;
+  rc = tiledb_attribute_get_dictionary_encoding(
+      ctx_, attr, &dictionary_encoding);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(dictionary_encoding == 0);
+  rc = tiledb_attribute_set_dictionary_encoding(ctx_, attr, 1);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_attribute_get_dictionary_encoding(
+      ctx_, attr, &dictionary_encoding);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(dictionary_encoding == 1);
+
+  // Create array
+  int64_t dim_domain[] = {1, 1000};
+  int64_t tile_extent = 100;
+  tiledb_dimension_t* d1;
+  rc = tiledb_dimension_create(
+      ctx_, &d1, "d1", TILEDB_INT64, dim_domain, &tile_extent);
+  REQUIRE(rc == TILEDB_OK);
+  tiledb_domain_t* domain;
+  rc = tiledb_domain_create(ctx_, &domain);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_domain_add_dimension(ctx_, domain, d1);
+  REQUIRE(rc == TILEDB_OK);
+  tiledb_array_schema_t* array_schema;
+  rc = tiledb_array_schema_create(ctx_, &array_schema, TILEDB_DENSE);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_schema_set_domain(ctx_, array_schema, domain);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_schema_add_attribute(ctx_, array_schema, attr);
+  REQUIRE(rc == TILEDB_OK);
+
+  std::string temp_dir = FILE_URI_PREFIX + FILE_TEMP_DIR;
+  std::string array_name = temp_dir + "dict";
+  create_temp_dir(temp_dir);
+  rc = tiledb_array_create(ctx_, array_name.c_str(), array_schema);
+  REQUIRE(rc == TILEDB_OK);
+
+  // Write a few distinct values, with a unique value in the last tile
+  const char* categories[] = {"red", "green", "blue", ""};
+  std::vector<uint64_t> a_off;
+  std::string a_val;
+  for (int i = 0; i < 1000; ++i) {
+    a_off.push_back(a_val.size());
+    a_val += (i < 900) ? categories[(i * 7) % 4] : std::to_string(i);
+  }
+  const char* attributes[] = {"a"};
+  void* write_buffers[] = {&a_off[0], &a_val[0]};
+  uint64_t write_buffer_sizes[] = {a_off.size() * sizeof(uint64_t),
+                                   a_val.size()};
+  tiledb_query_t* query;
+  rc = tiledb_query_create(ctx_, &query, array_name.c_str(), TILEDB_WRITE);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_buffers(
+      ctx_, query, attributes, 1, write_buffers, write_buffer_sizes);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_layout(ctx_, query, TILEDB_ROW_MAJOR);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_submit(ctx_, query);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_free(ctx_, query);
+  REQUIRE(rc == TILEDB_OK);
+
+  // Read a range spanning several tiles
+  int64_t subarray[] = {151, 950};
+  std::vector<uint64_t> r_a_off(800);
+  std::string r_a_val(a_val.size(), '\0');
+  void* read_buffers[] = {&r_a_off[0], &r_a_val[0]};
+  uint64_t read_buffer_sizes[] = {r_a_off.size() * sizeof(uint64_t),
+                                  r_a_val.size()};
+  rc = tiledb_query_create(ctx_, &query, array_name.c_str(), TILEDB_READ);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_subarray(ctx_, query, subarray);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_buffers(
+      ctx_, query, attributes, 1, read_buffers, read_buffer_sizes);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_layout(ctx_, query, TILEDB_ROW_MAJOR);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_submit(ctx_, query);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_free(ctx_, query);
+  REQUIRE(rc == TILEDB_OK);
+
+  // Check the read cells
+  uint64_t start = a_off[150];
+  uint64_t end = a_off[950];
+  REQUIRE(read_buffer_sizes[0] == 800 * sizeof(uint64_t));
+  REQUIRE(read_buffer_sizes[1] == end - start);
+  for (int i = 0; i < 800; ++i)
+    CHECK(r_a_off[i] == a_off[150 + i] - start);
+  CHECK(!memcmp(&r_a_val[0], &a_val[start], end - start));
+
+  // Dictionary encoding is persisted in the array schema
+  tiledb_array_schema_t* loaded_schema;
+  rc = tiledb_array_schema_load(ctx_, &loaded_schema, array_name.c_str());
+  REQUIRE(rc == TILEDB_OK);
+  tiledb_attribute_t* loaded_attr;
+  rc = tiledb_array_schema_get_attribute_from_name(
+      ctx_, loaded_schema, "a", &loaded_attr);
+  REQUIRE(rc == TILEDB_OK);
+  dictionary_encoding = 0;
+  rc = tiledb_attribute_get_dictionary_encoding(
+      ctx_, loaded_attr, &dictionary_encoding);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(dictionary_encoding == 1);
+
+  // Dictionary encoding applies only to var-sized char attributes
+  tiledb_attribute_t* attr_fixed;
+  rc = tiledb_attribute_create(ctx_, &attr_fixed, "b", TILEDB_CHAR);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_attribute_set_dictionary_encoding(ctx_, attr_fixed, 1);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_schema_add_attribute(ctx_, array_schema, attr_fixed);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_schema_check(ctx_, array_schema);
+  CHECK(rc == TILEDB_ERR);
+
+  // Clean up
+  remove_temp_dir(temp_dir);
+  CHECK(tiledb_attribute_free(ctx_, loaded_attr) == TILEDB_OK);
+  CHECK(tiledb_array_schema_free(ctx_, loaded_schema) == TILEDB_OK);
+  CHECK(tiledb_attribute_free(ctx_, attr) == TILEDB_OK);
+  CHECK(tiledb_attribute_free(ctx_, attr_fixed) == TILEDB_OK);
+  CHECK(tiledb_dimension_free(ctx_, d1) == TILEDB_OK);
+  CHECK(tiledb_domain_free(ctx_, domain) == TILEDB_OK);
+  CHECK(tiledb_array_schema_free(ctx_, array_schema) == TILEDB_OK);
+}
+
+TEST_CASE_METHOD(
+    ArraySchemaFx,
+    "C API: Test array schema load from version 1.2.0",
+    "[capi], [array-schema], [backwards-compat]") {
+  // Array written by version 1.2.0, prior to attribute filters and
+  // dictionary encoding
+  std::string array_name =
+      std::string(TILEDB_TEST_INPUTS_DIR) + "/arrays/dense_array_v1_2_0";
+  tiledb_array_schema_t* array_schema;
+  int rc = tiledb_array_schema_load(ctx_, &array_schema, array_name.c_str());
+  REQUIRE(rc == TILEDB_OK);
+
+  tiledb_array_type_t array_type;
+  rc = tiledb_array_schema_get_array_type(ctx_, array_schema, &array_type);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(array_type == TILEDB_DENSE);
+  unsigned int attr_num;
+  rc = tiledb_array_schema_get_attribute_num(ctx_, array_schema, &attr_num);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(attr_num == 2);
+
+  // Check attributes
+  const char* attr_names[] = {"a1", "a2"};
+  tiledb_datatype_t attr_types[] = {TILEDB_INT32, TILEDB_CHAR};
+  unsigned int cell_val_nums[] = {1, TILEDB_VAR_NUM};
+  for (unsigned int i = 0; i < 2; ++i) {
+    tiledb_attribute_t* attr;
+    rc = tiledb_array_schema_get_attribute_from_index(
+        ctx_, array_schema, i, &attr);
+    REQUIRE(rc == TILEDB_OK);
+    const char* attr_name;
+    rc = tiledb_attribute_get_name(ctx_, attr, &attr_name);
+    REQUIRE(rc == TILEDB_OK);
+    CHECK_THAT(attr_name, Catch::Equals(attr_names[i]));
+    tiledb_datatype_t attr_type;
+    rc = tiledb_attribute_get_type(ctx_, attr, &attr_type);
+    REQUIRE(rc == TILEDB_OK);
+    CHECK(attr_type == attr_types[i]);
+    unsigned int cell_val_num;
+    rc = tiledb_attribute_get_cell_val_num(ctx_, attr, &cell_val_num);
+    REQUIRE(rc == TILEDB_OK);
+    CHECK(cell_val_num == cell_val_nums[i]);
+    tiledb_compressor_t compressor;
+    int compression_level;
+    rc = tiledb_attribute_get_compressor(
+        ctx_, attr, &compressor, &compression_level);
+    REQUIRE(rc == TILEDB_OK);
+    CHECK(compressor == TILEDB_GZIP);
+    unsigned int filter_num;
+    rc = tiledb_attribute_get_filter_num(ctx_, attr, &filter_num);
+    REQUIRE(rc == TILEDB_OK);
+    CHECK(filter_num == 0);
+    int dictionary_encoding;
+    rc = tiledb_attribute_get_dictionary_encoding(
+        ctx_, attr, &dictionary_encoding);
+    REQUIRE(rc == TILEDB_OK);
+    CHECK(dictionary_encoding == 0);
+    CHECK(tiledb_attribute_free(ctx_, attr) == TILEDB_OK);
+  }
+
+  CHECK(tiledb_array_schema_free(ctx_, array_schema) == TILEDB_OK);
+}
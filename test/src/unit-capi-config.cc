@@ -178,7 +178,19 @@ void check_save_to_file() {
 
   std::stringstream ss;
   ss << "sm.array_schema_cache_size 10000000\n";
+  ss << "sm.compression_auto_bandwidth 0\n";
+  ss << "sm.compression_auto_candidates "
+     << "NO_COMPRESSION,LZ4,ZSTD,DOUBLE_DELTA,BITPACK,GORILLA\n";
+  ss << "sm.consolidation_max_fragments 0\n";
+  ss << "sm.consolidation_memory_budget 0\n";
+  ss << "sm.consolidation_min_fragments 2\n";
+  ss << "sm.consolidation_size_ratio 0\n";
   ss << "sm.fragment_metadata_cache_size 10000000\n";
+  ss << "sm.kv_bloom_filter_bits_per_key 10\n";
+  ss << "sm.lock_free_reads false\n";
+  ss << "sm.ordered_write_buffer_num 2\n";
+  ss << "sm.query_iter_memory_budget 10000000\n";
+  ss << "sm.thread_pool_size 4\n";
   ss << "sm.tile_cache_size 10000000\n";
   ss << "vfs.s3.connect_timeout_ms 3000\n";
   ss << "vfs.s3.endpoint_override localhost:9000\n";
@@ -309,6 +321,28 @@ TEST_CASE("C API: Test config", "[capi], [config]") {
   rc = tiledb_error_free(error);
   CHECK(rc == TILEDB_OK);
 
+  // Check the AUTO compression candidates
+  rc = tiledb_config_set(
+      config, "sm.compression_auto_candidates", "LZ4,ZSTD", &error);
+  CHECK(rc == TILEDB_OK);
+  CHECK(error == nullptr);
+  rc = tiledb_config_set(
+      config, "sm.compression_auto_candidates", "LZ4,FOO", &error);
+  CHECK(rc == TILEDB_ERR);
+  CHECK(error != nullptr);
+  check_error(
+      error,
+      "[TileDB::Utils] Error: Failed to convert string to compressors; "
+      "Unknown compressor 'FOO'");
+  rc = tiledb_error_free(error);
+  CHECK(rc == TILEDB_OK);
+  rc = tiledb_config_set(
+      config, "sm.compression_auto_candidates", "LZ4,AUTO", &error);
+  CHECK(rc == TILEDB_ERR);
+  CHECK(error != nullptr);
+  rc = tiledb_error_free(error);
+  CHECK(rc == TILEDB_OK);
+
   rc = tiledb_config_free(config);
   CHECK(rc == TILEDB_OK);
 }
@@ -341,7 +375,20 @@ TEST_CASE("C API: Test config iter", "[capi], [config]") {
   std::map<std::string, std::string> all_param_values;
   all_param_values["sm.tile_cache_size"] = "100";
   all_param_values["sm.array_schema_cache_size"] = "1000";
+  all_param_values["sm.compression_auto_bandwidth"] = "0";
+  all_param_values["sm.compression_auto_candidates"] =
+      "NO_COMPRESSION,LZ4,ZSTD,DOUBLE_DELTA,BITPACK,GORILLA";
+  all_param_values["sm.consolidation_max_fragments"] = "0";
+  all_param_values["sm.consolidation_memory_budget"] = "0";
+  all_param_values["sm.consolidation_min_fragments"] = "2";
+  all_param_values["sm.consolidation_size_ratio"] = "0";
   all_param_values["sm.fragment_metadata_cache_size"] = "10000000";
+  all_param_values["sm.kv_bloom_filter_bits_per_key"] = "10";
+  all_param_values["sm.lock_free_reads"] = "false";
+  all_param_values["sm.ordered_write_buffer_num"] = "2";
+  all_param_values["sm.query_iter_memory_budget"] = "10000000";
+  all_param_values["sm.thread_pool_size"] = "4";
+  all_param_values["sm.trace_file"] = "";
   all_param_values["vfs.s3.scheme"] = "https";
   all_param_values["vfs.s3.region"] = "";
   all_param_values["vfs.s3.endpoint_override"] = "localhost:9000";
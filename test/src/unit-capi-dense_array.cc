@@ -47,6 +47,7 @@
 #include <map>
 #include <sstream>
 #include <thread>
+#include <vector>
 
 struct DenseArrayFx {
   // Constant parameters
@@ -88,6 +89,8 @@ struct DenseArrayFx {
   void check_sorted_writes(const std::string& path);
   void check_invalid_global_writes(const std::string& path);
   void check_sparse_writes(const std::string& path);
+  void check_direct_reads(const std::string& path);
+  void check_attribute_stats(const std::string& path);
   static std::string random_bucket_name(const std::string& prefix);
 
   /**
@@ -124,6 +127,7 @@ struct DenseArrayFx {
    * @param capacity The tile capacity.
    * @param cell_order The cell order.
    * @param tile_order The tile order.
+   * @param compressor The attribute compressor.
    */
   void create_dense_array_2D(
       const std::string& array_name,
@@ -135,7 +139,8 @@ struct DenseArrayFx {
       const int64_t domain_1_hi,
       const uint64_t capacity,
       const tiledb_layout_t cell_order,
-      const tiledb_layout_t tile_order);
+      const tiledb_layout_t tile_order,
+      const tiledb_compressor_t compressor = TILEDB_NO_COMPRESSION);
 
   /**
    * Generates a 2D buffer containing the cell values of a 2D array.
@@ -356,11 +361,14 @@ void DenseArrayFx::create_dense_array_2D(
     const int64_t domain_1_hi,
     const uint64_t capacity,
     const tiledb_layout_t cell_order,
-    const tiledb_layout_t tile_order) {
+    const tiledb_layout_t tile_order,
+    const tiledb_compressor_t compressor) {
   // Create attribute
   tiledb_attribute_t* a;
   int rc = tiledb_attribute_create(ctx_, &a, ATTR_NAME, ATTR_TYPE);
   REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_attribute_set_compressor(ctx_, a, compressor, -1);
+  REQUIRE(rc == TILEDB_OK);
 
   // Create dimensions
   int64_t dim_domain[] = {domain_0_lo, domain_0_hi, domain_1_lo, domain_1_hi};
@@ -970,6 +978,242 @@ void DenseArrayFx::check_sparse_writes(const std::string& path) {
   delete[] buffer_coords;
 }
 
+static uint64_t stats_value(const std::string& json, const std::string& key) {
+  auto pos = json.find("\"" + key + "\": ");
+  REQUIRE(pos != std::string::npos);
+  return std::stoull(json.substr(pos + key.size() + 4));
+}
+
+void DenseArrayFx::check_direct_reads(const std::string& path) {
+  // Parameters used in this test
+  int64_t domain_size = 100;
+  int64_t tile_extent = 10;
+  int64_t tile_cell_num = tile_extent * tile_extent;
+  int64_t cell_num = domain_size * domain_size;
+  const char* attributes[] = {ATTR_NAME};
+  const int64_t subarray[] = {0, domain_size - 1, 0, domain_size - 1};
+
+  // The cell values in the global order
+  std::vector<int> expected;
+  for (int64_t ti = 0; ti < domain_size; ti += tile_extent)
+    for (int64_t tj = 0; tj < domain_size; tj += tile_extent)
+      for (int64_t k = ti; k < ti + tile_extent; ++k)
+        for (int64_t l = tj; l < tj + tile_extent; ++l)
+          expected.push_back((int)(k * domain_size + l));
+
+  tiledb_compressor_t compressors[] = {
+      TILEDB_NO_COMPRESSION, TILEDB_ZSTD, TILEDB_RLE, TILEDB_DOUBLE_DELTA};
+  for (auto compressor : compressors) {
+    std::string array_name =
+        path + "direct_reads_array_" + std::to_string(compressor);
+    create_dense_array_2D(
+        array_name,
+        tile_extent,
+        tile_extent,
+        0,
+        domain_size - 1,
+        0,
+        domain_size - 1,
+        tile_cell_num,
+        TILEDB_ROW_MAJOR,
+        TILEDB_ROW_MAJOR,
+        compressor);
+    write_dense_array_by_tiles(
+        array_name, domain_size, domain_size, tile_extent, tile_extent);
+
+    // Read the whole array twice in the global order, where every tile is
+    // fully covered and thus read straight into the buffer
+    std::string stats[2];
+    for (int i = 0; i < 2; ++i) {
+      std::vector<int> buffer_a1(cell_num);
+      void* buffers[] = {&buffer_a1[0]};
+      uint64_t buffer_sizes[] = {cell_num * sizeof(int)};
+      tiledb_query_t* query;
+      int rc =
+          tiledb_query_create(ctx_, &query, array_name.c_str(), TILEDB_READ);
+      REQUIRE(rc == TILEDB_OK);
+      rc = tiledb_query_set_buffers(
+          ctx_, query, attributes, 1, buffers, buffer_sizes);
+      REQUIRE(rc == TILEDB_OK);
+      rc = tiledb_query_set_subarray(ctx_, query, subarray);
+      REQUIRE(rc == TILEDB_OK);
+      rc = tiledb_query_set_layout(ctx_, query, TILEDB_GLOBAL_ORDER);
+      REQUIRE(rc == TILEDB_OK);
+      rc = tiledb_query_submit(ctx_, query);
+      REQUIRE(rc == TILEDB_OK);
+      const char* json;
+      rc = tiledb_query_get_stats(ctx_, query, &json);
+      REQUIRE(rc == TILEDB_OK);
+      stats[i] = json;
+      rc = tiledb_query_free(ctx_, query);
+      REQUIRE(rc == TILEDB_OK);
+      CHECK(buffer_sizes[0] == cell_num * sizeof(int));
+      CHECK(buffer_a1 == expected);
+    }
+
+    // No cells were copied out of the tiles, also on the cache hits
+    CHECK(stats_value(stats[0], "direct_read_bytes") == cell_num * sizeof(int));
+    CHECK(stats_value(stats[0], "cell_copy_bytes") == 0);
+    CHECK(
+        stats_value(stats[1], "tile_cache_hit_num") ==
+        stats_value(stats[1], "tile_read_num"));
+    CHECK(stats_value(stats[1], "direct_read_bytes") == cell_num * sizeof(int));
+    CHECK(stats_value(stats[1], "cell_copy_bytes") == 0);
+
+    // Read with a buffer fitting one and a half tiles, so that the tiles
+    // alternate between direct reads and copies across the submissions
+    std::vector<int> result;
+    std::vector<int> buffer_a1(tile_cell_num * 3 / 2);
+    void* buffers[] = {&buffer_a1[0]};
+    uint64_t buffer_sizes[1];
+    tiledb_query_t* query;
+    int rc =
+        tiledb_query_create(ctx_, &query, array_name.c_str(), TILEDB_READ);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_query_set_subarray(ctx_, query, subarray);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_query_set_layout(ctx_, query, TILEDB_GLOBAL_ORDER);
+    REQUIRE(rc == TILEDB_OK);
+    tiledb_query_status_t status;
+    do {
+      buffer_sizes[0] = buffer_a1.size() * sizeof(int);
+      rc = tiledb_query_set_buffers(
+          ctx_, query, attributes, 1, buffers, buffer_sizes);
+      REQUIRE(rc == TILEDB_OK);
+      rc = tiledb_query_submit(ctx_, query);
+      REQUIRE(rc == TILEDB_OK);
+      REQUIRE(buffer_sizes[0] > 0);
+      result.insert(
+          result.end(),
+          buffer_a1.begin(),
+          buffer_a1.begin() + buffer_sizes[0] / sizeof(int));
+      rc = tiledb_query_get_status(ctx_, query, &status);
+      REQUIRE(rc == TILEDB_OK);
+    } while (status == TILEDB_INCOMPLETE && result.size() < expected.size());
+    CHECK(status == TILEDB_COMPLETED);
+    const char* json;
+    rc = tiledb_query_get_stats(ctx_, query, &json);
+    REQUIRE(rc == TILEDB_OK);
+    CHECK(stats_value(json, "direct_read_bytes") > 0);
+    CHECK(stats_value(json, "cell_copy_bytes") > 0);
+    rc = tiledb_query_free(ctx_, query);
+    REQUIRE(rc == TILEDB_OK);
+    CHECK(result == expected);
+  }
+}
+
+void DenseArrayFx::check_attribute_stats(const std::string& path) {
+  // Write the whole array, with value = row id * COLUMNS + col id
+  int64_t domain_size = 100;
+  int64_t tile_extent = 10;
+  std::string array_name = path + "attribute_stats_array";
+  create_dense_array_2D(
+      array_name,
+      tile_extent,
+      tile_extent,
+      0,
+      domain_size - 1,
+      0,
+      domain_size - 1,
+      tile_extent * tile_extent,
+      TILEDB_ROW_MAJOR,
+      TILEDB_ROW_MAJOR);
+  write_dense_array_by_tiles(
+      array_name, domain_size, domain_size, tile_extent, tile_extent);
+
+  int min, max;
+  int64_t sum;
+  uint64_t count, null_count;
+  int has_stats;
+  int rc = tiledb_array_get_attribute_stats(
+      ctx_,
+      array_name.c_str(),
+      ATTR_NAME,
+      &min,
+      &max,
+      &sum,
+      &count,
+      &null_count,
+      &has_stats);
+  REQUIRE(rc == TILEDB_OK);
+  REQUIRE(has_stats == 1);
+  CHECK(min == 0);
+  CHECK(max == 9999);
+  CHECK(sum == 49995000);
+  CHECK(count == 10000);
+  CHECK(null_count == 0);
+
+  // Overwrite a subarray partially covering the first tile, whose other
+  // cells are written as empty in the new fragment
+  int64_t subarray[] = {0, 4, 0, 4};
+  int buffer[25];
+  for (int i = 0; i < 25; ++i)
+    buffer[i] = -1 - i;
+  uint64_t buffer_sizes[] = {sizeof(buffer)};
+  write_dense_subarray_2D(
+      array_name,
+      subarray,
+      TILEDB_WRITE,
+      TILEDB_ROW_MAJOR,
+      buffer,
+      buffer_sizes);
+  rc = tiledb_array_get_attribute_stats(
+      ctx_,
+      array_name.c_str(),
+      ATTR_NAME,
+      &min,
+      &max,
+      &sum,
+      &count,
+      &null_count,
+      &has_stats);
+  REQUIRE(rc == TILEDB_OK);
+  REQUIRE(has_stats == 1);
+  CHECK(min == -25);
+  CHECK(max == 9999);
+  CHECK(sum == 49995000 - 325);
+  CHECK(count == 10025);
+  CHECK(null_count == 75);
+
+  // Consolidation leaves only the current values
+  rc = tiledb_array_consolidate(ctx_, array_name.c_str());
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_get_attribute_stats(
+      ctx_,
+      array_name.c_str(),
+      ATTR_NAME,
+      &min,
+      &max,
+      &sum,
+      &count,
+      &null_count,
+      &has_stats);
+  REQUIRE(rc == TILEDB_OK);
+  REQUIRE(has_stats == 1);
+  int64_t overwritten_sum = 0;
+  for (int64_t i = 0; i < 5; ++i)
+    for (int64_t j = 0; j < 5; ++j)
+      overwritten_sum += i * domain_size + j;
+  CHECK(min == -25);
+  CHECK(max == 9999);
+  CHECK(sum == 49995000 - 325 - overwritten_sum);
+  CHECK(count == 10000);
+  CHECK(null_count == 0);
+
+  // Invalid attribute
+  rc = tiledb_array_get_attribute_stats(
+      ctx_,
+      array_name.c_str(),
+      "foo",
+      &min,
+      &max,
+      &sum,
+      &count,
+      &null_count,
+      &has_stats);
+  CHECK(rc == TILEDB_ERR);
+}
+
 std::string DenseArrayFx::random_bucket_name(const std::string& prefix) {
   std::stringstream ss;
   ss << prefix << "-" << std::this_thread::get_id() << "-"
@@ -1058,3 +1302,121 @@ TEST_CASE_METHOD(
     remove_temp_dir(FILE_URI_PREFIX + FILE_TEMP_DIR);
   }
 }
+
+TEST_CASE_METHOD(
+    DenseArrayFx, "C API: Test dense array, direct reads", "[capi], [dense]") {
+  if (supports_s3_) {
+    // S3
+    create_temp_dir(S3_TEMP_DIR);
+    check_direct_reads(S3_TEMP_DIR);
+    remove_temp_dir(S3_TEMP_DIR);
+  } else if (supports_hdfs_) {
+    // HDFS
+    create_temp_dir(HDFS_TEMP_DIR);
+    check_direct_reads(HDFS_TEMP_DIR);
+    remove_temp_dir(HDFS_TEMP_DIR);
+  } else {
+    // File
+    create_temp_dir(FILE_URI_PREFIX + FILE_TEMP_DIR);
+    check_direct_reads(FILE_URI_PREFIX + FILE_TEMP_DIR);
+    remove_temp_dir(FILE_URI_PREFIX + FILE_TEMP_DIR);
+  }
+}
+
+TEST_CASE_METHOD(
+    DenseArrayFx,
+    "C API: Test dense array, attribute statistics",
+    "[capi], [dense], [tile-stats]") {
+  if (supports_s3_) {
+    // S3
+    create_temp_dir(S3_TEMP_DIR);
+    check_attribute_stats(S3_TEMP_DIR);
+    remove_temp_dir(S3_TEMP_DIR);
+  } else if (supports_hdfs_) {
+    // HDFS
+    create_temp_dir(HDFS_TEMP_DIR);
+    check_attribute_stats(HDFS_TEMP_DIR);
+    remove_temp_dir(HDFS_TEMP_DIR);
+  } else {
+    // File
+    create_temp_dir(FILE_URI_PREFIX + FILE_TEMP_DIR);
+    check_attribute_stats(FILE_URI_PREFIX + FILE_TEMP_DIR);
+    remove_temp_dir(FILE_URI_PREFIX + FILE_TEMP_DIR);
+  }
+}
+
+TEST_CASE_METHOD(
+    DenseArrayFx,
+    "C API: Test dense array, read from version 1.2.0",
+    "[capi], [dense], [backwards-compat]") {
+  // Array and fragment written by version 1.2.0, whose offsets tiles are
+  // stored without the offsets filters
+  std::string array_name =
+      std::string(TILEDB_TEST_INPUTS_DIR) + "/arrays/dense_array_v1_2_0";
+  const char* attributes[] = {"a1", "a2"};
+
+  // Read the whole array in global order, as it was written
+  int c_buffer_a1[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+  uint64_t c_buffer_a2[] = {
+      0, 1, 3, 6, 10, 11, 13, 16, 20, 21, 23, 26, 30, 31, 33, 36};
+  char c_buffer_var_a2[] = "abbcccddddeffggghhhhijjkkkllllmnnooopppp";
+  int buffer_a1[16];
+  uint64_t buffer_a2[16];
+  char buffer_var_a2[40];
+  void* buffers[] = {buffer_a1, buffer_a2, buffer_var_a2};
+  uint64_t buffer_sizes[] = {
+      sizeof(buffer_a1), sizeof(buffer_a2), sizeof(buffer_var_a2)};
+  tiledb_query_t* query;
+  int rc = tiledb_query_create(ctx_, &query, array_name.c_str(), TILEDB_READ);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_buffers(
+      ctx_, query, attributes, 2, buffers, buffer_sizes);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_layout(ctx_, query, TILEDB_GLOBAL_ORDER);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_submit(ctx_, query);
+  REQUIRE(rc == TILEDB_OK);
+  tiledb_query_status_t status;
+  rc = tiledb_query_get_status(ctx_, query, &status);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(status == TILEDB_COMPLETED);
+  CHECK(tiledb_query_free(ctx_, query) == TILEDB_OK);
+
+  REQUIRE(buffer_sizes[0] == sizeof(c_buffer_a1));
+  REQUIRE(buffer_sizes[1] == sizeof(c_buffer_a2));
+  REQUIRE(buffer_sizes[2] == sizeof(c_buffer_var_a2) - 1);
+  CHECK(!memcmp(buffer_a1, c_buffer_a1, sizeof(c_buffer_a1)));
+  CHECK(!memcmp(buffer_a2, c_buffer_a2, sizeof(c_buffer_a2)));
+  CHECK(!memcmp(buffer_var_a2, c_buffer_var_a2, sizeof(c_buffer_var_a2) - 1));
+
+  // Read a subarray spanning all four tiles in row-major order
+  uint64_t subarray[] = {2, 3, 2, 3};
+  int c_sub_a1[] = {3, 6, 9, 12};
+  uint64_t c_sub_a2[] = {0, 4, 7, 9};
+  char c_sub_var_a2[] = "ddddgggjjm";
+  int sub_a1[4];
+  uint64_t sub_a2[4];
+  char sub_var_a2[10];
+  void* sub_buffers[] = {sub_a1, sub_a2, sub_var_a2};
+  uint64_t sub_buffer_sizes[] = {
+      sizeof(sub_a1), sizeof(sub_a2), sizeof(sub_var_a2)};
+  rc = tiledb_query_create(ctx_, &query, array_name.c_str(), TILEDB_READ);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_subarray(ctx_, query, subarray);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_buffers(
+      ctx_, query, attributes, 2, sub_buffers, sub_buffer_sizes);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_layout(ctx_, query, TILEDB_ROW_MAJOR);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_submit(ctx_, query);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(tiledb_query_free(ctx_, query) == TILEDB_OK);
+
+  REQUIRE(sub_buffer_sizes[0] == sizeof(c_sub_a1));
+  REQUIRE(sub_buffer_sizes[1] == sizeof(c_sub_a2));
+  REQUIRE(sub_buffer_sizes[2] == sizeof(c_sub_var_a2) - 1);
+  CHECK(!memcmp(sub_a1, c_sub_a1, sizeof(c_sub_a1)));
+  CHECK(!memcmp(sub_a2, c_sub_a2, sizeof(c_sub_a2)));
+  CHECK(!memcmp(sub_var_a2, c_sub_var_a2, sizeof(c_sub_var_a2) - 1));
+}
@@ -75,6 +75,7 @@ struct DenseVectorFx {
   void create_dense_vector(const std::string& path);
   void check_read(const std::string& path, tiledb_layout_t layout);
   void check_update(const std::string& path);
+  void check_est_read_buffer_sizes(const std::string& path);
   void create_temp_dir(const std::string& path);
   void remove_temp_dir(const std::string& path);
   static std::string random_bucket_name(const std::string& prefix);
@@ -302,6 +303,24 @@ void DenseVectorFx::check_update(const std::string& path) {
   CHECK((buffer[0] == 9 && buffer[1] == 8 && buffer[2] == 7));
 }
 
+void DenseVectorFx::check_est_read_buffer_sizes(const std::string& path) {
+  const char* attributes[] = {ATTR_NAME};
+  uint64_t subarray[] = {0, 2};
+  uint64_t est_buffer_sizes[1];
+  uint64_t max_buffer_sizes[1];
+  int rc = tiledb_array_compute_est_read_buffer_sizes(
+      ctx_,
+      path.c_str(),
+      subarray,
+      attributes,
+      1,
+      est_buffer_sizes,
+      max_buffer_sizes);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(est_buffer_sizes[0] == 3 * sizeof(int64_t));
+  CHECK(max_buffer_sizes[0] >= est_buffer_sizes[0]);
+}
+
 TEST_CASE_METHOD(
     DenseVectorFx, "C API: Test 1d dense vector", "[capi], [dense-vector]") {
   std::string vector_name;
@@ -313,6 +332,7 @@ TEST_CASE_METHOD(
     create_dense_vector(vector_name);
     check_read(vector_name, TILEDB_ROW_MAJOR);
     check_read(vector_name, TILEDB_COL_MAJOR);
+    check_est_read_buffer_sizes(vector_name);
     check_update(vector_name);
     remove_temp_dir(S3_TEMP_DIR);
   } else if (supports_hdfs_) {
@@ -322,6 +342,7 @@ TEST_CASE_METHOD(
     create_dense_vector(vector_name);
     check_read(vector_name, TILEDB_ROW_MAJOR);
     check_read(vector_name, TILEDB_COL_MAJOR);
+    check_est_read_buffer_sizes(vector_name);
     check_update(vector_name);
     remove_temp_dir(HDFS_TEMP_DIR);
   } else {
@@ -331,6 +352,7 @@ TEST_CASE_METHOD(
     create_dense_vector(vector_name);
     check_read(vector_name, TILEDB_ROW_MAJOR);
     check_read(vector_name, TILEDB_COL_MAJOR);
+    check_est_read_buffer_sizes(vector_name);
     check_update(vector_name);
     remove_temp_dir(FILE_URI_PREFIX + FILE_TEMP_DIR);
   }
@@ -39,7 +39,11 @@
 #include "tiledb.h"
 #include "utils.h"
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <set>
+#include <sstream>
 #include <thread>
 
 struct KVFx {
@@ -90,17 +94,25 @@ struct KVFx {
   KVFx();
   ~KVFx();
   void check_single_read(const std::string& path);
+  void check_batch_read(const std::string& path);
   void check_read_on_attribute_subset(const std::string& path);
   void check_iter(const std::string& path);
   void check_kv_item();
   void check_kv_item(tiledb_kv_item_t* kv_item);
   void check_interleaved_read_write(const std::string& path);
+  void check_items(const std::string& path, int item_num);
   void check_write(const std::string& path);
   void create_kv(const std::string& path);
   void create_temp_dir(const std::string& path);
+  bool has_item(const std::string& path, int key);
   void remove_temp_dir(const std::string& path);
+  std::string read_fragment_manifest(const std::string& path);
+  std::set<std::string> read_fragments(const std::string& path);
   static std::string random_bucket_name(const std::string& prefix);
   void set_supported_fs();
+  void write_fragment_manifest(
+      const std::string& path, const std::string& manifest);
+  void write_items(const std::string& path, int first_key, int item_num);
 };
 
 KVFx::KVFx() {
@@ -572,6 +584,58 @@ void KVFx::check_single_read(const std::string& path) {
   REQUIRE(rc == TILEDB_OK);
 }
 
+void KVFx::check_batch_read(const std::string& path) {
+  // Open key-value store
+  const char* attributes[] = {ATTR_1, ATTR_2, ATTR_3};
+  tiledb_kv_t* kv;
+  int rc = tiledb_kv_open(ctx_, &kv, path.c_str(), attributes, 3);
+  REQUIRE(rc == TILEDB_OK);
+
+  // Prepare keys, including an invalid and a duplicate one
+  const char* invalid_key = "invalid";
+  const void* keys[] = {KEY4, invalid_key, &KEY1, KEY3, &KEY2, &KEY1};
+  tiledb_datatype_t key_types[] = {TILEDB_CHAR,
+                                   TILEDB_CHAR,
+                                   TILEDB_INT32,
+                                   TILEDB_FLOAT64,
+                                   TILEDB_FLOAT32,
+                                   TILEDB_INT32};
+  uint64_t key_sizes[] = {strlen(KEY4) + 1,
+                          strlen(invalid_key) + 1,
+                          sizeof(int),
+                          2 * sizeof(double),
+                          sizeof(float),
+                          sizeof(int)};
+
+  // Get the items in a single batch
+  tiledb_kv_item_t* kv_items[6];
+  rc = tiledb_kv_get_items(ctx_, kv, kv_items, keys, key_types, key_sizes, 6);
+  REQUIRE(rc == TILEDB_OK);
+
+  // Check items, which must be in the order of the keys
+  const void* key;
+  tiledb_datatype_t key_type;
+  uint64_t key_size;
+  CHECK(kv_items[1] == nullptr);
+  for (int i = 0; i < 6; ++i) {
+    if (i == 1)
+      continue;
+    REQUIRE(kv_items[i] != nullptr);
+    rc = tiledb_kv_item_get_key(ctx_, kv_items[i], &key, &key_type, &key_size);
+    REQUIRE(rc == TILEDB_OK);
+    CHECK(key_type == key_types[i]);
+    CHECK(key_size == key_sizes[i]);
+    CHECK(!memcmp(key, keys[i], key_size));
+    check_kv_item(kv_items[i]);
+    rc = tiledb_kv_item_free(ctx_, kv_items[i]);
+    REQUIRE(rc == TILEDB_OK);
+  }
+
+  // Close key-value store
+  rc = tiledb_kv_close(ctx_, kv);
+  REQUIRE(rc == TILEDB_OK);
+}
+
 void KVFx::check_read_on_attribute_subset(const std::string& path) {
   // Open key-value store
   const char* attributes[] = {ATTR_1};
@@ -891,6 +955,141 @@ void KVFx::check_iter(const std::string& path) {
   REQUIRE(rc == TILEDB_OK);
 }
 
+std::string KVFx::read_fragment_manifest(const std::string& path) {
+  auto manifest_uri = path + "/__fragment_manifest.tdb";
+  int is_file = 0;
+  int rc = tiledb_vfs_is_file(ctx_, vfs_, manifest_uri.c_str(), &is_file);
+  REQUIRE(rc == TILEDB_OK);
+  if (!is_file)
+    return "";
+
+  uint64_t size;
+  rc = tiledb_vfs_file_size(ctx_, vfs_, manifest_uri.c_str(), &size);
+  REQUIRE(rc == TILEDB_OK);
+  std::string manifest(size, '\0');
+  tiledb_vfs_fh_t* fh;
+  rc = tiledb_vfs_open(ctx_, vfs_, manifest_uri.c_str(), TILEDB_VFS_READ, &fh);
+  REQUIRE(rc == TILEDB_OK);
+  if (size != 0) {
+    rc = tiledb_vfs_read(ctx_, fh, 0, &manifest[0], size);
+    REQUIRE(rc == TILEDB_OK);
+  }
+  rc = tiledb_vfs_close(ctx_, fh);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_vfs_fh_free(ctx_, fh);
+  REQUIRE(rc == TILEDB_OK);
+
+  return manifest;
+}
+
+std::set<std::string> KVFx::read_fragments(const std::string& path) {
+  std::set<std::string> fragments;
+  std::stringstream manifest(read_fragment_manifest(path));
+  std::string op, type, name;
+  while (manifest >> op) {
+    if (op == "add") {
+      manifest >> type >> name;
+      fragments.insert(name);
+    } else {
+      manifest >> name;
+      fragments.erase(name);
+    }
+  }
+
+  return fragments;
+}
+
+void KVFx::write_fragment_manifest(
+    const std::string& path, const std::string& manifest) {
+  auto manifest_uri = path + "/__fragment_manifest.tdb";
+  int rc = tiledb_vfs_remove_file(ctx_, vfs_, manifest_uri.c_str());
+  REQUIRE(rc == TILEDB_OK);
+  tiledb_vfs_fh_t* fh;
+  rc = tiledb_vfs_open(ctx_, vfs_, manifest_uri.c_str(), TILEDB_VFS_WRITE, &fh);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_vfs_write(ctx_, fh, manifest.data(), manifest.size());
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_vfs_close(ctx_, fh);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_vfs_fh_free(ctx_, fh);
+  REQUIRE(rc == TILEDB_OK);
+}
+
+void KVFx::write_items(const std::string& path, int first_key, int item_num) {
+  tiledb_kv_t* kv;
+  int rc = tiledb_kv_open(ctx_, &kv, path.c_str(), nullptr, 0);
+  REQUIRE(rc == TILEDB_OK);
+
+  // Every item stores its key in the first attribute
+  for (int key = first_key; key < first_key + item_num; ++key) {
+    tiledb_kv_item_t* kv_item;
+    rc = tiledb_kv_item_create(ctx_, &kv_item);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_kv_item_set_key(ctx_, kv_item, &key, TILEDB_INT32, sizeof(int));
+    CHECK(rc == TILEDB_OK);
+    rc = tiledb_kv_item_set_value(
+        ctx_, kv_item, ATTR_1, &key, TILEDB_INT32, sizeof(int));
+    CHECK(rc == TILEDB_OK);
+    rc = tiledb_kv_item_set_value(
+        ctx_, kv_item, ATTR_2, KEY1_A2, TILEDB_CHAR, strlen(KEY1_A2) + 1);
+    CHECK(rc == TILEDB_OK);
+    rc = tiledb_kv_item_set_value(
+        ctx_, kv_item, ATTR_3, KEY1_A3, TILEDB_FLOAT32, 2 * sizeof(float));
+    CHECK(rc == TILEDB_OK);
+    rc = tiledb_kv_add_item(ctx_, kv, kv_item);
+    CHECK(rc == TILEDB_OK);
+    rc = tiledb_kv_item_free(ctx_, kv_item);
+    REQUIRE(rc == TILEDB_OK);
+  }
+
+  rc = tiledb_kv_close(ctx_, kv);
+  REQUIRE(rc == TILEDB_OK);
+}
+
+void KVFx::check_items(const std::string& path, int item_num) {
+  tiledb_kv_t* kv;
+  int rc = tiledb_kv_open(ctx_, &kv, path.c_str(), nullptr, 0);
+  REQUIRE(rc == TILEDB_OK);
+
+  const void* a1;
+  tiledb_datatype_t a1_type;
+  uint64_t a1_size;
+  for (int key = 0; key < item_num; ++key) {
+    tiledb_kv_item_t* kv_item;
+    rc = tiledb_kv_get_item(
+        ctx_, kv, &kv_item, &key, TILEDB_INT32, sizeof(int));
+    REQUIRE(rc == TILEDB_OK);
+    REQUIRE(kv_item != nullptr);
+    rc = tiledb_kv_item_get_value(
+        ctx_, kv_item, ATTR_1, &a1, &a1_type, &a1_size);
+    CHECK(rc == TILEDB_OK);
+    CHECK(*(int*)a1 == key);
+    rc = tiledb_kv_item_free(ctx_, kv_item);
+    REQUIRE(rc == TILEDB_OK);
+  }
+
+  rc = tiledb_kv_close(ctx_, kv);
+  REQUIRE(rc == TILEDB_OK);
+}
+
+bool KVFx::has_item(const std::string& path, int key) {
+  tiledb_kv_t* kv;
+  int rc = tiledb_kv_open(ctx_, &kv, path.c_str(), nullptr, 0);
+  REQUIRE(rc == TILEDB_OK);
+  tiledb_kv_item_t* kv_item;
+  rc = tiledb_kv_get_item(ctx_, kv, &kv_item, &key, TILEDB_INT32, sizeof(int));
+  REQUIRE(rc == TILEDB_OK);
+  bool found = (kv_item != nullptr);
+  if (found) {
+    rc = tiledb_kv_item_free(ctx_, kv_item);
+    REQUIRE(rc == TILEDB_OK);
+  }
+  rc = tiledb_kv_close(ctx_, kv);
+  REQUIRE(rc == TILEDB_OK);
+
+  return found;
+}
+
 TEST_CASE_METHOD(KVFx, "C API: Test key-value", "[capi], [kv]") {
   std::string array_name;
 
@@ -901,6 +1100,7 @@ TEST_CASE_METHOD(KVFx, "C API: Test key-value", "[capi], [kv]") {
     create_kv(array_name);
     check_write(array_name);
     check_single_read(array_name);
+    check_batch_read(array_name);
     check_read_on_attribute_subset(array_name);
     check_iter(array_name);
     check_interleaved_read_write(array_name);
@@ -911,6 +1111,7 @@ TEST_CASE_METHOD(KVFx, "C API: Test key-value", "[capi], [kv]") {
     create_kv(array_name);
     check_write(array_name);
     check_single_read(array_name);
+    check_batch_read(array_name);
     check_read_on_attribute_subset(array_name);
     check_iter(array_name);
     check_interleaved_read_write(array_name);
@@ -923,9 +1124,292 @@ TEST_CASE_METHOD(KVFx, "C API: Test key-value", "[capi], [kv]") {
     check_kv_item();
     check_write(array_name);
     check_single_read(array_name);
+    check_batch_read(array_name);
     check_read_on_attribute_subset(array_name);
     check_iter(array_name);
     check_interleaved_read_write(array_name);
     remove_temp_dir(FILE_URI_PREFIX + FILE_TEMP_DIR);
   }
 }
+
+TEST_CASE_METHOD(
+    KVFx,
+    "C API: Test key-value batch reads across tiles",
+    "[capi], [kv], [kv-batch]") {
+  create_temp_dir(FILE_URI_PREFIX + FILE_TEMP_DIR);
+  std::string path = FILE_URI_PREFIX + FILE_TEMP_DIR + KV_NAME;
+  create_kv(path);
+
+  // Write two fragments, each spanning multiple data tiles
+  const int item_num = 25000;
+  tiledb_kv_t* kv;
+  int rc = tiledb_kv_open(ctx_, &kv, path.c_str(), nullptr, 0);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_kv_set_max_items(ctx_, kv, item_num);
+  REQUIRE(rc == TILEDB_OK);
+  float a3[] = {0.1f, 0.2f};
+  for (int key = 0; key < 2 * item_num; ++key) {
+    tiledb_kv_item_t* kv_item;
+    rc = tiledb_kv_item_create(ctx_, &kv_item);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_kv_item_set_key(ctx_, kv_item, &key, TILEDB_INT32, sizeof(int));
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_kv_item_set_value(
+        ctx_, kv_item, ATTR_1, &key, TILEDB_INT32, sizeof(int));
+    REQUIRE(rc == TILEDB_OK);
+    auto a2 = std::to_string(key);
+    rc = tiledb_kv_item_set_value(
+        ctx_, kv_item, ATTR_2, a2.c_str(), TILEDB_CHAR, a2.size() + 1);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_kv_item_set_value(
+        ctx_, kv_item, ATTR_3, a3, TILEDB_FLOAT32, sizeof(a3));
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_kv_add_item(ctx_, kv, kv_item);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_kv_item_free(ctx_, kv_item);
+    REQUIRE(rc == TILEDB_OK);
+  }
+  rc = tiledb_kv_close(ctx_, kv);
+  REQUIRE(rc == TILEDB_OK);
+
+  // Get every 7th key, plus keys that do not exist
+  std::vector<int> keys;
+  for (int key = 2 * item_num + 100; key >= 0; key -= 7)
+    keys.push_back(key);
+  auto key_num = (unsigned)keys.size();
+  std::vector<const void*> key_ptrs;
+  for (const auto& key : keys)
+    key_ptrs.push_back(&key);
+  std::vector<tiledb_datatype_t> key_types(key_num, TILEDB_INT32);
+  std::vector<uint64_t> key_sizes(key_num, sizeof(int));
+  std::vector<tiledb_kv_item_t*> kv_items(key_num);
+  rc = tiledb_kv_open(ctx_, &kv, path.c_str(), nullptr, 0);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_kv_get_items(
+      ctx_,
+      kv,
+      kv_items.data(),
+      key_ptrs.data(),
+      key_types.data(),
+      key_sizes.data(),
+      key_num);
+  REQUIRE(rc == TILEDB_OK);
+
+  // Check items
+  const void* value;
+  tiledb_datatype_t value_type;
+  uint64_t value_size;
+  for (unsigned i = 0; i < key_num; ++i) {
+    if (keys[i] >= 2 * item_num) {
+      CHECK(kv_items[i] == nullptr);
+      continue;
+    }
+    REQUIRE(kv_items[i] != nullptr);
+    rc = tiledb_kv_item_get_value(
+        ctx_, kv_items[i], ATTR_1, &value, &value_type, &value_size);
+    REQUIRE(rc == TILEDB_OK);
+    CHECK(*(const int*)value == keys[i]);
+    rc = tiledb_kv_item_get_value(
+        ctx_, kv_items[i], ATTR_2, &value, &value_type, &value_size);
+    REQUIRE(rc == TILEDB_OK);
+    CHECK(std::string((const char*)value) == std::to_string(keys[i]));
+    rc = tiledb_kv_item_free(ctx_, kv_items[i]);
+    REQUIRE(rc == TILEDB_OK);
+  }
+
+  rc = tiledb_kv_close(ctx_, kv);
+  REQUIRE(rc == TILEDB_OK);
+  remove_temp_dir(FILE_URI_PREFIX + FILE_TEMP_DIR);
+}
+
+TEST_CASE_METHOD(
+    KVFx,
+    "C API: Test key-value fragment manifest",
+    "[capi], [kv], [fragment-manifest]") {
+  create_temp_dir(FILE_URI_PREFIX + FILE_TEMP_DIR);
+  std::string path = FILE_URI_PREFIX + FILE_TEMP_DIR + KV_NAME;
+  create_kv(path);
+  CHECK(read_fragment_manifest(path).empty());
+
+  // Writes and consolidation are recorded in the manifest
+  check_write(path);
+  auto manifest = read_fragment_manifest(path);
+  CHECK(manifest.find("add s __") != std::string::npos);
+  CHECK(manifest.find("del __") != std::string::npos);
+  check_single_read(path);
+
+  // Reads recover from a missing manifest by listing the array directory
+  auto manifest_uri = path + "/__fragment_manifest.tdb";
+  int rc = tiledb_vfs_remove_file(ctx_, vfs_, manifest_uri.c_str());
+  REQUIRE(rc == TILEDB_OK);
+  check_single_read(path);
+
+  // The next write seeds the manifest with the fragments in the array
+  // directory, which already include the new fragment, and then appends
+  // the record of the new fragment
+  check_interleaved_read_write(path);
+  manifest = read_fragment_manifest(path);
+  CHECK(std::count(manifest.begin(), manifest.end(), '\n') == 3);
+  CHECK(manifest.find("del __") == std::string::npos);
+  check_single_read(path);
+
+  remove_temp_dir(FILE_URI_PREFIX + FILE_TEMP_DIR);
+}
+
+TEST_CASE_METHOD(
+    KVFx,
+    "C API: Test key-value fragments missing from the manifest",
+    "[capi], [kv], [fragment-manifest]") {
+  create_temp_dir(FILE_URI_PREFIX + FILE_TEMP_DIR);
+  std::string path = FILE_URI_PREFIX + FILE_TEMP_DIR + KV_NAME;
+  create_kv(path);
+  write_items(path, 0, 10);
+  auto manifest = read_fragment_manifest(path);
+  write_items(path, 10, 10);
+  REQUIRE(read_fragments(path).size() == 2);
+
+  // Drop the record of the second fragment, as if the writer crashed right
+  // before committing it. The fragment is then not part of the array.
+  write_fragment_manifest(path, manifest);
+  REQUIRE(read_fragments(path).size() == 1);
+  check_items(path, 10);
+  CHECK(!has_item(path, 10));
+
+  // Record a fragment that no longer exists, so that the array directory is
+  // listed upon opening the array. Only the committed fragments are loaded.
+  write_fragment_manifest(path, manifest + "add s __0_0\n");
+  REQUIRE(read_fragments(path).size() == 2);
+  check_items(path, 10);
+  CHECK(!has_item(path, 10));
+
+  remove_temp_dir(FILE_URI_PREFIX + FILE_TEMP_DIR);
+}
+
+TEST_CASE_METHOD(
+    KVFx,
+    "C API: Test key-value fragments deleted from the manifest",
+    "[capi], [kv], [fragment-manifest]") {
+  create_temp_dir(FILE_URI_PREFIX + FILE_TEMP_DIR);
+  std::string path = FILE_URI_PREFIX + FILE_TEMP_DIR + KV_NAME;
+  create_kv(path);
+  write_items(path, 0, 10);
+  auto first_fragment = *read_fragments(path).begin();
+  write_items(path, 10, 10);
+  auto manifest = read_fragment_manifest(path);
+  REQUIRE(read_fragments(path).size() == 2);
+
+  // Delete the first fragment from the manifest but not from the array
+  // directory, as consolidation does before the current readers are done.
+  // Opening the array in the meantime must not load the fragment.
+  manifest += "del " + first_fragment + "\n";
+  write_fragment_manifest(path, manifest);
+  CHECK(!has_item(path, 0));
+  CHECK(has_item(path, 10));
+
+  // The same holds when the array directory is listed upon opening
+  write_fragment_manifest(path, manifest + "add s __0_0\n");
+  CHECK(!has_item(path, 0));
+  CHECK(has_item(path, 10));
+
+  remove_temp_dir(FILE_URI_PREFIX + FILE_TEMP_DIR);
+}
+
+TEST_CASE_METHOD(
+    KVFx,
+    "C API: Test key-value fragment metadata consolidation",
+    "[capi], [kv], [fragment-metadata]") {
+  create_temp_dir(FILE_URI_PREFIX + FILE_TEMP_DIR);
+  std::string path = FILE_URI_PREFIX + FILE_TEMP_DIR + KV_NAME;
+  create_kv(path);
+
+  // Consolidation also consolidates the fragment metadata
+  auto consolidated_uri = path + "/__consolidated_fragment_metadata.tdb";
+  int is_file = 0;
+  check_write(path);
+  int rc = tiledb_vfs_is_file(ctx_, vfs_, consolidated_uri.c_str(), &is_file);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(is_file);
+
+  // Fragments written afterwards are loaded separately
+  check_interleaved_read_write(path);
+  check_single_read(path);
+  rc = tiledb_kv_consolidate_metadata(ctx_, path.c_str());
+  REQUIRE(rc == TILEDB_OK);
+
+  // Remove the metadata of the individual fragments, as listed in the
+  // manifest, and read with a fresh context so that nothing is cached
+  auto fragments = read_fragments(path);
+  CHECK(fragments.size() == 2);
+  for (const auto& fragment : fragments) {
+    auto metadata_uri = path + "/" + fragment + "/__fragment_metadata.tdb";
+    rc = tiledb_vfs_remove_file(ctx_, vfs_, metadata_uri.c_str());
+    REQUIRE(rc == TILEDB_OK);
+  }
+  tiledb_ctx_t* ctx = ctx_;
+  REQUIRE(tiledb_ctx_create(&ctx_, nullptr) == TILEDB_OK);
+  check_single_read(path);
+  check_batch_read(path);
+  CHECK(tiledb_ctx_free(ctx_) == TILEDB_OK);
+  ctx_ = ctx;
+
+  remove_temp_dir(FILE_URI_PREFIX + FILE_TEMP_DIR);
+}
+
+TEST_CASE_METHOD(
+    KVFx,
+    "C API: Test key-value size-tiered consolidation",
+    "[capi], [kv], [consolidation]") {
+  create_temp_dir(FILE_URI_PREFIX + FILE_TEMP_DIR);
+  std::string path = FILE_URI_PREFIX + FILE_TEMP_DIR + KV_NAME;
+  create_kv(path);
+
+  // Merge at most 2 fragments at a time, which are at most 4x apart in size
+  tiledb_config_t* config = nullptr;
+  tiledb_error_t* error = nullptr;
+  REQUIRE(tiledb_config_create(&config, &error) == TILEDB_OK);
+  REQUIRE(
+      tiledb_config_set(config, "sm.consolidation_size_ratio", "4", &error) ==
+      TILEDB_OK);
+  REQUIRE(
+      tiledb_config_set(
+          config, "sm.consolidation_max_fragments", "2", &error) == TILEDB_OK);
+  tiledb_ctx_t* ctx = ctx_;
+  REQUIRE(tiledb_ctx_create(&ctx_, config) == TILEDB_OK);
+  REQUIRE(tiledb_config_free(config) == TILEDB_OK);
+
+  // Write one large fragment followed by three small ones, sleeping in
+  // between so that the fragments get distinct timestamps
+  write_items(path, 0, 1000);
+  auto large_fragment = *read_fragments(path).begin();
+  for (int i = 0; i < 3; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    write_items(path, 1000 + i, 1);
+  }
+  CHECK(read_fragments(path).size() == 4);
+
+  // Only the small fragments get merged, two at a time
+  int rc = tiledb_kv_consolidate(ctx_, path.c_str());
+  REQUIRE(rc == TILEDB_OK);
+  auto fragments = read_fragments(path);
+  CHECK(fragments.size() == 3);
+  CHECK(fragments.count(large_fragment) == 1);
+  check_items(path, 1003);
+
+  rc = tiledb_kv_consolidate(ctx_, path.c_str());
+  REQUIRE(rc == TILEDB_OK);
+  fragments = read_fragments(path);
+  CHECK(fragments.size() == 2);
+  CHECK(fragments.count(large_fragment) == 1);
+  check_items(path, 1003);
+
+  // The remaining fragments are too far apart in size
+  rc = tiledb_kv_consolidate(ctx_, path.c_str());
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(read_fragments(path) == fragments);
+  check_items(path, 1003);
+
+  CHECK(tiledb_ctx_free(ctx_) == TILEDB_OK);
+  ctx_ = ctx;
+
+  remove_temp_dir(FILE_URI_PREFIX + FILE_TEMP_DIR);
+}
@@ -0,0 +1,342 @@
+/**
+ * @file   unit-capi-query_iter.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Tests of C API for query iterators.
+ */
+
+#include "catch.hpp"
+#ifdef _WIN32
+#include "win_filesystem.h"
+#else
+#include "posix_filesystem.h"
+#endif
+#include "tiledb.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct QueryIterFx {
+  const char* A1_NAME = "a1";
+  const char* A2_NAME = "a2";
+  const char* DIM_NAME = "d";
+  const int64_t CELL_NUM = 100;
+#ifdef _WIN32
+  const std::string FILE_URI_PREFIX = "";
+  const std::string FILE_TEMP_DIR =
+      tiledb::win::current_dir() + "\\tiledb_test\\";
+#else
+  const std::string FILE_URI_PREFIX = "file://";
+  const std::string FILE_TEMP_DIR =
+      tiledb::posix::current_dir() + "/tiledb_test/";
+#endif
+  const std::string DENSE_ARRAY = "query_iter_dense";
+  const std::string SPARSE_ARRAY = "query_iter_sparse";
+
+  // TileDB context
+  tiledb_ctx_t* ctx_;
+  tiledb_vfs_t* vfs_;
+
+  // Functions
+  QueryIterFx();
+  ~QueryIterFx();
+  void create_array(const std::string& path, tiledb_array_type_t type);
+  void write_array(const std::string& path, tiledb_array_type_t type);
+  void check_read(
+      const std::string& path,
+      const int64_t* subarray,
+      tiledb_layout_t layout,
+      bool coords);
+  void create_temp_dir(const std::string& path);
+  void remove_temp_dir(const std::string& path);
+  static std::string a2_value(int64_t i);
+};
+
+QueryIterFx::QueryIterFx() {
+  // Create TileDB context with a small iterator memory budget, so that the
+  // results are retrieved in several batches
+  tiledb_config_t* config = nullptr;
+  tiledb_error_t* error = nullptr;
+  REQUIRE(tiledb_config_create(&config, &error) == TILEDB_OK);
+  REQUIRE(error == nullptr);
+  REQUIRE(
+      tiledb_config_set(config, "sm.query_iter_memory_budget", "200", &error) ==
+      TILEDB_OK);
+  REQUIRE(error == nullptr);
+  REQUIRE(tiledb_ctx_create(&ctx_, config) == TILEDB_OK);
+  vfs_ = nullptr;
+  REQUIRE(tiledb_vfs_create(ctx_, &vfs_, config) == TILEDB_OK);
+  REQUIRE(tiledb_config_free(config) == TILEDB_OK);
+}
+
+QueryIterFx::~QueryIterFx() {
+  CHECK(tiledb_vfs_free(ctx_, vfs_) == TILEDB_OK);
+  CHECK(tiledb_ctx_free(ctx_) == TILEDB_OK);
+}
+
+void QueryIterFx::create_temp_dir(const std::string& path) {
+  remove_temp_dir(path);
+  REQUIRE(tiledb_vfs_create_dir(ctx_, vfs_, path.c_str()) == TILEDB_OK);
+}
+
+void QueryIterFx::remove_temp_dir(const std::string& path) {
+  int is_dir = 0;
+  REQUIRE(tiledb_vfs_is_dir(ctx_, vfs_, path.c_str(), &is_dir) == TILEDB_OK);
+  if (is_dir)
+    REQUIRE(tiledb_vfs_remove_dir(ctx_, vfs_, path.c_str()) == TILEDB_OK);
+}
+
+std::string QueryIterFx::a2_value(int64_t i) {
+  // Every 10th value is long, so that it overflows the initial buffer
+  return std::string((i % 10 == 0) ? 100 : (size_t)(i % 3 + 1), 'a' + i % 26);
+}
+
+void QueryIterFx::create_array(
+    const std::string& path, tiledb_array_type_t type) {
+  int64_t dim_domain[] = {1, CELL_NUM};
+  int64_t tile_extent = 10;
+
+  // Create domain
+  tiledb_domain_t* domain;
+  int rc = tiledb_domain_create(ctx_, &domain);
+  REQUIRE(rc == TILEDB_OK);
+  tiledb_dimension_t* dim;
+  rc = tiledb_dimension_create(
+      ctx_, &dim, DIM_NAME, TILEDB_INT64, dim_domain, &tile_extent);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_domain_add_dimension(ctx_, domain, dim);
+  REQUIRE(rc == TILEDB_OK);
+
+  // Create attributes
+  tiledb_attribute_t* a1;
+  rc = tiledb_attribute_create(ctx_, &a1, A1_NAME, TILEDB_INT32);
+  REQUIRE(rc == TILEDB_OK);
+  tiledb_attribute_t* a2;
+  rc = tiledb_attribute_create(ctx_, &a2, A2_NAME, TILEDB_CHAR);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_attribute_set_cell_val_num(ctx_, a2, TILEDB_VAR_NUM);
+  REQUIRE(rc == TILEDB_OK);
+
+  // Create array schema
+  tiledb_array_schema_t* array_schema;
+  rc = tiledb_array_schema_create(ctx_, &array_schema, type);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_schema_set_capacity(ctx_, array_schema, 10);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_schema_set_domain(ctx_, array_schema, domain);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_schema_add_attribute(ctx_, array_schema, a1);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_schema_add_attribute(ctx_, array_schema, a2);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_schema_check(ctx_, array_schema);
+  REQUIRE(rc == TILEDB_OK);
+
+  // Create array
+  rc = tiledb_array_create(ctx_, path.c_str(), array_schema);
+  REQUIRE(rc == TILEDB_OK);
+
+  // Clean up
+  tiledb_attribute_free(ctx_, a1);
+  tiledb_attribute_free(ctx_, a2);
+  tiledb_dimension_free(ctx_, dim);
+  tiledb_domain_free(ctx_, domain);
+  tiledb_array_schema_free(ctx_, array_schema);
+}
+
+void QueryIterFx::write_array(
+    const std::string& path, tiledb_array_type_t type) {
+  // Prepare buffers
+  std::vector<int> a1;
+  std::vector<uint64_t> a2_off;
+  std::string a2_val;
+  std::vector<int64_t> coords;
+  for (int64_t i = 1; i <= CELL_NUM; ++i) {
+    a1.push_back((int)i);
+    a2_off.push_back(a2_val.size());
+    a2_val += a2_value(i);
+    coords.push_back(i);
+  }
+  void* buffers[] = {&a1[0], &a2_off[0], &a2_val[0], &coords[0]};
+  uint64_t buffer_sizes[] = {a1.size() * sizeof(int),
+                             a2_off.size() * sizeof(uint64_t),
+                             a2_val.size(),
+                             coords.size() * sizeof(int64_t)};
+  const char* attributes[] = {A1_NAME, A2_NAME, TILEDB_COORDS};
+  unsigned int attribute_num = (type == TILEDB_SPARSE) ? 3 : 2;
+
+  // Write array
+  tiledb_query_t* query;
+  int rc = tiledb_query_create(ctx_, &query, path.c_str(), TILEDB_WRITE);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_buffers(
+      ctx_, query, attributes, attribute_num, buffers, buffer_sizes);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_layout(ctx_, query, TILEDB_GLOBAL_ORDER);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_submit(ctx_, query);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_free(ctx_, query);
+  REQUIRE(rc == TILEDB_OK);
+}
+
+void QueryIterFx::check_read(
+    const std::string& path,
+    const int64_t* subarray,
+    tiledb_layout_t layout,
+    bool coords) {
+  const char* attributes[] = {A1_NAME, A2_NAME, TILEDB_COORDS};
+  unsigned int attribute_num = (coords) ? 3 : 2;
+  tiledb_query_iter_t* query_iter;
+  int rc = tiledb_query_iter_create(
+      ctx_,
+      &query_iter,
+      path.c_str(),
+      subarray,
+      attributes,
+      attribute_num,
+      layout);
+  REQUIRE(rc == TILEDB_OK);
+
+  // Wrong buffer getters
+  void* buffer;
+  uint64_t buffer_size;
+  uint64_t* buffer_off;
+  uint64_t buffer_off_size;
+  rc = tiledb_query_iter_get_buffer(
+      ctx_, query_iter, A2_NAME, &buffer, &buffer_size);
+  CHECK(rc == TILEDB_ERR);
+  rc = tiledb_query_iter_get_buffer_var(
+      ctx_,
+      query_iter,
+      A1_NAME,
+      &buffer_off,
+      &buffer_off_size,
+      &buffer,
+      &buffer_size);
+  CHECK(rc == TILEDB_ERR);
+  rc = tiledb_query_iter_get_buffer(
+      ctx_, query_iter, "foo", &buffer, &buffer_size);
+  CHECK(rc == TILEDB_ERR);
+
+  // Stream the results, concatenating the batches
+  std::vector<int> a1;
+  std::vector<std::string> a2;
+  std::vector<int64_t> d;
+  int batch_num = 0;
+  int done = 0;
+  rc = tiledb_query_iter_done(ctx_, query_iter, &done);
+  REQUIRE(rc == TILEDB_OK);
+  while (!done) {
+    ++batch_num;
+
+    rc = tiledb_query_iter_get_buffer(
+        ctx_, query_iter, A1_NAME, &buffer, &buffer_size);
+    REQUIRE(rc == TILEDB_OK);
+    auto a1_buffer = (int*)buffer;
+    for (uint64_t i = 0; i < buffer_size / sizeof(int); ++i)
+      a1.push_back(a1_buffer[i]);
+
+    rc = tiledb_query_iter_get_buffer_var(
+        ctx_,
+        query_iter,
+        A2_NAME,
+        &buffer_off,
+        &buffer_off_size,
+        &buffer,
+        &buffer_size);
+    REQUIRE(rc == TILEDB_OK);
+    auto a2_buffer = (char*)buffer;
+    uint64_t a2_num = buffer_off_size / sizeof(uint64_t);
+    for (uint64_t i = 0; i < a2_num; ++i) {
+      uint64_t end = (i == a2_num - 1) ? buffer_size : buffer_off[i + 1];
+      a2.emplace_back(a2_buffer + buffer_off[i], end - buffer_off[i]);
+    }
+
+    if (coords) {
+      rc = tiledb_query_iter_get_buffer(
+          ctx_, query_iter, TILEDB_COORDS, &buffer, &buffer_size);
+      REQUIRE(rc == TILEDB_OK);
+      auto d_buffer = (int64_t*)buffer;
+      for (uint64_t i = 0; i < buffer_size / sizeof(int64_t); ++i)
+        d.push_back(d_buffer[i]);
+    }
+
+    rc = tiledb_query_iter_next(ctx_, query_iter);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_query_iter_done(ctx_, query_iter, &done);
+    REQUIRE(rc == TILEDB_OK);
+  }
+
+  rc = tiledb_query_iter_free(ctx_, query_iter);
+  REQUIRE(rc == TILEDB_OK);
+
+  // Check the results
+  int64_t lo = (subarray == nullptr) ? 1 : subarray[0];
+  int64_t hi = (subarray == nullptr) ? CELL_NUM : subarray[1];
+  auto result_num = (size_t)(hi - lo + 1);
+  CHECK(batch_num > 1);
+  REQUIRE(a1.size() == result_num);
+  REQUIRE(a2.size() == result_num);
+  if (coords)
+    REQUIRE(d.size() == result_num);
+  for (int64_t i = lo; i <= hi; ++i) {
+    CHECK(a1[i - lo] == i);
+    CHECK(a2[i - lo] == a2_value(i));
+    if (coords)
+      CHECK(d[i - lo] == i);
+  }
+}
+
+TEST_CASE_METHOD(
+    QueryIterFx, "C API: Test query iterator", "[capi], [query-iter]") {
+  create_temp_dir(FILE_URI_PREFIX + FILE_TEMP_DIR);
+
+  SECTION("- Dense array") {
+    std::string array_name = FILE_URI_PREFIX + FILE_TEMP_DIR + DENSE_ARRAY;
+    create_array(array_name, TILEDB_DENSE);
+    write_array(array_name, TILEDB_DENSE);
+    int64_t subarray[] = {5, 87};
+    check_read(array_name, nullptr, TILEDB_GLOBAL_ORDER, false);
+    check_read(array_name, subarray, TILEDB_GLOBAL_ORDER, false);
+    check_read(array_name, subarray, TILEDB_ROW_MAJOR, false);
+  }
+
+  SECTION("- Sparse array") {
+    std::string array_name = FILE_URI_PREFIX + FILE_TEMP_DIR + SPARSE_ARRAY;
+    create_array(array_name, TILEDB_SPARSE);
+    write_array(array_name, TILEDB_SPARSE);
+    int64_t subarray[] = {5, 87};
+    check_read(array_name, nullptr, TILEDB_GLOBAL_ORDER, true);
+    check_read(array_name, subarray, TILEDB_GLOBAL_ORDER, true);
+    check_read(array_name, subarray, TILEDB_ROW_MAJOR, true);
+  }
+
+  remove_temp_dir(FILE_URI_PREFIX + FILE_TEMP_DIR);
+}
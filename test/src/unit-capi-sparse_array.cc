@@ -44,9 +44,15 @@
 #include <cstring>
 #include <ctime>
 #include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <limits>
 #include <map>
 #include <sstream>
 #include <thread>
+#include <vector>
 
 struct SparseArrayFx {
   // Constant parameters
@@ -93,6 +99,8 @@ struct SparseArrayFx {
       tiledb_compressor_t compressor,
       tiledb_layout_t tile_order,
       tiledb_layout_t cell_order);
+  void check_snapshot_reads(const std::string& array_name, bool lock_free);
+  std::string read_fragment_manifest(const std::string& array_name);
 
   /**
    * Creates a 2D sparse array.
@@ -161,6 +169,44 @@ struct SparseArrayFx {
       const int64_t domain_size_0,
       const int64_t domain_size_1);
 
+  /**
+   * Writes the cells of rows `[row_lo, row_hi]` and columns `[0, 19]` in
+   * unsorted mode. Each cell is equal to `row_id*20+col_id+value_offset`.
+   *
+   * @param array_name The array name.
+   * @param row_lo The first row to be written.
+   * @param row_hi The last row to be written.
+   * @param value_offset The offset added to every cell value.
+   */
+  void write_sparse_array_rows(
+      const std::string& array_name,
+      const int64_t row_lo,
+      const int64_t row_hi,
+      const int value_offset);
+
+  void check_copy_consolidation(const std::string& array_name);
+  void check_consolidation_progress(const std::string& array_name);
+  void check_timestamp_range_reads(const std::string& array_name);
+  void check_query_stats(const std::string& array_name);
+  void check_trace(const std::string& array_name);
+  void check_gorilla_compression(const std::string& array_name);
+  void check_auto_compression(const std::string& array_name);
+  void check_query_conditions(const std::string& array_name);
+
+  /**
+   * Reads the cells of rows `[0, 9]` and columns `[0, 19]`, seeing only
+   * the fragments written within the input timestamp range.
+   *
+   * @param array_name The array name.
+   * @param timestamp_start The smallest fragment timestamp.
+   * @param timestamp_end The largest fragment timestamp.
+   * @return The values read.
+   */
+  std::vector<int> read_sparse_array_rows(
+      const std::string& array_name,
+      uint64_t timestamp_start,
+      uint64_t timestamp_end);
+  void check_est_read_buffer_sizes(const std::string& array_name);
   void test_random_subarrays(
       const std::string& array_name,
       int64_t domain_size_0,
@@ -437,6 +483,820 @@ void SparseArrayFx::write_sparse_array_unsorted_2D(
   delete[] buffer_coords;
 }
 
+void SparseArrayFx::write_sparse_array_rows(
+    const std::string& array_name,
+    const int64_t row_lo,
+    const int64_t row_hi,
+    const int value_offset) {
+  // Prepare buffers
+  int64_t cell_num = (row_hi - row_lo + 1) * 20;
+  std::vector<int> buffer_a1;
+  std::vector<int64_t> buffer_coords;
+  for (int64_t i = row_lo; i <= row_hi; ++i) {
+    for (int64_t j = 0; j < 20; ++j) {
+      buffer_a1.push_back(int(i * 20 + j) + value_offset);
+      buffer_coords.push_back(i);
+      buffer_coords.push_back(j);
+    }
+  }
+  void* buffers[] = {&buffer_a1[0], &buffer_coords[0]};
+  uint64_t buffer_sizes[] = {cell_num * sizeof(int),
+                             2 * cell_num * sizeof(int64_t)};
+  const char* attributes[] = {ATTR_NAME, TILEDB_COORDS};
+
+  // Create query
+  tiledb_query_t* query;
+  int rc = tiledb_query_create(ctx_, &query, array_name.c_str(), TILEDB_WRITE);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_buffers(
+      ctx_, query, attributes, 2, buffers, buffer_sizes);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_layout(ctx_, query, TILEDB_UNORDERED);
+  REQUIRE(rc == TILEDB_OK);
+
+  // Submit query
+  rc = tiledb_query_submit(ctx_, query);
+  REQUIRE(rc == TILEDB_OK);
+
+  // Free/finalize query
+  rc = tiledb_query_free(ctx_, query);
+  REQUIRE(rc == TILEDB_OK);
+}
+
+void SparseArrayFx::check_copy_consolidation(const std::string& array_name) {
+  // Capacity 30 leaves partial tiles in the end of every fragment
+  create_sparse_array_2D(
+      array_name,
+      10,
+      10,
+      0,
+      99,
+      0,
+      99,
+      30,
+      TILEDB_GZIP,
+      TILEDB_ROW_MAJOR,
+      TILEDB_ROW_MAJOR);
+
+  // Rows [0,9] and [50,59] overlap with no other fragment and have their
+  // tiles copied, whereas rows [20,29] and [25,34] are merged, with the
+  // latter overwriting the former
+  write_sparse_array_rows(array_name, 50, 59, 0);
+  write_sparse_array_rows(array_name, 0, 9, 0);
+  write_sparse_array_rows(array_name, 20, 29, 0);
+  write_sparse_array_rows(array_name, 25, 34, 10000);
+  int rc = tiledb_array_consolidate(ctx_, array_name.c_str());
+  REQUIRE(rc == TILEDB_OK);
+
+  // Read all the cells
+  const char* attributes[] = {ATTR_NAME, TILEDB_COORDS};
+  const int64_t subarray[] = {0, 99, 0, 99};
+  std::vector<int> buffer_a1(1000);
+  std::vector<int64_t> buffer_coords(2000);
+  void* buffers[] = {&buffer_a1[0], &buffer_coords[0]};
+  uint64_t buffer_sizes[] = {buffer_a1.size() * sizeof(int),
+                             buffer_coords.size() * sizeof(int64_t)};
+  tiledb_query_t* query;
+  rc = tiledb_query_create(ctx_, &query, array_name.c_str(), TILEDB_READ);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_buffers(
+      ctx_, query, attributes, 2, buffers, buffer_sizes);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_subarray(ctx_, query, subarray);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_layout(ctx_, query, TILEDB_ROW_MAJOR);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_submit(ctx_, query);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_free(ctx_, query);
+  REQUIRE(rc == TILEDB_OK);
+
+  // Check the cells
+  REQUIRE(buffer_sizes[0] == 700 * sizeof(int));
+  REQUIRE(buffer_sizes[1] == 1400 * sizeof(int64_t));
+  uint64_t c = 0;
+  for (int64_t i = 0; i < 60; ++i) {
+    if ((i >= 10 && i < 20) || (i >= 35 && i < 50))
+      continue;
+    int value_offset = (i >= 25 && i < 35) ? 10000 : 0;
+    for (int64_t j = 0; j < 20; ++j, ++c) {
+      CHECK(buffer_coords[2 * c] == i);
+      CHECK(buffer_coords[2 * c + 1] == j);
+      CHECK(buffer_a1[c] == int(i * 20 + j) + value_offset);
+    }
+  }
+}
+
+void SparseArrayFx::check_consolidation_progress(
+    const std::string& array_name) {
+  create_sparse_array_2D(
+      array_name,
+      10,
+      10,
+      0,
+      99,
+      0,
+      99,
+      100,
+      TILEDB_NO_COMPRESSION,
+      TILEDB_ROW_MAJOR,
+      TILEDB_ROW_MAJOR);
+  write_sparse_array_unsorted_2D(array_name, 20, 20);
+  write_sparse_array_unsorted_2D(array_name, 20, 20);
+
+  // Use a context with a memory budget that fits 75 cells per batch
+  tiledb_config_t* config = nullptr;
+  tiledb_error_t* error = nullptr;
+  REQUIRE(tiledb_config_create(&config, &error) == TILEDB_OK);
+  REQUIRE(
+      tiledb_config_set(
+          config, "sm.consolidation_memory_budget", "4800", &error) ==
+      TILEDB_OK);
+  tiledb_ctx_t* ctx;
+  REQUIRE(tiledb_ctx_create(&ctx, config) == TILEDB_OK);
+
+  // The progress is reported after every batch
+  std::vector<std::pair<uint64_t, uint64_t>> progress;
+  auto callback = [](uint64_t cell_num, uint64_t byte_num, void* data) {
+    auto progress =
+        static_cast<std::vector<std::pair<uint64_t, uint64_t>>*>(data);
+    progress->emplace_back(cell_num, byte_num);
+  };
+  int rc = tiledb_array_consolidate_with_progress(
+      ctx, array_name.c_str(), callback, &progress);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(progress.size() == 6);
+  for (size_t i = 1; i < progress.size(); ++i)
+    CHECK(progress[i].first > progress[i - 1].first);
+  CHECK(progress.back().first == 400);
+  CHECK(progress.back().second == 400 * (sizeof(int) + 2 * sizeof(int64_t)));
+
+  int* buffer = read_sparse_array_2D(
+      array_name, 0, 19, 0, 19, TILEDB_READ, TILEDB_ROW_MAJOR);
+  for (int i = 0; i < 400; ++i)
+    CHECK(buffer[i] == i);
+  delete[] buffer;
+
+  // A budget too small to hold the buffers fails
+  write_sparse_array_unsorted_2D(array_name, 20, 20);
+  REQUIRE(
+      tiledb_config_set(
+          config, "sm.consolidation_memory_budget", "1", &error) ==
+      TILEDB_OK);
+  tiledb_ctx_t* ctx_small;
+  REQUIRE(tiledb_ctx_create(&ctx_small, config) == TILEDB_OK);
+  rc = tiledb_array_consolidate(ctx_small, array_name.c_str());
+  CHECK(rc == TILEDB_ERR);
+
+  CHECK(tiledb_ctx_free(ctx) == TILEDB_OK);
+  CHECK(tiledb_ctx_free(ctx_small) == TILEDB_OK);
+  CHECK(tiledb_config_free(config) == TILEDB_OK);
+}
+
+std::vector<int> SparseArrayFx::read_sparse_array_rows(
+    const std::string& array_name,
+    uint64_t timestamp_start,
+    uint64_t timestamp_end) {
+  const char* attributes[] = {ATTR_NAME};
+  const int64_t subarray[] = {0, 9, 0, 19};
+  std::vector<int> buffer_a1(200);
+  void* buffers[] = {&buffer_a1[0]};
+  uint64_t buffer_sizes[] = {buffer_a1.size() * sizeof(int)};
+  tiledb_query_t* query;
+  int rc = tiledb_query_create_with_timestamp_range(
+      ctx_,
+      &query,
+      array_name.c_str(),
+      TILEDB_READ,
+      timestamp_start,
+      timestamp_end);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_buffers(
+      ctx_, query, attributes, 1, buffers, buffer_sizes);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_subarray(ctx_, query, subarray);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_layout(ctx_, query, TILEDB_ROW_MAJOR);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_submit(ctx_, query);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_free(ctx_, query);
+  REQUIRE(rc == TILEDB_OK);
+
+  buffer_a1.resize(buffer_sizes[0] / sizeof(int));
+  return buffer_a1;
+}
+
+void SparseArrayFx::check_timestamp_range_reads(
+    const std::string& array_name) {
+  create_sparse_array_2D(
+      array_name,
+      10,
+      10,
+      0,
+      99,
+      0,
+      99,
+      100,
+      TILEDB_NO_COMPRESSION,
+      TILEDB_ROW_MAJOR,
+      TILEDB_ROW_MAJOR);
+
+  // Write two fragments over the same cells, with distinct timestamps
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  uint64_t t_first = tiledb::utils::timestamp_ms();
+  write_sparse_array_rows(array_name, 0, 9, 0);
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  uint64_t t_second = tiledb::utils::timestamp_ms();
+  write_sparse_array_rows(array_name, 0, 9, 1000);
+
+  // All the fragments are visible by default
+  auto values = read_sparse_array_rows(array_name, 0, UINT64_MAX);
+  REQUIRE(values.size() == 200);
+  for (int i = 0; i < 200; ++i)
+    CHECK(values[i] == i + 1000);
+
+  // Read the array as it was before the second write
+  values = read_sparse_array_rows(array_name, 0, t_second - 1);
+  REQUIRE(values.size() == 200);
+  for (int i = 0; i < 200; ++i)
+    CHECK(values[i] == i);
+
+  // Ignore the first fragment
+  values = read_sparse_array_rows(array_name, t_second, UINT64_MAX);
+  REQUIRE(values.size() == 200);
+  for (int i = 0; i < 200; ++i)
+    CHECK(values[i] == i + 1000);
+
+  // No fragment precedes the first write
+  values = read_sparse_array_rows(array_name, 0, t_first - 1);
+  CHECK(values.empty());
+
+  // Timestamp ranges apply only to valid ranges and reads
+  tiledb_query_t* query;
+  int rc = tiledb_query_create_with_timestamp_range(
+      ctx_, &query, array_name.c_str(), TILEDB_READ, t_second, t_first);
+  CHECK(rc == TILEDB_ERR);
+  rc = tiledb_query_create_with_timestamp_range(
+      ctx_, &query, array_name.c_str(), TILEDB_WRITE, 0, t_second);
+  CHECK(rc == TILEDB_ERR);
+}
+
+/** Returns the value of `key` in a flat JSON object of integers. */
+static uint64_t stats_value(const std::string& json, const std::string& key) {
+  auto pos = json.find("\"" + key + "\": ");
+  REQUIRE(pos != std::string::npos);
+  return std::stoull(json.substr(pos + key.size() + 4));
+}
+
+void SparseArrayFx::check_query_stats(const std::string& array_name) {
+  create_sparse_array_2D(
+      array_name,
+      10,
+      10,
+      0,
+      99,
+      0,
+      99,
+      100,
+      TILEDB_GZIP,
+      TILEDB_ROW_MAJOR,
+      TILEDB_ROW_MAJOR);
+  write_sparse_array_rows(array_name, 0, 9, 0);
+  CHECK(tiledb_ctx_stats_reset(ctx_) == TILEDB_OK);
+
+  // Read the same cells twice, each time with a new query
+  const char* attributes[] = {ATTR_NAME};
+  const int64_t subarray[] = {0, 9, 0, 19};
+  std::vector<int> buffer_a1(200);
+  void* buffers[] = {&buffer_a1[0]};
+  std::string stats[2];
+  for (int i = 0; i < 2; ++i) {
+    uint64_t buffer_sizes[] = {buffer_a1.size() * sizeof(int)};
+    tiledb_query_t* query;
+    int rc =
+        tiledb_query_create(ctx_, &query, array_name.c_str(), TILEDB_READ);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_query_set_buffers(
+        ctx_, query, attributes, 1, buffers, buffer_sizes);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_query_set_subarray(ctx_, query, subarray);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_query_set_layout(ctx_, query, TILEDB_GLOBAL_ORDER);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_query_submit(ctx_, query);
+    REQUIRE(rc == TILEDB_OK);
+    const char* json;
+    rc = tiledb_query_get_stats(ctx_, query, &json);
+    REQUIRE(rc == TILEDB_OK);
+    stats[i] = json;
+    rc = tiledb_query_free(ctx_, query);
+    REQUIRE(rc == TILEDB_OK);
+    CHECK(buffer_sizes[0] == 200 * sizeof(int));
+  }
+
+  // The first read fetches and decompresses the tiles from storage
+  CHECK(stats_value(stats[0], "tile_read_num") > 0);
+  CHECK(stats_value(stats[0], "tile_cache_hit_num") == 0);
+  CHECK(
+      stats_value(stats[0], "tile_cache_miss_num") ==
+      stats_value(stats[0], "tile_read_num"));
+  CHECK(stats_value(stats[0], "vfs_read_bytes") > 0);
+  CHECK(stats_value(stats[0], "decompressed_bytes") > 0);
+  CHECK(stats_value(stats[0], "decompress_ns") > 0);
+  CHECK(stats_value(stats[0], "cell_copy_bytes") == 200 * sizeof(int));
+  CHECK(stats_value(stats[0], "query_read_ns") > 0);
+
+  // The second read is served by the tile cache
+  CHECK(
+      stats_value(stats[1], "tile_read_num") ==
+      stats_value(stats[0], "tile_read_num"));
+  CHECK(
+      stats_value(stats[1], "tile_cache_hit_num") ==
+      stats_value(stats[1], "tile_read_num"));
+  CHECK(stats_value(stats[1], "decompressed_bytes") == 0);
+  CHECK(stats_value(stats[1], "cell_copy_bytes") == 200 * sizeof(int));
+
+  // The context aggregates the queries
+  FILE* out = tmpfile();
+  REQUIRE(out != nullptr);
+  CHECK(tiledb_ctx_stats_dump(ctx_, out) == TILEDB_OK);
+  rewind(out);
+  char ctx_stats[4096];
+  auto len = fread(ctx_stats, 1, sizeof(ctx_stats) - 1, out);
+  ctx_stats[len] = '\0';
+  fclose(out);
+  CHECK(
+      stats_value(ctx_stats, "tile_cache_hit_num") ==
+      stats_value(stats[1], "tile_cache_hit_num"));
+  CHECK(stats_value(ctx_stats, "cell_copy_bytes") == 400 * sizeof(int));
+  CHECK(
+      stats_value(ctx_stats, "tile_read_num") >=
+      2 * stats_value(stats[0], "tile_read_num"));
+}
+
+void SparseArrayFx::check_trace(const std::string& array_name) {
+  create_sparse_array_2D(
+      array_name,
+      10,
+      10,
+      0,
+      99,
+      0,
+      99,
+      100,
+      TILEDB_GZIP,
+      TILEDB_ROW_MAJOR,
+      TILEDB_ROW_MAJOR);
+  write_sparse_array_rows(array_name, 0, 9, 0);
+
+  // Use a context that traces into a file
+  std::string trace_file = FILE_TEMP_DIR + "trace.json";
+  tiledb_config_t* config = nullptr;
+  tiledb_error_t* error = nullptr;
+  REQUIRE(tiledb_config_create(&config, &error) == TILEDB_OK);
+  REQUIRE(
+      tiledb_config_set(config, "sm.trace_file", trace_file.c_str(), &error) ==
+      TILEDB_OK);
+  tiledb_ctx_t* ctx;
+  REQUIRE(tiledb_ctx_create(&ctx, config) == TILEDB_OK);
+  CHECK(tiledb_config_free(config) == TILEDB_OK);
+
+  // Read in column-major order, which goes through the internal queries
+  const char* attributes[] = {ATTR_NAME};
+  const int64_t subarray[] = {0, 9, 0, 19};
+  std::vector<int> buffer_a1(200);
+  void* buffers[] = {&buffer_a1[0]};
+  uint64_t buffer_sizes[] = {buffer_a1.size() * sizeof(int)};
+  tiledb_query_t* query;
+  int rc = tiledb_query_create(ctx, &query, array_name.c_str(), TILEDB_READ);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_buffers(
+      ctx, query, attributes, 1, buffers, buffer_sizes);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_subarray(ctx, query, subarray);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_layout(ctx, query, TILEDB_COL_MAJOR);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_submit(ctx, query);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_free(ctx, query);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(buffer_sizes[0] == 200 * sizeof(int));
+
+  // The trace is dumped when the context is freed
+  CHECK(tiledb_ctx_free(ctx) == TILEDB_OK);
+  std::ifstream ifs(trace_file);
+  REQUIRE(ifs.is_open());
+  std::stringstream trace;
+  trace << ifs.rdbuf();
+  CHECK(trace.str().find("{\"traceEvents\":[") == 0);
+  for (auto name : {"query_submit",
+                    "array_open",
+                    "fragment_open",
+                    "async_queue_wait",
+                    "async_process",
+                    "fragment_merge",
+                    "tile_read",
+                    "vfs_read",
+                    "decompress",
+                    "cell_copy"}) {
+    auto span = std::string("{\"name\":\"") + name + "\",\"ph\":\"X\"";
+    CHECK(trace.str().find(span) != std::string::npos);
+  }
+}
+
+void SparseArrayFx::check_gorilla_compression(const std::string& array_name) {
+  // Real coordinates and attribute, both compressed with Gorilla
+  double dim_domain[] = {0.0, 100.0, 0.0, 100.0};
+  double tile_extents[] = {10.0, 10.0};
+  tiledb_dimension_t* d1;
+  int rc = tiledb_dimension_create(
+      ctx_, &d1, "d1", TILEDB_FLOAT64, &dim_domain[0], &tile_extents[0]);
+  REQUIRE(rc == TILEDB_OK);
+  tiledb_dimension_t* d2;
+  rc = tiledb_dimension_create(
+      ctx_, &d2, "d2", TILEDB_FLOAT64, &dim_domain[2], &tile_extents[1]);
+  REQUIRE(rc == TILEDB_OK);
+  tiledb_domain_t* domain;
+  rc = tiledb_domain_create(ctx_, &domain);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_domain_add_dimension(ctx_, domain, d1);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_domain_add_dimension(ctx_, domain, d2);
+  REQUIRE(rc == TILEDB_OK);
+  tiledb_attribute_t* a;
+  rc = tiledb_attribute_create(ctx_, &a, "a", TILEDB_FLOAT64);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_attribute_set_compressor(ctx_, a, TILEDB_GORILLA, -1);
+  REQUIRE(rc == TILEDB_OK);
+  tiledb_array_schema_t* array_schema;
+  rc = tiledb_array_schema_create(ctx_, &array_schema, TILEDB_SPARSE);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_schema_set_capacity(ctx_, array_schema, 100);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_schema_set_domain(ctx_, array_schema, domain);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_schema_set_coords_compressor(
+      ctx_, array_schema, TILEDB_GORILLA, -1);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_schema_add_attribute(ctx_, array_schema, a);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_create(ctx_, array_name.c_str(), array_schema);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(tiledb_attribute_free(ctx_, a) == TILEDB_OK);
+  CHECK(tiledb_dimension_free(ctx_, d1) == TILEDB_OK);
+  CHECK(tiledb_dimension_free(ctx_, d2) == TILEDB_OK);
+  CHECK(tiledb_domain_free(ctx_, domain) == TILEDB_OK);
+  CHECK(tiledb_array_schema_free(ctx_, array_schema) == TILEDB_OK);
+
+  // Write a slowly changing series along a diagonal
+  const int cell_num = 500;
+  std::vector<double> buffer_a(cell_num);
+  std::vector<double> buffer_coords(2 * cell_num);
+  for (int i = 0; i < cell_num; ++i) {
+    buffer_a[i] = 20.0 + (i / 10) * 0.25;
+    buffer_coords[2 * i] = i * 0.2;
+    buffer_coords[2 * i + 1] = i * 0.2;
+  }
+  const char* attributes[] = {"a", TILEDB_COORDS};
+  void* write_buffers[] = {&buffer_a[0], &buffer_coords[0]};
+  uint64_t write_buffer_sizes[] = {cell_num * sizeof(double),
+                                   2 * cell_num * sizeof(double)};
+  tiledb_query_t* query;
+  rc = tiledb_query_create(ctx_, &query, array_name.c_str(), TILEDB_WRITE);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_buffers(
+      ctx_, query, attributes, 2, write_buffers, write_buffer_sizes);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_layout(ctx_, query, TILEDB_GLOBAL_ORDER);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_submit(ctx_, query);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(tiledb_query_free(ctx_, query) == TILEDB_OK);
+
+  // Read everything back in global order
+  std::vector<double> read_a(cell_num);
+  std::vector<double> read_coords(2 * cell_num);
+  void* read_buffers[] = {&read_a[0], &read_coords[0]};
+  uint64_t read_buffer_sizes[] = {cell_num * sizeof(double),
+                                  2 * cell_num * sizeof(double)};
+  rc = tiledb_query_create(ctx_, &query, array_name.c_str(), TILEDB_READ);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_buffers(
+      ctx_, query, attributes, 2, read_buffers, read_buffer_sizes);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_layout(ctx_, query, TILEDB_GLOBAL_ORDER);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_submit(ctx_, query);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(tiledb_query_free(ctx_, query) == TILEDB_OK);
+  CHECK(read_buffer_sizes[0] == cell_num * sizeof(double));
+  CHECK(read_a == buffer_a);
+  CHECK(read_coords == buffer_coords);
+}
+
+void SparseArrayFx::check_auto_compression(const std::string& array_name) {
+  // Integer coordinates and attribute plus a real attribute, all with AUTO
+  int64_t dim_domain[] = {0, 999, 0, 999};
+  int64_t tile_extents[] = {100, 100};
+  tiledb_dimension_t* d1;
+  int rc = tiledb_dimension_create(
+      ctx_, &d1, "d1", TILEDB_INT64, &dim_domain[0], &tile_extents[0]);
+  REQUIRE(rc == TILEDB_OK);
+  tiledb_dimension_t* d2;
+  rc = tiledb_dimension_create(
+      ctx_, &d2, "d2", TILEDB_INT64, &dim_domain[2], &tile_extents[1]);
+  REQUIRE(rc == TILEDB_OK);
+  tiledb_domain_t* domain;
+  rc = tiledb_domain_create(ctx_, &domain);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_domain_add_dimension(ctx_, domain, d1);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_domain_add_dimension(ctx_, domain, d2);
+  REQUIRE(rc == TILEDB_OK);
+  tiledb_attribute_t* a1;
+  rc = tiledb_attribute_create(ctx_, &a1, "a1", TILEDB_INT32);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_attribute_set_compressor(ctx_, a1, TILEDB_AUTO, -1);
+  REQUIRE(rc == TILEDB_OK);
+  tiledb_attribute_t* a2;
+  rc = tiledb_attribute_create(ctx_, &a2, "a2", TILEDB_FLOAT64);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_attribute_set_compressor(ctx_, a2, TILEDB_AUTO, -1);
+  REQUIRE(rc == TILEDB_OK);
+  tiledb_array_schema_t* array_schema;
+  rc = tiledb_array_schema_create(ctx_, &array_schema, TILEDB_SPARSE);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_schema_set_capacity(ctx_, array_schema, 100);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_schema_set_domain(ctx_, array_schema, domain);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_schema_set_coords_compressor(
+      ctx_, array_schema, TILEDB_AUTO, -1);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_schema_add_attribute(ctx_, array_schema, a1);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_schema_add_attribute(ctx_, array_schema, a2);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_array_create(ctx_, array_name.c_str(), array_schema);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(tiledb_attribute_free(ctx_, a1) == TILEDB_OK);
+  CHECK(tiledb_attribute_free(ctx_, a2) == TILEDB_OK);
+  CHECK(tiledb_dimension_free(ctx_, d1) == TILEDB_OK);
+  CHECK(tiledb_dimension_free(ctx_, d2) == TILEDB_OK);
+  CHECK(tiledb_domain_free(ctx_, domain) == TILEDB_OK);
+  CHECK(tiledb_array_schema_free(ctx_, array_schema) == TILEDB_OK);
+
+  // Use a context that weighs the decompression time of the candidates
+  tiledb_config_t* config = nullptr;
+  tiledb_error_t* error = nullptr;
+  REQUIRE(tiledb_config_create(&config, &error) == TILEDB_OK);
+  REQUIRE(
+      tiledb_config_set(
+          config,
+          "sm.compression_auto_candidates",
+          "NO_COMPRESSION,ZSTD,DOUBLE_DELTA,GORILLA",
+          &error) == TILEDB_OK);
+  REQUIRE(
+      tiledb_config_set(
+          config, "sm.compression_auto_bandwidth", "100000000", &error) ==
+      TILEDB_OK);
+  tiledb_ctx_t* ctx;
+  REQUIRE(tiledb_ctx_create(&ctx, config) == TILEDB_OK);
+  CHECK(tiledb_config_free(config) == TILEDB_OK);
+
+  // Write a ramp and a slowly changing series along a diagonal
+  const int cell_num = 1000;
+  std::vector<int> buffer_a1(cell_num);
+  std::vector<double> buffer_a2(cell_num);
+  std::vector<int64_t> buffer_coords(2 * cell_num);
+  for (int i = 0; i < cell_num; ++i) {
+    buffer_a1[i] = 3 * i;
+    buffer_a2[i] = 20.0 + (i / 10) * 0.25;
+    buffer_coords[2 * i] = i;
+    buffer_coords[2 * i + 1] = i;
+  }
+  const char* attributes[] = {"a1", "a2", TILEDB_COORDS};
+  void* write_buffers[] = {&buffer_a1[0], &buffer_a2[0], &buffer_coords[0]};
+  uint64_t write_buffer_sizes[] = {cell_num * sizeof(int),
+                                   cell_num * sizeof(double),
+                                   2 * cell_num * sizeof(int64_t)};
+  tiledb_query_t* query;
+  rc = tiledb_query_create(ctx, &query, array_name.c_str(), TILEDB_WRITE);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_buffers(
+      ctx, query, attributes, 3, write_buffers, write_buffer_sizes);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_layout(ctx, query, TILEDB_GLOBAL_ORDER);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_submit(ctx, query);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(tiledb_query_free(ctx, query) == TILEDB_OK);
+  CHECK(tiledb_ctx_free(ctx) == TILEDB_OK);
+
+  // Read everything back in global order with the default context
+  std::vector<int> read_a1(cell_num);
+  std::vector<double> read_a2(cell_num);
+  std::vector<int64_t> read_coords(2 * cell_num);
+  void* read_buffers[] = {&read_a1[0], &read_a2[0], &read_coords[0]};
+  uint64_t read_buffer_sizes[] = {cell_num * sizeof(int),
+                                  cell_num * sizeof(double),
+                                  2 * cell_num * sizeof(int64_t)};
+  rc = tiledb_query_create(ctx_, &query, array_name.c_str(), TILEDB_READ);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_buffers(
+      ctx_, query, attributes, 3, read_buffers, read_buffer_sizes);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_layout(ctx_, query, TILEDB_GLOBAL_ORDER);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_submit(ctx_, query);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(tiledb_query_free(ctx_, query) == TILEDB_OK);
+  CHECK(read_buffer_sizes[0] == cell_num * sizeof(int));
+  CHECK(read_a1 == buffer_a1);
+  CHECK(read_a2 == buffer_a2);
+  CHECK(read_coords == buffer_coords);
+}
+
+void SparseArrayFx::check_query_conditions(const std::string& array_name) {
+  create_sparse_array_2D(
+      array_name,
+      10,
+      10,
+      0,
+      99,
+      0,
+      99,
+      100,
+      TILEDB_GZIP,
+      TILEDB_ROW_MAJOR,
+      TILEDB_ROW_MAJOR);
+  write_sparse_array_rows(array_name, 0, 9, 0);
+  write_sparse_array_rows(array_name, 10, 19, 1000);
+
+  // Select the values in [1200, 1300), held by the cells of rows [10, 14],
+  // reading in batches of at most 30 cells
+  const char* attributes[] = {ATTR_NAME, TILEDB_COORDS};
+  const int64_t subarray[] = {0, 19, 0, 19};
+  const int lo = 1200, hi = 1300;
+  for (auto layout : {TILEDB_GLOBAL_ORDER, TILEDB_ROW_MAJOR}) {
+    std::vector<int> values;
+    std::vector<int64_t> coords;
+    std::vector<int> buffer_a1(30);
+    std::vector<int64_t> buffer_coords(60);
+    void* buffers[] = {&buffer_a1[0], &buffer_coords[0]};
+    uint64_t buffer_sizes[2];
+    tiledb_query_t* query;
+    int rc =
+        tiledb_query_create(ctx_, &query, array_name.c_str(), TILEDB_READ);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_query_set_subarray(ctx_, query, subarray);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_query_set_layout(ctx_, query, layout);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_query_add_condition(ctx_, query, ATTR_NAME, TILEDB_GE, &lo);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_query_add_condition(ctx_, query, ATTR_NAME, TILEDB_LT, &hi);
+    REQUIRE(rc == TILEDB_OK);
+    tiledb_query_status_t status;
+    do {
+      buffer_sizes[0] = buffer_a1.size() * sizeof(int);
+      buffer_sizes[1] = buffer_coords.size() * sizeof(int64_t);
+      rc = tiledb_query_set_buffers(
+          ctx_, query, attributes, 2, buffers, buffer_sizes);
+      REQUIRE(rc == TILEDB_OK);
+      rc = tiledb_query_submit(ctx_, query);
+      REQUIRE(rc == TILEDB_OK);
+      REQUIRE(buffer_sizes[0] / sizeof(int) * 2 * sizeof(int64_t) ==
+              buffer_sizes[1]);
+      values.insert(
+          values.end(),
+          buffer_a1.begin(),
+          buffer_a1.begin() + buffer_sizes[0] / sizeof(int));
+      coords.insert(
+          coords.end(),
+          buffer_coords.begin(),
+          buffer_coords.begin() + buffer_sizes[1] / sizeof(int64_t));
+      rc = tiledb_query_get_status(ctx_, query, &status);
+      REQUIRE(rc == TILEDB_OK);
+    } while (status == TILEDB_INCOMPLETE && values.size() <= 100);
+    CHECK(status == TILEDB_COMPLETED);
+
+    // Only the satisfying cells are copied, and the tiles of the first
+    // fragment are skipped by their statistics
+    const char* json;
+    rc = tiledb_query_get_stats(ctx_, query, &json);
+    REQUIRE(rc == TILEDB_OK);
+    CHECK(stats_value(json, "condition_tile_skip_num") > 0);
+    CHECK(
+        stats_value(json, "cell_copy_bytes") ==
+        100 * (sizeof(int) + 2 * sizeof(int64_t)));
+    rc = tiledb_query_free(ctx_, query);
+    REQUIRE(rc == TILEDB_OK);
+
+    // Every cell keeps its coordinates
+    REQUIRE(values.size() == 100);
+    for (size_t i = 0; i < values.size(); ++i) {
+      CHECK(values[i] - 1000 == coords[2 * i] * 20 + coords[2 * i + 1]);
+      if (layout == TILEDB_ROW_MAJOR)
+        CHECK(values[i] == lo + (int)i);
+    }
+    std::sort(values.begin(), values.end());
+    for (int i = 0; i < 100; ++i)
+      CHECK(values[i] == lo + i);
+  }
+
+  // The conditioned attribute need not be read
+  const char* coords_attributes[] = {TILEDB_COORDS};
+  std::vector<int64_t> buffer_coords(800);
+  void* buffers[] = {&buffer_coords[0]};
+  uint64_t buffer_sizes[] = {buffer_coords.size() * sizeof(int64_t)};
+  tiledb_query_t* query;
+  int rc = tiledb_query_create(ctx_, &query, array_name.c_str(), TILEDB_READ);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_buffers(
+      ctx_, query, coords_attributes, 1, buffers, buffer_sizes);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_layout(ctx_, query, TILEDB_GLOBAL_ORDER);
+  REQUIRE(rc == TILEDB_OK);
+  const int value = 1250;
+  rc = tiledb_query_add_condition(ctx_, query, ATTR_NAME, TILEDB_EQ, &value);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_submit(ctx_, query);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_free(ctx_, query);
+  REQUIRE(rc == TILEDB_OK);
+  REQUIRE(buffer_sizes[0] == 2 * sizeof(int64_t));
+  CHECK(buffer_coords[0] == 12);
+  CHECK(buffer_coords[1] == 10);
+
+  // Conditions no cell satisfies
+  rc = tiledb_query_create(ctx_, &query, array_name.c_str(), TILEDB_READ);
+  REQUIRE(rc == TILEDB_OK);
+  buffer_sizes[0] = buffer_coords.size() * sizeof(int64_t);
+  rc = tiledb_query_set_buffers(
+      ctx_, query, coords_attributes, 1, buffers, buffer_sizes);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_layout(ctx_, query, TILEDB_GLOBAL_ORDER);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_add_condition(ctx_, query, ATTR_NAME, TILEDB_GT, &hi);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_add_condition(ctx_, query, ATTR_NAME, TILEDB_LE, &lo);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_submit(ctx_, query);
+  REQUIRE(rc == TILEDB_OK);
+  tiledb_query_status_t status;
+  rc = tiledb_query_get_status(ctx_, query, &status);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(status == TILEDB_COMPLETED);
+  rc = tiledb_query_free(ctx_, query);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(buffer_sizes[0] == 0);
+
+  // The maximum of the attribute type is a regular value in sparse arrays;
+  // row 20 holds the values [INT_MAX - 19, INT_MAX]
+  const int max = std::numeric_limits<int>::max();
+  write_sparse_array_rows(array_name, 20, 20, max - 419);
+  for (auto op : {TILEDB_EQ, TILEDB_GE}) {
+    const int max_value = (op == TILEDB_EQ) ? max : max - 1;
+    rc = tiledb_query_create(ctx_, &query, array_name.c_str(), TILEDB_READ);
+    REQUIRE(rc == TILEDB_OK);
+    buffer_sizes[0] = buffer_coords.size() * sizeof(int64_t);
+    rc = tiledb_query_set_buffers(
+        ctx_, query, coords_attributes, 1, buffers, buffer_sizes);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_query_set_layout(ctx_, query, TILEDB_GLOBAL_ORDER);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_query_add_condition(ctx_, query, ATTR_NAME, op, &max_value);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_query_submit(ctx_, query);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_query_free(ctx_, query);
+    REQUIRE(rc == TILEDB_OK);
+    uint64_t cell_num = (op == TILEDB_EQ) ? 1 : 2;
+    REQUIRE(buffer_sizes[0] == 2 * cell_num * sizeof(int64_t));
+    CHECK(buffer_coords[2 * cell_num - 2] == 20);
+    CHECK(buffer_coords[2 * cell_num - 1] == 19);
+  }
+
+  // Conditions apply only to reads on attributes
+  rc = tiledb_query_create(ctx_, &query, array_name.c_str(), TILEDB_READ);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_add_condition(ctx_, query, TILEDB_COORDS, TILEDB_EQ, &lo);
+  CHECK(rc == TILEDB_ERR);
+  rc = tiledb_query_add_condition(ctx_, query, "foo", TILEDB_EQ, &lo);
+  CHECK(rc == TILEDB_ERR);
+  rc = tiledb_query_free(ctx_, query);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_create(ctx_, &query, array_name.c_str(), TILEDB_WRITE);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_add_condition(ctx_, query, ATTR_NAME, TILEDB_EQ, &lo);
+  CHECK(rc == TILEDB_ERR);
+  rc = tiledb_query_free(ctx_, query);
+  REQUIRE(rc == TILEDB_OK);
+}
+
 void SparseArrayFx::test_random_subarrays(
     const std::string& array_name,
     int64_t domain_size_0,
@@ -487,6 +1347,72 @@ void SparseArrayFx::test_random_subarrays(
   }
 }
 
+void SparseArrayFx::check_est_read_buffer_sizes(
+    const std::string& array_name) {
+  // Each tile holds exactly the cells of a 10x10 space tile
+  create_sparse_array_2D(
+      array_name,
+      10,
+      10,
+      0,
+      99,
+      0,
+      99,
+      100,
+      TILEDB_NO_COMPRESSION,
+      TILEDB_ROW_MAJOR,
+      TILEDB_ROW_MAJOR);
+  write_sparse_array_unsorted_2D(array_name, 100, 100);
+
+  const char* attributes[] = {ATTR_NAME, TILEDB_COORDS};
+  uint64_t est_buffer_sizes[2];
+  uint64_t max_buffer_sizes[2];
+
+  // Subarray within a single tile
+  int64_t subarray_1[] = {0, 4, 0, 4};
+  int rc = tiledb_array_compute_est_read_buffer_sizes(
+      ctx_,
+      array_name.c_str(),
+      subarray_1,
+      attributes,
+      2,
+      est_buffer_sizes,
+      max_buffer_sizes);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(est_buffer_sizes[0] == 25 * sizeof(int));
+  CHECK(est_buffer_sizes[1] == 25 * 2 * sizeof(int64_t));
+  CHECK(max_buffer_sizes[0] == 100 * sizeof(int));
+  CHECK(max_buffer_sizes[1] == 100 * 2 * sizeof(int64_t));
+
+  // Subarray covering a quarter of four tiles
+  int64_t subarray_2[] = {5, 14, 5, 14};
+  rc = tiledb_array_compute_est_read_buffer_sizes(
+      ctx_,
+      array_name.c_str(),
+      subarray_2,
+      attributes,
+      2,
+      est_buffer_sizes,
+      max_buffer_sizes);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(est_buffer_sizes[0] == 100 * sizeof(int));
+  CHECK(est_buffer_sizes[1] == 100 * 2 * sizeof(int64_t));
+  CHECK(max_buffer_sizes[0] == 400 * sizeof(int));
+  CHECK(max_buffer_sizes[1] == 400 * 2 * sizeof(int64_t));
+
+  // The upper bounds are optional
+  rc = tiledb_array_compute_est_read_buffer_sizes(
+      ctx_,
+      array_name.c_str(),
+      subarray_2,
+      attributes,
+      2,
+      est_buffer_sizes,
+      nullptr);
+  REQUIRE(rc == TILEDB_OK);
+  CHECK(est_buffer_sizes[0] == 100 * sizeof(int));
+}
+
 void SparseArrayFx::check_sorted_reads(
     const std::string& array_name,
     tiledb_compressor_t compressor,
@@ -777,4 +1703,281 @@ TEST_CASE_METHOD(
           array_name, TILEDB_DOUBLE_DELTA, TILEDB_ROW_MAJOR, TILEDB_COL_MAJOR);
     }
   }
+
+  SECTION("- bit-packing compression, row/col-major") {
+    if (supports_s3_) {
+      // S3
+      array_name = S3_TEMP_DIR + ARRAY;
+      check_sorted_reads(
+          array_name, TILEDB_BITPACK, TILEDB_ROW_MAJOR, TILEDB_COL_MAJOR);
+    } else if (supports_hdfs_) {
+      // HDFS
+      array_name = HDFS_TEMP_DIR + ARRAY;
+      check_sorted_reads(
+          array_name, TILEDB_BITPACK, TILEDB_ROW_MAJOR, TILEDB_COL_MAJOR);
+    } else {
+      // File
+      array_name = FILE_URI_PREFIX + FILE_TEMP_DIR + ARRAY;
+      check_sorted_reads(
+          array_name, TILEDB_BITPACK, TILEDB_ROW_MAJOR, TILEDB_COL_MAJOR);
+    }
+  }
+
+  SECTION("- auto compression, row/col-major") {
+    if (supports_s3_) {
+      // S3
+      array_name = S3_TEMP_DIR + ARRAY;
+      check_sorted_reads(
+          array_name, TILEDB_AUTO, TILEDB_ROW_MAJOR, TILEDB_COL_MAJOR);
+    } else if (supports_hdfs_) {
+      // HDFS
+      array_name = HDFS_TEMP_DIR + ARRAY;
+      check_sorted_reads(
+          array_name, TILEDB_AUTO, TILEDB_ROW_MAJOR, TILEDB_COL_MAJOR);
+    } else {
+      // File
+      array_name = FILE_URI_PREFIX + FILE_TEMP_DIR + ARRAY;
+      check_sorted_reads(
+          array_name, TILEDB_AUTO, TILEDB_ROW_MAJOR, TILEDB_COL_MAJOR);
+    }
+  }
+}
+
+TEST_CASE_METHOD(
+    SparseArrayFx,
+    "C API: Test estimated read buffer sizes",
+    "[capi], [sparse], [est-buffer-sizes]") {
+  std::string array_name;
+
+  if (supports_s3_) {
+    // S3
+    array_name = S3_TEMP_DIR + ARRAY;
+  } else if (supports_hdfs_) {
+    // HDFS
+    array_name = HDFS_TEMP_DIR + ARRAY;
+  } else {
+    // File
+    array_name = FILE_URI_PREFIX + FILE_TEMP_DIR + ARRAY;
+  }
+  check_est_read_buffer_sizes(array_name);
+}
+
+std::string SparseArrayFx::read_fragment_manifest(
+    const std::string& array_name) {
+  auto manifest_uri = array_name + "/__fragment_manifest.tdb";
+  int is_file = 0;
+  int rc = tiledb_vfs_is_file(ctx_, vfs_, manifest_uri.c_str(), &is_file);
+  REQUIRE(rc == TILEDB_OK);
+  if (!is_file)
+    return "";
+
+  uint64_t size;
+  rc = tiledb_vfs_file_size(ctx_, vfs_, manifest_uri.c_str(), &size);
+  REQUIRE(rc == TILEDB_OK);
+  std::string manifest(size, '\0');
+  tiledb_vfs_fh_t* fh;
+  rc = tiledb_vfs_open(ctx_, vfs_, manifest_uri.c_str(), TILEDB_VFS_READ, &fh);
+  REQUIRE(rc == TILEDB_OK);
+  if (size != 0) {
+    rc = tiledb_vfs_read(ctx_, fh, 0, &manifest[0], size);
+    REQUIRE(rc == TILEDB_OK);
+  }
+  rc = tiledb_vfs_close(ctx_, fh);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_vfs_fh_free(ctx_, fh);
+  REQUIRE(rc == TILEDB_OK);
+
+  return manifest;
+}
+
+void SparseArrayFx::check_snapshot_reads(
+    const std::string& array_name, bool lock_free) {
+  create_sparse_array_2D(
+      array_name,
+      10,
+      10,
+      0,
+      99,
+      0,
+      99,
+      100,
+      TILEDB_NO_COMPRESSION,
+      TILEDB_ROW_MAJOR,
+      TILEDB_ROW_MAJOR);
+  write_sparse_array_unsorted_2D(array_name, 20, 20);
+  write_sparse_array_unsorted_2D(array_name, 20, 20);
+
+  // Read and consolidate in a context that may skip the array lock on reads
+  tiledb_config_t* config = nullptr;
+  tiledb_error_t* error = nullptr;
+  REQUIRE(tiledb_config_create(&config, &error) == TILEDB_OK);
+  REQUIRE(
+      tiledb_config_set(
+          config,
+          "sm.lock_free_reads",
+          lock_free ? "true" : "false",
+          &error) == TILEDB_OK);
+  tiledb_ctx_t* ctx;
+  REQUIRE(tiledb_ctx_create(&ctx, config) == TILEDB_OK);
+  REQUIRE(tiledb_config_free(config) == TILEDB_OK);
+
+  // Create a read query, which holds a snapshot of the two fragments
+  const char* attributes[] = {ATTR_NAME};
+  const int64_t subarray[] = {0, 19, 0, 19};
+  int buffer_a1[400];
+  void* buffers[] = {buffer_a1};
+  uint64_t buffer_sizes[] = {sizeof(buffer_a1)};
+  tiledb_query_t* query;
+  int rc = tiledb_query_create(ctx, &query, array_name.c_str(), TILEDB_READ);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_buffers(
+      ctx, query, attributes, 1, buffers, buffer_sizes);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_subarray(ctx, query, subarray);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_query_set_layout(ctx, query, TILEDB_ROW_MAJOR);
+  REQUIRE(rc == TILEDB_OK);
+
+  // Consolidation cannot delete the fragments while the snapshot is held,
+  // whether or not the read also holds the shared lock of the array
+  std::atomic<bool> consolidated(false);
+  int consolidate_rc = TILEDB_ERR;
+  std::thread consolidator([&]() {
+    consolidate_rc = tiledb_array_consolidate(ctx, array_name.c_str());
+    consolidated = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  CHECK(!consolidated);
+
+  // The snapshot is still readable
+  rc = tiledb_query_submit(ctx, query);
+  REQUIRE(rc == TILEDB_OK);
+  for (int i = 0; i < 400; ++i)
+    CHECK(buffer_a1[i] == i);
+
+  // Without the array lock, consolidation removes the fragments from the
+  // manifest and then waits for the snapshot. An array opened meanwhile
+  // must not snapshot the fragments about to be deleted.
+  int buffer_b1[400];
+  void* buffers_2[] = {buffer_b1};
+  uint64_t buffer_sizes_2[] = {sizeof(buffer_b1)};
+  tiledb_query_t* query_2 = nullptr;
+  if (lock_free) {
+    auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (read_fragment_manifest(array_name).find("del ") ==
+               std::string::npos &&
+           std::chrono::steady_clock::now() < deadline)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    REQUIRE(
+        read_fragment_manifest(array_name).find("del ") != std::string::npos);
+    rc = tiledb_query_create(ctx, &query_2, array_name.c_str(), TILEDB_READ);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_query_set_buffers(
+        ctx, query_2, attributes, 1, buffers_2, buffer_sizes_2);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_query_set_subarray(ctx, query_2, subarray);
+    REQUIRE(rc == TILEDB_OK);
+    rc = tiledb_query_set_layout(ctx, query_2, TILEDB_ROW_MAJOR);
+    REQUIRE(rc == TILEDB_OK);
+  }
+  rc = tiledb_query_free(ctx, query);
+  REQUIRE(rc == TILEDB_OK);
+
+  // Consolidation completes while the array opened during it is still open,
+  // which reads the consolidated fragment
+  if (lock_free) {
+    auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!consolidated && std::chrono::steady_clock::now() < deadline)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    CHECK(consolidated);
+    rc = tiledb_query_submit(ctx, query_2);
+    REQUIRE(rc == TILEDB_OK);
+    for (int i = 0; i < 400; ++i)
+      CHECK(buffer_b1[i] == i);
+    rc = tiledb_query_free(ctx, query_2);
+    REQUIRE(rc == TILEDB_OK);
+  }
+
+  // Releasing the snapshots lets consolidation complete
+  consolidator.join();
+  CHECK(consolidated);
+  CHECK(consolidate_rc == TILEDB_OK);
+  int* buffer = read_sparse_array_2D(
+      array_name, 0, 19, 0, 19, TILEDB_READ, TILEDB_ROW_MAJOR);
+  for (int i = 0; i < 400; ++i)
+    CHECK(buffer[i] == i);
+  delete[] buffer;
+  CHECK(tiledb_ctx_free(ctx) == TILEDB_OK);
+}
+
+TEST_CASE_METHOD(
+    SparseArrayFx,
+    "C API: Test reads on snapshots during consolidation",
+    "[capi], [sparse], [snapshot]") {
+  bool lock_free = false;
+  SECTION("- locked reads") {
+    lock_free = false;
+  }
+  SECTION("- lock-free reads") {
+    lock_free = true;
+  }
+  check_snapshot_reads(FILE_URI_PREFIX + FILE_TEMP_DIR + ARRAY, lock_free);
+}
+
+TEST_CASE_METHOD(
+    SparseArrayFx,
+    "C API: Test consolidation copying non-overlapping fragments",
+    "[capi], [sparse], [consolidation]") {
+  check_copy_consolidation(FILE_URI_PREFIX + FILE_TEMP_DIR + ARRAY);
+}
+
+TEST_CASE_METHOD(
+    SparseArrayFx,
+    "C API: Test consolidation progress under a memory budget",
+    "[capi], [sparse], [consolidation]") {
+  check_consolidation_progress(FILE_URI_PREFIX + FILE_TEMP_DIR + ARRAY);
+}
+
+TEST_CASE_METHOD(
+    SparseArrayFx,
+    "C API: Test reads within a timestamp range",
+    "[capi], [sparse], [timestamp]") {
+  check_timestamp_range_reads(FILE_URI_PREFIX + FILE_TEMP_DIR + ARRAY);
+}
+
+TEST_CASE_METHOD(
+    SparseArrayFx,
+    "C API: Test query and context stats",
+    "[capi], [sparse], [stats]") {
+  check_query_stats(FILE_URI_PREFIX + FILE_TEMP_DIR + ARRAY);
+}
+
+TEST_CASE_METHOD(
+    SparseArrayFx,
+    "C API: Test tracing into a Chrome trace file",
+    "[capi], [sparse], [trace]") {
+  check_trace(FILE_URI_PREFIX + FILE_TEMP_DIR + ARRAY);
+}
+
+TEST_CASE_METHOD(
+    SparseArrayFx,
+    "C API: Test Gorilla compression of real values",
+    "[capi], [sparse], [gorilla]") {
+  check_gorilla_compression(FILE_URI_PREFIX + FILE_TEMP_DIR + ARRAY);
+}
+
+TEST_CASE_METHOD(
+    SparseArrayFx,
+    "C API: Test adaptive compression",
+    "[capi], [sparse], [auto-compression]") {
+  check_auto_compression(FILE_URI_PREFIX + FILE_TEMP_DIR + ARRAY);
+}
+
+TEST_CASE_METHOD(
+    SparseArrayFx,
+    "C API: Test query conditions",
+    "[capi], [sparse], [query-condition]") {
+  check_query_conditions(FILE_URI_PREFIX + FILE_TEMP_DIR + ARRAY);
 }
@@ -0,0 +1,168 @@
+/**
+ * @file   unit-compression-bitpack.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB Inc.
+ * @copyright Copyright (c) 2016 MIT and Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * @section DESCRIPTION
+ *
+ * Tests the frame-of-reference bit-packing compression.
+ */
+
+#include "bitpack_compressor.h"
+#include "catch.hpp"
+
+#include <cstring>
+#include <limits>
+#include <vector>
+
+/**
+ * Compresses and decompresses the input values and checks that they are
+ * restored. Returns the compressed size.
+ */
+template <class T>
+static uint64_t check_round_trip(
+    tiledb::Datatype type, const std::vector<T>& data) {
+  // Compress
+  tiledb::ConstBuffer comp_in_buff(data.data(), data.size() * sizeof(T));
+  tiledb::Buffer comp_out_buff;
+  auto st = tiledb::BitPack::compress(type, &comp_in_buff, &comp_out_buff);
+  REQUIRE(st.ok());
+  CHECK(
+      comp_out_buff.size() <=
+      data.size() * sizeof(T) + tiledb::BitPack::overhead(0));
+
+  // Decompress
+  tiledb::ConstBuffer decomp_in_buff(
+      comp_out_buff.data(), comp_out_buff.size());
+  tiledb::Buffer decomp_out_buff;
+  st = tiledb::BitPack::decompress(type, &decomp_in_buff, &decomp_out_buff);
+  REQUIRE(st.ok());
+
+  // Check data
+  REQUIRE(decomp_out_buff.size() == data.size() * sizeof(T));
+  CHECK(!memcmp(
+      decomp_out_buff.data(), data.data(), data.size() * sizeof(T)));
+
+  return comp_out_buff.size();
+}
+
+/** Checks round trips for several sizes and value ranges of a type. */
+template <class T>
+static void check_type(tiledb::Datatype type) {
+  const T min = std::numeric_limits<T>::min();
+  const T max = std::numeric_limits<T>::max();
+
+  // Sizes around the block boundaries of both word types
+  std::vector<size_t> sizes = {1, 127, 128, 129, 256, 1000, 4097};
+  for (auto size : sizes) {
+    std::vector<T> data(size);
+
+    // Constant values
+    for (size_t i = 0; i < size; ++i)
+      data[i] = (T)7;
+    check_round_trip(type, data);
+
+    // Narrow range around a negative (when signed) reference
+    for (size_t i = 0; i < size; ++i)
+      data[i] = (T)((T)(min / 2) + (T)((i * 7) % 100));
+    check_round_trip(type, data);
+
+    // Full range
+    for (size_t i = 0; i < size; ++i)
+      data[i] = (i % 2) ? max : min;
+    check_round_trip(type, data);
+  }
+}
+
+TEST_CASE(
+    "Compression-BitPack: Test all types", "[compression], [bitpack]") {
+  check_type<char>(tiledb::Datatype::CHAR);
+  check_type<int8_t>(tiledb::Datatype::INT8);
+  check_type<uint8_t>(tiledb::Datatype::UINT8);
+  check_type<int16_t>(tiledb::Datatype::INT16);
+  check_type<uint16_t>(tiledb::Datatype::UINT16);
+  check_type<int>(tiledb::Datatype::INT32);
+  check_type<uint32_t>(tiledb::Datatype::UINT32);
+  check_type<int64_t>(tiledb::Datatype::INT64);
+  check_type<uint64_t>(tiledb::Datatype::UINT64);
+}
+
+TEST_CASE(
+    "Compression-BitPack: Test every bit width", "[compression], [bitpack]") {
+  for (unsigned int bitwidth = 1; bitwidth <= 64; ++bitwidth) {
+    uint64_t range = (bitwidth == 64) ? ~uint64_t(0) :
+                                        (uint64_t(1) << bitwidth) - 1;
+    uint64_t base = (bitwidth == 64) ? 0 : 1000;
+    std::vector<uint64_t> data(512);
+    for (size_t i = 0; i < data.size(); ++i)
+      data[i] = base + (i * 2654435761ULL) % (range / 2 + 1);
+    data[3] = base + range;
+    data[5] = base;
+    auto size = check_round_trip(tiledb::Datatype::UINT64, data);
+    CHECK(size == tiledb::BitPack::overhead(0) + 512 * bitwidth / 8);
+
+    if (bitwidth <= 32) {
+      std::vector<int> data32(512);
+      for (size_t i = 0; i < data32.size(); ++i)
+        data32[i] = (int)(-1000 + (int64_t)(data[i] & range));
+      check_round_trip(tiledb::Datatype::INT32, data32);
+    }
+  }
+}
+
+TEST_CASE(
+    "Compression-BitPack: Test narrow range ratio",
+    "[compression], [bitpack]") {
+  // 1024 int32 values in [1000000, 1000015] take 4 bits each
+  std::vector<int> data(1024);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = 1000000 + (int)(i % 16);
+  auto size = check_round_trip(tiledb::Datatype::INT32, data);
+  CHECK(size == tiledb::BitPack::overhead(0) + 1024 * 4 / 8);
+}
+
+TEST_CASE(
+    "Compression-BitPack: Test invalid input", "[compression], [bitpack]") {
+  // Real values are not supported
+  float f[] = {1.0f, 2.0f};
+  tiledb::ConstBuffer in_f(f, sizeof(f));
+  tiledb::Buffer out;
+  CHECK(!tiledb::BitPack::compress(tiledb::Datatype::FLOAT32, &in_f, &out)
+             .ok());
+
+  // Truncated compressed data
+  std::vector<int> data(300, 5);
+  data[10] = 100;
+  tiledb::ConstBuffer in(data.data(), data.size() * sizeof(int));
+  tiledb::Buffer compressed;
+  REQUIRE(
+      tiledb::BitPack::compress(tiledb::Datatype::INT32, &in, &compressed)
+          .ok());
+  tiledb::ConstBuffer truncated(compressed.data(), compressed.size() - 1);
+  tiledb::Buffer decompressed;
+  CHECK(!tiledb::BitPack::decompress(
+             tiledb::Datatype::INT32, &truncated, &decompressed)
+             .ok());
+}
@@ -0,0 +1,187 @@
+/**
+ * @file   unit-compression-contexts.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB Inc.
+ * @copyright Copyright (c) 2016 MIT and Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * @section DESCRIPTION
+ *
+ * Tests the reuse of the per-thread compression contexts and of the
+ * coordinate split/zip scratch space.
+ */
+
+#include "catch.hpp"
+#include "gzip_compressor.h"
+#include "tile.h"
+#include "zstd_compressor.h"
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+/** A compression function of GZip or ZStd. */
+typedef tiledb::Status (*CompressFunc)(
+    int, tiledb::ConstBuffer*, tiledb::Buffer*);
+
+/** A decompression function of GZip or ZStd. */
+typedef tiledb::Status (*DecompressFunc)(
+    tiledb::ConstBuffer*, tiledb::Buffer*);
+
+/**
+ * Compresses the input values at each of the input levels in turn, with
+ * the contexts of the calling thread, and checks that every round trip
+ * restores the values.
+ */
+static void check_round_trips(
+    CompressFunc compress,
+    DecompressFunc decompress,
+    uint64_t overhead,
+    const std::vector<int>& levels,
+    const std::vector<int>& data) {
+  uint64_t nbytes = data.size() * sizeof(int);
+  for (auto level : levels) {
+    // Compress
+    tiledb::ConstBuffer comp_in_buff(data.data(), nbytes);
+    tiledb::Buffer comp_out_buff;
+    REQUIRE(comp_out_buff.realloc(nbytes + overhead).ok());
+    REQUIRE(compress(level, &comp_in_buff, &comp_out_buff).ok());
+
+    // Decompress
+    tiledb::ConstBuffer decomp_in_buff(
+        comp_out_buff.data(), comp_out_buff.size());
+    tiledb::Buffer decomp_out_buff;
+    REQUIRE(decomp_out_buff.realloc(nbytes).ok());
+    REQUIRE(decompress(&decomp_in_buff, &decomp_out_buff).ok());
+
+    // Check data
+    REQUIRE(decomp_out_buff.size() == nbytes);
+    CHECK(!memcmp(decomp_out_buff.data(), data.data(), nbytes));
+  }
+}
+
+TEST_CASE(
+    "Compression contexts: Test reuse across levels and threads",
+    "[compression], [contexts]") {
+  std::vector<int> data(10000);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = (int)(i % 97) * 3;
+  uint64_t nbytes = data.size() * sizeof(int);
+  std::vector<int> levels = {1, 9, -1, -1, 3, 1};
+
+  SECTION("- gzip") {
+    check_round_trips(
+        tiledb::GZip::compress,
+        tiledb::GZip::decompress,
+        tiledb::GZip::overhead(nbytes),
+        levels,
+        data);
+  }
+
+  SECTION("- zstd") {
+    check_round_trips(
+        tiledb::ZStd::compress,
+        tiledb::ZStd::decompress,
+        tiledb::ZStd::overhead(nbytes),
+        levels,
+        data);
+  }
+
+  SECTION("- concurrent threads") {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back([&]() {
+        check_round_trips(
+            tiledb::GZip::compress,
+            tiledb::GZip::decompress,
+            tiledb::GZip::overhead(nbytes),
+            levels,
+            data);
+        check_round_trips(
+            tiledb::ZStd::compress,
+            tiledb::ZStd::decompress,
+            tiledb::ZStd::overhead(nbytes),
+            levels,
+            data);
+      });
+    }
+    for (auto& thread : threads)
+      thread.join();
+  }
+
+  SECTION("- corrupt input") {
+    // A failed decompression leaves the contexts reusable
+    std::vector<char> garbage(100, 'x');
+    tiledb::ConstBuffer in_buff(garbage.data(), garbage.size());
+    tiledb::Buffer out_buff;
+    REQUIRE(out_buff.realloc(nbytes).ok());
+    CHECK(!tiledb::GZip::decompress(&in_buff, &out_buff).ok());
+    CHECK(!tiledb::ZStd::decompress(&in_buff, &out_buff).ok());
+    check_round_trips(
+        tiledb::GZip::compress,
+        tiledb::GZip::decompress,
+        tiledb::GZip::overhead(nbytes),
+        levels,
+        data);
+    check_round_trips(
+        tiledb::ZStd::compress,
+        tiledb::ZStd::decompress,
+        tiledb::ZStd::overhead(nbytes),
+        levels,
+        data);
+  }
+}
+
+TEST_CASE(
+    "Compression contexts: Test coordinate split/zip scratch reuse",
+    "[compression], [contexts]") {
+  // 2D int64 coordinates of growing tiles, split and zipped back
+  tiledb::Buffer scratch;
+  for (uint64_t cell_num : {10, 1000, 10, 0}) {
+    std::vector<int64_t> coords(2 * cell_num);
+    for (uint64_t i = 0; i < cell_num; ++i) {
+      coords[2 * i] = (int64_t)i;
+      coords[2 * i + 1] = -(int64_t)i;
+    }
+    auto expected = coords;
+    uint64_t nbytes = coords.size() * sizeof(int64_t);
+    tiledb::Buffer buff(coords.data(), nbytes, false);
+    tiledb::Tile tile(
+        tiledb::Datatype::INT64,
+        tiledb::Compressor::NO_COMPRESSION,
+        -1,
+        2 * sizeof(int64_t),
+        2,
+        &buff,
+        false);
+
+    REQUIRE(tile.split_coordinates(&scratch).ok());
+    for (uint64_t i = 0; i < cell_num; ++i) {
+      CHECK(coords[i] == (int64_t)i);
+      CHECK(coords[cell_num + i] == -(int64_t)i);
+    }
+    REQUIRE(tile.zip_coordinates(&scratch).ok());
+    CHECK(coords == expected);
+  }
+  CHECK(scratch.alloced_size() == 1000 * 2 * sizeof(int64_t));
+}
@@ -0,0 +1,135 @@
+/**
+ * @file   unit-compression-gorilla.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB Inc.
+ * @copyright Copyright (c) 2016 MIT and Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * @section DESCRIPTION
+ *
+ * Tests the XOR (Gorilla) compression.
+ */
+
+#include "catch.hpp"
+#include "gorilla_compressor.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+/**
+ * Compresses and decompresses the input values and checks that they are
+ * restored bit by bit. Returns the compressed size.
+ */
+template <class T>
+static uint64_t check_round_trip(
+    tiledb::Datatype type, const std::vector<T>& data) {
+  // Compress
+  uint64_t nbytes = data.size() * sizeof(T);
+  tiledb::ConstBuffer comp_in_buff(data.data(), nbytes);
+  tiledb::Buffer comp_out_buff;
+  auto st = tiledb::Gorilla::compress(type, &comp_in_buff, &comp_out_buff);
+  REQUIRE(st.ok());
+  CHECK(comp_out_buff.size() <= nbytes + tiledb::Gorilla::overhead(nbytes));
+
+  // Decompress
+  tiledb::ConstBuffer decomp_in_buff(
+      comp_out_buff.data(), comp_out_buff.size());
+  tiledb::Buffer decomp_out_buff;
+  st = tiledb::Gorilla::decompress(type, &decomp_in_buff, &decomp_out_buff);
+  REQUIRE(st.ok());
+
+  // Check data
+  REQUIRE(decomp_out_buff.size() == nbytes);
+  CHECK(!memcmp(decomp_out_buff.data(), data.data(), nbytes));
+
+  return comp_out_buff.size();
+}
+
+/** Checks round trips of several value patterns of a real type. */
+template <class T>
+static void check_type(tiledb::Datatype type) {
+  // Single value
+  check_round_trip<T>(type, {(T)1.5});
+
+  // Smooth series with repeated values
+  std::vector<T> smooth(1000);
+  for (size_t i = 0; i < smooth.size(); ++i)
+    smooth[i] = (T)(20.0 + std::floor(std::sin(i / 50.0) * 40) / 8);
+  auto size = check_round_trip(type, smooth);
+  CHECK(size < smooth.size() * sizeof(T) / 4);
+
+  // Special values and sign changes
+  std::vector<T> special = {(T)0.0,
+                            (T)-0.0,
+                            std::numeric_limits<T>::infinity(),
+                            -std::numeric_limits<T>::infinity(),
+                            std::numeric_limits<T>::quiet_NaN(),
+                            std::numeric_limits<T>::denorm_min(),
+                            std::numeric_limits<T>::max(),
+                            std::numeric_limits<T>::lowest(),
+                            (T)1.0,
+                            (T)-1.0};
+  check_round_trip(type, special);
+
+  // Unrelated values, which force frequent new windows
+  std::vector<T> noisy(777);
+  uint64_t seed = 12345;
+  for (size_t i = 0; i < noisy.size(); ++i) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    noisy[i] = (T)((double)(seed >> 11) / (double)(1ULL << 53) * 1e6);
+  }
+  check_round_trip(type, noisy);
+}
+
+TEST_CASE(
+    "Compression-Gorilla: Test real types", "[compression], [gorilla]") {
+  check_type<float>(tiledb::Datatype::FLOAT32);
+  check_type<double>(tiledb::Datatype::FLOAT64);
+}
+
+TEST_CASE(
+    "Compression-Gorilla: Test invalid input", "[compression], [gorilla]") {
+  // Integer values are not supported
+  int data_int[] = {1, 2};
+  tiledb::ConstBuffer in_int(data_int, sizeof(data_int));
+  tiledb::Buffer out;
+  CHECK(!tiledb::Gorilla::compress(tiledb::Datatype::INT32, &in_int, &out)
+             .ok());
+
+  // Truncated compressed data
+  std::vector<double> data(100);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = i * 0.1;
+  tiledb::ConstBuffer in(data.data(), data.size() * sizeof(double));
+  tiledb::Buffer compressed;
+  REQUIRE(
+      tiledb::Gorilla::compress(tiledb::Datatype::FLOAT64, &in, &compressed)
+          .ok());
+  tiledb::ConstBuffer truncated(compressed.data(), compressed.size() - 8);
+  tiledb::Buffer decompressed;
+  CHECK(!tiledb::Gorilla::decompress(
+             tiledb::Datatype::FLOAT64, &truncated, &decompressed)
+             .ok());
+}
@@ -0,0 +1,162 @@
+/**
+ * @file   unit-dict_encoder.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB Inc.
+ * @copyright Copyright (c) 2016 MIT and Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * @section DESCRIPTION
+ *
+ * Tests the dictionary encoding of variable-sized cells.
+ */
+
+#include "catch.hpp"
+#include "dict_encoder.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * Encodes and decodes the input cells and checks that the values are
+ * restored. The offsets start at `base`, as if the cells were not the first
+ * in the attribute. Returns the encoded size.
+ */
+static uint64_t check_round_trip(
+    const std::vector<std::string>& cells, uint64_t base = 0) {
+  // Prepare the offsets and values
+  std::vector<uint64_t> offsets;
+  std::string values;
+  for (const auto& cell : cells) {
+    offsets.push_back(base + values.size());
+    values += cell;
+  }
+
+  // Encode
+  tiledb::ConstBuffer offsets_buff(
+      offsets.data(), offsets.size() * sizeof(uint64_t));
+  tiledb::ConstBuffer values_buff(values.data(), values.size());
+  tiledb::Buffer encoded;
+  auto st = tiledb::DictEncoder::encode(&offsets_buff, &values_buff, &encoded);
+  REQUIRE(st.ok());
+  CHECK(encoded.size() <= values.size() + 1);
+
+  // Decode
+  tiledb::ConstBuffer decode_in(encoded.data(), encoded.size());
+  tiledb::Buffer decoded;
+  st = tiledb::DictEncoder::decode(&decode_in, &decoded);
+  REQUIRE(st.ok());
+
+  // Check values
+  REQUIRE(decoded.size() == values.size());
+  CHECK(!memcmp(decoded.data(), values.data(), values.size()));
+
+  return encoded.size();
+}
+
+/** Returns `cell_num` cells cycling through `distinct_num` values. */
+static std::vector<std::string> make_cells(
+    uint64_t cell_num, uint64_t distinct_num) {
+  std::vector<std::string> cells;
+  for (uint64_t i = 0; i < cell_num; ++i)
+    cells.push_back("category_" + std::to_string(i % distinct_num));
+  return cells;
+}
+
+TEST_CASE("DictEncoder: Test round trips", "[dict]") {
+  SECTION("- low cardinality") {
+    std::vector<std::string> cells = {
+        "USA", "Greece", "USA", "France", "Greece", "USA", "USA", "France"};
+    cells.insert(cells.end(), cells.begin(), cells.end());
+    auto size = check_round_trip(cells, 1234);
+    CHECK(size > 0);
+
+    auto many = make_cells(10000, 10);
+    size = check_round_trip(many);
+    CHECK(size < 10000 * 2);
+  }
+
+  SECTION("- code sizes") {
+    // 1-byte, 2-byte and 4-byte codes
+    auto size = check_round_trip(make_cells(100000, 256));
+    CHECK(size < 100000 * 2);
+    size = check_round_trip(make_cells(100000, 257));
+    CHECK(size < 100000 * 3);
+    check_round_trip(make_cells(200000, 70000));
+  }
+
+  SECTION("- empty cells") {
+    check_round_trip({"", "a", "", "a", "", "", "a", ""});
+    check_round_trip({"", "", "", ""});
+  }
+
+  SECTION("- unique values") {
+    // The dictionary does not pay off, so the values are stored as is
+    std::vector<std::string> cells = {"alpha", "beta", "gamma", "delta"};
+    std::string values = "alphabetagammadelta";
+    auto size = check_round_trip(cells);
+    CHECK(size == values.size() + 1);
+  }
+}
+
+TEST_CASE("DictEncoder: Test invalid input", "[dict]") {
+  // Offsets beyond the values
+  uint64_t offsets[] = {0, 10};
+  char values[] = "abc";
+  tiledb::ConstBuffer offsets_buff(offsets, sizeof(offsets));
+  tiledb::ConstBuffer values_buff(values, 3);
+  tiledb::Buffer out;
+  CHECK(!tiledb::DictEncoder::encode(&offsets_buff, &values_buff, &out).ok());
+
+  // Unknown encoding flag
+  char flag = 2;
+  tiledb::ConstBuffer bad_flag(&flag, sizeof(flag));
+  tiledb::Buffer decoded;
+  CHECK(!tiledb::DictEncoder::decode(&bad_flag, &decoded).ok());
+
+  // Code out of the dictionary
+  std::vector<std::string> cells(100, "abc");
+  std::vector<uint64_t> cell_offsets;
+  for (uint64_t i = 0; i < cells.size(); ++i)
+    cell_offsets.push_back(3 * i);
+  std::string cell_values(300, ' ');
+  for (uint64_t i = 0; i < cells.size(); ++i)
+    memcpy(&cell_values[3 * i], "abc", 3);
+  tiledb::ConstBuffer cell_offsets_buff(
+      cell_offsets.data(), cell_offsets.size() * sizeof(uint64_t));
+  tiledb::ConstBuffer cell_values_buff(cell_values.data(), cell_values.size());
+  tiledb::Buffer encoded;
+  REQUIRE(tiledb::DictEncoder::encode(
+              &cell_offsets_buff, &cell_values_buff, &encoded)
+              .ok());
+  REQUIRE(((char*)encoded.data())[0] == 1);
+  ((char*)encoded.data())[encoded.size() - 1] = 5;
+  tiledb::ConstBuffer bad_code(encoded.data(), encoded.size());
+  tiledb::Buffer decoded_2;
+  CHECK(!tiledb::DictEncoder::decode(&bad_code, &decoded_2).ok());
+
+  // Truncated input
+  tiledb::ConstBuffer truncated(encoded.data(), encoded.size() - 1);
+  tiledb::Buffer decoded_3;
+  CHECK(!tiledb::DictEncoder::decode(&truncated, &decoded_3).ok());
+}
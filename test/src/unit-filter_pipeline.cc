@@ -0,0 +1,197 @@
+/**
+ * @file   unit-filter_pipeline.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB Inc.
+ * @copyright Copyright (c) 2016 MIT and Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * @section DESCRIPTION
+ *
+ * Tests for the filter pipeline.
+ */
+
+#include <cstring>
+#include <vector>
+
+#include "catch.hpp"
+#include "filter_pipeline.h"
+
+using namespace tiledb;
+
+/**
+ * Runs the pipeline forward and then in reverse on a copy of the input
+ * and checks that the original bytes are restored.
+ */
+static void check_round_trip(
+    const FilterPipeline& pipeline,
+    Datatype type,
+    const std::vector<unsigned char>& input) {
+  std::vector<unsigned char> data(input);
+  Buffer scratch;
+  CHECK(pipeline
+            .run_forward(type, data.data(), (uint64_t)data.size(), &scratch)
+            .ok());
+  CHECK(pipeline
+            .run_reverse(type, data.data(), (uint64_t)data.size(), &scratch)
+            .ok());
+  CHECK(data == input);
+}
+
+TEST_CASE("FilterPipeline: Test round trips", "[filter]") {
+  std::vector<Datatype> types = {
+      Datatype::INT8, Datatype::INT16, Datatype::INT32, Datatype::FLOAT64};
+  std::vector<std::vector<FilterType>> pipelines = {
+      {FilterType::FILTER_BYTESHUFFLE},
+      {FilterType::FILTER_BITSHUFFLE},
+      {FilterType::FILTER_DELTA},
+      {FilterType::FILTER_DOUBLE_DELTA},
+      {FilterType::FILTER_DELTA, FilterType::FILTER_BYTESHUFFLE},
+      {FilterType::FILTER_DOUBLE_DELTA, FilterType::FILTER_BITSHUFFLE},
+  };
+
+  // Sizes that are not multiples of the value size or of the bitshuffle
+  // group of 8 values leave a remainder that must stay intact
+  std::vector<size_t> sizes = {0, 1, 7, 64, 100, 1003};
+  for (const auto& filters : pipelines) {
+    FilterPipeline pipeline;
+    for (auto f : filters)
+      pipeline.add_filter(f);
+    for (auto type : types) {
+      for (auto size : sizes) {
+        std::vector<unsigned char> input(size);
+        for (size_t i = 0; i < size; ++i)
+          input[i] = (unsigned char)((i * 37 + i / 5) & 0xFF);
+        check_round_trip(pipeline, type, input);
+      }
+    }
+  }
+}
+
+TEST_CASE("FilterPipeline: Test byteshuffle layout", "[filter]") {
+  FilterPipeline pipeline;
+  pipeline.add_filter(FilterType::FILTER_BYTESHUFFLE);
+
+  uint16_t data[4] = {0x0102, 0x0304, 0x0506, 0x0708};
+  Buffer scratch;
+  REQUIRE(pipeline.run_forward(Datatype::UINT16, data, sizeof(data), &scratch)
+              .ok());
+
+  // All low bytes first, then all high bytes
+  unsigned char expected[8] = {0x02, 0x04, 0x06, 0x08, 0x01, 0x03, 0x05, 0x07};
+  CHECK(!memcmp(data, expected, sizeof(expected)));
+}
+
+TEST_CASE("FilterPipeline: Test bitshuffle layout", "[filter]") {
+  FilterPipeline pipeline;
+  pipeline.add_filter(FilterType::FILTER_BITSHUFFLE);
+
+  int32_t data[8];
+  for (int i = 0; i < 8; ++i)
+    data[i] = 1;
+  Buffer scratch;
+  REQUIRE(pipeline.run_forward(Datatype::INT32, data, sizeof(data), &scratch)
+              .ok());
+
+  // Only the lowest bit plane is set
+  auto bytes = (unsigned char*)data;
+  CHECK(bytes[0] == 0xFF);
+  for (size_t i = 1; i < sizeof(data); ++i)
+    CHECK(bytes[i] == 0);
+}
+
+TEST_CASE("FilterPipeline: Test delta", "[filter]") {
+  FilterPipeline pipeline;
+  pipeline.add_filter(FilterType::FILTER_DELTA);
+
+  int64_t data[5] = {100, 101, 103, 106, 110};
+  Buffer scratch;
+  REQUIRE(pipeline.run_forward(Datatype::INT64, data, sizeof(data), &scratch)
+              .ok());
+  int64_t expected[5] = {100, 1, 2, 3, 4};
+  CHECK(!memcmp(data, expected, sizeof(expected)));
+
+  pipeline.clear();
+  CHECK(pipeline.empty());
+  pipeline.add_filter(FilterType::FILTER_DOUBLE_DELTA);
+  int64_t ramp[5] = {100, 101, 103, 106, 110};
+  REQUIRE(pipeline.run_forward(Datatype::INT64, ramp, sizeof(ramp), &scratch)
+              .ok());
+  int64_t expected_dd[5] = {100, -99, 1, 1, 1};
+  CHECK(!memcmp(ramp, expected_dd, sizeof(expected_dd)));
+}
+
+TEST_CASE("FilterPipeline: Test serialization", "[filter]") {
+  FilterPipeline pipeline;
+  pipeline.add_filter(FilterType::FILTER_DELTA);
+  pipeline.add_filter(FilterType::FILTER_BITSHUFFLE);
+
+  Buffer buff;
+  REQUIRE(pipeline.serialize(&buff).ok());
+  ConstBuffer cbuff(&buff);
+  FilterPipeline loaded;
+  REQUIRE(loaded.deserialize(&cbuff).ok());
+  REQUIRE(loaded.filter_num() == 2);
+  CHECK(loaded.filter(0) == FilterType::FILTER_DELTA);
+  CHECK(loaded.filter(1) == FilterType::FILTER_BITSHUFFLE);
+
+  // Unknown filter type
+  Buffer bad;
+  unsigned int filter_num = 1;
+  REQUIRE(bad.write(&filter_num, sizeof(filter_num)).ok());
+  char type = 100;
+  REQUIRE(bad.write(&type, sizeof(type)).ok());
+  ConstBuffer cbad(&bad);
+  FilterPipeline invalid;
+  CHECK(!invalid.deserialize(&cbad).ok());
+}
+
+TEST_CASE("FilterPipeline: Test var offsets filters", "[filter]") {
+  // Nothing runs without compression or before double delta
+  CHECK(FilterPipeline::var_offsets_filters(Compressor::NO_COMPRESSION) ==
+        nullptr);
+  CHECK(FilterPipeline::var_offsets_filters(Compressor::DOUBLE_DELTA) ==
+        nullptr);
+
+  // Byte-oriented compressors get shuffled deltas
+  auto filters = FilterPipeline::var_offsets_filters(Compressor::ZSTD);
+  REQUIRE(filters != nullptr);
+  REQUIRE(filters->filter_num() == 2);
+  CHECK(filters->filter(0) == FilterType::FILTER_DELTA);
+  CHECK(filters->filter(1) == FilterType::FILTER_BYTESHUFFLE);
+
+  // Blosc shuffles on its own
+  filters = FilterPipeline::var_offsets_filters(Compressor::BLOSC_ZSTD);
+  REQUIRE(filters != nullptr);
+  REQUIRE(filters->filter_num() == 1);
+  CHECK(filters->filter(0) == FilterType::FILTER_DELTA);
+
+  // The offsets become the cell sizes
+  uint64_t offsets[4] = {1000, 1003, 1003, 1010};
+  Buffer scratch;
+  filters = FilterPipeline::var_offsets_filters(Compressor::BITPACK);
+  REQUIRE(filters->run_forward(
+                     Datatype::UINT64, offsets, sizeof(offsets), &scratch)
+              .ok());
+  uint64_t expected[4] = {1000, 3, 0, 7};
+  CHECK(!memcmp(offsets, expected, sizeof(expected)));
+}
@@ -0,0 +1,124 @@
+/**
+ * @file unit-fragment_manifest.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file unit-tests class FragmentManifest.
+ */
+
+#include "catch.hpp"
+#include "fragment_manifest.h"
+
+#include <string>
+
+using namespace tiledb;
+
+TEST_CASE("FragmentManifest: Test records", "[fragment-manifest]") {
+  URI array_uri("file:///tmp/array");
+  std::string manifest;
+  manifest += FragmentManifest::add_record(array_uri.join_path("__a_1"), true);
+  manifest += FragmentManifest::add_record(array_uri.join_path("__b_2"), false);
+  manifest += FragmentManifest::add_record(array_uri.join_path("__c_3"), false);
+  manifest += FragmentManifest::delete_record(array_uri.join_path("__a_1"));
+  manifest += FragmentManifest::delete_record(array_uri.join_path("__b_2"));
+  CHECK(manifest == "add d __a_1\nadd s __b_2\nadd s __c_3\n"
+                    "del __a_1\ndel __b_2\n");
+
+  FragmentManifest fragment_manifest;
+  REQUIRE(fragment_manifest
+              .deserialize(array_uri, manifest.data(), manifest.size())
+              .ok());
+  auto fragment_uris = fragment_manifest.fragment_uris();
+  REQUIRE(fragment_uris.size() == 1);
+  CHECK(fragment_uris[0].to_string() == array_uri.to_string() + "/__c_3");
+  bool dense = true;
+  CHECK(fragment_manifest.dense(fragment_uris[0], &dense).ok());
+  CHECK(!dense);
+  CHECK(!fragment_manifest.dense(array_uri.join_path("__a_1"), &dense).ok());
+  CHECK(fragment_manifest.contains(array_uri.join_path("__c_3")));
+  CHECK(!fragment_manifest.contains(array_uri.join_path("__a_1")));
+  CHECK(fragment_manifest.deleted(array_uri.join_path("__a_1")));
+  CHECK(!fragment_manifest.deleted(array_uri.join_path("__c_3")));
+}
+
+TEST_CASE("FragmentManifest: Test parts", "[fragment-manifest]") {
+  URI array_uri("file:///tmp/array");
+  std::string part_1 = "add d __a_1\ndel __b_2\n";
+  std::string part_2 = "add s __b_2\nadd s __c_3\n";
+
+  // A deleted fragment is not added back, whatever the order of the parts
+  FragmentManifest fragment_manifest;
+  REQUIRE(fragment_manifest
+              .deserialize(array_uri, part_2.data(), part_2.size())
+              .ok());
+  REQUIRE(fragment_manifest
+              .deserialize(array_uri, part_1.data(), part_1.size())
+              .ok());
+  auto fragment_uris = fragment_manifest.fragment_uris();
+  REQUIRE(fragment_uris.size() == 2);
+  CHECK(fragment_uris[0].to_string() == array_uri.to_string() + "/__a_1");
+  CHECK(fragment_uris[1].to_string() == array_uri.to_string() + "/__c_3");
+  CHECK(fragment_manifest.deleted(array_uri.join_path("__b_2")));
+
+  // The compact form keeps the deletions
+  auto manifest = fragment_manifest.serialize();
+  CHECK(manifest == "add d __a_1\nadd s __c_3\ndel __b_2\n");
+  FragmentManifest compacted;
+  REQUIRE(compacted.deserialize(array_uri, manifest.data(), manifest.size())
+              .ok());
+  REQUIRE(compacted.deserialize(array_uri, part_2.data(), part_2.size()).ok());
+  CHECK(compacted.fragment_uris().size() == 2);
+  CHECK(!compacted.contains(array_uri.join_path("__b_2")));
+}
+
+TEST_CASE(
+    "FragmentManifest: Test partial and invalid records",
+    "[fragment-manifest]") {
+  URI array_uri("file:///tmp/array");
+  FragmentManifest fragment_manifest;
+
+  // Empty manifest
+  REQUIRE(fragment_manifest.deserialize(array_uri, "", 0).ok());
+  CHECK(fragment_manifest.fragment_uris().empty());
+
+  // An interrupted append is ignored
+  std::string manifest = "add d __a_1\nadd s __b";
+  REQUIRE(fragment_manifest
+              .deserialize(array_uri, manifest.data(), manifest.size())
+              .ok());
+  CHECK(fragment_manifest.fragment_uris().size() == 1);
+
+  // Invalid records
+  manifest = "add x __a_1\n";
+  CHECK(!fragment_manifest
+             .deserialize(array_uri, manifest.data(), manifest.size())
+             .ok());
+  manifest = "foo\n";
+  CHECK(!fragment_manifest
+             .deserialize(array_uri, manifest.data(), manifest.size())
+             .ok());
+}
@@ -0,0 +1,141 @@
+/**
+ * @file unit-query_condition.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file unit-tests class QueryCondition.
+ */
+
+#include "catch.hpp"
+#include "query_condition.h"
+
+#include <cmath>
+#include <limits>
+
+using namespace tiledb;
+
+typedef QueryCondition::CellPosRange CellPosRange;
+
+TEST_CASE("QueryCondition: Test apply", "[query-condition]") {
+  // Every value is evaluated, including the maximum of the type
+  int ints[] = {1, 7, 8, std::numeric_limits<int>::max(), 9, 2, 7, 7};
+  int value = 7;
+  std::vector<CellPosRange> result;
+  QueryCondition ge(0, Datatype::INT32, QueryConditionOp::GE, &value);
+  REQUIRE(ge.apply(ints, CellPosRange(0, 7), &result).ok());
+  std::vector<CellPosRange> expected = {{1, 4}, {6, 7}};
+  CHECK(result == expected);
+
+  result.clear();
+  QueryCondition ne(0, Datatype::INT32, QueryConditionOp::NE, &value);
+  REQUIRE(ne.apply(ints, CellPosRange(2, 6), &result).ok());
+  expected = {{2, 5}};
+  CHECK(result == expected);
+
+  result.clear();
+  QueryCondition eq(0, Datatype::INT32, QueryConditionOp::EQ, &value);
+  REQUIRE(eq.apply(ints, CellPosRange(2, 5), &result).ok());
+  CHECK(result.empty());
+
+  result.clear();
+  value = std::numeric_limits<int>::max();
+  QueryCondition ge_max(0, Datatype::INT32, QueryConditionOp::GE, &value);
+  REQUIRE(ge_max.apply(ints, CellPosRange(0, 7), &result).ok());
+  expected = {{3, 3}};
+  CHECK(result == expected);
+
+  uint8_t uints[] = {255, 3, 255};
+  uint8_t uint_value = 255;
+  result.clear();
+  QueryCondition ueq(0, Datatype::UINT8, QueryConditionOp::EQ, &uint_value);
+  REQUIRE(ueq.apply(uints, CellPosRange(0, 2), &result).ok());
+  expected = {{0, 0}, {2, 2}};
+  CHECK(result == expected);
+
+  // NaNs never satisfy a condition either
+  double doubles[] = {0.5, NAN, 2.5, -1.0};
+  double real = 1.0;
+  result.clear();
+  QueryCondition dne(0, Datatype::FLOAT64, QueryConditionOp::NE, &real);
+  REQUIRE(dne.apply(doubles, CellPosRange(0, 3), &result).ok());
+  expected = {{0, 0}, {2, 3}};
+  CHECK(result == expected);
+}
+
+TEST_CASE("QueryCondition: Test tile statistics", "[query-condition]") {
+  int ints[] = {10, 20, 30};
+  TileStats stats;
+  REQUIRE(stats.compute(Datatype::INT32, ints, sizeof(ints), false).ok());
+
+  int value = 10;
+  QueryCondition lt(0, Datatype::INT32, QueryConditionOp::LT, &value);
+  CHECK(!lt.may_match(stats));
+  QueryCondition le(0, Datatype::INT32, QueryConditionOp::LE, &value);
+  CHECK(le.may_match(stats));
+  CHECK(!le.matches_all(stats));
+  QueryCondition ge(0, Datatype::INT32, QueryConditionOp::GE, &value);
+  CHECK(ge.matches_all(stats));
+  QueryCondition eq(0, Datatype::INT32, QueryConditionOp::EQ, &value);
+  CHECK(eq.may_match(stats));
+  CHECK(!eq.matches_all(stats));
+
+  value = 31;
+  QueryCondition gt(0, Datatype::INT32, QueryConditionOp::GT, &value);
+  CHECK(!gt.may_match(stats));
+  QueryCondition ne(0, Datatype::INT32, QueryConditionOp::NE, &value);
+  CHECK(ne.matches_all(stats));
+
+  // In sparse tiles, the maximum of the type is bounded like any value
+  int max = std::numeric_limits<int>::max();
+  int maxes[] = {20, max};
+  QueryCondition eq_max(0, Datatype::INT32, QueryConditionOp::EQ, &max);
+  QueryCondition ge_max(0, Datatype::INT32, QueryConditionOp::GE, &max);
+  REQUIRE(stats.compute(Datatype::INT32, maxes, sizeof(maxes), false).ok());
+  CHECK(eq_max.may_match(stats));
+  CHECK(!eq_max.matches_all(stats));
+  CHECK(ge_max.may_match(stats));
+  REQUIRE(stats.compute(Datatype::INT32, &maxes[1], sizeof(int), false).ok());
+  CHECK(eq_max.matches_all(stats));
+  CHECK(ge_max.matches_all(stats));
+
+  // In dense tiles, a tile of empty cells matches nothing, and empty cells
+  // prevent matching all
+  int nulls[] = {std::numeric_limits<int>::max(), 20};
+  REQUIRE(stats.compute(Datatype::INT32, nulls, sizeof(int), true).ok());
+  CHECK(!ne.may_match(stats));
+  REQUIRE(stats.compute(Datatype::INT32, nulls, sizeof(nulls), true).ok());
+  CHECK(ne.may_match(stats));
+  CHECK(!ne.matches_all(stats));
+
+  // Real tiles are never matched as a whole, as they may hold NaNs
+  float floats[] = {1.0f, NAN};
+  float real = 0.0f;
+  REQUIRE(stats.compute(Datatype::FLOAT32, floats, sizeof(floats), false).ok());
+  QueryCondition fgt(0, Datatype::FLOAT32, QueryConditionOp::GT, &real);
+  CHECK(fgt.may_match(stats));
+  CHECK(!fgt.matches_all(stats));
+}
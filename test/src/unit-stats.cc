@@ -0,0 +1,73 @@
+/**
+ * @file unit-stats.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file unit-tests classes Stats and ScopedTimer.
+ */
+
+#include "catch.hpp"
+#include "stats.h"
+
+using namespace tiledb;
+
+TEST_CASE("Stats: Test counters and timers", "[stats]") {
+  Stats parent;
+  Stats stats;
+  stats.set_parent(&parent);
+
+  // Values propagate into the parent
+  stats.add(Stats::Counter::TILE_READ_NUM, 3);
+  stats.add(Stats::Counter::TILE_READ_NUM, 2);
+  stats.add_time(Stats::Timer::VFS_READ, 100);
+  parent.add(Stats::Counter::VFS_READ_BYTES, 7);
+  CHECK(stats.counter(Stats::Counter::TILE_READ_NUM) == 5);
+  CHECK(stats.timer(Stats::Timer::VFS_READ) == 100);
+  CHECK(stats.counter(Stats::Counter::VFS_READ_BYTES) == 0);
+  CHECK(parent.counter(Stats::Counter::TILE_READ_NUM) == 5);
+  CHECK(parent.timer(Stats::Timer::VFS_READ) == 100);
+  CHECK(parent.counter(Stats::Counter::VFS_READ_BYTES) == 7);
+
+  // A scoped timer records on destruction, unless the stats are null
+  { ScopedTimer timer(&stats, Stats::Timer::DECOMPRESS); }
+  { ScopedTimer timer(nullptr, Stats::Timer::DECOMPRESS); }
+  CHECK(
+      stats.timer(Stats::Timer::DECOMPRESS) ==
+      parent.timer(Stats::Timer::DECOMPRESS));
+
+  // Every counter and timer is serialized
+  auto json = parent.to_json();
+  CHECK(json.find("\"tile_read_num\": 5,") != std::string::npos);
+  CHECK(json.find("\"vfs_read_bytes\": 7,") != std::string::npos);
+  CHECK(json.find("\"vfs_read_ns\": 100,") != std::string::npos);
+  CHECK(json.find("\"cell_copy_ns\": 0\n}") != std::string::npos);
+
+  // Resetting does not affect the parent
+  stats.reset();
+  CHECK(stats.counter(Stats::Counter::TILE_READ_NUM) == 0);
+  CHECK(parent.counter(Stats::Counter::TILE_READ_NUM) == 5);
+}
@@ -0,0 +1,78 @@
+/**
+ * @file unit-threadpool.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file unit-tests class ThreadPool.
+ */
+
+#include "catch.hpp"
+#include "thread_pool.h"
+
+#include <atomic>
+
+using namespace tiledb;
+
+TEST_CASE("ThreadPool: Test initialization", "[threadpool]") {
+  ThreadPool pool;
+  CHECK(pool.num_threads() == 0);
+  CHECK(!pool.init(0).ok());
+  CHECK(!pool.enqueue([]() { return Status::Ok(); }).valid());
+
+  CHECK(pool.init(4).ok());
+  CHECK(pool.num_threads() == 4);
+  CHECK(!pool.init(4).ok());
+}
+
+TEST_CASE("ThreadPool: Test tasks", "[threadpool]") {
+  ThreadPool pool;
+  REQUIRE(pool.init(4).ok());
+
+  // All tasks run to completion
+  std::atomic<int> result(0);
+  std::vector<std::future<Status>> tasks;
+  for (int i = 0; i < 100; ++i) {
+    tasks.emplace_back(pool.enqueue([&result]() {
+      ++result;
+      return Status::Ok();
+    }));
+  }
+  CHECK(pool.wait_all(tasks).ok());
+  CHECK(result == 100);
+
+  // A failed task is reported, after all tasks complete
+  result = 0;
+  tasks.clear();
+  for (int i = 0; i < 100; ++i) {
+    tasks.emplace_back(pool.enqueue([&result, i]() {
+      ++result;
+      return (i == 50) ? Status::Error("Task failed") : Status::Ok();
+    }));
+  }
+  CHECK(!pool.wait_all(tasks).ok());
+  CHECK(result == 100);
+}
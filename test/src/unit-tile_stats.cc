@@ -0,0 +1,154 @@
+/**
+ * @file unit-tile_stats.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file unit-tests class TileStats.
+ */
+
+#include "catch.hpp"
+#include "tile_stats.h"
+
+#include <cstring>
+#include <limits>
+
+using namespace tiledb;
+
+template <class T>
+static T value(const void* v) {
+  T ret;
+  std::memcpy(&ret, v, sizeof(T));
+  return ret;
+}
+
+TEST_CASE("TileStats: Test compute", "[tile-stats]") {
+  // Signed integers in a dense fragment, with the empty value counted as
+  // null
+  int ints[] = {5, -3, std::numeric_limits<int>::max(), 12, 0};
+  TileStats stats;
+  REQUIRE(stats.compute(Datatype::INT32, ints, sizeof(ints), true).ok());
+  CHECK(stats.count() == 4);
+  CHECK(stats.null_count() == 1);
+  CHECK(value<int>(stats.min()) == -3);
+  CHECK(value<int>(stats.max()) == 12);
+  CHECK(value<int64_t>(stats.sum()) == 14);
+
+  // Sparse fragments store only written cells, so the maximum is a value
+  REQUIRE(stats.compute(Datatype::INT32, ints, sizeof(ints), false).ok());
+  CHECK(stats.count() == 5);
+  CHECK(stats.null_count() == 0);
+  CHECK(value<int>(stats.min()) == -3);
+  CHECK(value<int>(stats.max()) == std::numeric_limits<int>::max());
+  CHECK(
+      value<int64_t>(stats.sum()) ==
+      14 + (int64_t)std::numeric_limits<int>::max());
+
+  // Unsigned integers, whose sum exceeds the type
+  uint8_t uints[] = {200, 100, 3};
+  REQUIRE(stats.compute(Datatype::UINT8, uints, sizeof(uints), true).ok());
+  CHECK(stats.count() == 3);
+  CHECK(stats.null_count() == 0);
+  CHECK(value<uint8_t>(stats.min()) == 3);
+  CHECK(value<uint8_t>(stats.max()) == 200);
+  CHECK(value<uint64_t>(stats.sum()) == 303);
+
+  // Reals
+  float floats[] = {1.5f, -2.25f, 4.0f};
+  REQUIRE(stats.compute(Datatype::FLOAT32, floats, sizeof(floats), true).ok());
+  CHECK(value<float>(stats.min()) == -2.25f);
+  CHECK(value<float>(stats.max()) == 4.0f);
+  CHECK(value<double>(stats.sum()) == 3.25);
+
+  // Characters have no sum
+  const char chars[] = "tiledb";
+  REQUIRE(stats.compute(Datatype::CHAR, chars, 6, true).ok());
+  CHECK(!TileStats::has_sum(Datatype::CHAR));
+  CHECK(value<char>(stats.min()) == 'b');
+  CHECK(value<char>(stats.max()) == 't');
+  CHECK(value<int64_t>(stats.sum()) == 0);
+
+  // Only nulls
+  int64_t empty[] = {std::numeric_limits<int64_t>::max()};
+  REQUIRE(stats.compute(Datatype::INT64, empty, sizeof(empty), true).ok());
+  CHECK(stats.count() == 0);
+  CHECK(stats.null_count() == 1);
+}
+
+TEST_CASE("TileStats: Test merge", "[tile-stats]") {
+  double values_1[] = {3.0, 8.5};
+  double values_2[] = {-1.0, std::numeric_limits<double>::max()};
+  double values_3[] = {std::numeric_limits<double>::max()};
+  TileStats stats_1, stats_2, stats_3;
+  REQUIRE(stats_1
+              .compute(Datatype::FLOAT64, values_1, sizeof(values_1), true)
+              .ok());
+  REQUIRE(stats_2
+              .compute(Datatype::FLOAT64, values_2, sizeof(values_2), true)
+              .ok());
+  REQUIRE(stats_3
+              .compute(Datatype::FLOAT64, values_3, sizeof(values_3), true)
+              .ok());
+
+  // Merging into empty statistics copies the input ones
+  TileStats merged;
+  REQUIRE(merged.merge(Datatype::FLOAT64, stats_3).ok());
+  REQUIRE(merged.merge(Datatype::FLOAT64, stats_1).ok());
+  CHECK(merged.count() == 2);
+  CHECK(merged.null_count() == 1);
+  CHECK(value<double>(merged.min()) == 3.0);
+  CHECK(value<double>(merged.max()) == 8.5);
+
+  REQUIRE(merged.merge(Datatype::FLOAT64, stats_2).ok());
+  CHECK(merged.count() == 3);
+  CHECK(merged.null_count() == 2);
+  CHECK(value<double>(merged.min()) == -1.0);
+  CHECK(value<double>(merged.max()) == 8.5);
+  CHECK(value<double>(merged.sum()) == 10.5);
+}
+
+TEST_CASE("TileStats: Test serialization", "[tile-stats]") {
+  uint32_t values[] = {7, 42, std::numeric_limits<uint32_t>::max(), 1};
+  TileStats stats;
+  REQUIRE(stats.compute(Datatype::UINT32, values, sizeof(values), true).ok());
+
+  Buffer buff;
+  REQUIRE(stats.serialize(&buff).ok());
+
+  TileStats stats_copy;
+  ConstBuffer cbuff(&buff);
+  REQUIRE(stats_copy.deserialize(&cbuff).ok());
+  CHECK(cbuff.end());
+  CHECK(stats_copy.count() == 3);
+  CHECK(stats_copy.null_count() == 1);
+  CHECK(value<uint32_t>(stats_copy.min()) == 1);
+  CHECK(value<uint32_t>(stats_copy.max()) == 42);
+  CHECK(value<uint64_t>(stats_copy.sum()) == 50);
+
+  // Truncated input
+  ConstBuffer truncated(buff.data(), buff.size() - 1);
+  CHECK(!stats_copy.deserialize(&truncated).ok());
+}
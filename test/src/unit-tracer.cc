@@ -0,0 +1,93 @@
+/**
+ * @file unit-tracer.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file unit-tests classes Tracer and TraceSpan.
+ */
+
+#include "catch.hpp"
+#include "tracer.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace tiledb;
+
+/** Returns the number of occurrences of `pattern` in `str`. */
+static size_t count(const std::string& str, const std::string& pattern) {
+  size_t num = 0;
+  for (auto pos = str.find(pattern); pos != std::string::npos;
+       pos = str.find(pattern, pos + 1))
+    ++num;
+  return num;
+}
+
+TEST_CASE("Tracer: Test spans", "[tracer]") {
+  // A tracer without a file records nothing
+  Tracer disabled;
+  CHECK(disabled.init("", 4).ok());
+  CHECK(!disabled.enabled());
+  { TraceSpan span(&disabled, "span"); }
+  { TraceSpan span(nullptr, "span"); }
+
+  std::string trace_file = "tiledb_test_trace.json";
+  {
+    Tracer tracer;
+    CHECK(!tracer.init(trace_file, 0).ok());
+    REQUIRE(tracer.init(trace_file, 4).ok());
+    CHECK(tracer.enabled());
+
+    // Each thread keeps only its 4 most recent spans
+    for (int i = 0; i < 6; ++i) {
+      TraceSpan span(&tracer, (i < 2) ? "old" : "main");
+    }
+    std::thread t([&tracer]() {
+      for (int i = 0; i < 3; ++i) {
+        TraceSpan span(&tracer, "worker");
+      }
+    });
+    t.join();
+    REQUIRE(tracer.dump().ok());
+  }
+
+  std::ifstream ifs(trace_file);
+  REQUIRE(ifs.is_open());
+  std::stringstream ss;
+  ss << ifs.rdbuf();
+  ifs.close();
+  auto trace = ss.str();
+  CHECK(trace.find("{\"traceEvents\":[") == 0);
+  CHECK(count(trace, "\"name\":\"old\"") == 0);
+  CHECK(count(trace, "\"name\":\"main\"") == 4);
+  CHECK(count(trace, "\"name\":\"worker\"") == 3);
+  CHECK(count(trace, "\"tid\":1,") == 4);
+  CHECK(count(trace, "\"tid\":2,") == 3);
+  std::remove(trace_file.c_str());
+}